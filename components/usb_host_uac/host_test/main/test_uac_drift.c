@@ -0,0 +1,225 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <inttypes.h>
+#include <math.h>
+#include "unity.h"
+#include "uac_pacer.h"
+#include "uac_drift.h"
+
+#define SIM_PACKETS_PER_DAY      (24ULL * 3600 * 1000)   /*!< 1 ms packets in 24 hours */
+#define SIM_SETTLE_PACKETS       (10ULL * 60 * 1000)     /*!< The loop must have settled after 10 minutes */
+#define SIM_WRITE_MS             (10)                     /*!< The writer writes a block every 10 ms of its clock */
+#define SIM_RING_MS              (80)                     /*!< Ring size */
+#define SIM_TARGET_MS            (40)                     /*!< Target depth */
+#define SIM_FB_REFRESH_PACKETS   (32)
+
+typedef struct {
+    uint32_t sample_freq;
+    int32_t writer_ppm;          // writer clock against the USB SOF clock
+    int32_t writer_ppm_after;    // writer clock after half a day, to check a step change
+    int32_t device_ppm;          // DAC clock against the USB SOF clock, asynchronous devices only
+    bool async;
+} sim_case_t;
+
+/**
+ * Simulate one day of a ring written by a free running clock and read by the USB packet schedule through the
+ * resampler, counting frames only. The ring must never run dry or overflow, and after settling must stay at the
+ * target depth, give or take the block the writer writes at once.
+ */
+static void simulate_drift(const sim_case_t *sim)
+{
+    const uint32_t freq = sim->sample_freq;
+    const int64_t ring = freq * SIM_RING_MS / 1000;
+    const uint32_t target = freq * SIM_TARGET_MS / 1000;
+    const uint32_t block = freq * SIM_WRITE_MS / 1000;
+    uac_pacer_t pacer;
+    TEST_ASSERT_TRUE(uac_pacer_init(&pacer, freq, 1, freq / 1000 + 2));
+    uac_drift_t drift;
+    uac_drift_init(&drift, freq, target);
+    uac_drift_phase_t phase = {0};
+    uac_drift_phase_set(&phase, 0);
+
+    // writer time in ns of its own clock
+    int64_t writer_ns = 0;
+    int64_t fill = target;
+    int64_t min_fill = INT64_MAX, max_fill = 0;
+    // device rate, 10.14 with 32 more fraction bits, reported with error feedback
+    int64_t device_rate = (int64_t)(((uint64_t)freq << 46) / 1000);
+    device_rate += device_rate / 1000000 * sim->device_ppm;
+    int64_t reported_err = 0;
+    // the writer lands its blocks on whole packets, so the fill also steps by one packet at the beat of the two
+    // clocks, seconds apart and too slow for the filter: judge the rate by the mean correction of the last minutes
+    int64_t correction_sum = 0;
+
+    for (uint64_t i = 0; i < SIM_PACKETS_PER_DAY; i++) {
+        int32_t writer_ppm = i < SIM_PACKETS_PER_DAY / 2 ? sim->writer_ppm : sim->writer_ppm_after;
+        // writer: 1 ms of USB time is 1 ms + ppm ns of its own, a block every SIM_WRITE_MS of it
+        writer_ns += 1000000 + writer_ppm;
+        while (writer_ns >= SIM_WRITE_MS * 1000000LL) {
+            writer_ns -= SIM_WRITE_MS * 1000000LL;
+            fill += block;
+            if (fill > ring) {
+                TEST_FAIL_MESSAGE("ring overflow");
+            }
+        }
+        // asynchronous device: feedback sets the packet sizes, and is the feed-forward of the servo
+        if (sim->async && i % SIM_FB_REFRESH_PACKETS == 0) {
+            int64_t t = device_rate + reported_err;
+            uint32_t value = (uint32_t)(t >> 32);
+            reported_err = t - ((int64_t)value << 32);
+            TEST_ASSERT_TRUE(uac_pacer_set_feedback(&pacer, value << 2));
+            uac_drift_set_feedforward(&drift, (int32_t)((((int64_t)freq << 16) * 1000000) / pacer.feedback - 1000000000));
+        }
+        // reader: one packet through the resampler
+        uint32_t out = uac_pacer_next(&pacer);
+        uint32_t need = uac_drift_phase_need(&phase, out);
+        if (fill < need) {
+            TEST_FAIL_MESSAGE("ring ran dry");
+        }
+        fill -= need;
+        phase.frac = (uint32_t)(phase.frac + phase.step * out);
+        uac_drift_phase_set(&phase, uac_drift_update(&drift, (uint32_t)fill, out));
+        if (i >= SIM_SETTLE_PACKETS && (i < SIM_PACKETS_PER_DAY / 2 || i >= SIM_PACKETS_PER_DAY / 2 + SIM_SETTLE_PACKETS)) {
+            min_fill = fill < min_fill ? fill : min_fill;
+            max_fill = fill > max_fill ? fill : max_fill;
+        }
+        if (i >= SIM_PACKETS_PER_DAY - SIM_SETTLE_PACKETS) {
+            correction_sum += drift.correction;
+        }
+    }
+    double correction_ppm = correction_sum * 1e-3 / SIM_SETTLE_PACKETS;
+    // the reader follows the writer against the DAC: 1 + c = (1 + writer) / (1 + device)
+    double expected_ppm = ((1.0 + sim->writer_ppm_after * 1e-6) / (1.0 + (sim->async ? sim->device_ppm : 0) * 1e-6) - 1.0) * 1e6;
+    printf("%6" PRIu32 " Hz writer %+4" PRIi32 "/%+4" PRIi32 " ppm device %+4" PRIi32 " ppm%s: fill %" PRIi64 "..%" PRIi64
+           " frames (target %" PRIu32 ", block %" PRIu32 "), mean correction %+.3f ppm, expected %+.3f ppm\n",
+           freq, sim->writer_ppm, sim->writer_ppm_after, sim->device_ppm, sim->async ? " async" : "", min_fill, max_fill,
+           target, block, correction_ppm, expected_ppm);
+    // just after a read the ring holds between target - block and target + block frames, plus the packet jitter
+    TEST_ASSERT_GREATER_OR_EQUAL_INT64(target - block - 4, min_fill);
+    TEST_ASSERT_LESS_OR_EQUAL_INT64(target + block + 4, max_fill);
+    TEST_ASSERT_DOUBLE_WITHIN(0.5, expected_ppm, correction_ppm);
+}
+
+TEST_CASE("uac drift servo with injected ppm offsets over 24 hours", "[drift]")
+{
+    const sim_case_t cases[] = {
+        {48000, 0, 0, 0, false},
+        {48000, 300, 300, 0, false},
+        {48000, -450, -450, 0, false},
+        {44100, 120, -380, 0, false},
+        {44100, 0, 0, 250, true},
+        {48000, 100, 100, -300, true},
+        {96000, -200, 200, 150, true},
+    };
+    for (int i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        simulate_drift(&cases[i]);
+    }
+}
+
+TEST_CASE("uac drift servo clamps at 500 ppm", "[drift]")
+{
+    uac_drift_t drift;
+    uac_drift_init(&drift, 48000, 1000);
+    // a ring stuck full asks for the largest correction and does not wind up
+    for (int i = 0; i < 100000; i++) {
+        TEST_ASSERT_LESS_OR_EQUAL_INT32(UAC_DRIFT_MAX_PPB, uac_drift_update(&drift, 4000, 48));
+    }
+    TEST_ASSERT_EQUAL_INT32(UAC_DRIFT_MAX_PPB, drift.correction);
+    // back at the target the correction comes off at once, the integral is bounded
+    for (int i = 0; i < 5000; i++) {
+        uac_drift_update(&drift, 1000, 48);
+    }
+    TEST_ASSERT_LESS_THAN_INT32(UAC_DRIFT_MAX_PPB, drift.correction);
+}
+
+#define SIM_TONE_BLOCKS          (2000)
+#define SIM_TONE_SKIP_BLOCKS     (10)                     /*!< Blocks before the history is all tone */
+
+/**
+ * Resample a 1 kHz tone at 48 kHz read ppb fast, 48 output frames a block like a 1 ms transfer. The output must be the
+ * same tone 1 + ppb higher with 2 frames of delay. The buffer past the new input frames is poisoned, it must never
+ * reach the output.
+ */
+static void check_resampler_tone(int32_t ppb, double *snr_db, double *max_err)
+{
+    const uint32_t out_frames = 48;
+    int16_t buf[(UAC_DRIFT_HISTORY + 64) * 2] = {0};
+    int16_t out[48 * 2];
+    uac_drift_phase_t phase = {0};
+    uac_drift_phase_set(&phase, ppb);
+    uint64_t in_pos = 0;
+    double err2 = 0, sig2 = 0;
+    *max_err = 0;
+    for (uint32_t block = 0; block < SIM_TONE_BLOCKS; block++) {
+        uint32_t need = uac_drift_phase_need(&phase, out_frames);
+        for (uint32_t i = 0; i < need; i++, in_pos++) {
+            int16_t v = (int16_t)lround(16384.0 * sin(2 * M_PI * 1000.0 * in_pos / 48000.0));
+            buf[(UAC_DRIFT_HISTORY + i) * 2] = v;
+            buf[(UAC_DRIFT_HISTORY + i) * 2 + 1] = (int16_t) - v;
+        }
+        for (uint32_t i = UAC_DRIFT_HISTORY + need; i < sizeof(buf) / sizeof(buf[0]) / 2; i++) {
+            buf[i * 2] = INT16_MAX;
+            buf[i * 2 + 1] = INT16_MIN;
+        }
+        uint64_t out_pos = (uint64_t)block * out_frames;
+        TEST_ASSERT_EQUAL_UINT32(need, uac_drift_resample_s16(&phase, buf, out, out_frames, 2));
+        if (block < SIM_TONE_SKIP_BLOCKS) {
+            continue;
+        }
+        for (uint32_t n = 0; n < out_frames; n++) {
+            // input position of output frame k is k x step, counted from the frame 2 before the first input
+            double t = (out_pos + n) * (1.0 + ppb * 1e-9) - 2.0;
+            double ideal = 16384.0 * sin(2 * M_PI * 1000.0 * t / 48000.0);
+            double e0 = out[n * 2] - ideal, e1 = out[n * 2 + 1] + ideal;
+            err2 += e0 * e0 + e1 * e1;
+            sig2 += 2 * ideal * ideal;
+            *max_err = fmax(*max_err, fmax(fabs(e0), fabs(e1)));
+        }
+    }
+    *snr_db = 10 * log10(sig2 / err2);
+    printf("1 kHz %+" PRIi32 " ppb: SNR %.1f dB, max error %.2f LSB\n", ppb, *snr_db, *max_err);
+}
+
+TEST_CASE("uac drift resampler accuracy", "[drift]")
+{
+    const int32_t ppbs[] = {300000, -300000};
+    for (int i = 0; i < sizeof(ppbs) / sizeof(ppbs[0]); i++) {
+        double snr, max_err;
+        check_resampler_tone(ppbs[i], &snr, &max_err);
+        TEST_ASSERT_GREATER_THAN_DOUBLE(80.0, snr);
+        TEST_ASSERT_LESS_THAN_DOUBLE(3.0, max_err);
+    }
+}
+
+TEST_CASE("uac drift resampler reads only the frames it needs when slow", "[drift]")
+{
+    // Read slower than 1:1, the last output frame of a block can sit less than 1 - step past an input frame: it is
+    // interpolated between the last two new frames, and the frame after them is not in the buffer. The poison only
+    // weighs t^2 / 2 there, so the output is put on a rounding edge: a steep ramp, half an LSB past a new frame.
+    const int32_t ppb = -300000;
+    const uint32_t out_frames = 48;
+    const double t = 0.5 / 2000;
+    const int16_t poison[] = {INT16_MAX, INT16_MIN};
+    int16_t out[2][48];
+    for (int p = 0; p < 2; p++) {
+        uac_drift_phase_t phase = {0};
+        uac_drift_phase_set(&phase, ppb);
+        phase.frac = (uint32_t)(llround(t * 4294967296.0) - phase.step * (out_frames - 1));
+        uint32_t need = uac_drift_phase_need(&phase, out_frames);
+        TEST_ASSERT_EQUAL_UINT32(need, (phase.frac + phase.step * (out_frames - 1)) >> 32);
+        int16_t buf[UAC_DRIFT_HISTORY + 64];
+        for (uint32_t i = 0; i < UAC_DRIFT_HISTORY + 64; i++) {
+            buf[i] = i < UAC_DRIFT_HISTORY + need ? (int16_t)(i < need ? 0 : 2000 * (i - need)) : poison[p];
+        }
+        TEST_ASSERT_EQUAL_UINT32(need, uac_drift_resample_s16(&phase, buf, out[p], out_frames, 1));
+        // 2 frames of delay: between the last two new frames, 2000 and 4000
+        TEST_ASSERT_INT_WITHIN(1, 2000, out[p][out_frames - 1] - 1);
+    }
+    TEST_ASSERT_EQUAL_INT16_ARRAY(out[0], out[1], out_frames);
+}
@@ -0,0 +1,132 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <inttypes.h>
+#include "unity.h"
+#include "uac_pacer.h"
+
+#define PACKETS_PER_DAY          (24ULL * 3600 * 1000)   /*!< 1 ms packets in 24 hours */
+#define FB_REFRESH_PACKETS       (32)                     /*!< Feedback period of a typical device, 2^5 ms */
+
+// Frames sent must be the exact count rounded down after every packet, one rounding only: no drift
+static void simulate_nominal(uint32_t sample_freq, uint32_t interval_ms, uint64_t packets)
+{
+    uac_pacer_t pacer;
+    TEST_ASSERT_TRUE(uac_pacer_init(&pacer, sample_freq, interval_ms, sample_freq * interval_ms / 1000 + 1));
+    uint32_t n = sample_freq * interval_ms / 1000;
+    uint64_t sent = 0;
+    for (uint64_t i = 1; i <= packets; i++) {
+        uint32_t frames = uac_pacer_next(&pacer);
+        if (frames != n && frames != n + 1) {
+            TEST_FAIL_MESSAGE("packet is neither N nor N + 1 frames");
+        }
+        sent += frames;
+        // exact frames after i packets: sample_freq * interval_ms * i / 1000
+        uint64_t exact_x1000 = (uint64_t)sample_freq * interval_ms * i;
+        if (sent * 1000 > exact_x1000 || (sent + 1) * 1000 <= exact_x1000) {
+            TEST_FAIL_MESSAGE("schedule is off by a frame or more");
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT64((uint64_t)sample_freq * interval_ms * packets / 1000, sent);
+    printf("%6" PRIu32 " Hz, %" PRIu32 " ms packets: %" PRIu64 " frames in %" PRIu64 " packets, drift 0\n",
+           sample_freq, interval_ms, sent, packets);
+}
+
+TEST_CASE("uac pacer nominal rates over 24 hours", "[pacer]")
+{
+    const uint32_t rates[] = {8000, 11025, 16000, 22050, 32000, 44100, 48000, 88200, 96000, 176400, 192000};
+    for (int i = 0; i < sizeof(rates) / sizeof(rates[0]); i++) {
+        simulate_nominal(rates[i], 1, PACKETS_PER_DAY);
+    }
+    simulate_nominal(44100, 2, PACKETS_PER_DAY / 2);
+    simulate_nominal(44100, 8, PACKETS_PER_DAY / 8);
+}
+
+TEST_CASE("uac pacer 44.1 kHz pattern", "[pacer]")
+{
+    uac_pacer_t pacer;
+    TEST_ASSERT_TRUE(uac_pacer_init(&pacer, 44100, 1, 45));
+    TEST_ASSERT_EQUAL_UINT32(44, pacer.frames);
+    // one 45 frame packet every 10 packets
+    for (int round = 0; round < 3; round++) {
+        uint32_t sum = 0;
+        for (int i = 0; i < 10; i++) {
+            uint32_t frames = uac_pacer_next(&pacer);
+            TEST_ASSERT_EQUAL_UINT32(i == 9 ? 45 : 44, frames);
+            sum += frames;
+        }
+        TEST_ASSERT_EQUAL_UINT32(441, sum);
+    }
+}
+
+// A device running fast by ppm parts per million reports its rate in 10.14 format every FB_REFRESH_PACKETS, dithering
+// between the two nearest values. Frames sent must follow the reported rates exactly over a day
+static void simulate_feedback(uint32_t sample_freq, int32_t ppm)
+{
+    uac_pacer_t pacer;
+    TEST_ASSERT_TRUE(uac_pacer_init(&pacer, sample_freq, 1, sample_freq / 1000 + 2));
+    // device rate in frames per ms, 10.14 with 32 more fraction bits
+    int64_t true_rate = (int64_t)(((uint64_t)sample_freq << 46) / 1000);
+    true_rate += true_rate / 1000000 * ppm;
+    int64_t reported_err = 0;
+    uint64_t requested = 0;          // sum of the rates in effect, in phase units
+    uint64_t sent = 0;
+    for (uint64_t i = 0; i < PACKETS_PER_DAY; i++) {
+        if (i % FB_REFRESH_PACKETS == 0) {
+            // round to 10.14 with error feedback, as a device servo would
+            int64_t target = true_rate + reported_err;
+            uint32_t value = (uint32_t)(target >> 32);
+            reported_err = target - ((int64_t)value << 32);
+            TEST_ASSERT_TRUE(uac_pacer_set_feedback(&pacer, value << 2));
+        }
+        requested += (uint64_t)pacer.feedback * 1000;
+        sent += uac_pacer_next(&pacer);
+        if (sent * UAC_PACER_ONE > requested || (sent + 1) * UAC_PACER_ONE <= requested) {
+            TEST_FAIL_MESSAGE("schedule is off the feedback by a frame or more");
+        }
+    }
+    // and the reported rates average to the device rate
+    int64_t device_frames = (int64_t)(((__int128)true_rate * PACKETS_PER_DAY) >> 46);
+    printf("%6" PRIu32 " Hz %+4" PRIi32 " ppm feedback: %" PRIu64 " frames sent, device consumed %" PRIi64 "\n",
+           sample_freq, ppm, sent, device_frames);
+    TEST_ASSERT_INT64_WITHIN(2, device_frames, (int64_t)sent);
+}
+
+TEST_CASE("uac pacer feedback over 24 hours", "[pacer]")
+{
+    simulate_feedback(44100, 0);
+    simulate_feedback(44100, 150);
+    simulate_feedback(44100, -230);
+    simulate_feedback(48000, 500);
+    simulate_feedback(96000, -500);
+}
+
+TEST_CASE("uac pacer limits", "[pacer]")
+{
+    uac_pacer_t pacer;
+    // 48 frames fit, 44.1 needs 45
+    TEST_ASSERT_TRUE(uac_pacer_init(&pacer, 48000, 1, 48));
+    TEST_ASSERT_FALSE(uac_pacer_init(&pacer, 44100, 1, 44));
+    TEST_ASSERT_TRUE(uac_pacer_init(&pacer, 44100, 1, 45));
+    // more than 1/8 off the nominal rate, or more frames than fit, is ignored
+    TEST_ASSERT_FALSE(uac_pacer_set_feedback(&pacer, 50 << 16));
+    TEST_ASSERT_FALSE(uac_pacer_set_feedback(&pacer, 38 << 16));
+    TEST_ASSERT_FALSE(uac_pacer_set_feedback(&pacer, (uint32_t)(45.5 * 65536)));
+    TEST_ASSERT_EQUAL_UINT32(0, pacer.feedback);
+    TEST_ASSERT_TRUE(uac_pacer_set_feedback(&pacer, (uint32_t)(44.5 * 65536)));
+    TEST_ASSERT_EQUAL_UINT32(44, uac_pacer_next(&pacer));
+    TEST_ASSERT_EQUAL_UINT32(45, uac_pacer_next(&pacer));
+    // back to 44.1 frames per packet
+    uac_pacer_reset(&pacer);
+    TEST_ASSERT_EQUAL_UINT32(0, pacer.feedback);
+    uint32_t sum = 0;
+    for (int i = 0; i < 1000; i++) {
+        sum += uac_pacer_next(&pacer);
+    }
+    TEST_ASSERT_EQUAL_UINT32(44100, sum);
+}
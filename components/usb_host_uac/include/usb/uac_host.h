@@ -0,0 +1,607 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <wchar.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "uac.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief USB UAC HOST string descriptor maximal length
+ *
+ * The maximum possible number of characters in an embedded string is device specific.
+ * For USB devices, the maximum string length is 126 wide characters (not including the terminating NULL character).
+ * This is a length, which is available to upper level application during getting information
+ * of UAC Device with 'uac_host_get_device_info' call.
+ *
+ * To decrease memory usage 32 wide characters (64 bytes per every string) is used.
+*/
+#define UAC_STR_DESC_MAX_LENGTH              (32)
+
+/**
+ * @brief Flags to control stream work flow
+ *
+ * FLAG_STREAM_SUSPEND_AFTER_START: do not start stream transfer during start, only claim interface and prepare memory
+ * @note User should call uac_host_device_resume to start stream transfer when needed
+ *
+ * FLAG_STREAM_TX_CONTINUOUS: (TX only) keep all transfers in flight from resume to suspend. When the ring buffer
+ * cannot fill a transfer, the missing part is concealed (see uac_host_device_set_tx_conceal) and counted as an
+ * underrun, instead of parking the transfer until the next uac_host_device_write
+*/
+#define FLAG_STREAM_SUSPEND_AFTER_START      (1 << 0)
+#define FLAG_STREAM_TX_CONTINUOUS            (1 << 1)
+
+typedef struct uac_interface *uac_host_device_handle_t;    /*!< Logic Device Handle. Handle to a particular UAC interface */
+
+// ------------------------ USB UAC Host events --------------------------------
+/**
+ * @brief USB UAC HOST Driver event id
+*/
+typedef enum {
+    UAC_HOST_DRIVER_EVENT_RX_CONNECTED = 0x00,           /*!< UAC RX Device has been found in connected USB device */
+    UAC_HOST_DRIVER_EVENT_TX_CONNECTED,                  /*!< UAC TX Device has been found in connected USB device */
+} uac_host_driver_event_t;
+
+/**
+ * @brief USB UAC Device (Interface) event id
+*/
+typedef enum {
+    UAC_HOST_DEVICE_EVENT_RX_DONE = 0x00,                /*!< RX Done: the receive buffer data size exceeds the threshold */
+    UAC_HOST_DEVICE_EVENT_TX_DONE,                       /*!< TX Done: the transmit buffer data size falls below the threshold */
+    UAC_HOST_DEVICE_EVENT_TRANSFER_ERROR,                /*!< UAC Device transfer error */
+    UAC_HOST_DRIVER_EVENT_DISCONNECTED,                  /*!< UAC Device has been disconnected */
+} uac_host_device_event_t;
+
+// ------------------------ USB UAC Host events callbacks -----------------------------
+/**
+ * @brief USB UAC driver event callback.
+ *
+ * @param[in] addr        USB Address of connected UAC device
+ * @param[in] iface_num   UAC Interface Number
+ * @param[in] event       UAC driver event
+ * @param[in] arg         User argument from UAC driver configuration structure
+*/
+typedef void (*uac_host_driver_event_cb_t)(uint8_t addr, uint8_t iface_num,
+        const uac_host_driver_event_t event, void *arg);
+
+/**
+ * @brief USB UAC logic device/interface event callback.
+ *
+ * @param[in] uac_device_handle     UAC device handle (UAC Interface)
+ * @param[in] event                 UAC device event
+ * @param[in] arg                   User argument
+*/
+typedef void (*uac_host_device_event_cb_t)(uac_host_device_handle_t uac_device_handle,
+        const uac_host_device_event_t event, void *arg);
+
+/**
+ * @brief  USB UAC host class descriptor print callback
+ *
+ * @param[in] desc  Pointer to the USB configuration descriptor
+ * @param[in] class  Class of the UAC device
+ * @param[in] subclass  Subclass of the UAC device
+ * @param[in] protocol  Protocol of the UAC device
+ *
+ */
+typedef void (*print_class_descriptor_with_context_cb)(const usb_standard_desc_t *desc,
+        uint8_t class, uint8_t subclass, uint8_t protocol);
+
+/**
+ * @brief Stream type
+ *
+*/
+typedef enum {
+    UAC_STREAM_TX = 0,     /*!< usb audio TX (eg. speaker stream) */
+    UAC_STREAM_RX,         /*!< usb audio RX (eg. microphone stream) */
+    UAC_STREAM_MAX,        /*!< max stream type */
+} uac_host_stream_t;
+
+/**
+ * @brief USB UAC logic device/interface information
+*/
+typedef struct {
+    uac_host_stream_t type;                             /*!< Stream type */
+    uint8_t iface_num;                                  /*!< UAC Interface Number */
+    uint8_t iface_alt_num;                              /*!< UAC Interface Alternate Setting Total Number */
+    uint8_t addr;                                       /*!< USB Address of connected UAC device */
+    uint16_t VID;                                       /*!< Vendor ID */
+    uint16_t PID;                                       /*!< Product ID */
+    wchar_t iManufacturer[UAC_STR_DESC_MAX_LENGTH];     /*!< Manufacturer string */
+    wchar_t iProduct[UAC_STR_DESC_MAX_LENGTH];          /*!< Product string */
+    wchar_t iSerialNumber[UAC_STR_DESC_MAX_LENGTH];     /*!< Serial Number string */
+} uac_host_dev_info_t;
+
+/**
+ * @brief USB UAC Interface alternate information
+ *
+*/
+typedef struct {
+    uint8_t format;                                  /*!< audio stream format, currently only support 1 - PCM */
+    uint8_t channels;                                /*!< audio stream channels */
+    uint8_t bit_resolution;                          /*!< audio stream bit resolution */
+    uint8_t sample_freq_type;                        /*!< audio stream sample frequency type, 0 - continuous, 1,2,3 - discrete */
+    union {
+        uint32_t sample_freq[UAC_FREQ_NUM_MAX];      /*!< audio stream sample frequency, first N discrete sample frequency */
+        struct {
+            uint32_t sample_freq_lower;              /*!< audio stream sample frequency lower */
+            uint32_t sample_freq_upper;              /*!< audio stream sample frequency upper */
+        };
+    };
+} uac_host_dev_alt_param_t;
+
+/**
+ * @brief UAC driver configuration structure.
+*/
+typedef struct {
+    bool create_background_task;            /*!< When set to true, background task handling USB events is created.
+                                             Otherwise user has to periodically call uac_host_handle_events function */
+    size_t task_priority;                   /*!< Task priority of created background task */
+    size_t stack_size;                      /*!< Stack size of created background task */
+    BaseType_t core_id;                     /*!< Select core on which background task will run or tskNO_AFFINITY  */
+    uac_host_driver_event_cb_t callback;    /*!< Callback invoked when UAC driver event occurs. Must not be NULL. */
+    void *callback_arg;                     /*!< User provided argument passed to callback */
+} uac_host_driver_config_t;
+
+/**
+ * @brief UAC logic device/interface configuration structure
+ *
+*/
+typedef struct {
+    uint8_t addr;                                       /*!< USB Address of connected physical device */
+    uint8_t iface_num;                                  /*!< UAC Interface Number */
+    uint32_t buffer_size;                               /*!< Audio buffer size */
+    uint32_t buffer_threshold;                          /*!< Audio buffer threshold */
+    uac_host_device_event_cb_t callback;                /*!< Callback invoked when UAC device event occurs */
+    void *callback_arg;                                 /*!< User provided argument passed to callback */
+} uac_host_device_config_t;
+
+/**
+ * @brief UAC stream configuration structure
+ *
+*/
+typedef struct {
+    uint8_t channels;                                    /*!< Audio channel number */
+    uint8_t bit_resolution;                              /*!< Audio bit resolution */
+    uint32_t sample_freq;                                /*!< Audio sample resolution */
+    uint16_t flags;                                      /*!< Control flags */
+} uac_host_stream_config_t;
+
+// ----------------------------- Public ---------------------------------------
+/**
+ * @brief Install USB Host UAC Class driver
+ *
+ * @note This function must be called after usb_host_install
+ *
+ * @param[in] config UAC driver configuration structure
+ * @return esp_err_r
+ *  - ESP_OK on success
+ *  - ESP_ERR_INVALID_STATE if UAC driver is already installed
+ *  - ESP_ERR_INVALID_ARG if the configuration is invalid
+ *  - ESP_ERR_NO_MEM if memory allocation failed
+ *
+*/
+esp_err_t uac_host_install(const uac_host_driver_config_t *config);
+
+/**
+ * @brief Uninstall USB Host UAC Class driver
+ *
+ * @note This function can only be called after all open devices have been closed
+ * @return esp_err_t
+ *  - ESP_OK on success
+ *  - ESP_ERR_INVALID_STATE if UAC driver is not installed or device is still opened
+ */
+esp_err_t uac_host_uninstall(void);
+
+/**
+ * @brief Open a UAC logic device/interface when new UAC device is connected
+ *
+ * @note The config->addr and config->iface_num should be retrieved from the UAC driver event callback
+ *      after UAC_HOST_DRIVER_EVENT_RX_CONNECTED or UAC_HOST_DRIVER_EVENT_TX_CONNECTED event
+ * @param[in] config            Pointer to UAC device configuration structure
+ * @param[out] uac_dev_handle   Pointer to UAC device handle
+ * @return esp_err_t
+ *  - ESP_OK on success
+ *  - ESP_ERR_INVALID_STATE if UAC driver is not installed
+ *  - ESP_ERR_INVALID_ARG if the configuration is invalid
+ *  - ESP_ERR_NO_MEM if memory allocation failed
+ *  - ESP_ERR_NOT_SUPPORTED if the UAC version is not supported
+ */
+esp_err_t uac_host_device_open(const uac_host_device_config_t *config, uac_host_device_handle_t *uac_dev_handle);
+
+/**
+ * @brief Open a UAC logic device/interface with specific VID, PID and interface number
+ *
+ * @note The config->addr is not used in this function, the VID, PID and config->iface_num should be provided by user.
+ *       If multiple hardware devices with the same VID and PID are connected through USB hub, the first one will be opened.
+ *
+ * @param[in] vid               Vendor ID
+ * @param[in] pid               Product ID
+ * @param[in] config            Pointer to UAC device configuration structure
+ * @param[out] uac_dev_handle   Pointer to UAC device handle
+ * @return esp_err_t
+ * - ESP_OK on success
+ * - ESP_ERR_INVALID_STATE if UAC driver is not installed
+ * - ESP_ERR_INVALID_ARG if the configuration is invalid
+ * - ESP_ERR_NO_MEM if memory allocation failed
+ * - ESP_ERR_NOT_SUPPORTED if the UAC version is not supported
+ * - ESP_ERR_NOT_FOUND if the device is not found
+ */
+esp_err_t uac_host_device_open_with_vid_pid(uint16_t vid, uint16_t pid, const uac_host_device_config_t *config,
+        uac_host_device_handle_t *uac_dev_handle);
+
+/**
+ * @brief Close a UAC logic device/interface
+ *
+ * @param[in] uac_dev_handle  UAC device handle
+ * @return esp_err_t
+ *  - ESP_OK on success
+ *  - ESP_ERR_INVALID_STATE if UAC driver is not installed
+ *  - ESP_ERR_INVALID_ARG if the device handle is invalid
+ */
+esp_err_t uac_host_device_close(uac_host_device_handle_t uac_dev_handle);
+
+/**
+ * @brief Get UAC device information
+ *
+ * @param[in] uac_dev_handle  UAC device handle
+ * @param[out] uac_dev_info   Pointer to UAC device information structure
+ * @return esp_err_t
+ *  - ESP_OK on success
+ *  - ESP_ERR_INVALID_STATE if UAC device is not opened
+ *  - ESP_ERR_INVALID_ARG if the device handle is invalid
+ */
+esp_err_t uac_host_get_device_info(uac_host_device_handle_t uac_dev_handle, uac_host_dev_info_t *uac_dev_info);
+
+/**
+ * @brief Get UAC device alt setting parameters by interface alternate index
+ *
+ * @param[in] uac_dev_handle  UAC device handle
+ * @param[in] iface_alt       Interface alt setting number
+ * @param[out] uac_alt_param  Pointer to UAC device alt setting parameters
+ * @return esp_err_t
+ *  - ESP_OK on success
+ *  - ESP_ERR_INVALID_STATE if UAC device is not opened
+ *  - ESP_ERR_INVALID_ARG if the device handle or alt setting number is invalid
+ */
+esp_err_t uac_host_get_device_alt_param(uac_host_device_handle_t uac_dev_handle, uint8_t iface_alt, uac_host_dev_alt_param_t *uac_alt_param);
+
+/**
+ * @brief Print the UAC device information and alternate parameters
+ *
+ * @param[in] uac_dev_handle  UAC device handle
+ * @return esp_err_t
+ * - ESP_OK on success
+ * - ESP_ERR_INVALID_STATE if UAC device is not opened
+ */
+esp_err_t uac_host_printf_device_param(uac_host_device_handle_t uac_dev_handle);
+
+/**
+ * @brief UAC Host USB event handler
+ *
+ * If UAC Host install was made with create_background_task=false configuration,
+ * application needs to handle USB Host events itself.
+ * Do not used if UAC host install was made with create_background_task=true configuration
+ *
+ * @param[in]  timeout  Timeout in ticks. For milliseconds, please use 'pdMS_TO_TICKS()' macros
+ * @return esp_err_t
+ *  - ESP_OK on success (keep calling this function)
+ *  - ESP_FAIL if the event handling is finished (stop calling this function)
+ */
+esp_err_t uac_host_handle_events(uint32_t timeout);
+
+// ------------------------ USB UAC Host driver API ----------------------------
+/**
+ * @brief Start a UAC stream with specific stream configuration (channels, bit resolution, sample frequency)
+ *
+ * @note set flags FLAG_STREAM_SUSPEND_AFTER_START to suspend stream after start
+ *
+ * @param[in] uac_dev_handle  UAC device handle
+ * @param[in] stream_config   Pointer to UAC stream configuration structure
+ * @return esp_err_t
+ * - ESP_OK on success
+ * - ESP_ERR_INVALID_ARG if the device handle or stream configuration is invalid
+ * - ESP_ERR_NOT_FOUND if the stream configuration is not supported
+ * - ESP_ERR_INVALID_STATE if the device is not in the right state
+ * - ESP_ERR_NO_MEM if memory allocation failed
+ * - ESP_ERR_TIMEOUT if the control transfer timeout
+ */
+esp_err_t uac_host_device_start(uac_host_device_handle_t uac_dev_handle, const uac_host_stream_config_t *stream_config);
+
+/**
+ * @brief Suspend a UAC stream
+ *
+ * @param[in] uac_dev_handle  UAC device handle
+ * @return esp_err_t
+ * - ESP_OK on success
+ * - ESP_ERR_INVALID_ARG if the device handle is invalid
+ * - ESP_ERR_INVALID_STATE if the device is not in the right state
+ */
+esp_err_t uac_host_device_suspend(uac_host_device_handle_t uac_dev_handle);
+
+/**
+ * @brief Resume a UAC stream with same stream configuration
+ *
+ * @param[in] uac_dev_handle  UAC device handle
+ * @return esp_err_t
+ * - ESP_OK on success
+ * - ESP_ERR_INVALID_ARG if the device handle is invalid
+ * - ESP_ERR_INVALID_STATE if the device is not in the right state
+ */
+esp_err_t uac_host_device_resume(uac_host_device_handle_t uac_dev_handle);
+
+/**
+ * @brief Stop a UAC stream, stream resources will be released
+ *
+ * @param[in] uac_dev_handle  UAC device handle
+ * @return esp_err_t
+ * - ESP_OK on success
+ * - ESP_ERR_INVALID_ARG if the device handle is invalid
+ * - ESP_ERR_INVALID_STATE if the device is not in the right state
+ */
+esp_err_t uac_host_device_stop(uac_host_device_handle_t uac_dev_handle);
+
+/**
+ * @brief Read data from UAC stream buffer, only available after stream started
+ *
+ * @param[in] uac_dev_handle  UAC device handle
+ * @param[out] data           Pointer to the buffer to store the data
+ * @param[in] size            Number of bytes to read
+ * @param[out] bytes_read     Pointer to the number of bytes read
+ * @param[in] timeout         Timeout in ticks. For milliseconds, please use 'pdMS_TO_TICKS()' macros
+ * @return esp_err_t
+ * - ESP_OK on success
+ * - ESP_ERR_INVALID_ARG if the device handle or data is invalid
+ * - ESP_ERR_INVALID_STATE if the device is not in the right state
+ */
+esp_err_t uac_host_device_read(uac_host_device_handle_t uac_dev_handle, uint8_t *data, uint32_t size,
+                               uint32_t *bytes_read, uint32_t timeout);
+
+/**
+ * @brief Write data to UAC stream buffer, only can be called after stream started
+ *
+ * @note The data will be sent to internal ringbuffer before function return,
+ * the actual data transfer is scheduled by the background task.
+ * For TX, the data is copied into the same buffer uac_host_device_write_acquire lends out.
+ *
+ * @param[in] uac_dev_handle  UAC device handle
+ * @param[in] data            Pointer to the data buffer
+ * @param[in] size            Number of bytes to write
+ * @param[in] timeout         Timeout in ticks. For milliseconds, please use 'pdMS_TO_TICKS()' macros
+ * @return esp_err_t
+ * - ESP_OK on success
+ * - ESP_ERR_INVALID_ARG if the device handle or data is invalid
+ * - ESP_ERR_INVALID_STATE if the device is not in the right state
+ * - ESP_FAIL if write failed or timeout
+*/
+esp_err_t uac_host_device_write(uac_host_device_handle_t uac_dev_handle, uint8_t *data, uint32_t size,
+                                uint32_t timeout);
+
+#define UAC_TX_ACQUIRE_MIN_MAX           (64)    /*!< Largest min_size of uac_host_device_write_acquire */
+
+/**
+ * @brief Borrow a contiguous region of the UAC stream buffer to produce audio in place, only can be called after
+ *        stream started
+ *
+ * Saves the copy of uac_host_device_write: the caller decodes, mixes or converts directly into the region, then
+ * publishes it with uac_host_device_write_commit. Only one region can be held at a time, by a single writer task.
+ * The region may be shorter than the free space at the wrap point, acquire again for the rest.
+ *
+ * @param[in]  uac_dev_handle  UAC device handle (speaker)
+ * @param[out] buf             Start of the region
+ * @param[out] size            Size of the region in bytes, at least min_size
+ * @param[in]  min_size        Wait until at least this many bytes are free, 1 ~ UAC_TX_ACQUIRE_MIN_MAX (e.g. one frame)
+ * @param[in]  timeout         Timeout in ticks. For milliseconds, please use 'pdMS_TO_TICKS()' macros
+ * @return esp_err_t
+ * - ESP_OK on success
+ * - ESP_ERR_INVALID_ARG if the device handle is invalid or not a TX interface
+ * - ESP_ERR_INVALID_SIZE if min_size is out of range
+ * - ESP_ERR_INVALID_STATE if the device is not in the right state or a region is already held
+ * - ESP_ERR_TIMEOUT if not enough space became free in time
+ */
+esp_err_t uac_host_device_write_acquire(uac_host_device_handle_t uac_dev_handle, uint8_t **buf, uint32_t *size,
+                                        uint32_t min_size, uint32_t timeout);
+
+/**
+ * @brief Publish the first size bytes of the region from uac_host_device_write_acquire and release it
+ *
+ * @param[in] uac_dev_handle  UAC device handle (speaker)
+ * @param[in] size            Bytes written to the start of the region, 0 to give it back unused
+ * @return esp_err_t
+ * - ESP_OK on success
+ * - ESP_ERR_INVALID_ARG if the device handle is invalid or not a TX interface
+ * - ESP_ERR_INVALID_SIZE if size is larger than the region
+ * - ESP_ERR_INVALID_STATE if no region is held, or the stream stopped (the data is dropped)
+ */
+esp_err_t uac_host_device_write_commit(uac_host_device_handle_t uac_dev_handle, uint32_t size);
+
+/**
+ * @brief Callback to process OUT data right before it is submitted to the ISOC endpoint
+ *
+ * Called from the USB Host client context each time a transfer is refilled from the ring buffer.
+ * The callback must not block.
+ *
+ * @param[in,out] data  Audio data of the transfer, can be modified in place
+ * @param[in]     size  Size of the data in bytes
+ * @param[in]     arg   User argument
+ */
+typedef void (*uac_host_tx_process_cb_t)(uint8_t *data, size_t size, void *arg);
+
+/**
+ * @brief Register a callback to process OUT data right before it is submitted
+ * @param[in] uac_dev_handle  UAC device handle (speaker)
+ * @param[in] cb              Callback, NULL to unregister
+ * @param[in] arg             Callback argument
+ * @return esp_err_t
+ * - ESP_OK on success
+ * - ESP_ERR_INVALID_ARG if the device handle is invalid or not a TX interface
+ */
+esp_err_t uac_host_device_set_tx_process_cb(uac_host_device_handle_t uac_dev_handle, uac_host_tx_process_cb_t cb, void *arg);
+
+/**
+ * @brief How the missing part of an OUT transfer is filled on underrun (FLAG_STREAM_TX_CONTINUOUS)
+ */
+typedef enum {
+    UAC_TX_CONCEAL_SILENCE = 0,     /*!< Pad with silence */
+    UAC_TX_CONCEAL_FADE,            /*!< Repeat the last full transfer fading out to silence, then pad with silence.
+                                         16-bit PCM only, other formats are padded with silence */
+} uac_host_tx_conceal_t;
+
+/**
+ * @brief Set the underrun concealment of a TX interface
+ * @param[in] uac_dev_handle  UAC device handle (speaker)
+ * @param[in] conceal         Concealment mode
+ * @return esp_err_t
+ * - ESP_OK on success
+ * - ESP_ERR_INVALID_ARG if the device handle is invalid or not a TX interface
+ */
+esp_err_t uac_host_device_set_tx_conceal(uac_host_device_handle_t uac_dev_handle, uac_host_tx_conceal_t conceal);
+
+/**
+ * @brief Keep the TX ring buffer at a target fill by resampling, for writers running on their own clock
+ *
+ * A writer paced by its own clock (I2S capture, a network stream) and the USB frame or device clock drift apart
+ * by up to a few hundred ppm, so the ring buffer slowly fills up or runs dry. With a target set, a PI servo on the
+ * ring buffer fill adjusts the rate the ring buffer is read at, within +-500 ppm, and a 4-point interpolator
+ * resamples the data to the packet schedule. For asynchronous endpoints the rate reported by the feedback endpoint
+ * is used as a feed-forward term. The correction is slow (about a minute to settle) and inaudible. After each
+ * start or resume, playback begins once the ring buffer holds the target.
+ *
+ * A writer that blocks on a full ring buffer (uac_host_device_write with a timeout) is paced by the stream itself
+ * and needs no compensation: the fill would stay at the top and the servo at its limit.
+ *
+ * 16-bit PCM only, other formats are streamed without compensation.
+ *
+ * @param[in] uac_dev_handle  UAC device handle (speaker)
+ * @param[in] target_bytes    Target ring buffer fill in bytes, typically half the buffer size, 0 to turn off
+ * @return esp_err_t
+ * - ESP_OK on success
+ * - ESP_ERR_INVALID_ARG if the device handle is invalid, not a TX interface, or the target exceeds the buffer size
+ * - ESP_ERR_INVALID_STATE if the interface is started, the target applies from the next uac_host_device_start
+ */
+esp_err_t uac_host_device_set_drift_target(uac_host_device_handle_t uac_dev_handle, uint32_t target_bytes);
+
+#define UAC_STATS_HISTORY_NUM            (4)     /*!< Number of underrun timestamps kept */
+
+/**
+ * @brief Stream statistics of an interface, counted since the interface was opened
+ */
+typedef struct {
+    uint32_t underrun_count;                        /*!< TX: times the ring buffer ran dry while streaming (a run of
+                                                         concealed transfers counts once, the end of playback included) */
+    uint32_t underrun_xfers;                        /*!< TX: transfers submitted with concealed data */
+    uint32_t concealed_bytes;                       /*!< TX: bytes filled by concealment */
+    uint32_t popped_bytes;                          /*!< TX: bytes taken from the ring buffer, counted right before
+                                                         the tx process callback of the same transfer */
+    int64_t underrun_time[UAC_STATS_HISTORY_NUM];   /*!< TX: esp_timer time (us) of the latest underruns, newest first */
+    uint32_t overrun_count;                         /*!< TX: writes that timed out on a full ring buffer,
+                                                         RX: packets dropped because the ring buffer was full */
+    int64_t overrun_time;                           /*!< esp_timer time (us) of the latest overrun */
+    uint32_t feedback;                              /*!< TX asynchronous endpoints: rate reported by the feedback endpoint,
+                                                         frames per ms in Q16.16, 0 until the first value after resume */
+    int32_t drift_ppb;                              /*!< TX with drift compensation: rate correction of the ring buffer
+                                                         read, parts per billion, positive when read faster */
+    uint32_t drift_fill;                            /*!< TX with drift compensation: filtered ring buffer fill, bytes */
+} uac_host_stream_stats_t;
+
+/**
+ * @brief Get the stream statistics of an interface
+ * @param[in]  uac_dev_handle  UAC device handle
+ * @param[out] stats           Statistics
+ * @return esp_err_t
+ * - ESP_OK on success
+ * - ESP_ERR_INVALID_ARG if the device handle or stats is invalid
+ */
+esp_err_t uac_host_device_get_stats(uac_host_device_handle_t uac_dev_handle, uac_host_stream_stats_t *stats);
+
+/**
+ * @brief Mute or un-mute the UAC device
+ * @param[in] uac_dev_handle  UAC device handle
+ * @param[in] mute        True to mute, false to unmute
+ * @return esp_err_t
+ * - ESP_OK on success
+ * - ESP_ERR_INVALID_STATE if the device is not ready or active
+ * - ESP_ERR_INVALID_ARG if the device handle is invalid
+ * - ESP_ERR_NOT_SUPPORTED if the device does not support mute control
+ * - ESP_ERR_TIMEOUT if the control timed out
+ */
+esp_err_t uac_host_device_set_mute(uac_host_device_handle_t uac_dev_handle, bool mute);
+
+/**
+ * @brief Get the mute status of the UAC device
+ * @param[in] uac_dev_handle  UAC device handle
+ * @param[out] mute       Pointer to store the mute status
+ * @return esp_err_t
+ * - ESP_OK on success
+ * - ESP_ERR_INVALID_STATE if the device is not ready or active
+ * - ESP_ERR_INVALID_ARG if the device handle is invalid
+ * - ESP_ERR_NOT_SUPPORTED if the device does not support mute control
+ * - ESP_ERR_TIMEOUT if the control timed out
+ */
+esp_err_t uac_host_device_get_mute(uac_host_device_handle_t uac_dev_handle, bool *mute);
+
+/**
+ * @brief Set the volume of the UAC device
+ * @param[in] uac_dev_handle  UAC device handle
+ * @param[in] volume      Volume to set, 0-100
+ * @return esp_err_t
+ * - ESP_OK on success
+ * - ESP_ERR_INVALID_STATE if the device is not ready or active
+ * - ESP_ERR_INVALID_ARG if the device handle is invalid or volume is out of range
+ * - ESP_ERR_NOT_SUPPORTED if the device does not support volume control
+ * - ESP_ERR_TIMEOUT if the control timed out
+ */
+esp_err_t uac_host_device_set_volume(uac_host_device_handle_t uac_dev_handle, uint8_t volume);
+
+/**
+ * @brief Get the volume of the UAC device
+ * @param[in] uac_dev_handle  UAC device handle
+ * @param[out] volume     Pointer to store the volume, 0-100
+ * @return esp_err_t
+ * - ESP_OK on success
+ * - ESP_ERR_INVALID_STATE if the device is not ready or active
+ * - ESP_ERR_INVALID_ARG if the device handle is invalid
+ * - ESP_ERR_NOT_SUPPORTED if the device does not support volume control
+ * - ESP_ERR_TIMEOUT if the control timed out
+ */
+esp_err_t uac_host_device_get_volume(uac_host_device_handle_t uac_dev_handle, uint8_t *volume);
+
+/**
+ * @brief Set the volume of the UAC device in dB
+ * @param[in] uac_dev_handle  UAC device handle
+ * @param[in] volume_db   Volume to set, with resolution of 1/256 dB,
+ * eg.  256 (0x0100) is 1 dB. 32767 (0x7FFF) is 127.996 dB. -32767 (0x8001) is -127.996 dB.
+ * @return esp_err_t
+ * - ESP_OK on success
+ * - ESP_ERR_INVALID_STATE if the device is not ready or active
+ * - ESP_ERR_INVALID_ARG if the device handle is invalid
+ * - ESP_ERR_NOT_SUPPORTED if the device does not support volume control
+ * - ESP_ERR_TIMEOUT if the control timed out
+ */
+esp_err_t uac_host_device_set_volume_db(uac_host_device_handle_t uac_dev_handle, int16_t volume_db);
+
+/**
+ * @brief Get the volume of the UAC device in dB
+ * @param[in] uac_dev_handle  UAC device handle
+ * @param[out] volume_db  Pointer to store the volume, with resolution of 1/256 dB,
+ * eg.  256 (0x0100) is 1 dB. 32767 (0x7FFF) is 127.996 dB. -32767 (0x8001) is -127.996 dB.
+ * @return esp_err_t
+ * - ESP_OK on success
+ * - ESP_ERR_INVALID_STATE if the device is not ready or active
+ * - ESP_ERR_INVALID_ARG if the device handle is invalid
+ * - ESP_ERR_NOT_SUPPORTED if the device does not support volume control
+ * - ESP_ERR_TIMEOUT if the control timed out
+ */
+esp_err_t uac_host_device_get_volume_db(uac_host_device_handle_t uac_dev_handle, int16_t *volume_db);
+
+#ifdef __cplusplus
+}
+#endif //__cplusplus
@@ -0,0 +1,107 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define UAC_DRIFT_MAX_PPB                (500000)    /*!< Largest correction, 500 ppm */
+#define UAC_DRIFT_HISTORY                (3)         /*!< Frames kept between resampled blocks */
+
+/**
+ * @brief Clock drift servo for a ring buffer written at one clock and read at another
+ *
+ * The fill level of the ring is sampled after every read, low-pass filtered, and a PI controller turns its distance
+ * to the target depth into a rate correction: the reader consumes 1 + correction input frames per output frame.
+ * A ring that fills up is read faster, a ring that drains is read slower, so its depth settles at the target and
+ * stays there whatever the offset between the two clocks, within UAC_DRIFT_MAX_PPB.
+ *
+ * When the offset is known in advance, e.g. from the feedback endpoint of an asynchronous device, it is added as a
+ * feed-forward term and the controller only trims the rest.
+ *
+ * The servo and phase accumulator are integer only; the Hermite interpolation in uac_drift_resample_s16() uses
+ * single-precision float. Neither depends on ESP-IDF, so both can be simulated on the host.
+ */
+typedef struct {
+    uint32_t sample_freq;        /*!< Frames per second, the time base of the loop */
+    uint32_t target;             /*!< Target fill, frames */
+    int64_t fill_avg;            /*!< Filtered fill, frames in Q16.16 */
+    int64_t integral;            /*!< Integral term, ppb in Q16.16 */
+    int32_t feedforward;         /*!< Known offset, ppb */
+    int32_t correction;          /*!< Current correction, ppb */
+    bool primed;                 /*!< fill_avg holds a value */
+} uac_drift_t;
+
+/**
+ * @brief Start the servo with no correction
+ *
+ * @param[in] sample_freq  Frames per second
+ * @param[in] target       Target fill in frames
+ */
+void uac_drift_init(uac_drift_t *drift, uint32_t sample_freq, uint32_t target);
+
+/**
+ * @brief Set the feed-forward term, added to the controller output
+ */
+void uac_drift_set_feedforward(uac_drift_t *drift, int32_t ppb);
+
+/**
+ * @brief Feed a fill level sample
+ *
+ * @param[in] fill     Frames in the ring right after a read
+ * @param[in] elapsed  Output frames since the previous sample
+ * @return New correction in ppb
+ */
+int32_t uac_drift_update(uac_drift_t *drift, uint32_t fill, uint32_t elapsed);
+
+/**
+ * @brief Fractional position of a resampler running at 1 + ppb input frames per output frame
+ */
+typedef struct {
+    uint64_t step;               /*!< Input frames per output frame, Q32.32 */
+    uint32_t frac;               /*!< Position between two input frames, Q0.32 */
+} uac_drift_phase_t;
+
+/**
+ * @brief Set the rate of a resampler, the position is kept
+ */
+static inline void uac_drift_phase_set(uac_drift_phase_t *phase, int32_t ppb)
+{
+    phase->step = (1ULL << 32) + (int64_t)ppb * (int64_t)(1ULL << 32) / 1000000000;
+}
+
+/**
+ * @brief Input frames consumed by the next out_frames output frames
+ */
+static inline uint32_t uac_drift_phase_need(const uac_drift_phase_t *phase, uint32_t out_frames)
+{
+    return (uint32_t)((phase->frac + phase->step * out_frames) >> 32);
+}
+
+/**
+ * @brief Resample 16-bit interleaved PCM with 4-point Hermite interpolation
+ *
+ * buf holds UAC_DRIFT_HISTORY frames kept from the previous block followed by uac_drift_phase_need(out_frames) new
+ * frames, nothing past them is read. On return the first UAC_DRIFT_HISTORY frames of buf are the history for the
+ * next block, and the position has moved on by out_frames. The output is delayed by 2 frames.
+ *
+ * @param[inout] buf         History and input frames
+ * @param[out]   out         out_frames output frames
+ * @param[in]    out_frames  Frames to produce
+ * @param[in]    channels    Interleaved channels
+ * @return Input frames consumed, uac_drift_phase_need(out_frames) before the call
+ */
+uint32_t uac_drift_resample_s16(uac_drift_phase_t *phase, int16_t *buf, int16_t *out, uint32_t out_frames,
+                                uint8_t channels);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,82 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define UAC_PACER_ONE                    (1000UL * 65536UL)   /*!< One frame in phase units (ms x Q16.16) */
+
+/**
+ * @brief Frames per isochronous packet for a stream whose rate is not a whole number of frames per packet
+ *
+ * Each packet carries N or N + 1 frames. A phase accumulator adds the fractional part of the rate every packet and
+ * emits the extra frame when it overflows, so after any number of packets the frames sent differ from the exact
+ * count by less than one frame, and never drift.
+ *
+ * The rate is the nominal sampling frequency, or for asynchronous endpoints the rate reported by the feedback
+ * endpoint. One phase unit is 1 / UAC_PACER_ONE frame, which makes both a rate in Hz and a feedback value in
+ * Q16.16 frames per ms exact, so a nominal rate such as 44100 Hz is paced without any rounding.
+ *
+ * Pure integer code with no dependency, so the schedule can be simulated on the host.
+ */
+typedef struct {
+    uint32_t frames;             /*!< Whole frames per packet */
+    uint32_t frac;               /*!< Fractional frames per packet, in phase units */
+    uint32_t phase;              /*!< Accumulated fraction, in [0, UAC_PACER_ONE) */
+    uint32_t interval_ms;        /*!< Packet interval */
+    uint32_t max_frames;         /*!< Frames that fit in one packet */
+    uint32_t sample_freq;        /*!< Nominal rate in Hz */
+    uint32_t feedback;           /*!< Accepted feedback, frames per ms in Q16.16, 0 if the nominal rate is used */
+} uac_pacer_t;
+
+/**
+ * @brief Start pacing at the nominal rate
+ *
+ * @param[in] sample_freq  Sampling frequency in Hz
+ * @param[in] interval_ms  Packet interval in ms
+ * @param[in] max_frames   Frames that fit in one packet
+ * @return false if N + 1 frames do not fit in a packet
+ */
+bool uac_pacer_init(uac_pacer_t *pacer, uint32_t sample_freq, uint32_t interval_ms, uint32_t max_frames);
+
+/**
+ * @brief Go back to the nominal rate and clear the phase, when the stream restarts
+ */
+void uac_pacer_reset(uac_pacer_t *pacer);
+
+/**
+ * @brief Follow the rate reported by a feedback endpoint, the phase is kept
+ *
+ * Values further than 1/8 from the nominal rate are ignored, as well as rates whose N + 1 frames do not fit.
+ *
+ * @param[in] feedback  Frames per ms in Q16.16
+ * @return true if the value is used
+ */
+bool uac_pacer_set_feedback(uac_pacer_t *pacer, uint32_t feedback);
+
+/**
+ * @brief Frames of the next packet
+ */
+static inline uint32_t uac_pacer_next(uac_pacer_t *pacer)
+{
+    uint32_t frames = pacer->frames;
+    pacer->phase += pacer->frac;
+    if (pacer->phase >= UAC_PACER_ONE) {
+        pacer->phase -= UAC_PACER_ONE;
+        frames++;
+    }
+    return frames;
+}
+
+#ifdef __cplusplus
+}
+#endif
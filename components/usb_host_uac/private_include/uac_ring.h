@@ -0,0 +1,131 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define UAC_RING_CACHE_LINE              (64)    /*!< Producer and consumer state are kept on separate lines */
+
+/**
+ * @brief Single-producer/single-consumer byte ring
+ *
+ * The producer only stores the write position and the consumer only stores the read position, so pushing, popping
+ * and length queries take no lock and never wait. Blocking is only used when a side has to wait for the other,
+ * through a semaphore given only while that side is waiting.
+ *
+ * Each side must be used from one context at a time. In uac_host both the TX consumer (transfer submission) and the
+ * RX producer (transfer callbacks) run in the client task, the writer or reader task is the other side.
+ *
+ * The storage has `mirror` bytes past the end that always hold a copy of the first `mirror` bytes. A region of up to
+ * `mirror` bytes at any position is therefore contiguous, both for the producer (uac_ring_write_region) and for
+ * the consumer (uac_ring_peek). The producer pays for it by writing the first `mirror` bytes twice.
+ */
+typedef struct {
+    // producer side
+    atomic_uint wr __attribute__((aligned(UAC_RING_CACHE_LINE))); /*!< Write position in [0, 2 * size) */
+    atomic_bool space_waiting;                  /*!< The producer waits for space */
+    // consumer side
+    atomic_uint rd __attribute__((aligned(UAC_RING_CACHE_LINE))); /*!< Read position in [0, 2 * size) */
+    atomic_bool data_waiting;                   /*!< The consumer waits for data */
+    // constant after create
+    uint8_t *buf __attribute__((aligned(UAC_RING_CACHE_LINE))); /*!< size + mirror bytes */
+    uint32_t size;                              /*!< Ring size */
+    uint32_t mirror;                            /*!< Bytes past the end mirroring the start */
+    atomic_bool aborted;                        /*!< Waits return at once, set before delete */
+    SemaphoreHandle_t space;                    /*!< Given by the consumer when the producer waits */
+    SemaphoreHandle_t data;                     /*!< Given by the producer when the consumer waits */
+} uac_ring_t;
+
+/**
+ * @brief Create a ring of size bytes with mirror bytes of contiguous overrun (in internal RAM)
+ */
+esp_err_t uac_ring_create(uac_ring_t *ring, uint32_t size, uint32_t mirror);
+
+/**
+ * @brief Delete the ring, call uac_ring_abort first if a side may be waiting
+ */
+void uac_ring_delete(uac_ring_t *ring);
+
+/**
+ * @brief Make the current and future waits of both sides return ESP_ERR_INVALID_STATE
+ */
+void uac_ring_abort(uac_ring_t *ring);
+
+/**
+ * @brief Bytes in the ring, can be called from any context
+ */
+size_t uac_ring_get_len(uac_ring_t *ring);
+
+/**
+ * @brief Drop all the data in the ring (consumer side, or while the consumer is stopped)
+ */
+void uac_ring_flush(uac_ring_t *ring);
+
+// ---------------------------- Producer ----------------------------------------
+
+/**
+ * @brief Wait until at least need bytes are free
+ *
+ * @return ESP_OK, ESP_ERR_INVALID_SIZE if need is larger than the ring, ESP_ERR_TIMEOUT, or ESP_ERR_INVALID_STATE
+ *         if aborted
+ */
+esp_err_t uac_ring_wait_space(uac_ring_t *ring, size_t need, TickType_t ticks_to_wait);
+
+/**
+ * @brief Contiguous free region at the write position, at least MIN(free, mirror) bytes
+ */
+uint8_t *uac_ring_write_region(uac_ring_t *ring, size_t *size);
+
+/**
+ * @brief Publish size bytes written to the start of uac_ring_write_region
+ */
+void uac_ring_commit(uac_ring_t *ring, size_t size);
+
+/**
+ * @brief Copy size bytes into the ring, waiting for space. Nothing is written on failure
+ */
+esp_err_t uac_ring_push(uac_ring_t *ring, const uint8_t *buf, size_t size, TickType_t ticks_to_wait);
+
+// ---------------------------- Consumer ----------------------------------------
+
+/**
+ * @brief Wait until the ring is not empty
+ *
+ * @return ESP_OK, ESP_ERR_TIMEOUT, or ESP_ERR_INVALID_STATE if aborted
+ */
+esp_err_t uac_ring_wait_data(uac_ring_t *ring, TickType_t ticks_to_wait);
+
+/**
+ * @brief Contiguous data at the read position, at least MIN(len, mirror) bytes
+ */
+const uint8_t *uac_ring_peek(uac_ring_t *ring, size_t *size);
+
+/**
+ * @brief Drop size bytes from the start of uac_ring_peek
+ */
+void uac_ring_release(uac_ring_t *ring, size_t size);
+
+/**
+ * @brief Copy up to size bytes out of the ring without waiting
+ *
+ * @return Bytes copied
+ */
+size_t uac_ring_pop(uac_ring_t *ring, uint8_t *buf, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,139 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <inttypes.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/ringbuf.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "unity.h"
+#include "uac_ring.h"
+
+#define RING_BENCH_SIZE          (16000)
+#define RING_BENCH_TRANSFERS     (20000)
+
+// One OUT transfer per loop, the way the driver uses the ring: the writer pushes a block, the USB callback checks
+// the length, takes a transfer and checks the length again against the TX_DONE threshold
+
+static size_t ringbuf_get_len(RingbufHandle_t ringbuf)
+{
+    size_t size = 0;
+    vRingbufferGetInfo(ringbuf, NULL, NULL, NULL, NULL, &size);
+    return size;
+}
+
+// The FreeRTOS byte buffer path the driver used before uac_ring
+static void ringbuf_pop(RingbufHandle_t ringbuf, uint8_t *buf, size_t req_bytes)
+{
+    size_t read_bytes = 0;
+    uint8_t *buf_rcv = xRingbufferReceiveUpTo(ringbuf, &read_bytes, 0, req_bytes);
+    TEST_ASSERT_NOT_NULL(buf_rcv);
+    memcpy(buf, buf_rcv, read_bytes);
+    vRingbufferReturnItem(ringbuf, buf_rcv);
+    if (read_bytes < req_bytes) {
+        size_t read_bytes2 = 0;
+        buf_rcv = xRingbufferReceiveUpTo(ringbuf, &read_bytes2, 0, req_bytes - read_bytes);
+        TEST_ASSERT_NOT_NULL(buf_rcv);
+        memcpy(buf + read_bytes, buf_rcv, read_bytes2);
+        vRingbufferReturnItem(ringbuf, buf_rcv);
+    }
+}
+
+static uint32_t bench_ringbuf(const uint8_t *src, uint8_t *dst, size_t xfer_size)
+{
+    RingbufHandle_t ringbuf = xRingbufferCreate(RING_BENCH_SIZE, RINGBUF_TYPE_BYTEBUF);
+    TEST_ASSERT_NOT_NULL(ringbuf);
+    size_t sink = 0;
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < RING_BENCH_TRANSFERS; i++) {
+        TEST_ASSERT_EQUAL(pdTRUE, xRingbufferSend(ringbuf, src, xfer_size, 0));
+        sink += ringbuf_get_len(ringbuf);
+        ringbuf_pop(ringbuf, dst, xfer_size);
+        sink += ringbuf_get_len(ringbuf);
+    }
+    int64_t elapsed = esp_timer_get_time() - start;
+    TEST_ASSERT_EQUAL_MEMORY(src, dst, xfer_size);
+    TEST_ASSERT_EQUAL(xfer_size * RING_BENCH_TRANSFERS, sink);
+    vRingbufferDelete(ringbuf);
+    return (uint32_t)(elapsed * 1000 / RING_BENCH_TRANSFERS);
+}
+
+static uint32_t bench_uac_ring(const uint8_t *src, uint8_t *dst, size_t xfer_size, uint32_t mirror)
+{
+    uac_ring_t ring;
+    TEST_ASSERT_EQUAL(ESP_OK, uac_ring_create(&ring, RING_BENCH_SIZE, mirror));
+    size_t sink = 0;
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < RING_BENCH_TRANSFERS; i++) {
+        TEST_ASSERT_EQUAL(ESP_OK, uac_ring_push(&ring, src, xfer_size, 0));
+        sink += uac_ring_get_len(&ring);
+        TEST_ASSERT_EQUAL(xfer_size, uac_ring_pop(&ring, dst, xfer_size));
+        sink += uac_ring_get_len(&ring);
+    }
+    int64_t elapsed = esp_timer_get_time() - start;
+    TEST_ASSERT_EQUAL_MEMORY(src, dst, xfer_size);
+    TEST_ASSERT_EQUAL(xfer_size * RING_BENCH_TRANSFERS, sink);
+    uac_ring_delete(&ring);
+    return (uint32_t)(elapsed * 1000 / RING_BENCH_TRANSFERS);
+}
+
+TEST_CASE("test uac ring wrap and mirror", "[uac_host][ring]")
+{
+    uac_ring_t ring;
+    uint8_t src[100], dst[100];
+    for (int i = 0; i < sizeof(src); i++) {
+        src[i] = i;
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, uac_ring_create(&ring, 250, 64));
+    // 3 x 80 bytes leave 10 bytes to the end, the 4th push wraps
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_EQUAL(ESP_OK, uac_ring_push(&ring, src, 80, 0));
+        TEST_ASSERT_EQUAL(80, uac_ring_pop(&ring, dst, 80));
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, uac_ring_push(&ring, src, 80, 0));
+    // the mirror makes the wrapped data readable in one piece
+    size_t size;
+    const uint8_t *data = uac_ring_peek(&ring, &size);
+    TEST_ASSERT_EQUAL(74, size);
+    TEST_ASSERT_EQUAL_MEMORY(src, data, size);
+    TEST_ASSERT_EQUAL(80, uac_ring_pop(&ring, dst, 80));
+    TEST_ASSERT_EQUAL_MEMORY(src, dst, 80);
+    // full ring: no space, and a push that does not fit writes nothing
+    TEST_ASSERT_EQUAL(ESP_OK, uac_ring_push(&ring, src, 100, 0));
+    TEST_ASSERT_EQUAL(ESP_OK, uac_ring_push(&ring, src, 100, 0));
+    TEST_ASSERT_EQUAL(ESP_ERR_TIMEOUT, uac_ring_push(&ring, src, 51, 0));
+    TEST_ASSERT_EQUAL(200, uac_ring_get_len(&ring));
+    uac_ring_flush(&ring);
+    TEST_ASSERT_EQUAL(0, uac_ring_get_len(&ring));
+    TEST_ASSERT_EQUAL(ESP_ERR_TIMEOUT, uac_ring_wait_data(&ring, 0));
+    uac_ring_delete(&ring);
+}
+
+TEST_CASE("test uac ring benchmark", "[uac_host][ring]")
+{
+    // transfer sizes of 3 x 1 ms packets: 48 kHz 16-bit mono, stereo, and 96 kHz 24-bit stereo
+    const size_t xfer_sizes[] = {288, 576, 1728};
+    uint8_t *src = heap_caps_malloc(1728, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    uint8_t *dst = heap_caps_malloc(1728, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    TEST_ASSERT_NOT_NULL(src);
+    TEST_ASSERT_NOT_NULL(dst);
+    for (int i = 0; i < 1728; i++) {
+        src[i] = (uint8_t)(i * 7);
+    }
+    for (int i = 0; i < sizeof(xfer_sizes) / sizeof(xfer_sizes[0]); i++) {
+        size_t xfer_size = xfer_sizes[i];
+        uint32_t ringbuf_ns = bench_ringbuf(src, dst, xfer_size);
+        uint32_t ring_ns = bench_uac_ring(src, dst, xfer_size, 0);
+        uint32_t mirror_ns = bench_uac_ring(src, dst, xfer_size, 1024);
+        printf("transfer %4zu bytes: ringbuf %6"PRIu32" ns, uac_ring %6"PRIu32" ns, uac_ring + mirror %6"PRIu32" ns\n",
+               xfer_size, ringbuf_ns, ring_ns, mirror_ns);
+    }
+    free(src);
+    free(dst);
+}
@@ -0,0 +1,96 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include "uac_drift.h"
+
+// The fill level moves by (writer rate - reader rate) x (1 + correction) seconds per second, an integrator. With a
+// PI controller the loop is second order: natural frequency sqrt(Ki), damping Kp / (2 sqrt(Ki)). 0.1 rad/s critically
+// damped settles in about a minute and keeps jitter of the fill level out of the correction, so the pitch change
+// stays inaudible. Gains in ppb per second of fill error
+#define DRIFT_KP_PPB                     (200000000LL)   /*!< Kp = 0.2 /s */
+#define DRIFT_KI_PPB                     (10000000LL)    /*!< Ki = 0.01 /s^2 */
+// The fill level is sampled right after a read and jumps by a whole block on every write. A 1 s low pass removes
+// that sawtooth before it reaches the proportional term
+#define DRIFT_AVG_SECONDS                (1)
+
+void uac_drift_init(uac_drift_t *drift, uint32_t sample_freq, uint32_t target)
+{
+    memset(drift, 0, sizeof(uac_drift_t));
+    drift->sample_freq = sample_freq;
+    drift->target = target;
+}
+
+static int32_t drift_clamp(int64_t ppb)
+{
+    return ppb > UAC_DRIFT_MAX_PPB ? UAC_DRIFT_MAX_PPB : (ppb < -UAC_DRIFT_MAX_PPB ? -UAC_DRIFT_MAX_PPB : (int32_t)ppb);
+}
+
+void uac_drift_set_feedforward(uac_drift_t *drift, int32_t ppb)
+{
+    drift->feedforward = ppb;
+}
+
+int32_t uac_drift_update(uac_drift_t *drift, uint32_t fill, uint32_t elapsed)
+{
+    const int64_t freq = drift->sample_freq;
+    int64_t fill_q16 = (int64_t)fill << 16;
+    if (!drift->primed) {
+        drift->fill_avg = fill_q16;
+        drift->primed = true;
+    } else {
+        uint32_t span = DRIFT_AVG_SECONDS * drift->sample_freq;
+        drift->fill_avg += (fill_q16 - drift->fill_avg) * (elapsed < span ? elapsed : span) / span;
+    }
+    // error in frames, Q16.16
+    int64_t err = drift->fill_avg - ((int64_t)drift->target << 16);
+    int64_t p = DRIFT_KP_PPB * err / freq >> 16;
+    int64_t out = drift->feedforward + p + (drift->integral >> 16);
+    // conditional integration: no wind up while the output is clamped in the direction of the error
+    if (!((out >= UAC_DRIFT_MAX_PPB && err > 0) || (out <= -UAC_DRIFT_MAX_PPB && err < 0))) {
+        drift->integral += DRIFT_KI_PPB * err / freq * elapsed / freq;
+        int64_t max = (int64_t)UAC_DRIFT_MAX_PPB << 17;
+        drift->integral = drift->integral > max ? max : (drift->integral < -max ? -max : drift->integral);
+        out = drift->feedforward + p + (drift->integral >> 16);
+    }
+    drift->correction = drift_clamp(out);
+    return drift->correction;
+}
+
+static inline int16_t drift_sat16(int32_t v)
+{
+    return (int16_t)(v > 32767 ? 32767 : (v < -32768 ? -32768 : v));
+}
+
+uint32_t uac_drift_resample_s16(uac_drift_phase_t *phase, int16_t *buf, int16_t *out, uint32_t out_frames,
+                                uint8_t channels)
+{
+    uint32_t pos = 0;
+    uint32_t frac = phase->frac;
+    // Read slower than 1:1, the last frame may sit less than 1 - step past buf[need + 1]: buf[need + 3] is past the
+    // input, repeat buf[need + 2] instead, it only weighs t^2 / 2 there
+    const uint32_t last = UAC_DRIFT_HISTORY + uac_drift_phase_need(phase, out_frames) - 1;
+    for (uint32_t n = 0; n < out_frames; n++) {
+        // between buf[pos + 1] and buf[pos + 2]
+        const int16_t *x = buf + pos * channels;
+        const int16_t *xn = buf + (pos + 3 > last ? last : pos + 3) * channels;
+        float t = frac * (1.0f / 4294967296.0f);
+        for (int c = 0; c < channels; c++) {
+            float xm1 = x[c], x0 = x[channels + c], x1 = x[2 * channels + c], x2 = xn[c];
+            float c1 = 0.5f * (x1 - xm1);
+            float c2 = xm1 - 2.5f * x0 + 2.0f * x1 - 0.5f * x2;
+            float c3 = 0.5f * (x2 - xm1) + 1.5f * (x0 - x1);
+            float y = ((c3 * t + c2) * t + c1) * t + x0;
+            out[n * channels + c] = drift_sat16((int32_t)(y + (y >= 0 ? 0.5f : -0.5f)));
+        }
+        uint64_t next = frac + phase->step;
+        pos += (uint32_t)(next >> 32);
+        frac = (uint32_t)next;
+    }
+    phase->frac = frac;
+    memmove(buf, buf + pos * channels, UAC_DRIFT_HISTORY * channels * sizeof(int16_t));
+    return pos;
+}
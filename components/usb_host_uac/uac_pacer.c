@@ -0,0 +1,52 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "uac_pacer.h"
+
+// Set the rate per packet from a rate per ms in phase units (1 / UAC_PACER_ONE frame per ms)
+static bool pacer_set_rate(uac_pacer_t *pacer, uint64_t rate)
+{
+    uint64_t per_packet = rate * pacer->interval_ms;
+    uint32_t frames = (uint32_t)(per_packet / UAC_PACER_ONE);
+    uint32_t frac = (uint32_t)(per_packet % UAC_PACER_ONE);
+    if (frames + (frac ? 1 : 0) > pacer->max_frames) {
+        return false;
+    }
+    pacer->frames = frames;
+    pacer->frac = frac;
+    return true;
+}
+
+bool uac_pacer_init(uac_pacer_t *pacer, uint32_t sample_freq, uint32_t interval_ms, uint32_t max_frames)
+{
+    pacer->interval_ms = interval_ms;
+    pacer->max_frames = max_frames;
+    pacer->sample_freq = sample_freq;
+    pacer->phase = 0;
+    pacer->feedback = 0;
+    // sample_freq Hz is sample_freq x 65536 phase units per ms, exactly
+    return pacer_set_rate(pacer, (uint64_t)sample_freq << 16);
+}
+
+void uac_pacer_reset(uac_pacer_t *pacer)
+{
+    pacer->phase = 0;
+    pacer->feedback = 0;
+    pacer_set_rate(pacer, (uint64_t)pacer->sample_freq << 16);
+}
+
+bool uac_pacer_set_feedback(uac_pacer_t *pacer, uint32_t feedback)
+{
+    uint32_t nominal = (uint32_t)(((uint64_t)pacer->sample_freq << 16) / 1000);
+    if (feedback < nominal - nominal / 8 || feedback > nominal + nominal / 8) {
+        return false;
+    }
+    if (!pacer_set_rate(pacer, (uint64_t)feedback * 1000)) {
+        return false;
+    }
+    pacer->feedback = feedback;
+    return true;
+}
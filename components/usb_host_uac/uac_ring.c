@@ -0,0 +1,226 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <sys/param.h>
+#include "esp_heap_caps.h"
+#include "freertos/task.h"
+#include "uac_ring.h"
+
+// Positions run over [0, 2 * size) so that a full ring and an empty ring can be told apart
+
+static inline uint32_t ring_offset(const uac_ring_t *ring, uint32_t pos)
+{
+    return pos >= ring->size ? pos - ring->size : pos;
+}
+
+static inline uint32_t ring_advance(const uac_ring_t *ring, uint32_t pos, uint32_t n)
+{
+    pos += n;
+    return pos >= 2 * ring->size ? pos - 2 * ring->size : pos;
+}
+
+static inline uint32_t ring_distance(const uac_ring_t *ring, uint32_t from, uint32_t to)
+{
+    return to >= from ? to - from : to + 2 * ring->size - from;
+}
+
+esp_err_t uac_ring_create(uac_ring_t *ring, uint32_t size, uint32_t mirror)
+{
+    memset(ring, 0, sizeof(uac_ring_t));
+    if (size == 0 || mirror > size) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    // the ring is accessed every transfer from the USB task, keep it in internal RAM
+    ring->buf = heap_caps_malloc(size + mirror, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    ring->space = xSemaphoreCreateBinary();
+    ring->data = xSemaphoreCreateBinary();
+    if (!ring->buf || !ring->space || !ring->data) {
+        uac_ring_delete(ring);
+        return ESP_ERR_NO_MEM;
+    }
+    ring->size = size;
+    ring->mirror = mirror;
+    atomic_init(&ring->wr, 0);
+    atomic_init(&ring->rd, 0);
+    atomic_init(&ring->space_waiting, false);
+    atomic_init(&ring->data_waiting, false);
+    atomic_init(&ring->aborted, false);
+    return ESP_OK;
+}
+
+void uac_ring_delete(uac_ring_t *ring)
+{
+    free(ring->buf);
+    if (ring->space) {
+        vSemaphoreDelete(ring->space);
+    }
+    if (ring->data) {
+        vSemaphoreDelete(ring->data);
+    }
+    memset(ring, 0, sizeof(uac_ring_t));
+}
+
+void uac_ring_abort(uac_ring_t *ring)
+{
+    atomic_store(&ring->aborted, true);
+    xSemaphoreGive(ring->space);
+    xSemaphoreGive(ring->data);
+}
+
+size_t uac_ring_get_len(uac_ring_t *ring)
+{
+    // read position first: the write position can only be ahead of it
+    uint32_t rd = atomic_load_explicit(&ring->rd, memory_order_acquire);
+    uint32_t wr = atomic_load_explicit(&ring->wr, memory_order_acquire);
+    uint32_t len = ring_distance(ring, rd, wr);
+    // the consumer may have moved on in between, when called from a third task
+    return MIN(len, ring->size);
+}
+
+void uac_ring_flush(uac_ring_t *ring)
+{
+    atomic_store(&ring->rd, atomic_load_explicit(&ring->wr, memory_order_acquire));
+    if (atomic_load(&ring->space_waiting)) {
+        xSemaphoreGive(ring->space);
+    }
+}
+
+/**
+ * @brief Wait on sem until ready(ring, arg) is true
+ *
+ * The flag is raised before the last check, and the other side gives sem after publishing whenever it sees the flag,
+ * so a wake up cannot be lost. A stale give only costs one more check.
+ */
+static esp_err_t ring_wait(uac_ring_t *ring, atomic_bool *waiting, SemaphoreHandle_t sem,
+                           bool (*ready)(uac_ring_t *ring, size_t arg), size_t arg, TickType_t ticks_to_wait)
+{
+    esp_err_t ret = ESP_OK;
+    TimeOut_t time_out;
+    vTaskSetTimeOutState(&time_out);
+    while (!ready(ring, arg)) {
+        atomic_store(waiting, true);
+        if (ready(ring, arg)) {
+            break;
+        }
+        if (atomic_load(&ring->aborted)) {
+            ret = ESP_ERR_INVALID_STATE;
+            break;
+        }
+        if (xTaskCheckForTimeOut(&time_out, &ticks_to_wait) == pdTRUE) {
+            ret = ESP_ERR_TIMEOUT;
+            break;
+        }
+        xSemaphoreTake(sem, ticks_to_wait);
+    }
+    atomic_store(waiting, false);
+    return ret;
+}
+
+static bool ring_has_space(uac_ring_t *ring, size_t need)
+{
+    return ring->size - uac_ring_get_len(ring) >= need;
+}
+
+static bool ring_has_data(uac_ring_t *ring, size_t unused)
+{
+    return uac_ring_get_len(ring) > 0;
+}
+
+esp_err_t uac_ring_wait_space(uac_ring_t *ring, size_t need, TickType_t ticks_to_wait)
+{
+    if (need > ring->size) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    return ring_wait(ring, &ring->space_waiting, ring->space, ring_has_space, need, ticks_to_wait);
+}
+
+uint8_t *uac_ring_write_region(uac_ring_t *ring, size_t *size)
+{
+    uint32_t wr = atomic_load_explicit(&ring->wr, memory_order_relaxed);
+    uint32_t rd = atomic_load_explicit(&ring->rd, memory_order_acquire);
+    uint32_t off = ring_offset(ring, wr);
+    *size = MIN(ring->size - ring_distance(ring, rd, wr), ring->size + ring->mirror - off);
+    return ring->buf + off;
+}
+
+void uac_ring_commit(uac_ring_t *ring, size_t size)
+{
+    uint32_t wr = atomic_load_explicit(&ring->wr, memory_order_relaxed);
+    uint32_t off = ring_offset(ring, wr);
+    size_t end = off + size;
+    if (end > ring->size) {
+        // written past the end: the tail is already the mirror, copy it to the start
+        memcpy(ring->buf, ring->buf + ring->size, end - ring->size);
+    }
+    if (off < ring->mirror) {
+        // written to the start: refresh the mirror
+        memcpy(ring->buf + ring->size + off, ring->buf + off, MIN(end, ring->mirror) - off);
+    }
+    atomic_store(&ring->wr, ring_advance(ring, wr, size));
+    if (atomic_load(&ring->data_waiting)) {
+        xSemaphoreGive(ring->data);
+    }
+}
+
+esp_err_t uac_ring_push(uac_ring_t *ring, const uint8_t *buf, size_t size, TickType_t ticks_to_wait)
+{
+    esp_err_t ret = uac_ring_wait_space(ring, size, ticks_to_wait);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    while (size > 0) {
+        size_t region_size;
+        uint8_t *region = uac_ring_write_region(ring, &region_size);
+        size_t n = MIN(size, region_size);
+        memcpy(region, buf, n);
+        uac_ring_commit(ring, n);
+        buf += n;
+        size -= n;
+    }
+    return ESP_OK;
+}
+
+esp_err_t uac_ring_wait_data(uac_ring_t *ring, TickType_t ticks_to_wait)
+{
+    return ring_wait(ring, &ring->data_waiting, ring->data, ring_has_data, 0, ticks_to_wait);
+}
+
+const uint8_t *uac_ring_peek(uac_ring_t *ring, size_t *size)
+{
+    uint32_t rd = atomic_load_explicit(&ring->rd, memory_order_relaxed);
+    uint32_t wr = atomic_load_explicit(&ring->wr, memory_order_acquire);
+    uint32_t off = ring_offset(ring, rd);
+    *size = MIN(ring_distance(ring, rd, wr), ring->size + ring->mirror - off);
+    return ring->buf + off;
+}
+
+void uac_ring_release(uac_ring_t *ring, size_t size)
+{
+    uint32_t rd = atomic_load_explicit(&ring->rd, memory_order_relaxed);
+    atomic_store(&ring->rd, ring_advance(ring, rd, size));
+    if (atomic_load(&ring->space_waiting)) {
+        xSemaphoreGive(ring->space);
+    }
+}
+
+size_t uac_ring_pop(uac_ring_t *ring, uint8_t *buf, size_t size)
+{
+    size_t read_bytes = 0;
+    // at most twice: once up to the end of the mirror, once from the start
+    while (read_bytes < size) {
+        size_t region_size;
+        const uint8_t *region = uac_ring_peek(ring, &region_size);
+        size_t n = MIN(size - read_bytes, region_size);
+        if (n == 0) {
+            break;
+        }
+        memcpy(buf + read_bytes, region, n);
+        uac_ring_release(ring, n);
+        read_bytes += n;
+    }
+    return read_bytes;
+}
@@ -0,0 +1,95 @@
+#include "audio_arena.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include "esp_heap_caps.h"
+
+struct audio_arena
+{
+    uint8_t *mem;
+    uint32_t size;
+    uint32_t used;
+    uint32_t peak;
+    uint32_t fail_count;
+};
+
+esp_err_t audio_arena_create(uint32_t size, uint32_t caps, audio_arena_handle_t *arena)
+{
+    if (size == 0 || arena == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    struct audio_arena *a = calloc(1, sizeof(struct audio_arena));
+    if (a == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    // 起始地址按 cache line 对齐，切分出的块可以用于 DMA
+    a->mem = heap_caps_aligned_alloc(64, size, caps);
+    if (a->mem == NULL)
+    {
+        free(a);
+        return ESP_ERR_NO_MEM;
+    }
+    a->size = size;
+    *arena = a;
+    return ESP_OK;
+}
+
+void audio_arena_delete(audio_arena_handle_t arena)
+{
+    if (arena == NULL)
+    {
+        return;
+    }
+    heap_caps_free(arena->mem);
+    free(arena);
+}
+
+void *audio_arena_alloc(audio_arena_handle_t arena, uint32_t size, uint32_t align)
+{
+    if (align == 0)
+    {
+        align = AUDIO_ARENA_ALIGN;
+    }
+    uint32_t start = (arena->used + align - 1) & ~(align - 1);
+    if (start > arena->size || size > arena->size - start)
+    {
+        arena->fail_count++;
+        return NULL;
+    }
+    arena->used = start + size;
+    if (arena->used > arena->peak)
+    {
+        arena->peak = arena->used;
+    }
+    return arena->mem + start;
+}
+
+void *audio_arena_calloc(audio_arena_handle_t arena, uint32_t size)
+{
+    void *p = audio_arena_alloc(arena, size, 0);
+    if (p != NULL)
+    {
+        memset(p, 0, size);
+    }
+    return p;
+}
+
+void audio_arena_reset(audio_arena_handle_t arena)
+{
+    arena->used = 0;
+}
+
+uint32_t audio_arena_get_free(audio_arena_handle_t arena)
+{
+    return arena->size - arena->used;
+}
+
+void audio_arena_get_stats(audio_arena_handle_t arena, audio_arena_stats_t *stats)
+{
+    stats->size = arena->size;
+    stats->used = arena->used;
+    stats->peak = arena->peak;
+    stats->fail_count = arena->fail_count;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 线性分配器
+ *
+ * 创建时一次分配整块内存，之后按顺序切分，不能单独释放，只能整体复位。
+ * 每首曲目的缓冲区从固定的区域中分配，切歌时整体复位，长时间播放不会使堆产生碎片。
+ *
+ * 不加锁，同一个分配器只能在一个任务中使用。
+ */
+
+// 默认对齐
+#define AUDIO_ARENA_ALIGN 16
+
+typedef struct
+{
+    uint32_t size;       // 总大小
+    uint32_t used;       // 已分配（含对齐填充）
+    uint32_t peak;       // 创建以来 used 的最大值
+    uint32_t fail_count; // 空间不足导致分配失败的次数
+} audio_arena_stats_t;
+
+typedef struct audio_arena *audio_arena_handle_t;
+
+/**
+ * @brief 创建分配器
+ *
+ * @param[in]  size  可分配的字节数
+ * @param[in]  caps  内存的 heap_caps 属性
+ * @param[out] arena 分配器句柄
+ * @return
+ *  - ESP_OK 成功
+ *  - ESP_ERR_INVALID_ARG 参数无效
+ *  - ESP_ERR_NO_MEM 内存不足
+ */
+esp_err_t audio_arena_create(uint32_t size, uint32_t caps, audio_arena_handle_t *arena);
+
+/**
+ * @brief 删除分配器，分配出的内存全部失效
+ */
+void audio_arena_delete(audio_arena_handle_t arena);
+
+/**
+ * @brief 分配 size 字节，按 align（2 的幂，0 时为 AUDIO_ARENA_ALIGN）对齐
+ *
+ * @return 内存地址，剩余空间不足时返回 NULL
+ */
+void *audio_arena_alloc(audio_arena_handle_t arena, uint32_t size, uint32_t align);
+
+/**
+ * @brief 分配并清零
+ */
+void *audio_arena_calloc(audio_arena_handle_t arena, uint32_t size);
+
+/**
+ * @brief 复位，之前分配的内存全部失效
+ */
+void audio_arena_reset(audio_arena_handle_t arena);
+
+/**
+ * @brief 剩余可分配的字节数（不考虑对齐）
+ */
+uint32_t audio_arena_get_free(audio_arena_handle_t arena);
+
+/**
+ * @brief 取得统计信息
+ */
+void audio_arena_get_stats(audio_arena_handle_t arena, audio_arena_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
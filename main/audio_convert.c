@@ -0,0 +1,325 @@
+#include "audio_convert.h"
+
+#include <string.h>
+#include <inttypes.h>
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_cpu.h"
+#include "audio_simd.h"
+
+static const char *TAG = "AUDIO_CONVERT";
+
+// 测量吞吐率用的样本数
+#define CONVERT_BENCH_SAMPLES 1024
+
+bool audio_sample_format_from_bits(uint8_t bits, audio_sample_format_t *format)
+{
+    switch (bits)
+    {
+    case 16:
+        *format = AUDIO_SAMPLE_S16;
+        return true;
+    case 24:
+        *format = AUDIO_SAMPLE_S24;
+        return true;
+    case 32:
+        *format = AUDIO_SAMPLE_S32;
+        return true;
+    default:
+        return false;
+    }
+}
+
+void audio_dither_init(audio_dither_t *dither, uint32_t seed)
+{
+    dither->seed = seed ? seed : 1;
+}
+
+// 有效精度（位），浮点按 24 位尾数加符号位计
+static uint8_t convert_precision(audio_sample_format_t format)
+{
+    static const uint8_t precision[] = {16, 24, 32, 25};
+    return precision[format];
+}
+
+// 读出一个样本，统一为 Q31
+static inline int32_t convert_load(const uint8_t *p, audio_sample_format_t format)
+{
+    switch (format)
+    {
+    case AUDIO_SAMPLE_S16:
+        return (int32_t)((uint32_t)*(const uint16_t *)p << 16);
+    case AUDIO_SAMPLE_S24:
+        return (int32_t)((uint32_t)p[0] << 8 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 24);
+    case AUDIO_SAMPLE_S32:
+        return *(const int32_t *)p;
+    default:
+    {
+        float f = *(const float *)p * 2147483648.0f;
+        return f >= 2147483647.0f ? INT32_MAX : (f <= -2147483648.0f ? INT32_MIN : (int32_t)f);
+    }
+    }
+}
+
+// TPDF 抖动：两个 [0, 2^shift) 均匀分布之差，shift 为 1 到 16
+// LCG 的低 k 位周期只有 2^k，两个均匀分布分别取相邻两步输出的高 shift 位
+static inline int32_t convert_tpdf(audio_dither_t *dither, uint32_t shift)
+{
+    uint32_t a = dither->seed * 1664525u + 1013904223u;
+    uint32_t b = a * 1664525u + 1013904223u;
+    dither->seed = b;
+    return (int32_t)(a >> (32 - shift)) - (int32_t)(b >> (32 - shift));
+}
+
+// Q31 样本写为目标格式：丢弃的低位四舍五入（或加抖动后取整），超出范围时饱和
+static inline void convert_store(uint8_t *p, audio_sample_format_t format, int32_t v, audio_dither_t *dither)
+{
+    if (format == AUDIO_SAMPLE_S32)
+    {
+        *(int32_t *)p = v;
+        return;
+    }
+    if (format == AUDIO_SAMPLE_F32)
+    {
+        *(float *)p = v * (1.0f / 2147483648.0f);
+        return;
+    }
+    uint32_t shift = format == AUDIO_SAMPLE_S16 ? 16 : 8;
+    int64_t x = (int64_t)v + (1 << (shift - 1));
+    if (dither)
+    {
+        x += convert_tpdf(dither, shift);
+    }
+    x >>= shift;
+    int32_t max = (1 << (31 - shift)) - 1;
+    int32_t y = x > max ? max : (x < -max - 1 ? -max - 1 : (int32_t)x);
+    if (format == AUDIO_SAMPLE_S16)
+    {
+        *(int16_t *)p = (int16_t)y;
+    }
+    else
+    {
+        p[0] = (uint8_t)y;
+        p[1] = (uint8_t)(y >> 8);
+        p[2] = (uint8_t)(y >> 16);
+    }
+}
+
+// 16 位到 24 位：每 4 个样本合成 3 个 32 位字，dst 需要 4 字节对齐
+static uint32_t convert_s16_to_s24(const int16_t *src, uint8_t *dst, uint32_t n)
+{
+    if (((uintptr_t)dst & 3) != 0)
+    {
+        return 0;
+    }
+    uint32_t *w = (uint32_t *)dst;
+    uint32_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        uint32_t a = (uint16_t)src[i];
+        uint32_t b = (uint16_t)src[i + 1];
+        uint32_t c = (uint16_t)src[i + 2];
+        uint32_t d = (uint16_t)src[i + 3];
+        *w++ = a << 8;
+        *w++ = b | c << 24;
+        *w++ = c >> 8 | d << 16;
+    }
+    return i;
+}
+
+void audio_convert_samples(const void *src, audio_sample_format_t src_fmt, void *dst, audio_sample_format_t dst_fmt,
+                           uint32_t n, audio_dither_t *dither)
+{
+    const uint8_t *s = src;
+    uint8_t *d = dst;
+    uint32_t sb = audio_sample_bytes(src_fmt);
+    uint32_t db = audio_sample_bytes(dst_fmt);
+    if (src_fmt == dst_fmt)
+    {
+        if (src != dst)
+        {
+            memcpy(dst, src, n * sb);
+        }
+        return;
+    }
+    // 只有精度降低时才需要抖动
+    if (convert_precision(dst_fmt) >= convert_precision(src_fmt))
+    {
+        dither = NULL;
+    }
+    uint32_t done = 0;
+    if (src != dst && src_fmt == AUDIO_SAMPLE_S16 && dst_fmt == AUDIO_SAMPLE_S32)
+    {
+        audio_simd_s16_to_s32(src, dst, n);
+        return;
+    }
+    if (src != dst && src_fmt == AUDIO_SAMPLE_S16 && dst_fmt == AUDIO_SAMPLE_S24)
+    {
+        done = convert_s16_to_s24(src, dst, n);
+    }
+    // 原地增大样本宽度时从后往前处理，不会覆盖还没读取的样本
+    if (src == dst && db > sb)
+    {
+        for (uint32_t i = n; i-- > done;)
+        {
+            convert_store(d + i * db, dst_fmt, convert_load(s + i * sb, src_fmt), dither);
+        }
+        return;
+    }
+    for (uint32_t i = done; i < n; i++)
+    {
+        convert_store(d + i * db, dst_fmt, convert_load(s + i * sb, src_fmt), dither);
+    }
+}
+
+void audio_convert_interleave_s16(const int16_t *left, const int16_t *right, int16_t *dst, uint32_t frames)
+{
+    for (uint32_t i = 0; i < frames; i++)
+    {
+        dst[2 * i] = left[i];
+        dst[2 * i + 1] = right[i];
+    }
+}
+
+void audio_convert_deinterleave_s16(const int16_t *src, int16_t *left, int16_t *right, uint32_t frames)
+{
+    for (uint32_t i = 0; i < frames; i++)
+    {
+        left[i] = src[2 * i];
+        right[i] = src[2 * i + 1];
+    }
+}
+
+esp_err_t audio_convert_channels(const void *src, uint8_t src_ch, void *dst, uint8_t dst_ch, audio_sample_format_t format,
+                                 uint32_t frames)
+{
+    const uint8_t *s = src;
+    uint8_t *d = dst;
+    uint32_t sb = audio_sample_bytes(format);
+    if (src_ch == dst_ch)
+    {
+        if (src != dst)
+        {
+            memcpy(dst, src, frames * src_ch * sb);
+        }
+        return ESP_OK;
+    }
+    if (src_ch == 1 && dst_ch == 2)
+    {
+        // 从后往前处理，支持原地转换
+        if (format == AUDIO_SAMPLE_S16)
+        {
+            const int16_t *s16 = src;
+            int16_t *d16 = dst;
+            for (uint32_t i = frames; i-- > 0;)
+            {
+                int16_t v = s16[i];
+                d16[2 * i] = v;
+                d16[2 * i + 1] = v;
+            }
+            return ESP_OK;
+        }
+        for (uint32_t i = frames; i-- > 0;)
+        {
+            memmove(d + (2 * i + 1) * sb, s + i * sb, sb);
+            memmove(d + 2 * i * sb, s + i * sb, sb);
+        }
+        return ESP_OK;
+    }
+    if (src_ch == 2 && dst_ch == 1)
+    {
+        for (uint32_t i = 0; i < frames; i++)
+        {
+            const uint8_t *p = s + 2 * i * sb;
+            if (format == AUDIO_SAMPLE_F32)
+            {
+                *(float *)(d + i * sb) = (*(const float *)p + *(const float *)(p + sb)) * 0.5f;
+            }
+            else
+            {
+                // 在 Q31 上求平均（64 位不会溢出），写回时四舍五入
+                int32_t v = (int32_t)(((int64_t)convert_load(p, format) + convert_load(p + sb, format)) >> 1);
+                convert_store(d + i * sb, format, v, NULL);
+            }
+        }
+        return ESP_OK;
+    }
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t audio_convert_pcm(const uint8_t *src, uint8_t src_bits, uint8_t src_ch, uint8_t *dst, uint8_t dst_bits,
+                            uint8_t dst_ch, uint32_t frames, audio_dither_t *dither)
+{
+    audio_sample_format_t src_fmt, dst_fmt;
+    if (!audio_sample_format_from_bits(src_bits, &src_fmt) || !audio_sample_format_from_bits(dst_bits, &dst_fmt) ||
+        !((src_ch == dst_ch) || (src_ch == 1 && dst_ch == 2) || (src_ch == 2 && dst_ch == 1)))
+    {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    // 先减少通道、后增加通道，处理的样本数最少
+    if (dst_ch < src_ch)
+    {
+        audio_convert_channels(src, src_ch, dst, dst_ch, src_fmt, frames);
+        audio_convert_samples(dst, src_fmt, dst, dst_fmt, frames * dst_ch, dither);
+    }
+    else
+    {
+        audio_convert_samples(src, src_fmt, dst, dst_fmt, frames * src_ch, dither);
+        audio_convert_channels(dst, src_ch, dst, dst_ch, dst_fmt, frames);
+    }
+    return ESP_OK;
+}
+
+void audio_convert_benchmark(void)
+{
+    static const char *names[] = {"s16", "s24", "s32", "f32"};
+    uint8_t *src = heap_caps_aligned_alloc(AUDIO_SIMD_ALIGN, CONVERT_BENCH_SAMPLES * 4, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    uint8_t *dst = heap_caps_aligned_alloc(AUDIO_SIMD_ALIGN, CONVERT_BENCH_SAMPLES * 4 * 2, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (src == NULL || dst == NULL)
+    {
+        heap_caps_free(src);
+        heap_caps_free(dst);
+        return;
+    }
+    audio_dither_t dither;
+    audio_dither_init(&dither, 1);
+    for (int i = 0; i < CONVERT_BENCH_SAMPLES; i++)
+    {
+        // 满量程一半左右的锯齿波，浮点格式也在有效范围内
+        ((int16_t *)src)[i] = (int16_t)(i * 37 - 16384);
+    }
+    for (int f = AUDIO_SAMPLE_S16; f <= AUDIO_SAMPLE_F32; f++)
+    {
+        for (int t = AUDIO_SAMPLE_S16; t <= AUDIO_SAMPLE_F32; t++)
+        {
+            if (f == t)
+            {
+                continue;
+            }
+            // 先把锯齿波转为输入格式，再测量
+            audio_convert_samples(src, AUDIO_SAMPLE_S16, dst, f, CONVERT_BENCH_SAMPLES, NULL);
+            uint32_t start = esp_cpu_get_cycle_count();
+            audio_convert_samples(dst, f, dst + CONVERT_BENCH_SAMPLES * 4, t, CONVERT_BENCH_SAMPLES, &dither);
+            uint32_t cycles = esp_cpu_get_cycle_count() - start;
+            uint32_t bytes = CONVERT_BENCH_SAMPLES * audio_sample_bytes(f);
+            ESP_LOGI(TAG, "%s -> %s: %.3f bytes/cycle", names[f], names[t], (float)bytes / cycles);
+        }
+    }
+    const uint32_t frames = CONVERT_BENCH_SAMPLES / 2;
+    int16_t *s16 = (int16_t *)src;
+    int16_t *out = (int16_t *)dst;
+    uint32_t start = esp_cpu_get_cycle_count();
+    audio_convert_interleave_s16(s16, s16 + frames, out, frames);
+    ESP_LOGI(TAG, "interleave s16: %.3f bytes/cycle", (float)(frames * 4) / (esp_cpu_get_cycle_count() - start));
+    start = esp_cpu_get_cycle_count();
+    audio_convert_deinterleave_s16(s16, out, out + frames, frames);
+    ESP_LOGI(TAG, "deinterleave s16: %.3f bytes/cycle", (float)(frames * 4) / (esp_cpu_get_cycle_count() - start));
+    start = esp_cpu_get_cycle_count();
+    audio_convert_channels(s16, 1, out, 2, AUDIO_SAMPLE_S16, frames);
+    ESP_LOGI(TAG, "mono -> stereo s16: %.3f bytes/cycle", (float)(frames * 2) / (esp_cpu_get_cycle_count() - start));
+    start = esp_cpu_get_cycle_count();
+    audio_convert_channels(s16, 2, out, 1, AUDIO_SAMPLE_S16, frames);
+    ESP_LOGI(TAG, "stereo -> mono s16: %.3f bytes/cycle", (float)(frames * 4) / (esp_cpu_get_cycle_count() - start));
+    heap_caps_free(src);
+    heap_caps_free(dst);
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 样本格式转换
+ *
+ * 16 位、24 位（3 字节紧凑排列，与 UAC 的 bSubframeSize 3 一致）、32 位整数和 32 位浮点之间互相转换，
+ * 交错/解交错，单声道与立体声互转。降低位深时可以加 TPDF 抖动（两个均匀分布之差，幅度为目标格式的
+ * ±1 LSB），把量化误差变为与信号无关的白噪声。
+ *
+ * 常用路径有专门的内核：16 位到 32 位在 ESP32-S3 上用 PIE 向量指令，16 位到 24 位每 4 个样本
+ * 合成 3 个 32 位字写出；其余路径为标量实现。
+ *
+ * 所有函数只访问参数中的数据，可以在任意任务中调用；同一个抖动状态不能同时在多个任务中使用。
+ */
+
+/**
+ * @brief 样本格式
+ */
+typedef enum
+{
+    AUDIO_SAMPLE_S16 = 0, // 16 位整数
+    AUDIO_SAMPLE_S24,     // 24 位整数，3 字节小端
+    AUDIO_SAMPLE_S32,     // 32 位整数
+    AUDIO_SAMPLE_F32,     // 32 位浮点，满量程为 ±1.0
+} audio_sample_format_t;
+
+/**
+ * @brief TPDF 抖动的随机数状态
+ */
+typedef struct
+{
+    uint32_t seed;
+} audio_dither_t;
+
+/**
+ * @brief 每个样本的字节数
+ */
+static inline uint8_t audio_sample_bytes(audio_sample_format_t format)
+{
+    return format == AUDIO_SAMPLE_S16 ? 2 : (format == AUDIO_SAMPLE_S24 ? 3 : 4);
+}
+
+/**
+ * @brief 整数 PCM 位深度对应的样本格式
+ *
+ * @return 是否为支持的位深度（16、24 或 32）
+ */
+bool audio_sample_format_from_bits(uint8_t bits, audio_sample_format_t *format);
+
+/**
+ * @brief 初始化抖动状态
+ */
+void audio_dither_init(audio_dither_t *dither, uint32_t seed);
+
+/**
+ * @brief 样本格式转换
+ *
+ * @param[in]  src     输入样本
+ * @param[in]  src_fmt 输入格式
+ * @param[out] dst     输出样本，可以与 src 相同（原地转换），其余情况不能重叠
+ * @param[in]  dst_fmt 输出格式
+ * @param[in]  n       样本数（各通道之和）
+ * @param[in]  dither  降低精度时使用的抖动状态，NULL 时四舍五入
+ */
+void audio_convert_samples(const void *src, audio_sample_format_t src_fmt, void *dst, audio_sample_format_t dst_fmt,
+                           uint32_t n, audio_dither_t *dither);
+
+/**
+ * @brief 两个单声道 16 位样本交错为立体声
+ */
+void audio_convert_interleave_s16(const int16_t *left, const int16_t *right, int16_t *dst, uint32_t frames);
+
+/**
+ * @brief 立体声 16 位样本拆分为两个单声道
+ */
+void audio_convert_deinterleave_s16(const int16_t *src, int16_t *left, int16_t *right, uint32_t frames);
+
+/**
+ * @brief 交错 PCM 的通道数转换：单声道复制到两个通道，立体声取两个通道的平均值
+ *
+ * @param[in]  src    输入
+ * @param[in]  src_ch 输入通道数
+ * @param[out] dst    输出，可以与 src 相同（原地转换）
+ * @param[in]  dst_ch 输出通道数
+ * @param[in]  format 样本格式
+ * @param[in]  frames 帧数
+ * @return
+ *  - ESP_OK 成功
+ *  - ESP_ERR_NOT_SUPPORTED 不是单声道与立体声之间的转换
+ */
+esp_err_t audio_convert_channels(const void *src, uint8_t src_ch, void *dst, uint8_t dst_ch, audio_sample_format_t format,
+                                 uint32_t frames);
+
+/**
+ * @brief 交错整数 PCM 一次完成位深度和通道数的转换
+ *
+ * dst 需要能容纳 frames * dst_ch * max(输入样本字节数, 输出样本字节数) 字节（先减少通道再转换位深时的中间结果）。
+ *
+ * @param[in]  src      输入
+ * @param[in]  src_bits 输入位深度
+ * @param[in]  src_ch   输入通道数
+ * @param[out] dst      输出，不能与 src 重叠
+ * @param[in]  dst_bits 输出位深度
+ * @param[in]  dst_ch   输出通道数
+ * @param[in]  frames   帧数
+ * @param[in]  dither   降低位深度时使用的抖动状态，NULL 时四舍五入
+ * @return
+ *  - ESP_OK 成功
+ *  - ESP_ERR_NOT_SUPPORTED 不支持的位深度或通道数组合
+ */
+esp_err_t audio_convert_pcm(const uint8_t *src, uint8_t src_bits, uint8_t src_ch, uint8_t *dst, uint8_t dst_bits,
+                            uint8_t dst_ch, uint32_t frames, audio_dither_t *dither);
+
+/**
+ * @brief 测量各转换内核的吞吐率（输入字节/周期）并打印日志，用于开发时比较内核
+ */
+void audio_convert_benchmark(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,406 @@
+#include "audio_eq.h"
+
+#include <math.h>
+#include <string.h>
+#include <inttypes.h>
+#include <stdatomic.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_cpu.h"
+#include "audio_simd.h"
+
+static const char *TAG = "AUDIO_EQ";
+
+// 每次转换为 Q27 处理的帧数
+#define EQ_BLOCK_FRAMES 256
+// 系数过渡期间每隔多少帧更新一次系数
+#define EQ_XFADE_STEP_FRAMES 32
+// 16 位样本到 Q27 的移位
+#define EQ_SAMPLE_SHIFT 12
+// 系数的小数位数
+#define EQ_COEF_BITS 29
+// Q29 只能表示 ±4，大增益搁架滤波器的前馈系数可达 ±11.3（15 dB），最多预先缩小 2^2 倍
+#define EQ_PRESCALE_MAX 2
+#define EQ_COEF_NUM 5
+#define EQ_STATE_NUM 5
+
+struct audio_eq
+{
+    portMUX_TYPE lock;                                            // 保护 pending
+    audio_eq_band_t pending[AUDIO_EQ_CHANNEL_MAX][AUDIO_EQ_BAND_MAX];
+    atomic_bool dirty;
+    // 仅处理任务访问
+    audio_eq_band_t bands[AUDIO_EQ_CHANNEL_MAX][AUDIO_EQ_BAND_MAX];
+    uint32_t sample_rate;
+    int32_t from[AUDIO_EQ_CHANNEL_MAX][AUDIO_EQ_BAND_MAX][EQ_COEF_NUM]; // 过渡起点
+    int32_t to[AUDIO_EQ_CHANNEL_MAX][AUDIO_EQ_BAND_MAX][EQ_COEF_NUM];   // 过渡终点
+    int32_t coef[AUDIO_EQ_CHANNEL_MAX][AUDIO_EQ_BAND_MAX][EQ_COEF_NUM]; // 当前使用
+    int32_t state[AUDIO_EQ_CHANNEL_MAX][AUDIO_EQ_BAND_MAX][EQ_STATE_NUM];
+    uint8_t to_shift[AUDIO_EQ_CHANNEL_MAX][AUDIO_EQ_BAND_MAX]; // to 的前馈系数缩小的位数
+    uint8_t shift[AUDIO_EQ_CHANNEL_MAX][AUDIO_EQ_BAND_MAX];    // coef 和状态中 y 缩小的位数
+    bool active[AUDIO_EQ_CHANNEL_MAX][AUDIO_EQ_BAND_MAX];
+    bool any_active;
+    uint32_t xfade_pos;
+    uint32_t xfade_len;                                           // 0 表示没有在过渡
+    uint64_t cycles;
+    uint64_t frames;
+    int32_t work[EQ_BLOCK_FRAMES * AUDIO_EQ_CHANNEL_MAX];
+};
+
+static const int32_t s_eq_identity[EQ_COEF_NUM] = {1 << EQ_COEF_BITS, 0, 0, 0, 0};
+
+static bool eq_is_identity(const int32_t *coef)
+{
+    return memcmp(coef, s_eq_identity, sizeof(s_eq_identity)) == 0;
+}
+
+/**
+ * 按 RBJ Audio EQ Cookbook 计算系数，只在参数改变时调用，用双精度保证低频滤波器的精度
+ *
+ * 前馈系数超出 Q29 范围时整体除以 2^shift：滤波器是线性的，输出也缩小 2^shift 倍，
+ * 反馈系数不变（稳定滤波器的 |a1| < 2，|a2| < 1），滤波后再左移 shift 位恢复。
+ */
+static void eq_design(const audio_eq_band_t *band, uint32_t sample_rate, int32_t *coef, uint8_t *shift)
+{
+    memcpy(coef, s_eq_identity, sizeof(s_eq_identity));
+    *shift = 0;
+    if (band->type == AUDIO_EQ_BAND_OFF || sample_rate == 0)
+    {
+        return;
+    }
+    bool gain_type = band->type == AUDIO_EQ_BAND_PEAK || band->type == AUDIO_EQ_BAND_LOW_SHELF ||
+                     band->type == AUDIO_EQ_BAND_HIGH_SHELF;
+    if (gain_type && band->gain_db == 0.0f)
+    {
+        return;
+    }
+    if (band->freq >= sample_rate * 0.49f)
+    {
+        ESP_LOGW(TAG, "Band at %.0f Hz above Nyquist of %" PRIu32 " Hz, bypassed", band->freq, sample_rate);
+        return;
+    }
+    double A = pow(10.0, band->gain_db / 40.0);
+    double w0 = 2.0 * M_PI * band->freq / sample_rate;
+    double cs = cos(w0);
+    double alpha = sin(w0) / (2.0 * band->q);
+    double sa = 2.0 * sqrt(A) * alpha;
+    double b0, b1, b2, a0, a1, a2;
+    switch (band->type)
+    {
+    case AUDIO_EQ_BAND_PEAK:
+        b0 = 1.0 + alpha * A;
+        b1 = -2.0 * cs;
+        b2 = 1.0 - alpha * A;
+        a0 = 1.0 + alpha / A;
+        a1 = -2.0 * cs;
+        a2 = 1.0 - alpha / A;
+        break;
+    case AUDIO_EQ_BAND_LOW_SHELF:
+        b0 = A * ((A + 1.0) - (A - 1.0) * cs + sa);
+        b1 = 2.0 * A * ((A - 1.0) - (A + 1.0) * cs);
+        b2 = A * ((A + 1.0) - (A - 1.0) * cs - sa);
+        a0 = (A + 1.0) + (A - 1.0) * cs + sa;
+        a1 = -2.0 * ((A - 1.0) + (A + 1.0) * cs);
+        a2 = (A + 1.0) + (A - 1.0) * cs - sa;
+        break;
+    case AUDIO_EQ_BAND_HIGH_SHELF:
+        b0 = A * ((A + 1.0) + (A - 1.0) * cs + sa);
+        b1 = -2.0 * A * ((A - 1.0) + (A + 1.0) * cs);
+        b2 = A * ((A + 1.0) + (A - 1.0) * cs - sa);
+        a0 = (A + 1.0) - (A - 1.0) * cs + sa;
+        a1 = 2.0 * ((A - 1.0) - (A + 1.0) * cs);
+        a2 = (A + 1.0) - (A - 1.0) * cs - sa;
+        break;
+    case AUDIO_EQ_BAND_LOW_PASS:
+        b0 = (1.0 - cs) / 2.0;
+        b1 = 1.0 - cs;
+        b2 = b0;
+        a0 = 1.0 + alpha;
+        a1 = -2.0 * cs;
+        a2 = 1.0 - alpha;
+        break;
+    case AUDIO_EQ_BAND_HIGH_PASS:
+        b0 = (1.0 + cs) / 2.0;
+        b1 = -(1.0 + cs);
+        b2 = b0;
+        a0 = 1.0 + alpha;
+        a1 = -2.0 * cs;
+        a2 = 1.0 - alpha;
+        break;
+    default:
+        return;
+    }
+    // 反馈系数取负，内核中全部用加法
+    const double c[EQ_COEF_NUM] = {b0 / a0, b1 / a0, b2 / a0, -a1 / a0, -a2 / a0};
+    double b_max = fmax(fabs(c[0]), fmax(fabs(c[1]), fabs(c[2])));
+    uint8_t s = 0;
+    while (s < EQ_PRESCALE_MAX && round(b_max * (1 << (EQ_COEF_BITS - s))) >= (double)INT32_MAX)
+    {
+        s++;
+    }
+    int32_t q[EQ_COEF_NUM];
+    for (int i = 0; i < EQ_COEF_NUM; i++)
+    {
+        double v = round(c[i] * (1 << (i < 3 ? EQ_COEF_BITS - s : EQ_COEF_BITS)));
+        if (v >= (double)INT32_MAX || v <= (double)INT32_MIN)
+        {
+            ESP_LOGW(TAG, "Band %d at %.0f Hz out of range, bypassed", band->type, band->freq);
+            return;
+        }
+        q[i] = (int32_t)v;
+    }
+    memcpy(coef, q, sizeof(q));
+    *shift = s;
+}
+
+// 改变频段缩小的位数，状态中的 y1/y2 同步缩放，余数清零
+static void eq_set_shift(struct audio_eq *eq, int ch, int b, uint8_t shift)
+{
+    int32_t *state = eq->state[ch][b];
+    for (int i = 2; i < 4; i++)
+    {
+        if (shift > eq->shift[ch][b])
+        {
+            state[i] >>= shift - eq->shift[ch][b];
+        }
+        else
+        {
+            int64_t v = (int64_t)state[i] << (eq->shift[ch][b] - shift);
+            state[i] = (int32_t)(v > INT32_MAX ? INT32_MAX : (v < INT32_MIN ? INT32_MIN : v));
+        }
+    }
+    state[4] = 0;
+    eq->shift[ch][b] = shift;
+}
+
+// 滤波后左移恢复预先缩小的增益，饱和
+static void eq_unscale(int32_t *x, uint32_t n, uint32_t stride, uint8_t shift)
+{
+    const int32_t limit = INT32_MAX >> shift;
+    for (uint32_t i = 0; i < n; i++, x += stride)
+    {
+        int32_t v = *x;
+        *x = v > limit ? INT32_MAX : (v < -limit - 1 ? INT32_MIN : (int32_t)((uint32_t)v << shift));
+    }
+}
+
+// 按 pending 中的参数重新计算系数，xfade 为 false 时立即生效并清空状态
+static void eq_update(struct audio_eq *eq, bool xfade)
+{
+    portENTER_CRITICAL(&eq->lock);
+    memcpy(eq->bands, eq->pending, sizeof(eq->bands));
+    portEXIT_CRITICAL(&eq->lock);
+
+    eq->any_active = false;
+    for (int ch = 0; ch < AUDIO_EQ_CHANNEL_MAX; ch++)
+    {
+        for (int b = 0; b < AUDIO_EQ_BAND_MAX; b++)
+        {
+            eq_design(&eq->bands[ch][b], eq->sample_rate, eq->to[ch][b], &eq->to_shift[ch][b]);
+            if (!xfade)
+            {
+                memcpy(eq->coef[ch][b], eq->to[ch][b], sizeof(eq->coef[ch][b]));
+                eq->shift[ch][b] = eq->to_shift[ch][b];
+            }
+            else if (eq->to_shift[ch][b] > eq->shift[ch][b])
+            {
+                // 过渡期间按两端中较大的位数缩小，当前系数的前馈部分和状态一起缩放
+                for (int i = 0; i < 3; i++)
+                {
+                    eq->coef[ch][b][i] >>= eq->to_shift[ch][b] - eq->shift[ch][b];
+                }
+                eq_set_shift(eq, ch, b, eq->to_shift[ch][b]);
+            }
+            memcpy(eq->from[ch][b], eq->coef[ch][b], sizeof(eq->from[ch][b]));
+            // 过渡期间两端任意一端不是直通都要计算
+            bool active = !eq_is_identity(eq->to[ch][b]) || !eq_is_identity(eq->coef[ch][b]);
+            if (!xfade || (active && !eq->active[ch][b]))
+            {
+                memset(eq->state[ch][b], 0, sizeof(eq->state[ch][b]));
+            }
+            eq->active[ch][b] = active;
+            eq->any_active |= active;
+        }
+    }
+    eq->xfade_pos = 0;
+    eq->xfade_len = xfade ? eq->sample_rate * AUDIO_EQ_XFADE_MS / 1000 : 0;
+}
+
+// 按过渡位置插值出当前系数
+static void eq_interpolate(struct audio_eq *eq)
+{
+    for (int ch = 0; ch < AUDIO_EQ_CHANNEL_MAX; ch++)
+    {
+        for (int b = 0; b < AUDIO_EQ_BAND_MAX; b++)
+        {
+            if (!eq->active[ch][b])
+            {
+                continue;
+            }
+            for (int i = 0; i < EQ_COEF_NUM; i++)
+            {
+                int32_t to = eq->to[ch][b][i];
+                if (i < 3)
+                {
+                    to >>= eq->shift[ch][b] - eq->to_shift[ch][b];
+                }
+                int64_t from = eq->from[ch][b][i];
+                int64_t diff = (int64_t)to - from;
+                eq->coef[ch][b][i] = (int32_t)(from + diff * eq->xfade_pos / eq->xfade_len);
+            }
+        }
+    }
+}
+
+// 过渡结束，只保留不是直通的频段
+static void eq_xfade_done(struct audio_eq *eq)
+{
+    eq->xfade_len = 0;
+    eq->any_active = false;
+    for (int ch = 0; ch < AUDIO_EQ_CHANNEL_MAX; ch++)
+    {
+        for (int b = 0; b < AUDIO_EQ_BAND_MAX; b++)
+        {
+            memcpy(eq->coef[ch][b], eq->to[ch][b], sizeof(eq->coef[ch][b]));
+            if (eq->shift[ch][b] != eq->to_shift[ch][b])
+            {
+                eq_set_shift(eq, ch, b, eq->to_shift[ch][b]);
+            }
+            eq->active[ch][b] = !eq_is_identity(eq->to[ch][b]);
+            eq->any_active |= eq->active[ch][b];
+        }
+    }
+}
+
+esp_err_t audio_eq_create(audio_eq_handle_t *eq)
+{
+    if (eq == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    // 每帧都要访问系数和状态，放在内部 RAM
+    struct audio_eq *e = heap_caps_calloc(1, sizeof(struct audio_eq), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (e == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    portMUX_INITIALIZE(&e->lock);
+    atomic_init(&e->dirty, false);
+    eq_update(e, false);
+    *eq = e;
+    return ESP_OK;
+}
+
+void audio_eq_delete(audio_eq_handle_t eq)
+{
+    heap_caps_free(eq);
+}
+
+esp_err_t audio_eq_set_band(audio_eq_handle_t eq, uint8_t channel_mask, uint8_t index, const audio_eq_band_t *band)
+{
+    if (eq == NULL || band == NULL || index >= AUDIO_EQ_BAND_MAX || band->type > AUDIO_EQ_BAND_HIGH_PASS ||
+        (band->type != AUDIO_EQ_BAND_OFF && (!(band->freq > 0.0f) || !(band->q > 0.0f) ||
+                                             fabsf(band->gain_db) > AUDIO_EQ_GAIN_MAX_DB)))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    portENTER_CRITICAL(&eq->lock);
+    for (int ch = 0; ch < AUDIO_EQ_CHANNEL_MAX; ch++)
+    {
+        if (channel_mask & (1 << ch))
+        {
+            eq->pending[ch][index] = *band;
+        }
+    }
+    portEXIT_CRITICAL(&eq->lock);
+    atomic_store(&eq->dirty, true);
+    return ESP_OK;
+}
+
+void audio_eq_reset(audio_eq_handle_t eq)
+{
+    memset(eq->state, 0, sizeof(eq->state));
+}
+
+void audio_eq_process(audio_eq_handle_t eq, int16_t *data, uint32_t frames, uint8_t channels, uint32_t sample_rate)
+{
+    if (channels == 0 || channels > AUDIO_EQ_CHANNEL_MAX)
+    {
+        return;
+    }
+    if (sample_rate != eq->sample_rate)
+    {
+        // 采样率改变时系数全部重新计算，不做过渡
+        atomic_store(&eq->dirty, false);
+        eq->sample_rate = sample_rate;
+        eq_update(eq, false);
+    }
+    else if (atomic_exchange(&eq->dirty, false))
+    {
+        eq_update(eq, true);
+    }
+    if (!eq->any_active)
+    {
+        return;
+    }
+
+    uint32_t start = esp_cpu_get_cycle_count();
+    eq->frames += frames;
+    while (frames > 0)
+    {
+        uint32_t n = frames < EQ_BLOCK_FRAMES ? frames : EQ_BLOCK_FRAMES;
+        uint32_t samples = n * channels;
+        for (uint32_t i = 0; i < samples; i++)
+        {
+            eq->work[i] = (int32_t)data[i] << EQ_SAMPLE_SHIFT;
+        }
+        for (uint32_t off = 0; off < n;)
+        {
+            // 过渡期间每 EQ_XFADE_STEP_FRAMES 帧更新一次系数
+            uint32_t len = n - off;
+            if (eq->xfade_len > 0)
+            {
+                eq_interpolate(eq);
+                len = len < EQ_XFADE_STEP_FRAMES ? len : EQ_XFADE_STEP_FRAMES;
+            }
+            for (uint8_t ch = 0; ch < channels; ch++)
+            {
+                for (int b = 0; b < AUDIO_EQ_BAND_MAX; b++)
+                {
+                    if (eq->active[ch][b])
+                    {
+                        int32_t *x = eq->work + off * channels + ch;
+                        audio_simd_biquad_s32(x, len, channels, eq->coef[ch][b], eq->state[ch][b]);
+                        if (eq->shift[ch][b] > 0)
+                        {
+                            eq_unscale(x, len, channels, eq->shift[ch][b]);
+                        }
+                    }
+                }
+            }
+            off += len;
+            if (eq->xfade_len > 0)
+            {
+                eq->xfade_pos += len;
+                if (eq->xfade_pos >= eq->xfade_len)
+                {
+                    eq_xfade_done(eq);
+                }
+            }
+        }
+        for (uint32_t i = 0; i < samples; i++)
+        {
+            int32_t v = (eq->work[i] + (1 << (EQ_SAMPLE_SHIFT - 1))) >> EQ_SAMPLE_SHIFT;
+            data[i] = (int16_t)(v > INT16_MAX ? INT16_MAX : (v < INT16_MIN ? INT16_MIN : v));
+        }
+        data += samples;
+        frames -= n;
+    }
+    eq->cycles += esp_cpu_get_cycle_count() - start;
+}
+
+uint32_t audio_eq_get_cycles_per_frame(audio_eq_handle_t eq)
+{
+    return eq->frames ? (uint32_t)(eq->cycles / eq->frames) : 0;
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 参数均衡器
+ *
+ * 每个通道最多 AUDIO_EQ_BAND_MAX 节双二阶滤波器串联（RBJ Audio EQ Cookbook 公式）。
+ * 参数改变时才重新计算系数，新旧系数在 AUDIO_EQ_XFADE_MS 内逐块线性过渡，避免
+ * 拉链噪声；二阶滤波器的稳定区域是凸的，两组稳定系数之间的插值仍然稳定。
+ * 系数为 1（0 dB 的峰值/搁架滤波器或关闭的频段）的频段不参与计算。
+ *
+ * 定点实现：16 位样本扩展为 Q27，系数为 Q29，每节滤波的乘积取高 32 位；前馈系数超出
+ * Q29 范围（±4，如大增益的搁架滤波器）的频段把前馈系数缩小 2 的幂倍，滤波后再放大，
+ * AUDIO_EQ_GAIN_MAX_DB 范围内的参数都能实现。
+ * ESP32-S3 使用汇编内核（audio_simd_biquad_s32），其余芯片使用逐位一致的标量实现。
+ *
+ * audio_eq_set_band 可以在任意任务中调用，在下一次 audio_eq_process 时生效；
+ * audio_eq_process 只能在一个任务中调用（播放任务）。
+ */
+
+#define AUDIO_EQ_BAND_MAX 10
+#define AUDIO_EQ_CHANNEL_MAX 2
+// 峰值/搁架滤波器的增益范围（dB）
+#define AUDIO_EQ_GAIN_MAX_DB 15.0f
+// 系数过渡时长
+#define AUDIO_EQ_XFADE_MS 20
+
+/**
+ * @brief 频段类型
+ */
+typedef enum
+{
+    AUDIO_EQ_BAND_OFF = 0,
+    AUDIO_EQ_BAND_PEAK,       // 峰值
+    AUDIO_EQ_BAND_LOW_SHELF,  // 低频搁架
+    AUDIO_EQ_BAND_HIGH_SHELF, // 高频搁架
+    AUDIO_EQ_BAND_LOW_PASS,   // 低通
+    AUDIO_EQ_BAND_HIGH_PASS,  // 高通
+} audio_eq_band_type_t;
+
+/**
+ * @brief 频段参数
+ */
+typedef struct
+{
+    audio_eq_band_type_t type;
+    float freq;    // 中心/转折频率（Hz）
+    float gain_db; // 增益（dB），低通/高通忽略
+    float q;       // 品质因数
+} audio_eq_band_t;
+
+typedef struct audio_eq *audio_eq_handle_t;
+
+/**
+ * @brief 创建均衡器，所有频段关闭
+ */
+esp_err_t audio_eq_create(audio_eq_handle_t *eq);
+
+/**
+ * @brief 删除均衡器
+ */
+void audio_eq_delete(audio_eq_handle_t eq);
+
+/**
+ * @brief 设置一个频段
+ *
+ * @param[in] eq           均衡器句柄
+ * @param[in] channel_mask 作用的通道（bit0 左，bit1 右）
+ * @param[in] index        频段序号（0 ~ AUDIO_EQ_BAND_MAX - 1）
+ * @param[in] band         频段参数
+ * @return
+ *  - ESP_OK 成功
+ *  - ESP_ERR_INVALID_ARG 参数无效
+ */
+esp_err_t audio_eq_set_band(audio_eq_handle_t eq, uint8_t channel_mask, uint8_t index, const audio_eq_band_t *band);
+
+/**
+ * @brief 清空滤波器状态（跳转或曲目不连续时调用）
+ */
+void audio_eq_reset(audio_eq_handle_t eq);
+
+/**
+ * @brief 对 16 位交错 PCM 原地均衡
+ *
+ * @param[in]     eq          均衡器句柄
+ * @param[in,out] data        PCM 数据
+ * @param[in]     frames      帧数
+ * @param[in]     channels    通道数（1 或 2）
+ * @param[in]     sample_rate 采样率，改变时重新计算系数并清空状态
+ */
+void audio_eq_process(audio_eq_handle_t eq, int16_t *data, uint32_t frames, uint8_t channels, uint32_t sample_rate);
+
+/**
+ * @brief 平均每帧消耗的 CPU 周期数
+ */
+uint32_t audio_eq_get_cycles_per_frame(audio_eq_handle_t eq);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,233 @@
+#include "audio_gain.h"
+
+#include <string.h>
+#include <math.h>
+#include "audio_simd.h"
+
+// 请求打包：最高位为有效位，其次为从 0 开始的标志，再下 16 位为目标增益，最低 14 位为斜坡毫秒数
+#define GAIN_REQUEST_VALID (1u << 31)
+#define GAIN_REQUEST_FROM_ZERO (1u << 30)
+#define GAIN_REQUEST_TARGET_SHIFT 14
+#define GAIN_REQUEST_TARGET_MASK 0xFFFF
+#define GAIN_REQUEST_RAMP_MAX 0x3FFF
+// 音量百分比 0~100 对应的衰减范围
+#define GAIN_PERCENT_RANGE_DB 60.0f
+
+void audio_gain_init(audio_gain_t *g, uint32_t gain_q15)
+{
+    if (gain_q15 > AUDIO_GAIN_UNITY)
+    {
+        gain_q15 = AUDIO_GAIN_UNITY;
+    }
+    atomic_init(&g->request, 0);
+    atomic_init(&g->current, gain_q15);
+    atomic_init(&g->ramping, false);
+    g->gain = (int32_t)(gain_q15 << 15);
+    g->target = g->gain;
+    g->step = 0;
+    g->ramp_remain = 0;
+}
+
+static void gain_request(audio_gain_t *g, uint32_t flags, uint32_t target_q15, uint32_t ramp_ms)
+{
+    if (target_q15 > AUDIO_GAIN_UNITY)
+    {
+        target_q15 = AUDIO_GAIN_UNITY;
+    }
+    if (ramp_ms > GAIN_REQUEST_RAMP_MAX)
+    {
+        ramp_ms = GAIN_REQUEST_RAMP_MAX;
+    }
+    atomic_store(&g->request, GAIN_REQUEST_VALID | flags | (target_q15 << GAIN_REQUEST_TARGET_SHIFT) | ramp_ms);
+}
+
+void audio_gain_set(audio_gain_t *g, uint32_t target_q15, uint32_t ramp_ms)
+{
+    gain_request(g, 0, target_q15, ramp_ms);
+}
+
+void audio_gain_fade_in(audio_gain_t *g, uint32_t target_q15, uint32_t ramp_ms)
+{
+    gain_request(g, GAIN_REQUEST_FROM_ZERO, target_q15, ramp_ms);
+}
+
+uint32_t audio_gain_get(audio_gain_t *g)
+{
+    return atomic_load(&g->current);
+}
+
+bool audio_gain_is_settled(audio_gain_t *g)
+{
+    return atomic_load(&g->request) == 0 && !atomic_load(&g->ramping);
+}
+
+uint32_t audio_gain_from_percent(uint8_t percent)
+{
+    if (percent == 0)
+    {
+        return 0;
+    }
+    if (percent >= 100)
+    {
+        return AUDIO_GAIN_UNITY;
+    }
+    float db = (percent - 100) * GAIN_PERCENT_RANGE_DB / 100.0f;
+    return (uint32_t)(powf(10.0f, db / 20.0f) * AUDIO_GAIN_UNITY + 0.5f);
+}
+
+// 等功率曲线：四分之一周期正弦表（Q15），表项之间线性插值
+#define GAIN_SINE_TABLE_BITS 8
+#define GAIN_SINE_TABLE_SIZE (1 << GAIN_SINE_TABLE_BITS)
+
+static int32_t s_sine_table[GAIN_SINE_TABLE_SIZE + 1];
+static bool s_sine_table_ready = false;
+// 逐帧增益（Q15）乘到一帧的所有通道
+static void gain_apply_frame(uint8_t *p, uint8_t channels, uint8_t bits, int32_t gain)
+{
+    for (uint8_t ch = 0; ch < channels; ch++)
+    {
+        if (bits == 16)
+        {
+            int16_t *s = (int16_t *)p;
+            *s = (int16_t)(((int32_t)*s * gain) >> 15);
+            p += 2;
+        }
+        else if (bits == 24)
+        {
+            int32_t v = (int32_t)((uint32_t)p[0] << 8 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 24) >> 8;
+            v = (int32_t)(((int64_t)v * gain) >> 15);
+            p[0] = (uint8_t)v;
+            p[1] = (uint8_t)(v >> 8);
+            p[2] = (uint8_t)(v >> 16);
+            p += 3;
+        }
+        else
+        {
+            int32_t *s = (int32_t *)p;
+            *s = (int32_t)(((int64_t)*s * gain) >> 15);
+            p += 4;
+        }
+    }
+}
+
+// 增益不变时整块处理
+static void gain_apply_block(uint8_t *p, uint32_t samples, uint8_t bits, int32_t gain)
+{
+    if (gain >= AUDIO_GAIN_UNITY)
+    {
+        return;
+    }
+    if (gain == 0)
+    {
+        memset(p, 0, samples * (bits / 8));
+        return;
+    }
+    if (bits == 16)
+    {
+        audio_simd_scale_s16((int16_t *)p, (int16_t)gain, samples);
+        return;
+    }
+    for (uint32_t i = 0; i < samples; i++)
+    {
+        gain_apply_frame(p, 1, bits, gain);
+        p += bits / 8;
+    }
+}
+
+void audio_gain_process(audio_gain_t *g, uint8_t *data, uint32_t frames, uint8_t channels, uint8_t bits,
+                        uint32_t sample_rate)
+{
+    if (bits != 16 && bits != 24 && bits != 32)
+    {
+        return;
+    }
+    uint32_t request = 0;
+    if (atomic_load(&g->request) != 0)
+    {
+        // 先标记斜坡进行中，再取走请求，查询方不会在两者之间看到已稳定
+        atomic_store(&g->ramping, true);
+        request = atomic_exchange(&g->request, 0);
+    }
+    if (request & GAIN_REQUEST_VALID)
+    {
+        uint32_t target = (request >> GAIN_REQUEST_TARGET_SHIFT) & GAIN_REQUEST_TARGET_MASK;
+        uint32_t ramp_frames = (uint32_t)((uint64_t)(request & GAIN_REQUEST_RAMP_MAX) * sample_rate / 1000);
+        g->target = (int32_t)(target << 15);
+        if (request & GAIN_REQUEST_FROM_ZERO)
+        {
+            g->gain = 0;
+        }
+        if (ramp_frames == 0)
+        {
+            g->gain = g->target;
+            g->ramp_remain = 0;
+        }
+        else
+        {
+            g->step = (g->target - g->gain) / (int32_t)ramp_frames;
+            g->ramp_remain = ramp_frames;
+        }
+    }
+
+    uint32_t frame_bytes = channels * (bits / 8);
+    // 斜坡部分逐帧计算，最后一帧直接落到目标值，消除整除误差
+    while (g->ramp_remain > 0 && frames > 0)
+    {
+        g->gain = g->ramp_remain == 1 ? g->target : g->gain + g->step;
+        g->ramp_remain--;
+        gain_apply_frame(data, channels, bits, g->gain >> 15);
+        data += frame_bytes;
+        frames--;
+    }
+    if (frames > 0)
+    {
+        gain_apply_block(data, frames * channels, bits, g->gain >> 15);
+    }
+    atomic_store(&g->current, (uint32_t)(g->gain >> 15));
+    atomic_store(&g->ramping, g->ramp_remain > 0);
+}
+
+// 淡化位置 t（Q16，0~65536）处的 sin(t * pi / 2)，Q15
+static int32_t gain_sine_q15(uint32_t t)
+{
+    uint32_t idx = t >> (16 - GAIN_SINE_TABLE_BITS);
+    if (idx >= GAIN_SINE_TABLE_SIZE)
+    {
+        return s_sine_table[GAIN_SINE_TABLE_SIZE];
+    }
+    uint32_t frac = t & ((1 << (16 - GAIN_SINE_TABLE_BITS)) - 1);
+    int32_t a = s_sine_table[idx];
+    int32_t b = s_sine_table[idx + 1];
+    return a + (((b - a) * (int32_t)frac) >> (16 - GAIN_SINE_TABLE_BITS));
+}
+
+void audio_gain_crossfade_s16(int16_t *a, const int16_t *b, uint32_t frames, uint8_t channels, uint32_t pos,
+                              uint32_t len)
+{
+    if (!s_sine_table_ready)
+    {
+        for (int i = 0; i <= GAIN_SINE_TABLE_SIZE; i++)
+        {
+            s_sine_table[i] = (int32_t)(sinf((float)i / GAIN_SINE_TABLE_SIZE * (float)M_PI / 2) * AUDIO_GAIN_UNITY + 0.5f);
+        }
+        s_sine_table_ready = true;
+    }
+    for (uint32_t i = 0; i < frames; i++, pos++)
+    {
+        int32_t gain_in = AUDIO_GAIN_UNITY;
+        int32_t gain_out = 0;
+        if (pos < len)
+        {
+            uint32_t t = (uint32_t)(((uint64_t)pos << 16) / len);
+            gain_in = gain_sine_q15(t);
+            gain_out = gain_sine_q15(65536 - t);
+        }
+        for (uint8_t ch = 0; ch < channels; ch++)
+        {
+            int32_t v = ((int32_t)*a * gain_out + (int32_t)*b * gain_in) >> 15;
+            *a = (int16_t)(v > INT16_MAX ? INT16_MAX : (v < INT16_MIN ? INT16_MIN : v));
+            a++;
+            b++;
+        }
+    }
+}
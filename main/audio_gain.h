@@ -0,0 +1,98 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief PCM 域增益
+ *
+ * 音量、静音和淡入淡出都在写给 USB 之前的 PCM 上完成，不再发送控制传输。
+ * 增益变化按帧线性过渡（斜坡），斜坡期间逐帧计算；增益稳定后整块相乘，
+ * 16 位样本使用 PIE 向量内核，增益为 1 时直接跳过，为 0 时清零。
+ *
+ * audio_gain_set 可以在任意任务中调用，请求在下一次 audio_gain_process 时生效；
+ * audio_gain_process 只能在一个任务中调用（播放任务）。
+ */
+
+// Q15 增益 1.0
+#define AUDIO_GAIN_UNITY 32768
+
+/**
+ * @brief 增益状态
+ */
+typedef struct
+{
+    atomic_uint request;    // 等待生效的请求：有效位 | 目标增益 | 斜坡时长
+    atomic_uint current;    // 当前增益（Q15），供其他任务查询
+    atomic_bool ramping;    // 斜坡是否进行中
+    // 仅处理任务访问
+    int32_t gain;           // 当前增益（Q30），斜坡时逐帧累加
+    int32_t target;         // 目标增益（Q30）
+    int32_t step;           // 每帧增量（Q30）
+    uint32_t ramp_remain;   // 剩余斜坡帧数
+} audio_gain_t;
+
+/**
+ * @brief 初始化，增益立即设为 gain_q15
+ */
+void audio_gain_init(audio_gain_t *g, uint32_t gain_q15);
+
+/**
+ * @brief 在 ramp_ms 内过渡到 target_q15（0 ~ AUDIO_GAIN_UNITY），ramp_ms 为 0 时立即生效
+ */
+void audio_gain_set(audio_gain_t *g, uint32_t target_q15, uint32_t ramp_ms);
+
+/**
+ * @brief 增益先置 0，再在 ramp_ms 内升到 target_q15（开始播放时的淡入）
+ */
+void audio_gain_fade_in(audio_gain_t *g, uint32_t target_q15, uint32_t ramp_ms);
+
+/**
+ * @brief 当前增益（Q15）
+ */
+uint32_t audio_gain_get(audio_gain_t *g);
+
+/**
+ * @brief 是否已到达目标增益（没有等待生效的请求，斜坡已结束）
+ */
+bool audio_gain_is_settled(audio_gain_t *g);
+
+/**
+ * @brief 音量百分比换算为 Q15 增益：按 dB 线性（0~100 对应 -60~0 dB），0 为静音
+ */
+uint32_t audio_gain_from_percent(uint8_t percent);
+
+/**
+ * @brief 对交错 PCM 原地施加增益
+ *
+ * @param[in]     g           增益状态
+ * @param[in,out] data        PCM 数据
+ * @param[in]     frames      帧数
+ * @param[in]     channels    通道数
+ * @param[in]     bits        位深度（16、24 或 32）
+ * @param[in]     sample_rate 采样率，用于把斜坡时长换算为帧数
+ */
+void audio_gain_process(audio_gain_t *g, uint8_t *data, uint32_t frames, uint8_t channels, uint8_t bits,
+                        uint32_t sample_rate);
+
+/**
+ * @brief 等功率交叉淡化：a 按 cos 曲线淡出，b 按 sin 曲线淡入，结果写回 a（16 位交错 PCM）
+ *
+ * @param[in,out] a        淡出的曲目，输出
+ * @param[in]     b        淡入的曲目
+ * @param[in]     frames   帧数
+ * @param[in]     channels 通道数
+ * @param[in]     pos      第一帧在淡化过程中的位置（帧），超过 len 的帧直接取 b
+ * @param[in]     len      淡化总长度（帧）
+ */
+void audio_gain_crossfade_s16(int16_t *a, const int16_t *b, uint32_t frames, uint8_t channels, uint32_t pos,
+                              uint32_t len);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,166 @@
+#include "audio_gapless.h"
+
+#include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include "audio_probe.h"
+
+// 查找第一个 MP3 帧时最多扫描的字节数（ID3v2 标签之后）
+#define MP3_SYNC_SEARCH_LEN 4096
+// iTunSMPB 标签名之后到数值文本之间最多允许的字节数（ID3 COMM 帧头或 MP4 data 原子头）
+#define ITUNSMPB_TEXT_SEARCH_LEN 32
+
+static uint32_t read_be32(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+/*
+ * Xing/Info 帧：帧头 + 边信息之后是 "Xing"/"Info" 标识、标志位和可选的帧数/字节数/TOC/质量字段，
+ * 其后的 LAME 扩展第 21~23 字节是 12 位编码器延迟和 12 位填充。
+ */
+static bool mp3_parse_info_frame(const uint8_t *buf, size_t len, audio_gapless_info_t *info)
+{
+    size_t pos = audio_probe_id3v2_size(buf, len);
+    size_t end = pos + MP3_SYNC_SEARCH_LEN;
+    if (end > len)
+    {
+        end = len;
+    }
+    audio_probe_frame_t frame;
+    while (pos + 4 <= end && !audio_probe_mp3_frame(buf + pos, &frame))
+    {
+        pos++;
+    }
+    if (pos + 4 > end || pos + frame.frame_len > len)
+    {
+        return false;
+    }
+
+    const uint8_t *p = buf + pos + 4 + frame.side_len;
+    const uint8_t *frame_end = buf + pos + frame.frame_len;
+    if (p + 8 > frame_end || (memcmp(p, "Xing", 4) != 0 && memcmp(p, "Info", 4) != 0))
+    {
+        return false;
+    }
+    // Xing/Info 帧本身不含音频，解码前整帧跳过
+    info->skip_bytes = pos + frame.frame_len;
+
+    uint32_t flags = read_be32(p + 4);
+    uint32_t frames = 0;
+    p += 8;
+    if (flags & 0x01)
+    {
+        if (p + 4 > frame_end)
+        {
+            return false;
+        }
+        frames = read_be32(p);
+        p += 4;
+    }
+    p += ((flags & 0x02) ? 4 : 0) + ((flags & 0x04) ? 100 : 0) + ((flags & 0x08) ? 4 : 0);
+
+    // LAME 扩展以编码器名开头（"LAME"、"Lavc" 等）
+    if (p + 24 > frame_end || !isalpha(p[0]) || !isalpha(p[1]) || !isalpha(p[2]) || !isalpha(p[3]))
+    {
+        return false;
+    }
+    uint32_t enc_delay = ((uint32_t)p[21] << 4) | (p[22] >> 4);
+    uint32_t enc_padding = ((uint32_t)(p[22] & 0x0F) << 8) | p[23];
+
+    info->source = AUDIO_GAPLESS_SOURCE_LAME;
+    info->delay = enc_delay + AUDIO_GAPLESS_MP3_DECODER_DELAY;
+    info->padding = enc_padding;
+    if (frames > 0 && (uint64_t)frames * frame.samples > enc_delay + enc_padding)
+    {
+        info->total_frames = (uint64_t)frames * frame.samples - enc_delay - enc_padding;
+    }
+    return true;
+}
+
+/*
+ * iTunSMPB 文本格式为 " 00000000 DDDDDDDD PPPPPPPP NNNNNNNNNNNNNNNN ..."（十六进制），
+ * 依次为保留字段、延迟、填充和有效采样数。
+ */
+static bool parse_itunsmpb(const uint8_t *buf, size_t len, bool is_mp3, audio_gapless_info_t *info)
+{
+    static const char tag[] = "iTunSMPB";
+    const size_t tag_len = sizeof(tag) - 1;
+    const uint8_t *p = NULL;
+    for (size_t i = 0; i + tag_len <= len; i++)
+    {
+        if (buf[i] == 'i' && memcmp(buf + i, tag, tag_len) == 0)
+        {
+            p = buf + i + tag_len;
+            break;
+        }
+    }
+    if (p == NULL)
+    {
+        return false;
+    }
+
+    // 跳过帧头/原子头，找到 " 0" 开头的数值文本
+    const uint8_t *limit = p + ITUNSMPB_TEXT_SEARCH_LEN;
+    while (p + 1 < buf + len && p < limit && !(p[0] == ' ' && isxdigit(p[1])))
+    {
+        p++;
+    }
+    if (p + 1 >= buf + len || p >= limit)
+    {
+        return false;
+    }
+
+    char text[64];
+    size_t n = (size_t)(buf + len - p);
+    if (n > sizeof(text) - 1)
+    {
+        n = sizeof(text) - 1;
+    }
+    memcpy(text, p, n);
+    text[n] = '\0';
+    return audio_gapless_parse_itunsmpb(text, is_mp3, info);
+}
+
+bool audio_gapless_parse_itunsmpb(const char *text, bool is_mp3, audio_gapless_info_t *info)
+{
+    const char *s = text;
+    unsigned long long fields[4];
+    for (int i = 0; i < 4; i++)
+    {
+        char *e;
+        fields[i] = strtoull(s, &e, 16);
+        if (e == s)
+        {
+            return false;
+        }
+        s = e;
+    }
+
+    info->source = AUDIO_GAPLESS_SOURCE_ITUNSMPB;
+    // MP3 的延迟与 LAME 一样只包含编码器延迟，AAC 的延迟已包含解码器预滚
+    info->delay = (uint32_t)fields[1] + (is_mp3 ? AUDIO_GAPLESS_MP3_DECODER_DELAY : 0);
+    info->padding = (uint32_t)fields[2];
+    info->total_frames = fields[3];
+    return true;
+}
+
+bool audio_gapless_parse(const uint8_t *buf, size_t len, bool is_mp3, audio_gapless_info_t *info)
+{
+    memset(info, 0, sizeof(*info));
+    if (buf == NULL)
+    {
+        return false;
+    }
+    // LAME 信息最准确，优先使用；iTunSMPB 在 ID3v2 标签或 MP4 ilst 中
+    if (is_mp3 && mp3_parse_info_frame(buf, len, info))
+    {
+        return true;
+    }
+    size_t tag_len = audio_probe_id3v2_size(buf, len);
+    if (is_mp3 && tag_len == 0)
+    {
+        return false;
+    }
+    return parse_itunsmpb(buf, (tag_len > 0 && tag_len < len) ? tag_len : len, is_mp3, info);
+}
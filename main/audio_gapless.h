@@ -0,0 +1,66 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 无缝播放所需的编码器延迟/填充信息
+ *
+ * 从文件开头的数据中解析 LAME/Xing Info 帧或 iTunSMPB 标签，得到解码输出开头
+ * 需要丢弃的帧数和曲目的有效帧数，使相邻曲目可以按采样精确拼接。
+ */
+
+/**
+ * @brief 信息来源
+ */
+typedef enum
+{
+    AUDIO_GAPLESS_SOURCE_NONE = 0, // 没有找到
+    AUDIO_GAPLESS_SOURCE_LAME,     // MP3 Xing/Info 帧中的 LAME 扩展
+    AUDIO_GAPLESS_SOURCE_ITUNSMPB, // iTunes 的 iTunSMPB 标签
+} audio_gapless_source_t;
+
+/**
+ * @brief 解析结果
+ */
+typedef struct
+{
+    audio_gapless_source_t source;
+    uint32_t delay;         // 解码输出开头需要丢弃的帧数（已包含解码器延迟）
+    uint32_t padding;       // 编码器在末尾填充的帧数
+    uint64_t total_frames;  // 曲目的有效帧数，0 表示未知（不裁剪末尾）
+    uint32_t skip_bytes;    // 送入解码器前需要跳过的字节数（ID3v2 标签和 Xing/Info 帧），0 表示不跳过
+} audio_gapless_info_t;
+
+// MP3 解码器（Layer III 合成滤波器组）固有的输出延迟
+#define AUDIO_GAPLESS_MP3_DECODER_DELAY 529
+
+/**
+ * @brief 从文件开头的数据中解析编码器延迟/填充
+ *
+ * @param[in]  buf    文件开头的数据
+ * @param[in]  len    数据长度
+ * @param[in]  is_mp3 是否为 MP3 文件（只有 MP3 才查找 Xing/Info 帧）
+ * @param[out] info   解析结果，没有找到时 source 为 AUDIO_GAPLESS_SOURCE_NONE
+ * @return 是否找到延迟/填充信息
+ */
+bool audio_gapless_parse(const uint8_t *buf, size_t len, bool is_mp3, audio_gapless_info_t *info);
+
+/**
+ * @brief 解析 iTunSMPB 文本（例如从 ID3v2 COMM 帧中读出的内容）
+ *
+ * @param[in]  text   iTunSMPB 文本
+ * @param[in]  is_mp3 是否为 MP3 文件（MP3 需要加上解码器延迟）
+ * @param[out] info   解析结果，只修改延迟/填充/有效帧数和来源
+ * @return 是否解析成功
+ */
+bool audio_gapless_parse_itunsmpb(const char *text, bool is_mp3, audio_gapless_info_t *info);
+
+#ifdef __cplusplus
+}
+#endif
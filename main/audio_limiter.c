@@ -0,0 +1,272 @@
+#include "audio_limiter.h"
+
+#include <string.h>
+#include <math.h>
+#include <stdatomic.h>
+#include "esp_heap_caps.h"
+#include "audio_simd.h"
+
+#define LIMITER_UNITY 32768
+// 前瞻块数的上限
+#define LIMITER_DEPTH_MAX \
+    ((AUDIO_LIMITER_LOOKAHEAD_MAX_MS * AUDIO_LIMITER_RATE_MAX / 1000 + AUDIO_LIMITER_BLOCK - 1) / AUDIO_LIMITER_BLOCK)
+// 延迟线比前瞻多一块：一块的峰值算完后，它之前第 depth 块的增益曲线才确定
+#define LIMITER_RING_FRAMES ((LIMITER_DEPTH_MAX + 1) * AUDIO_LIMITER_BLOCK)
+// 样本峰值低于上限 3 dB 时，采样点之间的峰值实际上不会超过上限，不再做过采样
+#define LIMITER_TP_MARGIN 23170
+
+struct audio_limiter
+{
+    int16_t ring[LIMITER_RING_FRAMES * AUDIO_LIMITER_CHANNEL_MAX] __attribute__((aligned(AUDIO_SIMD_ALIGN)));
+    int32_t need[LIMITER_DEPTH_MAX + 1];    // 最近 depth + 1 块各自需要的增益（Q15）
+    uint32_t lookahead_ms;
+    uint32_t release_ms;
+    int32_t ceiling;                        // 真峰值上限（16 位样本值）
+    // 随格式变化
+    uint8_t channels;
+    uint32_t sample_rate;
+    uint32_t depth;                         // 前瞻块数
+    uint32_t ring_frames;
+    int32_t release_coef;                   // 每块向目标恢复的比例（Q15）
+    uint32_t pos;                           // 延迟线读写位置（帧），读出旧样本后写入新样本
+    uint32_t block_count;                   // 已计算峰值的块数
+    int32_t gain_start;                     // 正在输出的块起点和终点的增益（Q15）
+    int32_t gain_end;
+    // 统计
+    uint32_t sec_frames;
+    uint32_t sec_limited;
+    int32_t sec_min_gain;
+    atomic_uint stat_limited;
+    atomic_uint stat_min_gain;
+    atomic_uint stat_limited_seconds;
+    atomic_uint stat_seconds;
+};
+
+esp_err_t audio_limiter_create(const audio_limiter_config_t *config, audio_limiter_handle_t *limiter)
+{
+    if (config == NULL || limiter == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    // 在播放任务中逐样本访问，放在内部 RAM
+    struct audio_limiter *l = heap_caps_aligned_calloc(AUDIO_SIMD_ALIGN, 1, sizeof(struct audio_limiter),
+                                                       MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (l == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    uint32_t ms = config->lookahead_ms;
+    l->lookahead_ms = ms < AUDIO_LIMITER_LOOKAHEAD_MIN_MS   ? AUDIO_LIMITER_LOOKAHEAD_MIN_MS
+                      : ms > AUDIO_LIMITER_LOOKAHEAD_MAX_MS ? AUDIO_LIMITER_LOOKAHEAD_MAX_MS
+                                                            : ms;
+    l->release_ms = config->release_ms > 0 ? config->release_ms : 1;
+    float ceiling = 32767.0f * powf(10.0f, config->ceiling_db / 20.0f);
+    l->ceiling = ceiling > 32767.0f ? 32767 : (ceiling < 1.0f ? 1 : (int32_t)ceiling);
+    atomic_init(&l->stat_limited, 0);
+    atomic_init(&l->stat_min_gain, LIMITER_UNITY);
+    atomic_init(&l->stat_limited_seconds, 0);
+    atomic_init(&l->stat_seconds, 0);
+    *limiter = l;
+    return ESP_OK;
+}
+
+void audio_limiter_delete(audio_limiter_handle_t limiter)
+{
+    heap_caps_free(limiter);
+}
+
+// 新格式：按采样率计算前瞻块数，清空延迟线
+static void limiter_configure(struct audio_limiter *l, uint8_t channels, uint32_t sample_rate)
+{
+    uint32_t frames = l->lookahead_ms * sample_rate / 1000;
+    uint32_t depth = (frames + AUDIO_LIMITER_BLOCK - 1) / AUDIO_LIMITER_BLOCK;
+    l->depth = depth < 1 ? 1 : (depth > LIMITER_DEPTH_MAX ? LIMITER_DEPTH_MAX : depth);
+    l->ring_frames = (l->depth + 1) * AUDIO_LIMITER_BLOCK;
+    l->channels = channels;
+    l->sample_rate = sample_rate;
+    double coef = 1.0 - exp(-(double)AUDIO_LIMITER_BLOCK * 1000.0 / ((double)sample_rate * l->release_ms));
+    l->release_coef = (int32_t)(coef * LIMITER_UNITY) > 0 ? (int32_t)(coef * LIMITER_UNITY) : 1;
+    memset(l->ring, 0, sizeof(l->ring));
+    for (uint32_t i = 0; i <= LIMITER_DEPTH_MAX; i++)
+    {
+        l->need[i] = LIMITER_UNITY;
+    }
+    l->pos = 0;
+    l->block_count = 0;
+    l->gain_start = LIMITER_UNITY;
+    l->gain_end = LIMITER_UNITY;
+    l->sec_frames = 0;
+    l->sec_limited = 0;
+    l->sec_min_gain = LIMITER_UNITY;
+}
+
+// 块内（加上前一块末尾三帧）采样点之间的峰值：相邻六点半带插值的中点
+// 系数 [54, -263, 1240, 1240, -263, 54] / 2048 在 0 到 fs/4 之间的增益为 1.000 到 1.007，
+// 不会低估这一频段内正弦的真峰值（四点三次插值在 fs/4 处低估 1.07 dB）
+static int32_t limiter_inter_sample_peak(const struct audio_limiter *l, uint32_t start)
+{
+    const uint8_t ch = l->channels;
+    int32_t peak = 0;
+    for (uint8_t c = 0; c < ch; c++)
+    {
+        int32_t s[AUDIO_LIMITER_BLOCK + 5];
+        for (uint32_t i = 0; i < AUDIO_LIMITER_BLOCK + 5; i++)
+        {
+            uint32_t f = (start + l->ring_frames + i - 5) % l->ring_frames;
+            s[i] = l->ring[f * ch + c];
+        }
+        for (uint32_t i = 0; i < AUDIO_LIMITER_BLOCK; i++)
+        {
+            int32_t mid = (54 * (s[i] + s[i + 5]) - 263 * (s[i + 1] + s[i + 4]) + 1240 * (s[i + 2] + s[i + 3])) >> 11;
+            mid = mid < 0 ? -mid : mid;
+            peak = mid > peak ? mid : peak;
+        }
+    }
+    return peak;
+}
+
+// 一块写满：求出它需要的增益，确定 depth 块之前那一块终点的增益
+static void limiter_block_done(struct audio_limiter *l, uint32_t start)
+{
+    const int16_t *block = &l->ring[start * l->channels];
+    int32_t peak = audio_simd_peak_s16(block, AUDIO_LIMITER_BLOCK * l->channels);
+    if (peak > (l->ceiling * LIMITER_TP_MARGIN >> 15))
+    {
+        int32_t inter = limiter_inter_sample_peak(l, start);
+        peak = inter > peak ? inter : peak;
+    }
+    uint32_t n = l->depth + 1;
+    uint32_t j = l->block_count++;
+    l->need[j % n] = peak <= l->ceiling ? LIMITER_UNITY : (l->ceiling << 15) / peak;
+
+    // 第 j - depth 块终点的增益：不超过它自己和之后 depth - 1 块的需要；
+    // 起音斜坡：对终点之后 dist 块的峰值，增益从 dist = depth 处的 1 沿直线降到 dist = 0 处的需要值
+    int32_t target = LIMITER_UNITY;
+    for (uint32_t d = 0; d < n; d++)
+    {
+        int32_t need = l->need[(j + n - d) % n];
+        // d 为到第 j 块的距离，换算为到终点（第 j - depth + 1 块的起点）的距离
+        int32_t dist = (int32_t)l->depth - 1 - (int32_t)d;
+        int32_t c = dist <= 0 ? need : need + (LIMITER_UNITY - need) * dist / (int32_t)l->depth;
+        target = c < target ? c : target;
+    }
+    int32_t gain = l->gain_end;
+    if (target <= gain)
+    {
+        gain = target;
+    }
+    else
+    {
+        // 释放：指数接近目标，至少前进 1
+        int32_t step = (target - gain) * l->release_coef >> 15;
+        gain += step > 0 ? step : 1;
+    }
+    l->gain_start = l->gain_end;
+    l->gain_end = gain;
+}
+
+// 对从延迟线读出的 n 帧施加增益，offset 为它们在块内的位置
+static void limiter_apply(struct audio_limiter *l, int16_t *data, uint32_t offset, uint32_t n)
+{
+    const uint8_t ch = l->channels;
+    int32_t g0 = l->gain_start;
+    int32_t g1 = l->gain_end;
+    if (g0 >= LIMITER_UNITY && g1 >= LIMITER_UNITY)
+    {
+        return;
+    }
+    if (g0 == g1)
+    {
+        audio_simd_scale_s16(data, (int16_t)g0, n * ch);
+        l->sec_limited += n * ch;
+        l->sec_min_gain = g0 < l->sec_min_gain ? g0 : l->sec_min_gain;
+        return;
+    }
+    for (uint32_t i = 0; i < n; i++)
+    {
+        int32_t g = g0 + (g1 - g0) * (int32_t)(offset + i) / AUDIO_LIMITER_BLOCK;
+        if (g >= LIMITER_UNITY)
+        {
+            data += ch;
+            continue;
+        }
+        for (uint8_t c = 0; c < ch; c++, data++)
+        {
+            *data = (int16_t)(((int32_t)*data * g) >> 15);
+        }
+        l->sec_limited += ch;
+        l->sec_min_gain = g < l->sec_min_gain ? g : l->sec_min_gain;
+    }
+}
+
+// 每满一秒发布一次统计
+static void limiter_count(struct audio_limiter *l, uint32_t frames)
+{
+    l->sec_frames += frames;
+    if (l->sec_frames < l->sample_rate)
+    {
+        return;
+    }
+    atomic_store(&l->stat_limited, l->sec_limited);
+    atomic_store(&l->stat_min_gain, (uint32_t)l->sec_min_gain);
+    atomic_fetch_add(&l->stat_seconds, 1);
+    if (l->sec_limited > 0)
+    {
+        atomic_fetch_add(&l->stat_limited_seconds, 1);
+    }
+    l->sec_frames -= l->sample_rate;
+    l->sec_limited = 0;
+    l->sec_min_gain = LIMITER_UNITY;
+}
+
+void audio_limiter_process(audio_limiter_handle_t limiter, int16_t *data, uint32_t frames, uint8_t channels,
+                           uint32_t sample_rate)
+{
+    struct audio_limiter *l = limiter;
+    if (channels == 0 || channels > AUDIO_LIMITER_CHANNEL_MAX || sample_rate == 0 || sample_rate > AUDIO_LIMITER_RATE_MAX)
+    {
+        return;
+    }
+    if (channels != l->channels || sample_rate != l->sample_rate)
+    {
+        limiter_configure(l, channels, sample_rate);
+    }
+    limiter_count(l, frames);
+    int16_t tmp[AUDIO_LIMITER_BLOCK * AUDIO_LIMITER_CHANNEL_MAX];
+    while (frames > 0)
+    {
+        // 每次处理到块边界为止：与延迟线交换数据，再对读出的样本施加增益
+        uint32_t offset = l->pos % AUDIO_LIMITER_BLOCK;
+        uint32_t n = AUDIO_LIMITER_BLOCK - offset < frames ? AUDIO_LIMITER_BLOCK - offset : frames;
+        uint32_t bytes = n * channels * sizeof(int16_t);
+        int16_t *slot = &l->ring[l->pos * channels];
+        memcpy(tmp, slot, bytes);
+        memcpy(slot, data, bytes);
+        memcpy(data, tmp, bytes);
+        limiter_apply(l, data, offset, n);
+        data += n * channels;
+        frames -= n;
+        l->pos += n;
+        if (l->pos % AUDIO_LIMITER_BLOCK == 0)
+        {
+            limiter_block_done(l, l->pos - AUDIO_LIMITER_BLOCK);
+            if (l->pos == l->ring_frames)
+            {
+                l->pos = 0;
+            }
+        }
+    }
+}
+
+uint32_t audio_limiter_get_latency_frames(audio_limiter_handle_t limiter)
+{
+    return limiter->ring_frames;
+}
+
+void audio_limiter_get_stats(audio_limiter_handle_t limiter, audio_limiter_stats_t *stats)
+{
+    stats->limited_per_sec = atomic_load(&limiter->stat_limited);
+    stats->max_reduction_db = -20.0f * log10f(atomic_load(&limiter->stat_min_gain) / (float)LIMITER_UNITY);
+    stats->limited_seconds = atomic_load(&limiter->stat_limited_seconds);
+    stats->total_seconds = atomic_load(&limiter->stat_seconds);
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 前瞻峰值限制器
+ *
+ * 输出延迟 look-ahead 时长，增益在峰值到达之前沿直线降到所需值，释放时按指数曲线恢复，
+ * 输出的真峰值不超过设定的上限。包络按 AUDIO_LIMITER_BLOCK 帧的小块计算：块内的样本峰值
+ * 由 PIE 向量内核求出（audio_simd_peak_s16），接近上限的块再用 2 倍过采样（六点半带插值的中点）
+ * 估计采样点之间的峰值；增益在块边界之间线性插值。
+ *
+ * 统计最近一秒内被衰减的样本数，用于调整前级的增益分配。
+ *
+ * audio_limiter_process 只能在一个任务中调用（播放任务），audio_limiter_get_stats 可以在任意任务中调用。
+ */
+
+// 前瞻时长范围
+#define AUDIO_LIMITER_LOOKAHEAD_MIN_MS 1
+#define AUDIO_LIMITER_LOOKAHEAD_MAX_MS 5
+// 包络计算的块大小（帧）
+#define AUDIO_LIMITER_BLOCK 16
+// 支持的最高采样率和最多通道数，决定延迟线的大小
+#define AUDIO_LIMITER_RATE_MAX 192000
+#define AUDIO_LIMITER_CHANNEL_MAX 2
+
+typedef struct
+{
+    uint32_t lookahead_ms; // 前瞻时长，延迟为它按块向上取整再多一块（audio_limiter_get_latency_frames）
+    uint32_t release_ms;   // 增益恢复的时间常数
+    float ceiling_db;      // 真峰值上限（dBFS）
+} audio_limiter_config_t;
+
+typedef struct
+{
+    uint32_t limited_per_sec;  // 最近一秒内被衰减的样本数（各通道分别计数）
+    float max_reduction_db;    // 最近一秒内的最大衰减（dB）
+    uint32_t limited_seconds;  // 出现过衰减的秒数
+    uint32_t total_seconds;    // 处理过的总秒数
+} audio_limiter_stats_t;
+
+typedef struct audio_limiter *audio_limiter_handle_t;
+
+/**
+ * @brief 创建限制器
+ *
+ * @param[in]  config  配置，lookahead_ms 超出范围时取最近的边界
+ * @param[out] limiter 限制器句柄
+ */
+esp_err_t audio_limiter_create(const audio_limiter_config_t *config, audio_limiter_handle_t *limiter);
+
+/**
+ * @brief 删除限制器
+ */
+void audio_limiter_delete(audio_limiter_handle_t limiter);
+
+/**
+ * @brief 对 16 位交错 PCM 原地限幅，输出比输入延迟 audio_limiter_get_latency_frames 帧
+ *
+ * @param[in]     limiter     限制器句柄
+ * @param[in,out] data        PCM 数据
+ * @param[in]     frames      帧数
+ * @param[in]     channels    通道数（1 或 2）
+ * @param[in]     sample_rate 采样率，通道数或采样率改变时清空延迟线
+ */
+void audio_limiter_process(audio_limiter_handle_t limiter, int16_t *data, uint32_t frames, uint8_t channels,
+                           uint32_t sample_rate);
+
+/**
+ * @brief 当前配置下的延迟（帧）
+ */
+uint32_t audio_limiter_get_latency_frames(audio_limiter_handle_t limiter);
+
+/**
+ * @brief 取得统计信息
+ */
+void audio_limiter_get_stats(audio_limiter_handle_t limiter, audio_limiter_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
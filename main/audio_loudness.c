@@ -0,0 +1,255 @@
+#include "audio_loudness.h"
+
+#include <math.h>
+#include <string.h>
+#include "esp_heap_caps.h"
+#include "audio_mem.h"
+
+// 块响度分箱：-70 ~ +10 LUFS，每箱 0.1 LU
+#define LOUDNESS_HIST_MIN -70.0
+#define LOUDNESS_HIST_STEP 0.1
+#define LOUDNESS_HIST_BINS 800
+// 400 ms 块由 4 个 100 ms 子块组成（75% 重叠）
+#define LOUDNESS_SUB_BLOCKS 4
+// 相对门限
+#define LOUDNESS_RELATIVE_GATE -10.0
+// 真峰值过采样
+#define LOUDNESS_TP_FACTOR 4
+#define LOUDNESS_TP_TAPS 12
+#define LOUDNESS_MAX_CHANNELS 2
+
+typedef struct
+{
+    double b[3];
+    double a[3];
+} loudness_biquad_t;
+
+struct audio_loudness
+{
+    uint8_t channels;
+    uint32_t sub_len;                                           // 每个子块的帧数
+    loudness_biquad_t shelf;                                    // K 加权第一级：高频搁架
+    loudness_biquad_t hpf;                                      // K 加权第二级：高通
+    double state[LOUDNESS_MAX_CHANNELS][2][4];                  // 两级滤波器状态 x1, x2, y1, y2
+    double sub_energy[LOUDNESS_SUB_BLOCKS];                     // 最近 4 个子块的平方和
+    uint32_t sub_count;                                         // 已完成的子块数
+    uint32_t sub_pos;                                           // 当前子块已累计的帧数
+    double sub_acc;
+    uint32_t hist_count[LOUDNESS_HIST_BINS];
+    double hist_energy[LOUDNESS_HIST_BINS];
+    float tp_coef[LOUDNESS_TP_FACTOR][LOUDNESS_TP_TAPS];
+    float tp_hist[LOUDNESS_MAX_CHANNELS][LOUDNESS_TP_TAPS];
+    float peak;                                                 // 线性真峰值（满量程为 1）
+};
+
+// 按 BS.1770 的模拟原型在任意采样率下计算 K 加权滤波器
+static void loudness_k_weighting(struct audio_loudness *m, uint32_t sample_rate)
+{
+    double K = tan(M_PI * 1681.974450955533 / sample_rate);
+    double Q = 0.7071752369554196;
+    double Vh = pow(10.0, 3.999843853973347 / 20.0);
+    double Vb = pow(Vh, 0.4996667741545416);
+    double a0 = 1.0 + K / Q + K * K;
+    m->shelf.b[0] = (Vh + Vb * K / Q + K * K) / a0;
+    m->shelf.b[1] = 2.0 * (K * K - Vh) / a0;
+    m->shelf.b[2] = (Vh - Vb * K / Q + K * K) / a0;
+    m->shelf.a[1] = 2.0 * (K * K - 1.0) / a0;
+    m->shelf.a[2] = (1.0 - K / Q + K * K) / a0;
+
+    K = tan(M_PI * 38.13547087602444 / sample_rate);
+    Q = 0.5003270373238773;
+    a0 = 1.0 + K / Q + K * K;
+    m->hpf.b[0] = 1.0;
+    m->hpf.b[1] = -2.0;
+    m->hpf.b[2] = 1.0;
+    m->hpf.a[1] = 2.0 * (K * K - 1.0) / a0;
+    m->hpf.a[2] = (1.0 - K / Q + K * K) / a0;
+}
+
+// 4 倍过采样的插值滤波器：Hann 窗 sinc，截止频率为原始奈奎斯特频率
+static void loudness_tp_design(struct audio_loudness *m)
+{
+    const int len = LOUDNESS_TP_FACTOR * LOUDNESS_TP_TAPS;
+    for (int n = 0; n < len; n++)
+    {
+        double t = (n - (len - 1) / 2.0) / LOUDNESS_TP_FACTOR;
+        double sinc = t == 0.0 ? 1.0 : sin(M_PI * t) / (M_PI * t);
+        double w = 0.5 - 0.5 * cos(2.0 * M_PI * (n + 0.5) / len);
+        m->tp_coef[n % LOUDNESS_TP_FACTOR][n / LOUDNESS_TP_FACTOR] = (float)(sinc * w);
+    }
+}
+
+esp_err_t audio_loudness_create(uint32_t sample_rate, uint8_t channels, audio_loudness_handle_t *meter)
+{
+    if (meter == NULL || sample_rate < 8000 || channels == 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    struct audio_loudness *m = audio_mem_calloc(AUDIO_MEM_BULK, sizeof(struct audio_loudness));
+    if (m == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    m->channels = channels;
+    m->sub_len = sample_rate / 10;
+    loudness_k_weighting(m, sample_rate);
+    loudness_tp_design(m);
+    *meter = m;
+    return ESP_OK;
+}
+
+void audio_loudness_delete(audio_loudness_handle_t meter)
+{
+    heap_caps_free(meter);
+}
+
+static inline double loudness_biquad(const loudness_biquad_t *f, double *s, double x)
+{
+    double y = f->b[0] * x + f->b[1] * s[0] + f->b[2] * s[1] - f->a[1] * s[2] - f->a[2] * s[3];
+    s[1] = s[0];
+    s[0] = x;
+    s[3] = s[2];
+    s[2] = y;
+    return y;
+}
+
+static inline float loudness_sample(const uint8_t *p, uint8_t bits)
+{
+    if (bits == 16)
+    {
+        return (int16_t)(p[0] | p[1] << 8) / 32768.0f;
+    }
+    if (bits == 24)
+    {
+        return ((int32_t)((uint32_t)p[0] << 8 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 24) >> 8) / 8388608.0f;
+    }
+    return (int32_t)((uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24) / 2147483648.0f;
+}
+
+// 一个 400 ms 块结束，按块响度计入分箱
+static void loudness_block_done(struct audio_loudness *m)
+{
+    double energy = 0.0;
+    for (int i = 0; i < LOUDNESS_SUB_BLOCKS; i++)
+    {
+        energy += m->sub_energy[i];
+    }
+    energy /= (double)m->sub_len * LOUDNESS_SUB_BLOCKS;
+    if (energy <= 0.0)
+    {
+        return;
+    }
+    double lufs = -0.691 + 10.0 * log10(energy);
+    if (lufs < LOUDNESS_HIST_MIN)
+    {
+        return;
+    }
+    int bin = (int)((lufs - LOUDNESS_HIST_MIN) / LOUDNESS_HIST_STEP);
+    if (bin >= LOUDNESS_HIST_BINS)
+    {
+        bin = LOUDNESS_HIST_BINS - 1;
+    }
+    m->hist_count[bin]++;
+    m->hist_energy[bin] += energy;
+}
+
+void audio_loudness_add(audio_loudness_handle_t meter, const uint8_t *data, uint32_t frames, uint8_t bits)
+{
+    struct audio_loudness *m = meter;
+    if (bits != 16 && bits != 24 && bits != 32)
+    {
+        return;
+    }
+    uint32_t sample_bytes = bits / 8;
+    for (uint32_t i = 0; i < frames; i++)
+    {
+        for (uint8_t ch = 0; ch < m->channels; ch++)
+        {
+            float x = loudness_sample(data, bits);
+            data += sample_bytes;
+            uint8_t c = ch < LOUDNESS_MAX_CHANNELS ? ch : LOUDNESS_MAX_CHANNELS - 1;
+            double y = loudness_biquad(&m->shelf, m->state[c][0], x);
+            y = loudness_biquad(&m->hpf, m->state[c][1], y);
+            m->sub_acc += y * y;
+
+            // 真峰值只看前两个通道
+            if (ch >= LOUDNESS_MAX_CHANNELS)
+            {
+                continue;
+            }
+            float *h = m->tp_hist[ch];
+            memmove(h + 1, h, (LOUDNESS_TP_TAPS - 1) * sizeof(float));
+            h[0] = x;
+            for (int p = 0; p < LOUDNESS_TP_FACTOR; p++)
+            {
+                float acc = 0.0f;
+                for (int k = 0; k < LOUDNESS_TP_TAPS; k++)
+                {
+                    acc += m->tp_coef[p][k] * h[k];
+                }
+                acc = fabsf(acc);
+                if (acc > m->peak)
+                {
+                    m->peak = acc;
+                }
+            }
+        }
+        if (++m->sub_pos == m->sub_len)
+        {
+            m->sub_energy[m->sub_count % LOUDNESS_SUB_BLOCKS] = m->sub_acc;
+            m->sub_acc = 0.0;
+            m->sub_pos = 0;
+            if (++m->sub_count >= LOUDNESS_SUB_BLOCKS)
+            {
+                loudness_block_done(m);
+            }
+        }
+    }
+}
+
+void audio_loudness_get(audio_loudness_handle_t meter, float *lufs, float *true_peak_db)
+{
+    struct audio_loudness *m = meter;
+    // 绝对门限：所有分箱都在 -70 LUFS 以上
+    uint64_t count = 0;
+    double energy = 0.0;
+    for (int i = 0; i < LOUDNESS_HIST_BINS; i++)
+    {
+        count += m->hist_count[i];
+        energy += m->hist_energy[i];
+    }
+    float result = AUDIO_LOUDNESS_SILENCE;
+    if (count > 0)
+    {
+        // 相对门限：比绝对门限后的平均响度低 10 LU
+        double gate = -0.691 + 10.0 * log10(energy / count) + LOUDNESS_RELATIVE_GATE;
+        int first = (int)ceil((gate - LOUDNESS_HIST_MIN) / LOUDNESS_HIST_STEP);
+        count = 0;
+        energy = 0.0;
+        for (int i = first < 0 ? 0 : first; i < LOUDNESS_HIST_BINS; i++)
+        {
+            count += m->hist_count[i];
+            energy += m->hist_energy[i];
+        }
+        if (count > 0)
+        {
+            result = (float)(-0.691 + 10.0 * log10(energy / count));
+        }
+    }
+    *lufs = result;
+    *true_peak_db = m->peak > 0.0f ? 20.0f * log10f(m->peak) : -INFINITY;
+}
+
+uint32_t audio_loudness_gain_q15(float lufs, float true_peak_db)
+{
+    float gain_db = AUDIO_LOUDNESS_TARGET_LUFS - lufs;
+    if (true_peak_db + gain_db > AUDIO_LOUDNESS_PEAK_LIMIT_DB)
+    {
+        gain_db = AUDIO_LOUDNESS_PEAK_LIMIT_DB - true_peak_db;
+    }
+    if (gain_db >= 0.0f)
+    {
+        return 32768;
+    }
+    return (uint32_t)(powf(10.0f, gain_db / 20.0f) * 32768.0f + 0.5f);
+}
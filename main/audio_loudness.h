@@ -0,0 +1,69 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief EBU R128 / ITU-R BS.1770-4 响度测量
+ *
+ * 积分响度：K 加权滤波后按 400 ms 块（75% 重叠）计算均方值，经过 -70 LUFS 绝对门限和
+ * -10 LU 相对门限后取平均。块响度按 0.1 LU 分箱累计，内存占用与曲目长度无关。
+ * 真峰值：4 倍过采样（每相 12 抽头的多相 FIR）后的最大绝对值。
+ *
+ * 用于后台扫描，浮点实现，不要求实时。
+ */
+
+// 归一化的目标响度（ReplayGain 2.0 参考电平）
+#define AUDIO_LOUDNESS_TARGET_LUFS -18.0f
+// 归一化后真峰值的上限
+#define AUDIO_LOUDNESS_PEAK_LIMIT_DB -1.0f
+// 没有有效块（静音或过短）时的积分响度
+#define AUDIO_LOUDNESS_SILENCE -70.0f
+
+typedef struct audio_loudness *audio_loudness_handle_t;
+
+/**
+ * @brief 创建测量实例
+ *
+ * @param[in]  sample_rate 采样率
+ * @param[in]  channels    通道数（1 或 2，更多通道时按相同权重累计）
+ * @param[out] meter       实例句柄
+ */
+esp_err_t audio_loudness_create(uint32_t sample_rate, uint8_t channels, audio_loudness_handle_t *meter);
+
+/**
+ * @brief 删除测量实例
+ */
+void audio_loudness_delete(audio_loudness_handle_t meter);
+
+/**
+ * @brief 输入交错 PCM
+ *
+ * @param[in] meter  实例句柄
+ * @param[in] data   PCM 数据
+ * @param[in] frames 帧数
+ * @param[in] bits   位深度（16、24 或 32）
+ */
+void audio_loudness_add(audio_loudness_handle_t meter, const uint8_t *data, uint32_t frames, uint8_t bits);
+
+/**
+ * @brief 积分响度（LUFS）和真峰值（dBTP）
+ */
+void audio_loudness_get(audio_loudness_handle_t meter, float *lufs, float *true_peak_db);
+
+/**
+ * @brief 按测量结果计算归一化增益（Q15）
+ *
+ * 增益把积分响度调整到 AUDIO_LOUDNESS_TARGET_LUFS，并保证真峰值不超过
+ * AUDIO_LOUDNESS_PEAK_LIMIT_DB；只衰减，不提升（输出路径的增益上限为 1）。
+ */
+uint32_t audio_loudness_gain_q15(float lufs, float true_peak_db);
+
+#ifdef __cplusplus
+}
+#endif
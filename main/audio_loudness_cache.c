@@ -0,0 +1,209 @@
+#include "audio_loudness_cache.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "audio_mem.h"
+
+static const char *TAG = "LOUDNESS_CACHE";
+
+#define CACHE_MAGIC 0x3143444C // "LDC1"
+#define CACHE_PATH_MAX 64
+// 记录数组每次扩容的数量
+#define CACHE_GROW 64
+
+typedef struct
+{
+    uint32_t path_hash;
+    uint32_t size;
+    uint32_t mtime;
+    int16_t lufs_centi;  // 积分响度 x100
+    int16_t peak_centi;  // 真峰值 x100
+} cache_record_t;
+
+static SemaphoreHandle_t s_cache_lock = NULL;
+static char s_cache_path[CACHE_PATH_MAX];
+static cache_record_t *s_records = NULL;
+static uint32_t s_record_num = 0;
+static uint32_t s_record_cap = 0;
+
+// FNV-1a
+static uint32_t cache_hash(const char *s)
+{
+    uint32_t h = 2166136261u;
+    while (*s)
+    {
+        h = (h ^ (uint8_t)*s++) * 16777619u;
+    }
+    return h;
+}
+
+static bool cache_key(const char *path, cache_record_t *rec)
+{
+    struct stat st;
+    if (stat(path, &st) != 0)
+    {
+        return false;
+    }
+    rec->path_hash = cache_hash(path);
+    rec->size = (uint32_t)st.st_size;
+    rec->mtime = (uint32_t)st.st_mtime;
+    return true;
+}
+
+// 调用方持有锁
+static cache_record_t *cache_find(const cache_record_t *key)
+{
+    // 同一文件重新扫描时追加在后面，从后往前找到最新的记录
+    for (uint32_t i = s_record_num; i > 0; i--)
+    {
+        cache_record_t *r = &s_records[i - 1];
+        if (r->path_hash == key->path_hash && r->size == key->size && r->mtime == key->mtime)
+        {
+            return r;
+        }
+    }
+    return NULL;
+}
+
+// 调用方持有锁
+static bool cache_append(const cache_record_t *rec)
+{
+    if (s_record_num == s_record_cap)
+    {
+        cache_record_t *p = heap_caps_realloc(s_records, (s_record_cap + CACHE_GROW) * sizeof(cache_record_t),
+                                              audio_mem_caps(AUDIO_MEM_BULK));
+        if (p == NULL)
+        {
+            return false;
+        }
+        s_records = p;
+        s_record_cap += CACHE_GROW;
+    }
+    s_records[s_record_num++] = *rec;
+    return true;
+}
+
+esp_err_t audio_loudness_cache_init(const char *cache_path)
+{
+    if (s_cache_lock == NULL)
+    {
+        s_cache_lock = xSemaphoreCreateMutex();
+        if (s_cache_lock == NULL)
+        {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    xSemaphoreTake(s_cache_lock, portMAX_DELAY);
+    strncpy(s_cache_path, cache_path, sizeof(s_cache_path) - 1);
+    s_record_num = 0;
+    FILE *f = fopen(s_cache_path, "rb");
+    uint32_t magic = 0;
+    if (f != NULL && fread(&magic, sizeof(magic), 1, f) == 1 && magic == CACHE_MAGIC)
+    {
+        cache_record_t rec;
+        while (fread(&rec, sizeof(rec), 1, f) == 1)
+        {
+            if (!cache_append(&rec))
+            {
+                break;
+            }
+        }
+    }
+    if (f != NULL)
+    {
+        fclose(f);
+    }
+    // 文件不存在或格式不对时重新创建
+    if (magic != CACHE_MAGIC)
+    {
+        f = fopen(s_cache_path, "wb");
+        if (f != NULL)
+        {
+            magic = CACHE_MAGIC;
+            fwrite(&magic, sizeof(magic), 1, f);
+            fclose(f);
+        }
+        else
+        {
+            ESP_LOGW(TAG, "Failed to create %s", s_cache_path);
+        }
+    }
+    ESP_LOGI(TAG, "%lu records loaded", (unsigned long)s_record_num);
+    xSemaphoreGive(s_cache_lock);
+    return ESP_OK;
+}
+
+bool audio_loudness_cache_lookup(const char *path, float *lufs, float *true_peak_db)
+{
+    cache_record_t key;
+    if (s_cache_lock == NULL || !cache_key(path, &key))
+    {
+        return false;
+    }
+    xSemaphoreTake(s_cache_lock, portMAX_DELAY);
+    const cache_record_t *r = cache_find(&key);
+    if (r != NULL)
+    {
+        *lufs = r->lufs_centi / 100.0f;
+        *true_peak_db = r->peak_centi / 100.0f;
+    }
+    xSemaphoreGive(s_cache_lock);
+    return r != NULL;
+}
+
+static int16_t cache_centi(float v)
+{
+    v *= 100.0f;
+    return (int16_t)(v > INT16_MAX ? INT16_MAX : (v < INT16_MIN ? INT16_MIN : v));
+}
+
+esp_err_t audio_loudness_cache_store(const char *path, float lufs, float true_peak_db)
+{
+    if (s_cache_lock == NULL)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    cache_record_t rec;
+    if (!cache_key(path, &rec))
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+    rec.lufs_centi = cache_centi(lufs);
+    rec.peak_centi = cache_centi(true_peak_db);
+    xSemaphoreTake(s_cache_lock, portMAX_DELAY);
+    esp_err_t ret = ESP_OK;
+    FILE *f = fopen(s_cache_path, "ab");
+    if (f == NULL || fwrite(&rec, sizeof(rec), 1, f) != 1)
+    {
+        ESP_LOGE(TAG, "Failed to write %s", s_cache_path);
+        ret = ESP_FAIL;
+    }
+    if (f != NULL)
+    {
+        fclose(f);
+    }
+    // 写文件失败时本次运行仍然使用结果
+    cache_append(&rec);
+    xSemaphoreGive(s_cache_lock);
+    return ret;
+}
+
+void audio_loudness_cache_clear(void)
+{
+    if (s_cache_lock == NULL)
+    {
+        return;
+    }
+    xSemaphoreTake(s_cache_lock, portMAX_DELAY);
+    heap_caps_free(s_records);
+    s_records = NULL;
+    s_record_num = 0;
+    s_record_cap = 0;
+    s_cache_path[0] = '\0';
+    xSemaphoreGive(s_cache_lock);
+}
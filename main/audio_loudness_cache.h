@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 响度扫描结果缓存
+ *
+ * 每个音频文件的积分响度和真峰值保存在 SD 卡上的一个缓存文件中（定长记录，只追加），
+ * 启动时整体读入内存。记录按路径哈希、文件大小和修改时间匹配，文件被替换后自动失效。
+ * 查询和写入可以在不同任务中进行。
+ */
+
+/**
+ * @brief 读入缓存文件，文件不存在时创建
+ *
+ * @return
+ *  - ESP_OK 成功
+ *  - ESP_ERR_NO_MEM 内存不足
+ */
+esp_err_t audio_loudness_cache_init(const char *cache_path);
+
+/**
+ * @brief 查询文件的扫描结果
+ *
+ * @return 是否有与当前文件匹配的记录
+ */
+bool audio_loudness_cache_lookup(const char *path, float *lufs, float *true_peak_db);
+
+/**
+ * @brief 保存文件的扫描结果
+ *
+ * @return
+ *  - ESP_OK 成功
+ *  - ESP_ERR_INVALID_STATE 缓存未初始化
+ *  - ESP_ERR_NOT_FOUND 文件不存在
+ *  - ESP_FAIL 写入缓存文件失败
+ */
+esp_err_t audio_loudness_cache_store(const char *path, float lufs, float true_peak_db);
+
+/**
+ * @brief 释放内存中的记录（例如卸载存储之前），缓存文件保留，之后需要重新 audio_loudness_cache_init
+ */
+void audio_loudness_cache_clear(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,120 @@
+#include "audio_mem.h"
+
+#include <string.h>
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_heap_caps.h"
+
+typedef struct
+{
+    audio_mem_place_t place;
+    uint32_t internal_caps; // 放在内部 RAM 时的属性
+} audio_mem_policy_t;
+
+// 放置策略表：每帧都要访问的 PCM 和解码器工作内存放内部 RAM，按块顺序读取的预读数据和冷数据放 PSRAM
+static audio_mem_policy_t s_policy[AUDIO_MEM_CLASS_NUM] = {
+    [AUDIO_MEM_PCM] = {AUDIO_MEM_INTERNAL, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT},
+    [AUDIO_MEM_DECODER] = {AUDIO_MEM_INTERNAL, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT},
+    // 放内部 RAM 时要能让 SDMMC 直接 DMA
+    [AUDIO_MEM_READ_AHEAD] = {AUDIO_MEM_PSRAM, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL},
+    [AUDIO_MEM_BULK] = {AUDIO_MEM_PSRAM, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT},
+};
+
+#define AUDIO_MEM_PSRAM_CAPS (MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT)
+
+#if CONFIG_SPIRAM_USE_MALLOC
+// malloc 的 PSRAM 门限是全局的，解码任务和响度扫描任务都会在 begin/end 之间打开解码器，
+// 用互斥锁保证同一时间只有一个任务修改它，否则先 end 的任务会提前恢复另一个任务设置的门限
+static StaticSemaphore_t s_extmem_lock_buf;
+static SemaphoreHandle_t s_extmem_lock = NULL;
+static portMUX_TYPE s_extmem_init_lock = portMUX_INITIALIZER_UNLOCKED;
+// IDF 没有读取门限的接口，当前值由这里记录；begin 时保存，end 时恢复
+static size_t s_extmem_limit = CONFIG_SPIRAM_MALLOC_ALWAYSINTERNAL;
+static size_t s_extmem_saved;
+
+static void extmem_lock(void)
+{
+    // 第一次调用时创建，两个任务可能同时走到这里
+    portENTER_CRITICAL(&s_extmem_init_lock);
+    if (s_extmem_lock == NULL)
+    {
+        s_extmem_lock = xSemaphoreCreateMutexStatic(&s_extmem_lock_buf);
+    }
+    portEXIT_CRITICAL(&s_extmem_init_lock);
+    xSemaphoreTake(s_extmem_lock, portMAX_DELAY);
+}
+
+static void extmem_set(size_t limit)
+{
+    heap_caps_malloc_extmem_enable(limit);
+    s_extmem_limit = limit;
+}
+#endif
+
+audio_mem_place_t audio_mem_get_place(audio_mem_class_t cls)
+{
+    return s_policy[cls].place;
+}
+
+void audio_mem_set_place(audio_mem_class_t cls, audio_mem_place_t place)
+{
+    s_policy[cls].place = place;
+}
+
+uint32_t audio_mem_caps(audio_mem_class_t cls)
+{
+    return s_policy[cls].place == AUDIO_MEM_INTERNAL ? s_policy[cls].internal_caps : AUDIO_MEM_PSRAM_CAPS;
+}
+
+uint32_t audio_mem_fallback_caps(audio_mem_class_t cls)
+{
+    return s_policy[cls].place == AUDIO_MEM_INTERNAL ? AUDIO_MEM_PSRAM_CAPS : s_policy[cls].internal_caps;
+}
+
+void *audio_mem_alloc(audio_mem_class_t cls, size_t size)
+{
+    void *p = heap_caps_aligned_alloc(AUDIO_MEM_ALIGN, size, audio_mem_caps(cls));
+    if (p == NULL)
+    {
+        p = heap_caps_aligned_alloc(AUDIO_MEM_ALIGN, size, audio_mem_fallback_caps(cls));
+    }
+    return p;
+}
+
+void *audio_mem_calloc(audio_mem_class_t cls, size_t size)
+{
+    void *p = audio_mem_alloc(cls, size);
+    if (p != NULL)
+    {
+        memset(p, 0, size);
+    }
+    return p;
+}
+
+void audio_mem_set_malloc_threshold(size_t limit)
+{
+#if CONFIG_SPIRAM_USE_MALLOC
+    extmem_lock();
+    extmem_set(limit);
+    xSemaphoreGive(s_extmem_lock);
+#endif
+}
+
+void audio_mem_decoder_begin(void)
+{
+#if CONFIG_SPIRAM_USE_MALLOC
+    extmem_lock();
+    s_extmem_saved = s_extmem_limit;
+    // 门限以下的 malloc 先用内部 RAM，以上的先用 PSRAM，都会退回另一种
+    extmem_set(s_policy[AUDIO_MEM_DECODER].place == AUDIO_MEM_INTERNAL ? SIZE_MAX : 0);
+#endif
+}
+
+void audio_mem_decoder_end(void)
+{
+#if CONFIG_SPIRAM_USE_MALLOC
+    extmem_set(s_extmem_saved);
+    xSemaphoreGive(s_extmem_lock);
+#endif
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 音频缓冲区的内存放置策略
+ *
+ * 缓冲区按访问频率分类，每类放在内部 RAM 还是 PSRAM 由 audio_mem.c 中的一张表决定，
+ * 首选的内存不足时退回另一种。分配的内存按 cache line 对齐。
+ *
+ * 放置只在分配时生效，修改后新分配的缓冲区才按新的位置。
+ */
+
+// cache line 大小，PSRAM 中的缓冲区按它对齐可以避免与其他数据共用 cache line
+#define AUDIO_MEM_ALIGN 64
+
+typedef enum
+{
+    AUDIO_MEM_PCM = 0,    // 热路径上的 PCM：环形缓冲区的槽、采样率/格式转换的输出、混音输入
+    AUDIO_MEM_DECODER,    // 解码器内部的工作内存
+    AUDIO_MEM_READ_AHEAD, // 文件预读块（解码器的输入）
+    AUDIO_MEM_BULK,       // 不在热路径上的大块内存：曲目槽、帧索引、响度缓存等
+    AUDIO_MEM_CLASS_NUM,
+} audio_mem_class_t;
+
+typedef enum
+{
+    AUDIO_MEM_INTERNAL = 0, // 内部 SRAM
+    AUDIO_MEM_PSRAM,        // 外部 PSRAM
+} audio_mem_place_t;
+
+/**
+ * @brief 取得/修改一类缓冲区的放置位置
+ */
+audio_mem_place_t audio_mem_get_place(audio_mem_class_t cls);
+void audio_mem_set_place(audio_mem_class_t cls, audio_mem_place_t place);
+
+/**
+ * @brief 一类缓冲区首选的 heap_caps 属性，以及首选内存不足时退回的属性
+ */
+uint32_t audio_mem_caps(audio_mem_class_t cls);
+uint32_t audio_mem_fallback_caps(audio_mem_class_t cls);
+
+/**
+ * @brief 按放置策略分配 size 字节（AUDIO_MEM_ALIGN 对齐），用 heap_caps_free 释放
+ *
+ * @return 内存地址，两种内存都不足时返回 NULL
+ */
+void *audio_mem_alloc(audio_mem_class_t cls, size_t size);
+
+/**
+ * @brief 分配并清零
+ */
+void *audio_mem_calloc(audio_mem_class_t cls, size_t size);
+
+/**
+ * @brief 修改 malloc 使用 PSRAM 的门限（默认为 sdkconfig 中的 CONFIG_SPIRAM_MALLOC_ALWAYSINTERNAL）
+ *
+ * 代替 heap_caps_malloc_extmem_enable，audio_mem_decoder_end 恢复的是这里设置的值。
+ * 与 begin/end 使用同一个锁，解码器打开期间调用时等待 end 之后生效。
+ */
+void audio_mem_set_malloc_threshold(size_t limit);
+
+/**
+ * @brief 解码器用 malloc 分配工作内存，不能指定属性。在 begin/end 之间按 AUDIO_MEM_DECODER 的位置
+ *        调整 malloc 使用 PSRAM 的门限，end 时恢复 begin 之前的门限
+ *
+ * 门限是全局的，期间其他任务的 malloc 也受影响，只应包住打开解码器和解码第一帧等短时间的调用。
+ * begin 获取一个互斥锁，end 释放，多个任务的 begin/end 依次进行；两者必须在同一个任务中成对调用，不能嵌套。
+ */
+void audio_mem_decoder_begin(void);
+void audio_mem_decoder_end(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,340 @@
+#include "audio_mixer.h"
+
+#include <string.h>
+#include <stdatomic.h>
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "audio_gain.h"
+#include "audio_simd.h"
+#include "audio_mem.h"
+
+static const char *TAG = "AUDIO_MIXER";
+
+// 混音时输入数据先拷贝到对齐的临时缓冲区，再与音乐做饱和加
+#define MIXER_SCRATCH_SIZE 1024
+// 开始/结束压低音乐的过渡时长
+#define MIXER_DUCK_ATTACK_MS 50
+#define MIXER_DUCK_RELEASE_MS 300
+// 关闭时等待数据播完的轮询间隔和最长时间
+#define MIXER_DRAIN_POLL_MS 10
+#define MIXER_DRAIN_TIMEOUT_MS 1000
+
+struct audio_mixer_stream
+{
+    struct audio_mixer *mixer;
+    bool used;
+    bool duck;
+    uint8_t *buf;
+    uint32_t size;             // 2 的幂
+    atomic_uint head;          // 写入位置（只增不减），写入方更新
+    atomic_uint tail;          // 读取位置（只增不减），混音方更新
+    SemaphoreHandle_t space;   // 混音方取走数据后通知写入方
+    audio_gain_t gain;
+};
+
+struct audio_mixer
+{
+    SemaphoreHandle_t lock;    // 保护输入流的打开/关闭和输出格式
+    struct audio_mixer_stream streams[AUDIO_MIXER_STREAM_MAX];
+    uac_format_t format;
+    atomic_uint open_num;
+    atomic_uint duck_num;
+    uint32_t duck_gain;
+    // 仅混音方访问
+    uac_format_t mix_format;   // 最近一次取得锁时的输出格式
+    audio_gain_t duck;
+    bool ducked;
+    int16_t scratch[MIXER_SCRATCH_SIZE / sizeof(int16_t)] __attribute__((aligned(AUDIO_SIMD_ALIGN)));
+};
+
+esp_err_t audio_mixer_create(uint32_t duck_gain_q15, audio_mixer_handle_t *mixer)
+{
+    if (mixer == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    // 混音在 USB 任务中进行，控制结构放在内部 RAM
+    struct audio_mixer *m = heap_caps_aligned_calloc(AUDIO_SIMD_ALIGN, 1, sizeof(struct audio_mixer),
+                                                     MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (m == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    m->lock = xSemaphoreCreateMutex();
+    if (m->lock == NULL)
+    {
+        heap_caps_free(m);
+        return ESP_ERR_NO_MEM;
+    }
+    atomic_init(&m->open_num, 0);
+    atomic_init(&m->duck_num, 0);
+    m->duck_gain = duck_gain_q15 > AUDIO_GAIN_UNITY ? AUDIO_GAIN_UNITY : duck_gain_q15;
+    audio_gain_init(&m->duck, AUDIO_GAIN_UNITY);
+    m->ducked = false;
+    *mixer = m;
+    return ESP_OK;
+}
+
+void audio_mixer_set_format(audio_mixer_handle_t mixer, const uac_format_t *format)
+{
+    xSemaphoreTake(mixer->lock, portMAX_DELAY);
+    mixer->format = *format;
+    xSemaphoreGive(mixer->lock);
+}
+
+void audio_mixer_get_format(audio_mixer_handle_t mixer, uac_format_t *format)
+{
+    xSemaphoreTake(mixer->lock, portMAX_DELAY);
+    *format = mixer->format;
+    xSemaphoreGive(mixer->lock);
+}
+
+bool audio_mixer_is_active(audio_mixer_handle_t mixer)
+{
+    return atomic_load(&mixer->open_num) > 0;
+}
+
+esp_err_t audio_mixer_stream_open(audio_mixer_handle_t mixer, const audio_mixer_stream_config_t *config,
+                                  audio_mixer_stream_handle_t *stream)
+{
+    if (mixer == NULL || config == NULL || stream == NULL || config->buffer_size == 0 ||
+        config->buffer_size > (1u << 30))
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    uint32_t size = 1;
+    while (size < config->buffer_size)
+    {
+        size <<= 1;
+    }
+    uint8_t *buf = audio_mem_alloc(AUDIO_MEM_PCM, size);
+    SemaphoreHandle_t space = xSemaphoreCreateBinary();
+    if (buf == NULL || space == NULL)
+    {
+        heap_caps_free(buf);
+        if (space)
+        {
+            vSemaphoreDelete(space);
+        }
+        return ESP_ERR_NO_MEM;
+    }
+
+    xSemaphoreTake(mixer->lock, portMAX_DELAY);
+    struct audio_mixer_stream *s = NULL;
+    for (int i = 0; i < AUDIO_MIXER_STREAM_MAX; i++)
+    {
+        if (!mixer->streams[i].used)
+        {
+            s = &mixer->streams[i];
+            break;
+        }
+    }
+    if (s == NULL)
+    {
+        xSemaphoreGive(mixer->lock);
+        heap_caps_free(buf);
+        vSemaphoreDelete(space);
+        ESP_LOGW(TAG, "No free stream");
+        return ESP_ERR_NOT_FOUND;
+    }
+    s->mixer = mixer;
+    s->duck = config->duck;
+    s->buf = buf;
+    s->size = size;
+    s->space = space;
+    atomic_init(&s->head, 0);
+    atomic_init(&s->tail, 0);
+    audio_gain_init(&s->gain, config->gain_q15);
+    s->used = true;
+    atomic_fetch_add(&mixer->open_num, 1);
+    if (s->duck)
+    {
+        atomic_fetch_add(&mixer->duck_num, 1);
+    }
+    xSemaphoreGive(mixer->lock);
+    *stream = s;
+    return ESP_OK;
+}
+
+esp_err_t audio_mixer_stream_write(audio_mixer_stream_handle_t stream, const uint8_t *data, uint32_t len,
+                                   uint32_t *written, TickType_t timeout)
+{
+    uint32_t done = 0;
+    TickType_t start = xTaskGetTickCount();
+    while (done < len)
+    {
+        uint32_t head = atomic_load(&stream->head);
+        uint32_t space = stream->size - (head - atomic_load(&stream->tail));
+        if (space == 0)
+        {
+            TickType_t elapsed = xTaskGetTickCount() - start;
+            if (elapsed >= timeout || xSemaphoreTake(stream->space, timeout - elapsed) != pdTRUE)
+            {
+                break;
+            }
+            continue;
+        }
+        uint32_t n = len - done < space ? len - done : space;
+        uint32_t pos = head & (stream->size - 1);
+        uint32_t first = stream->size - pos < n ? stream->size - pos : n;
+        memcpy(stream->buf + pos, data + done, first);
+        memcpy(stream->buf, data + done + first, n - first);
+        atomic_store(&stream->head, head + n);
+        done += n;
+    }
+    if (written)
+    {
+        *written = done;
+    }
+    return done == len ? ESP_OK : ESP_ERR_TIMEOUT;
+}
+
+void audio_mixer_stream_set_gain(audio_mixer_stream_handle_t stream, uint32_t gain_q15, uint32_t ramp_ms)
+{
+    audio_gain_set(&stream->gain, gain_q15, ramp_ms);
+}
+
+void audio_mixer_stream_close(audio_mixer_stream_handle_t stream, bool drain)
+{
+    if (stream == NULL)
+    {
+        return;
+    }
+    struct audio_mixer *mixer = stream->mixer;
+    for (int t = 0; drain && t < MIXER_DRAIN_TIMEOUT_MS && atomic_load(&stream->head) != atomic_load(&stream->tail);
+         t += MIXER_DRAIN_POLL_MS)
+    {
+        xSemaphoreTake(stream->space, pdMS_TO_TICKS(MIXER_DRAIN_POLL_MS));
+    }
+    // 混音方持有锁期间不会看到流被释放
+    xSemaphoreTake(mixer->lock, portMAX_DELAY);
+    stream->used = false;
+    atomic_fetch_sub(&mixer->open_num, 1);
+    if (stream->duck)
+    {
+        atomic_fetch_sub(&mixer->duck_num, 1);
+    }
+    xSemaphoreGive(mixer->lock);
+    heap_caps_free(stream->buf);
+    vSemaphoreDelete(stream->space);
+    stream->buf = NULL;
+    stream->space = NULL;
+}
+
+// 从环形缓冲区取出 len 字节
+static void mixer_stream_read(struct audio_mixer_stream *s, uint32_t tail, uint8_t *dst, uint32_t len)
+{
+    uint32_t pos = tail & (s->size - 1);
+    uint32_t first = s->size - pos < len ? s->size - pos : len;
+    memcpy(dst, s->buf + pos, first);
+    memcpy(dst + first, s->buf, len - first);
+}
+
+// 24/32 位饱和加，24 位样本为 3 字节小端（与 UAC 的 bSubframeSize 3 一致）
+static void mixer_add_sat(uint8_t *dst, const uint8_t *src, uint32_t len, uint8_t bits)
+{
+    if (bits == 24)
+    {
+        for (uint32_t i = 0; i + 3 <= len; i += 3)
+        {
+            int32_t a = (int32_t)((uint32_t)dst[i] << 8 | (uint32_t)dst[i + 1] << 16 | (uint32_t)dst[i + 2] << 24) >> 8;
+            int32_t b = (int32_t)((uint32_t)src[i] << 8 | (uint32_t)src[i + 1] << 16 | (uint32_t)src[i + 2] << 24) >> 8;
+            int32_t v = a + b;
+            v = v > 0x7FFFFF ? 0x7FFFFF : (v < -0x800000 ? -0x800000 : v);
+            dst[i] = (uint8_t)v;
+            dst[i + 1] = (uint8_t)(v >> 8);
+            dst[i + 2] = (uint8_t)(v >> 16);
+        }
+        return;
+    }
+    int32_t *d = (int32_t *)dst;
+    const int32_t *s = (const int32_t *)src;
+    for (uint32_t i = 0; i < len / sizeof(int32_t); i++)
+    {
+        int64_t v = (int64_t)d[i] + s[i];
+        d[i] = v > INT32_MAX ? INT32_MAX : (v < INT32_MIN ? INT32_MIN : (int32_t)v);
+    }
+}
+
+// 把一路输入流叠加到 data 上，返回取走的字节数
+static uint32_t mixer_stream_mix(struct audio_mixer *m, struct audio_mixer_stream *s, uint8_t *data, uint32_t size)
+{
+    const uac_format_t *fmt = &m->mix_format;
+    uint32_t frame_bytes = fmt->channels * (fmt->bits / 8);
+    uint32_t tail = atomic_load(&s->tail);
+    uint32_t avail = atomic_load(&s->head) - tail;
+    // 只取整帧
+    uint32_t len = (avail < size ? avail : size) / frame_bytes * frame_bytes;
+    // 临时缓冲区与 data 保持相同的 16 字节偏移，16 位饱和加可以使用向量内核
+    uint32_t chunk_max = (sizeof(m->scratch) - AUDIO_SIMD_ALIGN) / frame_bytes * frame_bytes;
+    for (uint32_t off = 0; off < len;)
+    {
+        uint32_t chunk = len - off < chunk_max ? len - off : chunk_max;
+        uint8_t *dst = data + off;
+        int16_t *src = (int16_t *)((uint8_t *)m->scratch + ((uintptr_t)dst & (AUDIO_SIMD_ALIGN - 1)));
+        mixer_stream_read(s, tail + off, (uint8_t *)src, chunk);
+        audio_gain_process(&s->gain, (uint8_t *)src, chunk / frame_bytes, fmt->channels, fmt->bits, fmt->sample_rate);
+        if (fmt->bits == 16)
+        {
+            audio_simd_add_sat_s16((int16_t *)dst, src, chunk / sizeof(int16_t));
+        }
+        else
+        {
+            mixer_add_sat(dst, (const uint8_t *)src, chunk, fmt->bits);
+        }
+        off += chunk;
+    }
+    return len;
+}
+
+void audio_mixer_process(uint8_t *data, size_t size, void *arg)
+{
+    struct audio_mixer *m = arg;
+    // 在 USB 客户端任务中调用，不能等待：打开/关闭流或设置格式的任务持有锁时只做 duck，
+    // 这一包不混音，输入流的数据留到下一包
+    bool locked = xSemaphoreTake(m->lock, 0) == pdTRUE;
+    if (locked)
+    {
+        m->mix_format = m->format;
+    }
+    const uac_format_t *fmt = &m->mix_format;
+    uint32_t frame_bytes = fmt->channels * (fmt->bits / 8);
+    if (frame_bytes == 0)
+    {
+        if (locked)
+        {
+            xSemaphoreGive(m->lock);
+        }
+        return;
+    }
+
+    bool duck = atomic_load(&m->duck_num) > 0;
+    if (duck != m->ducked)
+    {
+        m->ducked = duck;
+        audio_gain_set(&m->duck, duck ? m->duck_gain : AUDIO_GAIN_UNITY, duck ? MIXER_DUCK_ATTACK_MS : MIXER_DUCK_RELEASE_MS);
+    }
+    audio_gain_process(&m->duck, data, size / frame_bytes, fmt->channels, fmt->bits, fmt->sample_rate);
+    if (!locked)
+    {
+        return;
+    }
+
+    for (int i = 0; i < AUDIO_MIXER_STREAM_MAX; i++)
+    {
+        struct audio_mixer_stream *s = &m->streams[i];
+        if (!s->used)
+        {
+            continue;
+        }
+        uint32_t len = mixer_stream_mix(m, s, data, size);
+        if (len > 0)
+        {
+            atomic_fetch_add(&s->tail, len);
+            xSemaphoreGive(s->space);
+        }
+    }
+    xSemaphoreGive(m->lock);
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_err.h"
+#include "uac_format.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 多路混音
+ *
+ * 在 USB 等时传输提交前（uac_host_device_set_tx_process_cb 回调）把提示音等输入流
+ * 叠加到音乐上，而不是在 uac_host_device_write 之前混音：驱动环形缓冲区中已排队的
+ * 音乐不会推迟提示音，新加入的流只需等待已提交的等时传输播完。
+ *
+ * 每路输入流有一个单生产者/单消费者的字节环形缓冲区和独立的增益；标记为 duck 的流
+ * 打开期间，音乐按 duck 增益平滑压低。16 位输出使用 PIE 饱和加法，24 位（3 字节）和 32 位
+ * 输出为标量饱和加法。
+ *
+ * 输入流的数据格式必须与当前输出格式一致（audio_mixer_get_format）。
+ */
+
+// 同时存在的输入流数量上限
+#define AUDIO_MIXER_STREAM_MAX 4
+
+typedef struct audio_mixer *audio_mixer_handle_t;
+typedef struct audio_mixer_stream *audio_mixer_stream_handle_t;
+
+/**
+ * @brief 输入流配置
+ */
+typedef struct
+{
+    uint32_t buffer_size; // 环形缓冲区字节数，向上取整为 2 的幂
+    uint32_t gain_q15;    // 流的增益（Q15，AUDIO_GAIN_UNITY 为 1.0）
+    bool duck;            // 流打开期间是否压低音乐
+} audio_mixer_stream_config_t;
+
+/**
+ * @brief 创建混音器
+ *
+ * @param[in]  duck_gain_q15 压低时音乐的增益（Q15）
+ * @param[out] mixer         混音器句柄
+ */
+esp_err_t audio_mixer_create(uint32_t duck_gain_q15, audio_mixer_handle_t *mixer);
+
+/**
+ * @brief 设置输出格式，输出流格式改变后由播放器调用
+ */
+void audio_mixer_set_format(audio_mixer_handle_t mixer, const uac_format_t *format);
+
+/**
+ * @brief 当前输出格式
+ */
+void audio_mixer_get_format(audio_mixer_handle_t mixer, uac_format_t *format);
+
+/**
+ * @brief 是否有打开的输入流（播放器空闲时需要继续写静音，使等时传输不停）
+ */
+bool audio_mixer_is_active(audio_mixer_handle_t mixer);
+
+/**
+ * @brief 打开一路输入流
+ *
+ * @return
+ *  - ESP_OK 成功
+ *  - ESP_ERR_INVALID_ARG 参数无效
+ *  - ESP_ERR_NOT_FOUND 输入流数量已达上限
+ *  - ESP_ERR_NO_MEM 内存不足
+ */
+esp_err_t audio_mixer_stream_open(audio_mixer_handle_t mixer, const audio_mixer_stream_config_t *config,
+                                  audio_mixer_stream_handle_t *stream);
+
+/**
+ * @brief 写入 PCM 数据，缓冲区满时最多等待 timeout
+ *
+ * @param[out] written 实际写入的字节数，可为 NULL
+ * @return
+ *  - ESP_OK 全部写入
+ *  - ESP_ERR_TIMEOUT 超时，只写入了 written 字节
+ */
+esp_err_t audio_mixer_stream_write(audio_mixer_stream_handle_t stream, const uint8_t *data, uint32_t len,
+                                   uint32_t *written, TickType_t timeout);
+
+/**
+ * @brief 平滑调整流的增益
+ */
+void audio_mixer_stream_set_gain(audio_mixer_stream_handle_t stream, uint32_t gain_q15, uint32_t ramp_ms);
+
+/**
+ * @brief 关闭输入流
+ *
+ * @param[in] drain 为 true 时先等待已写入的数据播完（输出停止时最多等待 1 秒）
+ */
+void audio_mixer_stream_close(audio_mixer_stream_handle_t stream, bool drain);
+
+/**
+ * @brief 把输入流叠加到 data 上（等时传输提交前调用，可直接作为 uac_host_tx_process_cb_t）
+ *
+ * 不会阻塞：其他任务正在打开/关闭输入流或设置格式时，这一包只做 duck，输入流留到下一包再混。
+ *
+ * @param[in,out] data 音乐数据，按当前输出格式
+ * @param[in]     size 字节数
+ * @param[in]     arg  混音器句柄
+ */
+void audio_mixer_process(uint8_t *data, size_t size, void *arg);
+
+#ifdef __cplusplus
+}
+#endif
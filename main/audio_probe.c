@@ -0,0 +1,249 @@
+#include "audio_probe.h"
+
+#include <string.h>
+#include <strings.h>
+
+// ID3v2 标签之后查找帧同步字时最多扫描的字节数
+#define PROBE_SYNC_SEARCH_LEN 4096
+// MPEG-TS 包长度
+#define TS_PACKET_SIZE 188
+
+// 目录枚举时认为是音频文件的扩展名
+static const char *s_audio_exts[] = {".mp3", ".aac", ".flac", ".wav", ".m4a", ".mp4", ".ts", ".amr"};
+
+static const uint16_t s_mp3_bitrate_v1[16] = {0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 0};
+static const uint16_t s_mp3_bitrate_v2[16] = {0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160, 0};
+static const uint32_t s_mp3_sample_rate[3] = {44100, 48000, 32000};
+static const uint32_t s_adts_sample_rate[13] = {96000, 88200, 64000, 48000, 44100, 32000, 24000,
+                                                22050, 16000, 12000, 11025, 8000, 7350};
+
+static uint16_t read_le16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t read_le32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+size_t audio_probe_id3v2_size(const uint8_t *buf, size_t len)
+{
+    if (len < 10 || memcmp(buf, "ID3", 3) != 0)
+    {
+        return 0;
+    }
+    size_t size = ((size_t)(buf[6] & 0x7F) << 21) | ((size_t)(buf[7] & 0x7F) << 14) | ((size_t)(buf[8] & 0x7F) << 7) |
+                  (buf[9] & 0x7F);
+    // 带页脚时再加 10 字节
+    return size + 10 + ((buf[5] & 0x10) ? 10 : 0);
+}
+
+// MPEG 音频帧头：11 位同步字，layer 不为 0，比特率和采样率索引有效
+static bool is_mpeg_audio_sync(const uint8_t *p)
+{
+    return p[0] == 0xFF && (p[1] & 0xE0) == 0xE0 && ((p[1] >> 3) & 0x03) != 1 && ((p[1] >> 1) & 0x03) != 0 &&
+           (p[2] >> 4) != 0x0F && ((p[2] >> 2) & 0x03) != 3;
+}
+
+// ADTS 帧头：12 位同步字，layer 为 0，采样率索引有效
+static bool is_adts_sync(const uint8_t *p)
+{
+    return p[0] == 0xFF && (p[1] & 0xF6) == 0xF0 && ((p[2] >> 2) & 0x0F) < 13;
+}
+
+bool audio_probe_mp3_frame(const uint8_t *p, audio_probe_frame_t *frame)
+{
+    if (p[0] != 0xFF || (p[1] & 0xE0) != 0xE0)
+    {
+        return false;
+    }
+    uint8_t version = (p[1] >> 3) & 0x03; // 3: MPEG1, 2: MPEG2, 0: MPEG2.5
+    uint8_t layer = (p[1] >> 1) & 0x03;   // 1: Layer III
+    uint8_t bitrate_idx = p[2] >> 4;
+    uint8_t rate_idx = (p[2] >> 2) & 0x03;
+    if (version == 1 || layer != 1 || bitrate_idx == 0 || bitrate_idx == 15 || rate_idx == 3)
+    {
+        return false;
+    }
+    bool mpeg1 = version == 3;
+    bool mono = (p[3] >> 6) == 3;
+    uint32_t bitrate = (mpeg1 ? s_mp3_bitrate_v1 : s_mp3_bitrate_v2)[bitrate_idx] * 1000;
+
+    frame->sample_rate = s_mp3_sample_rate[rate_idx] >> (mpeg1 ? 0 : (version == 2 ? 1 : 2));
+    frame->samples = mpeg1 ? 1152 : 576;
+    frame->frame_len = frame->samples / 8 * bitrate / frame->sample_rate + ((p[2] >> 1) & 0x01);
+    frame->side_len = (mpeg1 ? (mono ? 17 : 32) : (mono ? 9 : 17)) + ((p[1] & 0x01) ? 0 : 2);
+    return true;
+}
+
+bool audio_probe_adts_frame(const uint8_t *p, audio_probe_frame_t *frame)
+{
+    if (!is_adts_sync(p))
+    {
+        return false;
+    }
+    uint32_t frame_len = ((uint32_t)(p[3] & 0x03) << 11) | ((uint32_t)p[4] << 3) | (p[5] >> 5);
+    // 帧长度至少包含帧头（带 CRC 时 9 字节）
+    if (frame_len < ((p[1] & 0x01) ? 7 : 9))
+    {
+        return false;
+    }
+    frame->frame_len = frame_len;
+    frame->samples = 1024 * ((p[6] & 0x03) + 1);
+    frame->sample_rate = s_adts_sample_rate[(p[2] >> 2) & 0x0F];
+    frame->side_len = 0;
+    return true;
+}
+
+static bool is_ts(const uint8_t *buf, size_t len)
+{
+    if (len < TS_PACKET_SIZE * 2 + 1)
+    {
+        return false;
+    }
+    return buf[0] == 0x47 && buf[TS_PACKET_SIZE] == 0x47 && buf[TS_PACKET_SIZE * 2] == 0x47;
+}
+
+esp_audio_simple_dec_type_t audio_probe_type(const uint8_t *buf, size_t len)
+{
+    if (buf == NULL || len < 12)
+    {
+        return ESP_AUDIO_SIMPLE_DEC_TYPE_NONE;
+    }
+    // 有固定标识的容器
+    if (memcmp(buf, "RIFF", 4) == 0 && memcmp(buf + 8, "WAVE", 4) == 0)
+    {
+        return ESP_AUDIO_SIMPLE_DEC_TYPE_WAV;
+    }
+    if (memcmp(buf + 4, "ftyp", 4) == 0)
+    {
+        return ESP_AUDIO_SIMPLE_DEC_TYPE_M4A;
+    }
+    if (memcmp(buf, "#!AMR-WB\n", 9) == 0)
+    {
+        return ESP_AUDIO_SIMPLE_DEC_TYPE_AMRWB;
+    }
+    if (memcmp(buf, "#!AMR\n", 6) == 0)
+    {
+        return ESP_AUDIO_SIMPLE_DEC_TYPE_AMRNB;
+    }
+    if (is_ts(buf, len))
+    {
+        return ESP_AUDIO_SIMPLE_DEC_TYPE_TS;
+    }
+
+    // ID3v2 标签后面可能是 MP3、AAC 或 FLAC
+    size_t pos = audio_probe_id3v2_size(buf, len);
+    if (pos + 4 <= len && memcmp(buf + pos, "fLaC", 4) == 0)
+    {
+        return ESP_AUDIO_SIMPLE_DEC_TYPE_FLAC;
+    }
+    size_t end = pos + PROBE_SYNC_SEARCH_LEN < len ? pos + PROBE_SYNC_SEARCH_LEN : len;
+    for (; pos + 4 <= end; pos++)
+    {
+        if (buf[pos] != 0xFF)
+        {
+            continue;
+        }
+        if (is_adts_sync(buf + pos))
+        {
+            return ESP_AUDIO_SIMPLE_DEC_TYPE_AAC;
+        }
+        if (is_mpeg_audio_sync(buf + pos))
+        {
+            return ESP_AUDIO_SIMPLE_DEC_TYPE_MP3;
+        }
+    }
+    return ESP_AUDIO_SIMPLE_DEC_TYPE_NONE;
+}
+
+const char *audio_probe_type_name(esp_audio_simple_dec_type_t type)
+{
+    switch (type)
+    {
+    case ESP_AUDIO_SIMPLE_DEC_TYPE_AAC:
+        return "AAC";
+    case ESP_AUDIO_SIMPLE_DEC_TYPE_MP3:
+        return "MP3";
+    case ESP_AUDIO_SIMPLE_DEC_TYPE_AMRNB:
+        return "AMR-NB";
+    case ESP_AUDIO_SIMPLE_DEC_TYPE_AMRWB:
+        return "AMR-WB";
+    case ESP_AUDIO_SIMPLE_DEC_TYPE_FLAC:
+        return "FLAC";
+    case ESP_AUDIO_SIMPLE_DEC_TYPE_WAV:
+        return "WAV";
+    case ESP_AUDIO_SIMPLE_DEC_TYPE_M4A:
+        return "M4A";
+    case ESP_AUDIO_SIMPLE_DEC_TYPE_TS:
+        return "TS";
+    default:
+        return "unknown";
+    }
+}
+
+bool audio_probe_wav_pcm(const uint8_t *buf, size_t len, audio_probe_wav_t *wav)
+{
+    if (len < 12 || memcmp(buf, "RIFF", 4) != 0 || memcmp(buf + 8, "WAVE", 4) != 0)
+    {
+        return false;
+    }
+    bool fmt_ok = false;
+    size_t pos = 12;
+    while (pos + 8 <= len)
+    {
+        const uint8_t *chunk = buf + pos;
+        uint32_t chunk_size = read_le32(chunk + 4);
+        if (memcmp(chunk, "fmt ", 4) == 0)
+        {
+            if (chunk_size < 16 || pos + 8 + 16 > len)
+            {
+                return false;
+            }
+            uint16_t format = read_le16(chunk + 8);
+            // WAVE_FORMAT_EXTENSIBLE：子格式 GUID 的前两个字节是实际格式
+            if (format == 0xFFFE)
+            {
+                if (chunk_size < 40 || pos + 8 + 26 > len)
+                {
+                    return false;
+                }
+                format = read_le16(chunk + 8 + 24);
+            }
+            wav->channels = (uint8_t)read_le16(chunk + 10);
+            wav->sample_rate = read_le32(chunk + 12);
+            wav->bits = (uint8_t)read_le16(chunk + 22);
+            // 只直通整数 PCM；8 位是无符号格式，交给解码器处理
+            fmt_ok = format == 1 && wav->channels >= 1 && wav->channels <= 2 && wav->sample_rate > 0 &&
+                     (wav->bits == 16 || wav->bits == 24 || wav->bits == 32);
+        }
+        else if (memcmp(chunk, "data", 4) == 0)
+        {
+            wav->data_offset = pos + 8;
+            // 边录边写的文件长度字段可能是 0 或全 1，按读到文件末尾处理
+            wav->data_size = (chunk_size == 0 || chunk_size == UINT32_MAX) ? UINT32_MAX : chunk_size;
+            return fmt_ok;
+        }
+        // 块按偶数字节对齐
+        pos += 8 + (size_t)chunk_size + (chunk_size & 1);
+    }
+    return false;
+}
+
+bool audio_probe_is_audio_file(const char *file_name)
+{
+    const char *ext = strrchr(file_name, '.');
+    if (ext == NULL)
+    {
+        return false;
+    }
+    for (size_t i = 0; i < sizeof(s_audio_exts) / sizeof(s_audio_exts[0]); i++)
+    {
+        if (strcasecmp(ext, s_audio_exts[i]) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "esp_audio_simple_dec.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 音频文件格式识别
+ *
+ * 按文件开头的特征字节（ID3/帧同步字、fLaC、RIFF/WAVE、ftyp、ADTS、TS 同步字节）
+ * 判断容器格式，不依赖文件扩展名。扩展名只用于目录枚举时的快速过滤。
+ */
+
+/**
+ * @brief WAV 中可以直接输出的 PCM 数据信息
+ */
+typedef struct
+{
+    uint32_t sample_rate; // 采样率
+    uint8_t channels;     // 通道数
+    uint8_t bits;         // 位深度
+    uint32_t data_offset; // data 块在文件中的偏移
+    uint32_t data_size;   // data 块长度，未知时为 UINT32_MAX
+} audio_probe_wav_t;
+
+/**
+ * @brief MP3（Layer III）或 ADTS 帧头解析结果
+ */
+typedef struct
+{
+    uint32_t frame_len;   // 帧长度（字节）
+    uint32_t samples;     // 每帧采样数
+    uint32_t sample_rate; // 采样率
+    uint32_t side_len;    // MP3 边信息长度（含可选 CRC），ADTS 为 0
+} audio_probe_frame_t;
+
+/**
+ * @brief 按特征字节识别格式
+ *
+ * @param[in] buf 文件开头的数据（建议至少 4 KB，可跨过较小的 ID3v2 标签）
+ * @param[in] len 数据长度
+ * @return 简单解码器类型，无法识别返回 ESP_AUDIO_SIMPLE_DEC_TYPE_NONE
+ */
+esp_audio_simple_dec_type_t audio_probe_type(const uint8_t *buf, size_t len);
+
+/**
+ * @brief 格式名称，用于日志
+ */
+const char *audio_probe_type_name(esp_audio_simple_dec_type_t type);
+
+/**
+ * @brief ID3v2 标签总长度（含标签头和页脚），没有标签返回 0
+ */
+size_t audio_probe_id3v2_size(const uint8_t *buf, size_t len);
+
+/**
+ * @brief 解析 WAV 头，判断是否为可直接输出的整数 PCM（16/24/32 位，1~2 通道）
+ *
+ * @param[in]  buf 文件开头的数据
+ * @param[in]  len 数据长度
+ * @param[out] wav PCM 数据信息
+ * @return 是否可以跳过解码直接输出
+ */
+bool audio_probe_wav_pcm(const uint8_t *buf, size_t len, audio_probe_wav_t *wav);
+
+/**
+ * @brief 解析 MPEG Layer III 帧头（至少 4 字节）
+ */
+bool audio_probe_mp3_frame(const uint8_t *p, audio_probe_frame_t *frame);
+
+/**
+ * @brief 解析 ADTS 帧头（至少 7 字节）
+ */
+bool audio_probe_adts_frame(const uint8_t *p, audio_probe_frame_t *frame);
+
+/**
+ * @brief 按扩展名判断是否可能是支持的音频文件（不区分大小写），用于目录枚举
+ */
+bool audio_probe_is_audio_file(const char *file_name);
+
+#ifdef __cplusplus
+}
+#endif
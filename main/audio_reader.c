@@ -0,0 +1,358 @@
+#include "audio_reader.h"
+
+#include <stdio.h>
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <sys/stat.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "audio_trace.h"
+
+static const char *TAG = "AUDIO_READER";
+
+#define READER_TASK_STACK_SIZE 1024 * 3
+// 关闭时通知读取任务退出的哨兵
+#define READER_BLOCK_STOP 0xFF
+
+typedef enum
+{
+    READER_BLOCK_OK = 0,
+    READER_BLOCK_EOF,
+    READER_BLOCK_ERROR,
+} reader_block_status_t;
+
+// 读取任务交给解码任务的块
+typedef struct
+{
+    uint8_t idx;
+    uint8_t status;
+    uint32_t len;
+    uint32_t gen; // 读取时的跳转代数，跳转前预读的块会被丢弃
+    int64_t done_us; // 读完的时间（延迟统计用）
+} reader_block_t;
+
+struct audio_reader
+{
+    FILE *file;
+    uint32_t size;
+    uint32_t block_num;
+    uint32_t block_size;
+    uint8_t **mem;           // 分配的内存（含 headroom）
+    bool own_mem;            // 块内存是否由自己分配
+    uint8_t **blocks;        // 块数据起始位置
+    QueueHandle_t free_q;    // 空闲块编号
+    QueueHandle_t full_q;    // 已填充的块
+    SemaphoreHandle_t done_sem;
+    TaskHandle_t task;
+    atomic_bool stop;
+    atomic_uint gen;         // 每次跳转加一
+    atomic_uint seek_offset;
+    atomic_bool all_read;    // 当前代的数据已全部读完
+    // 仅解码任务访问
+    int held;                // 解码任务正在使用的块，-1 表示没有
+    int64_t held_us;         // 该块读完的时间
+    audio_reader_stats_t stats;
+};
+
+static void audio_reader_task(void *arg)
+{
+    struct audio_reader *r = arg;
+    uint32_t gen = 0;
+    bool done = false; // 已读到文件末尾或出错
+    int idx = -1;
+    while (!atomic_load(&r->stop))
+    {
+        if (idx < 0)
+        {
+            uint8_t free_idx;
+            xQueueReceive(r->free_q, &free_idx, portMAX_DELAY);
+            if (free_idx == READER_BLOCK_STOP || atomic_load(&r->stop))
+            {
+                break;
+            }
+            idx = free_idx;
+        }
+        uint32_t cur_gen = atomic_load(&r->gen);
+        if (cur_gen != gen)
+        {
+            gen = cur_gen;
+            clearerr(r->file);
+            fseek(r->file, atomic_load(&r->seek_offset), SEEK_SET);
+            done = false;
+            atomic_store(&r->all_read, false);
+        }
+        if (done)
+        {
+            // 等待跳转或关闭
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+
+        int64_t start = esp_timer_get_time();
+        size_t n = fread(r->blocks[idx], 1, r->block_size, r->file);
+        uint32_t read_us = (uint32_t)(esp_timer_get_time() - start);
+        r->stats.bytes += n;
+        r->stats.read_us += read_us;
+        if (read_us > r->stats.max_read_us)
+        {
+            r->stats.max_read_us = read_us;
+        }
+
+        reader_block_t block = {
+            .idx = (uint8_t)idx,
+            .status = READER_BLOCK_OK,
+            .len = n,
+            .gen = gen,
+            .done_us = AUDIO_TRACE_NOW(),
+        };
+        if (ferror(r->file))
+        {
+            block.status = READER_BLOCK_ERROR;
+            done = true;
+        }
+        else if (n == 0)
+        {
+            block.status = READER_BLOCK_EOF;
+            done = true;
+        }
+        if (block.status != READER_BLOCK_OK || feof(r->file))
+        {
+            atomic_store(&r->all_read, gen == atomic_load(&r->gen));
+        }
+        // full_q 长度等于块数量，不会阻塞
+        xQueueSend(r->full_q, &block, portMAX_DELAY);
+        idx = -1;
+    }
+    xSemaphoreGive(r->done_sem);
+    vTaskDelete(NULL);
+}
+
+static void audio_reader_free(struct audio_reader *r)
+{
+    if (r->mem && r->own_mem)
+    {
+        for (uint32_t i = 0; i < r->block_num; i++)
+        {
+            heap_caps_free(r->mem[i]);
+        }
+    }
+    free(r->mem);
+    free(r->blocks);
+    if (r->free_q)
+    {
+        vQueueDelete(r->free_q);
+    }
+    if (r->full_q)
+    {
+        vQueueDelete(r->full_q);
+    }
+    if (r->done_sem)
+    {
+        vSemaphoreDelete(r->done_sem);
+    }
+    if (r->file)
+    {
+        fclose(r->file);
+    }
+    free(r);
+}
+
+static uint32_t audio_reader_headroom(const audio_reader_config_t *config)
+{
+    return (config->headroom + AUDIO_READER_ALIGN - 1) & ~(AUDIO_READER_ALIGN - 1);
+}
+
+uint32_t audio_reader_mem_size(const audio_reader_config_t *config)
+{
+    uint32_t block = (audio_reader_headroom(config) + config->block_size + AUDIO_READER_ALIGN - 1) & ~(AUDIO_READER_ALIGN - 1);
+    return block * config->block_num;
+}
+
+esp_err_t audio_reader_open(const char *path, const audio_reader_config_t *config, uint32_t offset,
+                            audio_reader_handle_t *reader)
+{
+    if (path == NULL || config == NULL || reader == NULL || config->block_num < 2 ||
+        config->block_num >= READER_BLOCK_STOP || config->block_size == 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    struct audio_reader *r = calloc(1, sizeof(struct audio_reader));
+    if (r == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    struct stat st;
+    r->file = stat(path, &st) == 0 ? fopen(path, "rb") : NULL;
+    if (r->file == NULL)
+    {
+        ESP_LOGE(TAG, "Failed to open file: %s", path);
+        audio_reader_free(r);
+        return ESP_ERR_NOT_FOUND;
+    }
+    // 读取任务自己按块读取，关闭 stdio 缓冲避免多一次拷贝
+    setvbuf(r->file, NULL, _IONBF, 0);
+    if (offset > 0)
+    {
+        fseek(r->file, offset, SEEK_SET);
+    }
+    r->size = st.st_size;
+    r->block_num = config->block_num;
+    r->block_size = config->block_size;
+    r->held = -1;
+    atomic_init(&r->stop, false);
+    atomic_init(&r->gen, 0);
+    atomic_init(&r->seek_offset, 0);
+    atomic_init(&r->all_read, false);
+
+    uint32_t headroom = audio_reader_headroom(config);
+    r->mem = calloc(r->block_num, sizeof(uint8_t *));
+    r->blocks = calloc(r->block_num, sizeof(uint8_t *));
+    r->free_q = xQueueCreate(r->block_num + 1, sizeof(uint8_t));
+    r->full_q = xQueueCreate(r->block_num, sizeof(reader_block_t));
+    r->done_sem = xSemaphoreCreateBinary();
+    if (r->mem == NULL || r->blocks == NULL || r->free_q == NULL || r->full_q == NULL || r->done_sem == NULL)
+    {
+        audio_reader_free(r);
+        return ESP_ERR_NO_MEM;
+    }
+    r->own_mem = config->mem == NULL;
+    uint32_t stride = audio_reader_mem_size(config) / r->block_num;
+    for (uint32_t i = 0; i < r->block_num; i++)
+    {
+        if (!r->own_mem)
+        {
+            r->mem[i] = config->mem + i * stride;
+        }
+        else if ((r->mem[i] = heap_caps_aligned_alloc(AUDIO_READER_ALIGN, headroom + r->block_size, config->caps)) == NULL)
+        {
+            ESP_LOGW(TAG, "Block %" PRIu32 " falls back to PSRAM", i);
+            r->mem[i] = heap_caps_aligned_alloc(AUDIO_READER_ALIGN, headroom + r->block_size, MALLOC_CAP_SPIRAM);
+        }
+        if (r->mem[i] == NULL)
+        {
+            audio_reader_free(r);
+            return ESP_ERR_NO_MEM;
+        }
+        r->blocks[i] = r->mem[i] + headroom;
+        uint8_t idx = (uint8_t)i;
+        xQueueSend(r->free_q, &idx, 0);
+    }
+
+    if (xTaskCreatePinnedToCore(audio_reader_task, "audio_reader", READER_TASK_STACK_SIZE, r, config->task_prio, &r->task,
+                                config->task_core) != pdPASS)
+    {
+        audio_reader_free(r);
+        return ESP_ERR_NO_MEM;
+    }
+    *reader = r;
+    return ESP_OK;
+}
+
+void audio_reader_close(audio_reader_handle_t reader)
+{
+    if (reader == NULL)
+    {
+        return;
+    }
+    atomic_store(&reader->stop, true);
+    uint8_t stop = READER_BLOCK_STOP;
+    // free_q 比块数量多一个位置，哨兵总能放进去
+    xQueueSend(reader->free_q, &stop, 0);
+    xTaskNotifyGive(reader->task);
+    xSemaphoreTake(reader->done_sem, portMAX_DELAY);
+    audio_reader_free(reader);
+}
+
+static void audio_reader_put(audio_reader_handle_t reader, uint8_t idx)
+{
+    xQueueSend(reader->free_q, &idx, 0);
+}
+
+esp_err_t audio_reader_next(audio_reader_handle_t reader, uint8_t **data, uint32_t *len, TickType_t timeout)
+{
+    if (reader->held >= 0)
+    {
+        audio_reader_put(reader, (uint8_t)reader->held);
+        reader->held = -1;
+    }
+    reader_block_t block;
+    while (1)
+    {
+        bool waited = uxQueueMessagesWaiting(reader->full_q) == 0;
+        int64_t start = esp_timer_get_time();
+        if (xQueueReceive(reader->full_q, &block, timeout) != pdTRUE)
+        {
+            return ESP_ERR_TIMEOUT;
+        }
+        if (waited)
+        {
+            uint32_t stall_us = (uint32_t)(esp_timer_get_time() - start);
+            reader->stats.stall_count++;
+            if (stall_us > reader->stats.max_stall_us)
+            {
+                reader->stats.max_stall_us = stall_us;
+            }
+        }
+        // 跳转前预读的块直接归还
+        if (block.gen == atomic_load(&reader->gen))
+        {
+            break;
+        }
+        audio_reader_put(reader, block.idx);
+    }
+
+    if (block.status != READER_BLOCK_OK)
+    {
+        audio_reader_put(reader, block.idx);
+        return block.status == READER_BLOCK_EOF ? ESP_ERR_NOT_FOUND : ESP_FAIL;
+    }
+    AUDIO_TRACE_SPAN(AUDIO_TRACE_READ_WAIT, block.done_us);
+    reader->held = block.idx;
+    reader->held_us = block.done_us;
+    *data = reader->blocks[block.idx];
+    *len = block.len;
+    return ESP_OK;
+}
+
+esp_err_t audio_reader_seek(audio_reader_handle_t reader, uint32_t offset)
+{
+    if (offset > reader->size)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (reader->held >= 0)
+    {
+        audio_reader_put(reader, (uint8_t)reader->held);
+        reader->held = -1;
+    }
+    atomic_store(&reader->seek_offset, offset);
+    atomic_store(&reader->all_read, false);
+    atomic_fetch_add(&reader->gen, 1);
+    xTaskNotifyGive(reader->task);
+    return ESP_OK;
+}
+
+bool audio_reader_all_read(audio_reader_handle_t reader)
+{
+    return atomic_load(&reader->all_read);
+}
+
+uint32_t audio_reader_size(audio_reader_handle_t reader)
+{
+    return reader->size;
+}
+
+int64_t audio_reader_block_time(audio_reader_handle_t reader)
+{
+    return reader->held >= 0 ? reader->held_us : 0;
+}
+
+void audio_reader_get_stats(audio_reader_handle_t reader, audio_reader_stats_t *stats)
+{
+    *stats = reader->stats;
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 文件预读
+ *
+ * 每个打开的文件有一个读取任务和 N 个对齐的数据块，读取任务提前把文件读进空闲块，
+ * 解码任务按顺序取得已填充的块，直接在块内解码，用完后归还。SD 卡偶尔的慢速访问
+ * 只消耗预读的余量，不会直接卡住解码。
+ *
+ * 每个块前面留有 headroom 字节，解码任务可以把上一块没用完的尾部数据拷贝到这里，
+ * 使跨块的一帧在内存中连续。
+ */
+
+/**
+ * @brief 预读配置
+ */
+typedef struct
+{
+    uint32_t block_num;    // 块数量（2 为双缓冲，3 为三缓冲）
+    uint32_t block_size;   // 每次读取的字节数，建议为 FAT 簇大小的整数倍
+    uint32_t headroom;     // 每块前面预留的字节数
+    uint32_t caps;         // 块内存的 heap_caps 属性，分配失败时退回 PSRAM
+    uint8_t *mem;          // 调用方提供的块内存（audio_reader_mem_size 字节，AUDIO_READER_ALIGN 对齐），NULL 时自行分配
+    UBaseType_t task_prio; // 读取任务优先级
+    BaseType_t task_core;  // 读取任务所在的核
+} audio_reader_config_t;
+
+/**
+ * @brief 预读统计
+ */
+typedef struct
+{
+    uint64_t bytes;        // 已读取的字节数
+    uint64_t read_us;      // fread 累计耗时
+    uint32_t max_read_us;  // 单次 fread 最长耗时
+    uint32_t max_stall_us; // 解码任务等待数据的最长时间
+    uint32_t stall_count;  // 解码任务需要等待的次数
+} audio_reader_stats_t;
+
+typedef struct audio_reader *audio_reader_handle_t;
+
+// 块数据按 cache line 对齐，便于 SDMMC DMA 直接写入
+#define AUDIO_READER_ALIGN 64
+
+/**
+ * @brief 按配置需要的块内存大小（调用方提供块内存时使用）
+ */
+uint32_t audio_reader_mem_size(const audio_reader_config_t *config);
+
+/**
+ * @brief 打开文件并从 offset 处开始预读
+ *
+ * @return
+ *  - ESP_OK 成功
+ *  - ESP_ERR_INVALID_ARG 参数无效
+ *  - ESP_ERR_NOT_FOUND 文件打开失败
+ *  - ESP_ERR_NO_MEM 内存不足
+ */
+esp_err_t audio_reader_open(const char *path, const audio_reader_config_t *config, uint32_t offset,
+                            audio_reader_handle_t *reader);
+
+/**
+ * @brief 停止读取任务并关闭文件，已取得的块随之失效
+ */
+void audio_reader_close(audio_reader_handle_t reader);
+
+/**
+ * @brief 取得下一个已填充的块，前一个块自动归还
+ *
+ * @param[in]  reader  预读句柄
+ * @param[out] data    块数据（前面有 headroom 字节可写）
+ * @param[out] len     数据长度
+ * @param[in]  timeout 等待时间
+ * @return
+ *  - ESP_OK 成功
+ *  - ESP_ERR_NOT_FOUND 文件已读完
+ *  - ESP_ERR_TIMEOUT 超时
+ *  - ESP_FAIL 读取出错
+ */
+esp_err_t audio_reader_next(audio_reader_handle_t reader, uint8_t **data, uint32_t *len, TickType_t timeout);
+
+/**
+ * @brief 从 offset 处重新开始预读，已预读的数据全部丢弃
+ */
+esp_err_t audio_reader_seek(audio_reader_handle_t reader, uint32_t offset);
+
+/**
+ * @brief 文件是否已全部读进预读块（解码任务可能还没取完）
+ */
+bool audio_reader_all_read(audio_reader_handle_t reader);
+
+/**
+ * @brief 文件长度
+ */
+uint32_t audio_reader_size(audio_reader_handle_t reader);
+
+/**
+ * @brief 最近一次 audio_reader_next 取得的块从 SD 卡读完的时间（esp_timer 微秒），
+ *        用于延迟统计；没有块或未启用 AUDIO_TRACE_ENABLE 时为 0
+ */
+int64_t audio_reader_block_time(audio_reader_handle_t reader);
+
+/**
+ * @brief 读取统计
+ */
+void audio_reader_get_stats(audio_reader_handle_t reader, audio_reader_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,481 @@
+#include "audio_seek.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <string.h>
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "audio_probe.h"
+#include "audio_mem.h"
+
+static const char *TAG = "AUDIO_SEEK";
+
+// 扫描帧头时每次读取的字节数，也是 VBRI 表的长度上限
+#define SEEK_WINDOW_SIZE 1024 * 16
+// 在文件开头或估计位置之后查找帧同步字时最多扫描的字节数
+#define SEEK_SYNC_SEARCH_LEN 1024 * 64
+// 索引数组每次扩容的条目数
+#define SEEK_INDEX_GROW 256
+
+typedef enum
+{
+    SEEK_TOC_NONE = 0,
+    SEEK_TOC_XING, // Xing/Info 帧中 100 项的百分比表
+    SEEK_TOC_VBRI, // VBRI 表（已转换为帧索引）
+} seek_toc_t;
+
+// 稀疏帧索引条目
+typedef struct
+{
+    uint32_t offset; // 帧头在文件中的位置
+    uint64_t sample; // 该帧第一个采样的序号（帧头采样率）
+} seek_entry_t;
+
+// 一个文件的定位信息
+typedef struct
+{
+    char path[256];
+    uint32_t audio_start;
+    uint32_t audio_end;
+    esp_audio_simple_dec_type_t type;
+    uint32_t last_used;    // 最近使用的序号，缓存满时替换最久未用的
+    uint32_t sample_rate;  // 帧头中的采样率
+    uint32_t frame_samples;
+    seek_toc_t toc_type;
+    uint8_t xing_toc[100];
+    uint32_t xing_offset;  // Xing 帧的位置，TOC 相对于它
+    uint32_t xing_bytes;   // TOC 覆盖的字节数
+    uint64_t xing_samples; // TOC 覆盖的采样数
+    seek_entry_t *index;
+    uint32_t index_num;
+    uint32_t index_cap;
+    // 顺序扫描的进度，下次从这里继续
+    uint32_t scan_offset;
+    uint64_t scan_sample;
+    uint32_t scan_frames;
+    bool scan_done;
+} seek_cache_t;
+
+// 读取窗口：按顺序扫描帧头时只在越过窗口时才重新读取
+typedef struct
+{
+    FILE *file;
+    uint8_t *buf;
+    uint32_t start;
+    uint32_t len;
+} seek_window_t;
+
+static seek_cache_t s_cache[AUDIO_SEEK_CACHE_NUM];
+static uint32_t s_cache_clock = 0;
+
+static uint32_t read_be16(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 8) | p[1];
+}
+
+static uint32_t read_be32(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+// 取得 [pos, pos + need) 的数据，不在窗口内时从 pos 处重新读取
+static const uint8_t *window_get(seek_window_t *w, uint32_t pos, uint32_t need)
+{
+    if (pos >= w->start && pos + need <= w->start + w->len)
+    {
+        return w->buf + (pos - w->start);
+    }
+    if (fseek(w->file, pos, SEEK_SET) != 0)
+    {
+        return NULL;
+    }
+    w->start = pos;
+    w->len = fread(w->buf, 1, SEEK_WINDOW_SIZE, w->file);
+    return need <= w->len ? w->buf : NULL;
+}
+
+// 取得 [pos, pos + need) 的数据，不在窗口内时只把这几个字节读到 tmp，窗口不动
+static const uint8_t *window_peek(seek_window_t *w, uint32_t pos, uint32_t need, uint8_t *tmp)
+{
+    if (pos >= w->start && pos + need <= w->start + w->len)
+    {
+        return w->buf + (pos - w->start);
+    }
+    if (fseek(w->file, pos, SEEK_SET) != 0 || fread(tmp, 1, need, w->file) != need)
+    {
+        return NULL;
+    }
+    return tmp;
+}
+
+static bool parse_frame(const seek_cache_t *c, const uint8_t *p, audio_probe_frame_t *frame)
+{
+    if (c->type == ESP_AUDIO_SIMPLE_DEC_TYPE_MP3)
+    {
+        return audio_probe_mp3_frame(p, frame);
+    }
+    return audio_probe_adts_frame(p, frame);
+}
+
+// pos 处是否为可信的帧：帧头有效，下一帧帧头也有效且采样率相同（或正好到达音频数据末尾）
+static bool frame_at(const seek_cache_t *c, seek_window_t *w, uint32_t pos, audio_probe_frame_t *frame)
+{
+    const uint8_t *p = window_get(w, pos, 7);
+    if (p == NULL || !parse_frame(c, p, frame))
+    {
+        return false;
+    }
+    uint32_t next = pos + frame->frame_len;
+    if (next >= c->audio_end)
+    {
+        return next == c->audio_end;
+    }
+    // 下一帧在窗口外时单独读帧头：伪同步字指向的位置不可信，窗口移过去后
+    // 继续向后查找又要从 pos + 1 重新读整个窗口
+    uint8_t tmp[7];
+    audio_probe_frame_t next_frame;
+    p = window_peek(w, next, sizeof(tmp), tmp);
+    return p != NULL && parse_frame(c, p, &next_frame) && next_frame.sample_rate == frame->sample_rate;
+}
+
+// 从 pos 开始向后查找第一个可信的帧
+static bool frame_sync(const seek_cache_t *c, seek_window_t *w, uint32_t *pos, audio_probe_frame_t *frame)
+{
+    uint32_t end = *pos + SEEK_SYNC_SEARCH_LEN < c->audio_end ? *pos + SEEK_SYNC_SEARCH_LEN : c->audio_end;
+    for (uint32_t p = *pos; p + 7 <= end; p++)
+    {
+        if (frame_at(c, w, p, frame))
+        {
+            *pos = p;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool index_append(seek_cache_t *c, uint32_t offset, uint64_t sample)
+{
+    if (c->index_num == c->index_cap)
+    {
+        uint32_t cap = c->index_cap + SEEK_INDEX_GROW;
+        seek_entry_t *index = heap_caps_realloc(c->index, cap * sizeof(seek_entry_t), audio_mem_caps(AUDIO_MEM_BULK));
+        if (index == NULL)
+        {
+            return false;
+        }
+        c->index = index;
+        c->index_cap = cap;
+    }
+    c->index[c->index_num].offset = offset;
+    c->index[c->index_num].sample = sample;
+    c->index_num++;
+    return true;
+}
+
+/*
+ * Xing/Info 帧：帧头 + 边信息之后是 "Xing"/"Info"、标志位和可选的帧数/字节数/TOC；
+ * VBRI 帧：帧头之后 32 字节处是 "VBRI"，其后为版本、延迟、质量、字节数、帧数、
+ * 表项数、缩放系数、表项字节数和每项帧数，最后是每项的字节数表。
+ * 两种帧本身都不含音频，返回第一个音频帧的位置。
+ */
+static uint32_t parse_toc(seek_cache_t *c, seek_window_t *w, uint32_t pos, const audio_probe_frame_t *frame)
+{
+    const uint8_t *p = window_get(w, pos, frame->frame_len);
+    if (c->type != ESP_AUDIO_SIMPLE_DEC_TYPE_MP3 || p == NULL)
+    {
+        return pos;
+    }
+    const uint8_t *xing = p + 4 + frame->side_len;
+    if (4 + frame->side_len + 8 <= frame->frame_len && (memcmp(xing, "Xing", 4) == 0 || memcmp(xing, "Info", 4) == 0))
+    {
+        uint32_t flags = read_be32(xing + 4);
+        const uint8_t *q = xing + 8;
+        uint32_t frames = 0;
+        uint32_t bytes = c->audio_end - pos;
+        if (flags & 0x01)
+        {
+            frames = read_be32(q);
+            q += 4;
+        }
+        if (flags & 0x02)
+        {
+            bytes = read_be32(q);
+            q += 4;
+        }
+        if ((flags & 0x04) && frames > 0 && q + 100 <= p + frame->frame_len)
+        {
+            memcpy(c->xing_toc, q, sizeof(c->xing_toc));
+            c->toc_type = SEEK_TOC_XING;
+            c->xing_offset = pos;
+            c->xing_bytes = bytes;
+            c->xing_samples = (uint64_t)frames * frame->samples;
+        }
+        return pos + frame->frame_len;
+    }
+
+    const uint8_t *vbri = p + 4 + 32;
+    if (4 + 32 + 26 <= frame->frame_len && memcmp(vbri, "VBRI", 4) == 0)
+    {
+        uint32_t entries = read_be16(vbri + 18);
+        uint32_t scale = read_be16(vbri + 20);
+        uint32_t entry_size = read_be16(vbri + 22);
+        uint32_t frames_per_entry = read_be16(vbri + 24);
+        uint32_t audio_pos = pos + frame->frame_len;
+        const uint8_t *table = vbri + 26;
+        if (entry_size >= 1 && entry_size <= 4 && entries > 0 && frames_per_entry > 0 &&
+            (table - p) + entries * entry_size <= w->len - (pos - w->start))
+        {
+            uint32_t offset = audio_pos;
+            uint64_t sample = 0;
+            bool ok = index_append(c, offset, sample);
+            for (uint32_t i = 0; ok && i < entries; i++)
+            {
+                uint32_t size = 0;
+                for (uint32_t b = 0; b < entry_size; b++)
+                {
+                    size = (size << 8) | table[i * entry_size + b];
+                }
+                offset += size * scale;
+                sample += (uint64_t)frames_per_entry * frame->samples;
+                if (offset >= c->audio_end)
+                {
+                    break;
+                }
+                ok = index_append(c, offset, sample);
+            }
+            if (ok)
+            {
+                c->toc_type = SEEK_TOC_VBRI;
+                c->scan_done = true;
+            }
+            else
+            {
+                c->index_num = 0;
+            }
+        }
+        return audio_pos;
+    }
+    return pos;
+}
+
+static void cache_free(seek_cache_t *c)
+{
+    heap_caps_free(c->index);
+    memset(c, 0, sizeof(seek_cache_t));
+}
+
+// 新建缓存项：找到第一个帧，解析 TOC，索引的第一项为第一个音频帧
+static esp_err_t cache_init(seek_cache_t *c, const audio_seek_file_t *file, seek_window_t *w)
+{
+    cache_free(c);
+    strncpy(c->path, file->path, sizeof(c->path) - 1);
+    c->audio_start = file->audio_start;
+    c->audio_end = file->audio_end;
+    c->type = file->type;
+
+    uint32_t pos = file->audio_start;
+    audio_probe_frame_t frame;
+    if (!frame_sync(c, w, &pos, &frame))
+    {
+        ESP_LOGW(TAG, "No frame sync in %s", file->path);
+        cache_free(c);
+        return ESP_ERR_NOT_FOUND;
+    }
+    c->sample_rate = frame.sample_rate;
+    c->frame_samples = frame.samples;
+    uint32_t audio_pos = parse_toc(c, w, pos, &frame);
+    if (c->toc_type != SEEK_TOC_VBRI)
+    {
+        if (!index_append(c, audio_pos, 0))
+        {
+            cache_free(c);
+            return ESP_ERR_NO_MEM;
+        }
+        c->scan_offset = audio_pos;
+    }
+    ESP_LOGI(TAG, "%s: %s, %" PRIu32 " Hz", file->path,
+             c->toc_type == SEEK_TOC_XING ? "Xing TOC" : (c->toc_type == SEEK_TOC_VBRI ? "VBRI table" : "frame index"),
+             c->sample_rate);
+    return ESP_OK;
+}
+
+// 取得文件的缓存项，没有时替换最久未用的一项
+static seek_cache_t *cache_get(const audio_seek_file_t *file, bool *found)
+{
+    seek_cache_t *victim = &s_cache[0];
+    for (int i = 0; i < AUDIO_SEEK_CACHE_NUM; i++)
+    {
+        seek_cache_t *c = &s_cache[i];
+        // 文件长度或标签变化时视为新文件
+        if (c->path[0] != '\0' && strcmp(c->path, file->path) == 0 && c->audio_start == file->audio_start &&
+            c->audio_end == file->audio_end && c->type == file->type)
+        {
+            c->last_used = ++s_cache_clock;
+            *found = true;
+            return c;
+        }
+        if (c->last_used < victim->last_used)
+        {
+            victim = c;
+        }
+    }
+    victim->last_used = ++s_cache_clock;
+    *found = false;
+    return victim;
+}
+
+// 从上次扫描结束的位置继续扫描帧头，直到越过 target 或到达末尾
+static esp_err_t index_extend(seek_cache_t *c, seek_window_t *w, uint64_t target)
+{
+    while (!c->scan_done && c->scan_sample <= target)
+    {
+        audio_probe_frame_t frame;
+        uint32_t pos = c->scan_offset;
+        const uint8_t *p = window_get(w, pos, 7);
+        if (p == NULL || !parse_frame(c, p, &frame))
+        {
+            // 帧之间有垃圾数据时重新同步
+            if (pos + 7 > c->audio_end || !frame_sync(c, w, &pos, &frame))
+            {
+                c->scan_done = true;
+                break;
+            }
+        }
+        if (c->scan_frames > 0 && c->scan_frames % AUDIO_SEEK_INDEX_INTERVAL == 0 && !index_append(c, pos, c->scan_sample))
+        {
+            return ESP_ERR_NO_MEM;
+        }
+        c->scan_offset = pos + frame.frame_len;
+        c->scan_sample += frame.samples;
+        c->scan_frames++;
+        if (c->scan_offset >= c->audio_end)
+        {
+            c->scan_done = true;
+        }
+    }
+    return ESP_OK;
+}
+
+// 按 Xing TOC 插值估计字节位置
+static uint32_t xing_estimate(const seek_cache_t *c, uint64_t target)
+{
+    // 以 1/1000 为单位的百分比，再在相邻两项之间线性插值
+    uint32_t permille = (uint32_t)(target * 100000 / c->xing_samples);
+    uint32_t i = permille / 1000;
+    if (i > 99)
+    {
+        i = 99;
+        permille = 99999;
+    }
+    uint32_t a = c->xing_toc[i];
+    uint32_t b = i < 99 ? c->xing_toc[i + 1] : 256;
+    uint32_t scaled = a * 1000 + (b - a) * (permille - i * 1000); // 1/256000 单位
+    return c->xing_offset + (uint32_t)((uint64_t)scaled * c->xing_bytes / 256000);
+}
+
+esp_err_t audio_seek_lookup(const audio_seek_file_t *file, uint64_t sample, uint32_t sample_rate, audio_seek_point_t *point)
+{
+    if (file == NULL || file->path == NULL || point == NULL || sample_rate == 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (file->type != ESP_AUDIO_SIMPLE_DEC_TYPE_MP3 && file->type != ESP_AUDIO_SIMPLE_DEC_TYPE_AAC)
+    {
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    seek_window_t w = {0};
+    w.file = fopen(file->path, "rb");
+    w.buf = audio_mem_alloc(AUDIO_MEM_BULK, SEEK_WINDOW_SIZE);
+    esp_err_t err = ESP_OK;
+    if (w.file == NULL || w.buf == NULL)
+    {
+        err = w.file == NULL ? ESP_ERR_NOT_FOUND : ESP_ERR_NO_MEM;
+        goto exit;
+    }
+    // 窗口由 stdio 之外的缓冲区承担
+    setvbuf(w.file, NULL, _IONBF, 0);
+
+    bool found;
+    seek_cache_t *c = cache_get(file, &found);
+    if (!found && (err = cache_init(c, file, &w)) != ESP_OK)
+    {
+        goto exit;
+    }
+
+    // 换算到帧头采样率，并至少提前一帧
+    uint64_t target = sample * c->sample_rate / sample_rate;
+    uint64_t preroll = target > c->frame_samples ? target - c->frame_samples : 0;
+
+    if (c->toc_type == SEEK_TOC_XING && target >= c->xing_samples)
+    {
+        // 超出曲目长度
+        point->offset = c->audio_end;
+        point->sample = c->xing_samples * sample_rate / c->sample_rate;
+        point->exact = true;
+        goto exit;
+    }
+    if (c->toc_type == SEEK_TOC_XING)
+    {
+        uint32_t pos = xing_estimate(c, preroll);
+        audio_probe_frame_t frame;
+        if (pos < c->index[0].offset)
+        {
+            pos = c->index[0].offset;
+        }
+        if (pos < c->audio_end && frame_sync(c, &w, &pos, &frame))
+        {
+            point->offset = pos;
+            point->sample = target * sample_rate / c->sample_rate;
+            point->exact = false;
+            goto exit;
+        }
+    }
+
+    if ((err = index_extend(c, &w, target)) != ESP_OK)
+    {
+        goto exit;
+    }
+    if (c->scan_done && target >= c->scan_sample && c->toc_type != SEEK_TOC_VBRI)
+    {
+        // 超出曲目长度
+        point->offset = c->audio_end;
+        point->sample = c->scan_sample * sample_rate / c->sample_rate;
+        point->exact = true;
+        goto exit;
+    }
+    // 二分查找最后一个不晚于 preroll 的索引项
+    uint32_t lo = 0;
+    uint32_t hi = c->index_num;
+    while (hi - lo > 1)
+    {
+        uint32_t mid = (lo + hi) / 2;
+        if (c->index[mid].sample <= preroll)
+        {
+            lo = mid;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    point->offset = c->index[lo].offset;
+    point->sample = c->index[lo].sample * sample_rate / c->sample_rate;
+    point->exact = true;
+
+exit:
+    if (w.file)
+    {
+        fclose(w.file);
+    }
+    heap_caps_free(w.buf);
+    return err;
+}
+
+void audio_seek_cache_clear(void)
+{
+    for (int i = 0; i < AUDIO_SEEK_CACHE_NUM; i++)
+    {
+        cache_free(&s_cache[i]);
+    }
+}
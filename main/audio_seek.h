@@ -0,0 +1,74 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "esp_audio_simple_dec.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief MP3/ADTS 跳转定位
+ *
+ * MP3 的 Xing/Info 帧带有 TOC 时按 TOC 插值得到字节位置，再在附近重新同步帧头；
+ * 带 VBRI 表时直接把表作为帧索引。两者都没有（以及 ADTS AAC）时，按需顺序扫描帧头，
+ * 每 AUDIO_SEEK_INDEX_INTERVAL 帧记录一个位置，建立稀疏帧索引。
+ *
+ * 索引按文件缓存（最近使用的 AUDIO_SEEK_CACHE_NUM 个文件），之后的跳转在索引中
+ * 二分查找，只有目标超出已扫描的范围时才从上次扫描结束的位置继续向后扫描。
+ *
+ * 只在解码任务中调用，内部不加锁。
+ */
+
+#define AUDIO_SEEK_INDEX_INTERVAL 64
+#define AUDIO_SEEK_CACHE_NUM 4
+
+/**
+ * @brief 要定位的文件
+ */
+typedef struct
+{
+    const char *path;
+    esp_audio_simple_dec_type_t type; // 只支持 MP3 和 AAC（ADTS）
+    uint32_t audio_start;             // 音频数据起始位置（ID3v2 标签之后）
+    uint32_t audio_end;               // 音频数据结束位置（ID3v1/APE 标签之前）
+} audio_seek_file_t;
+
+/**
+ * @brief 定位结果
+ */
+typedef struct
+{
+    uint32_t offset; // 从这个位置开始送入解码器（帧头），目标超出曲目长度时为 audio_end
+    uint64_t sample; // offset 处第一帧的第一个采样在解码输出中的序号
+    bool exact;      // sample 是否精确；按 Xing TOC 插值时为估计值，等于目标采样
+} audio_seek_point_t;
+
+/**
+ * @brief 查找解码输出第 sample 个采样之前最近的帧
+ *
+ * 返回的位置至少在目标之前一帧，解码器从这里开始输出的第一帧（可能缺少比特储备）
+ * 会在裁剪时丢弃。
+ *
+ * @param[in]  file        要定位的文件
+ * @param[in]  sample      目标采样序号（解码输出的采样率，含编码器延迟）
+ * @param[in]  sample_rate 解码输出的采样率（HE-AAC 可能是帧头采样率的两倍）
+ * @param[out] point       定位结果
+ * @return
+ *  - ESP_OK 成功
+ *  - ESP_ERR_NOT_SUPPORTED 格式不支持跳转
+ *  - ESP_ERR_NOT_FOUND 文件无法打开或找不到帧头
+ *  - ESP_ERR_NO_MEM 内存不足
+ */
+esp_err_t audio_seek_lookup(const audio_seek_file_t *file, uint64_t sample, uint32_t sample_rate, audio_seek_point_t *point);
+
+/**
+ * @brief 清空所有文件的定位缓存并释放帧索引（例如卸载存储之前）
+ */
+void audio_seek_cache_clear(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,224 @@
+#pragma once
+
+#include <stdint.h>
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 音频处理用的向量内核
+ *
+ * ESP32-S3 上使用 PIE 128 位向量指令（audio_simd_aes3.S），其余芯片使用标量实现。
+ * 向量内核的要求：
+ *  - 系数/第二操作数 16 字节对齐
+ *  - 长度为 8 的整数倍
+ *  - 第一操作数可以不对齐，但其后至少要有 16 字节可读的填充
+ * 不满足要求时自动退回标量实现。定义 AUDIO_SIMD_DISABLE 可强制使用标量实现。
+ */
+#if CONFIG_IDF_TARGET_ESP32S3 && !defined(AUDIO_SIMD_DISABLE)
+#define AUDIO_SIMD_AES3 1
+#else
+#define AUDIO_SIMD_AES3 0
+#endif
+
+// 向量内核要求的对齐字节数
+#define AUDIO_SIMD_ALIGN 16
+
+#if AUDIO_SIMD_AES3
+int32_t audio_simd_dot_s16_aes3(const int16_t *x, const int16_t *coef, uint32_t n);
+void audio_simd_scale_s16_aes3(int16_t *x, const int16_t *gain, uint32_t n);
+void audio_simd_add_sat_s16_aes3(int16_t *dst, const int16_t *src, uint32_t n);
+void audio_simd_biquad_s32_aes3(int32_t *x, uint32_t n, uint32_t stride, const int32_t *coef, int32_t *state);
+void audio_simd_minmax_s16_aes3(const int16_t *x, uint32_t n, int16_t *minmax);
+void audio_simd_s16_to_s32_aes3(const int16_t *src, int32_t *dst, uint32_t n);
+#endif
+
+/**
+ * @brief 16 位点积，累加结果为 32 位（调用方保证不溢出）
+ */
+static inline int32_t audio_simd_dot_s16(const int16_t *x, const int16_t *coef, uint32_t n)
+{
+#if AUDIO_SIMD_AES3
+    if ((n & 7) == 0 && ((uintptr_t)coef & (AUDIO_SIMD_ALIGN - 1)) == 0)
+    {
+        return audio_simd_dot_s16_aes3(x, coef, n);
+    }
+#endif
+    int32_t acc = 0;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        acc += (int32_t)x[i] * coef[i];
+    }
+    return acc;
+}
+
+/**
+ * @brief 16 位样本原地乘以 Q15 增益（gain < 32768）
+ *
+ * 向量内核要求起始地址 16 字节对齐，这里先用标量处理到对齐位置，末尾不足 8 个的样本也用标量处理。
+ */
+static inline void audio_simd_scale_s16(int16_t *x, int16_t gain, uint32_t n)
+{
+    uint32_t i = 0;
+#if AUDIO_SIMD_AES3
+    while (i < n && ((uintptr_t)(x + i) & (AUDIO_SIMD_ALIGN - 1)) != 0)
+    {
+        x[i] = (int16_t)(((int32_t)x[i] * gain) >> 15);
+        i++;
+    }
+    uint32_t body = (n - i) & ~7u;
+    if (body > 0)
+    {
+        audio_simd_scale_s16_aes3(x + i, &gain, body);
+        i += body;
+    }
+#endif
+    for (; i < n; i++)
+    {
+        x[i] = (int16_t)(((int32_t)x[i] * gain) >> 15);
+    }
+}
+
+static inline int16_t audio_simd_sat_s16(int32_t v)
+{
+    return (int16_t)(v > INT16_MAX ? INT16_MAX : (v < INT16_MIN ? INT16_MIN : v));
+}
+
+/**
+ * @brief 16 位样本饱和加：dst[i] = sat(dst[i] + src[i])
+ *
+ * 两个地址相对 16 字节的偏移相同时才能用向量内核（先用标量处理到对齐位置），否则全部用标量处理。
+ */
+static inline void audio_simd_add_sat_s16(int16_t *dst, const int16_t *src, uint32_t n)
+{
+    uint32_t i = 0;
+#if AUDIO_SIMD_AES3
+    if ((((uintptr_t)dst ^ (uintptr_t)src) & (AUDIO_SIMD_ALIGN - 1)) == 0)
+    {
+        while (i < n && ((uintptr_t)(dst + i) & (AUDIO_SIMD_ALIGN - 1)) != 0)
+        {
+            dst[i] = audio_simd_sat_s16((int32_t)dst[i] + src[i]);
+            i++;
+        }
+        uint32_t body = (n - i) & ~7u;
+        if (body > 0)
+        {
+            audio_simd_add_sat_s16_aes3(dst + i, src + i, body);
+            i += body;
+        }
+    }
+#endif
+    for (; i < n; i++)
+    {
+        dst[i] = audio_simd_sat_s16((int32_t)dst[i] + src[i]);
+    }
+}
+
+/**
+ * @brief 16 位样本的峰值 max(|x[i]|)，-32768 的峰值为 32768
+ *
+ * 向量内核要求 x 16 字节对齐、n 为 8 的整数倍，按通道求出最大值和最小值后再合并。
+ */
+static inline int32_t audio_simd_peak_s16(const int16_t *x, uint32_t n)
+{
+    int32_t hi = 0;
+    int32_t lo = 0;
+    uint32_t i = 0;
+#if AUDIO_SIMD_AES3
+    if (n >= 8 && ((uintptr_t)x & (AUDIO_SIMD_ALIGN - 1)) == 0)
+    {
+        int16_t minmax[16] __attribute__((aligned(AUDIO_SIMD_ALIGN)));
+        i = n & ~7u;
+        audio_simd_minmax_s16_aes3(x, i, minmax);
+        for (int k = 0; k < 8; k++)
+        {
+            hi = minmax[k] > hi ? minmax[k] : hi;
+            lo = minmax[k + 8] < lo ? minmax[k + 8] : lo;
+        }
+    }
+#endif
+    for (; i < n; i++)
+    {
+        hi = x[i] > hi ? x[i] : hi;
+        lo = x[i] < lo ? x[i] : lo;
+    }
+    return hi > -lo ? hi : -lo;
+}
+
+/**
+ * @brief 16 位样本扩展为 32 位：dst[i] = src[i] << 16
+ *
+ * 向量内核要求 src 和 dst 都 16 字节对齐，末尾不足 8 个的样本用标量处理。
+ */
+static inline void audio_simd_s16_to_s32(const int16_t *src, int32_t *dst, uint32_t n)
+{
+    uint32_t i = 0;
+#if AUDIO_SIMD_AES3
+    if ((((uintptr_t)src | (uintptr_t)dst) & (AUDIO_SIMD_ALIGN - 1)) == 0)
+    {
+        i = n & ~7u;
+        if (i > 0)
+        {
+            audio_simd_s16_to_s32_aes3(src, dst, i);
+        }
+    }
+#endif
+    for (; i < n; i++)
+    {
+        dst[i] = (int32_t)((uint32_t)(uint16_t)src[i] << 16);
+    }
+}
+
+/**
+ * @brief 一节双二阶滤波（直接 I 型），原地处理间隔为 stride 个样本的 n 个样本
+ *
+ * 样本为 Q27（16 位样本左移 12 位，留出 24 dB 余量），系数为 Q29：b0, b1, b2, -a1, -a2，
+ * 状态为 x1, x2, y1, y2 和上一个输出截断的余数。乘积为 64 位，高 32 位和低 32 位（右移 3 位）
+ * 分别累加，余数反馈到下一个样本，低频滤波器也不会因截断产生直流偏移。
+ * 标量实现与 ESP32-S3 汇编内核逐位一致。
+ */
+static inline void audio_simd_biquad_s32(int32_t *x, uint32_t n, uint32_t stride, const int32_t *coef, int32_t *state)
+{
+    uint32_t i = 0;
+#if AUDIO_SIMD_AES3
+    uint32_t body = n & ~1u;
+    if (body > 0)
+    {
+        audio_simd_biquad_s32_aes3(x, body, stride * sizeof(int32_t), coef, state);
+        i = body;
+    }
+#endif
+    int32_t x1 = state[0], x2 = state[1], y1 = state[2], y2 = state[3];
+    uint32_t rem = (uint32_t)state[4];
+    for (; i < n; i++)
+    {
+        int32_t *p = x + i * stride;
+        const int32_t v[5] = {*p, x1, x2, y1, y2};
+        // 与汇编内核一样按 32 位回绕累加
+        uint32_t hi = 0;
+        uint32_t lo = rem;
+        for (int k = 0; k < 5; k++)
+        {
+            int64_t prod = (int64_t)coef[k] * v[k];
+            hi += (uint32_t)(prod >> 32);
+            lo += (uint32_t)prod >> 3;
+        }
+        x2 = x1;
+        x1 = *p;
+        y2 = y1;
+        y1 = (int32_t)((hi << 3) + (lo >> 26));
+        rem = lo & 0x3FFFFFF;
+        *p = y1;
+    }
+    state[0] = x1;
+    state[1] = x2;
+    state[2] = y1;
+    state[3] = y2;
+    state[4] = (int32_t)rem;
+}
+
+#ifdef __cplusplus
+}
+#endif
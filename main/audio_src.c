@@ -0,0 +1,369 @@
+#include "audio_src.h"
+
+#include <math.h>
+#include <string.h>
+#include <inttypes.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_log.h"
+#include "esp_cpu.h"
+#include "audio_simd.h"
+
+static const char *TAG = "AUDIO_SRC";
+
+// 约分后插值因子 L 的上限，决定系数表大小（例如 11025->48000 需要 640 相）
+#define SRC_MAX_PHASES 640
+// 每次处理的输入帧数，决定历史缓冲区大小
+#define SRC_BLOCK_FRAMES 256
+#define SRC_MAX_CHANNELS 2
+
+/**
+ * @brief 各档位参数
+ *
+ * cost 为每个输出样本（单通道）的估算 CPU 周期数，用于 AUTO 档位选择
+ */
+typedef struct
+{
+    const char *name;
+    uint16_t taps;  // 每相抽头数，sinc 档位为 8 的整数倍以便使用向量内核
+    float rolloff;  // 截止频率相对于奈奎斯特频率的比例
+    float beta;     // Kaiser 窗参数
+    uint16_t cost;
+} src_tier_t;
+
+static const src_tier_t s_src_tiers[] = {
+    [AUDIO_SRC_QUALITY_LINEAR] = {"linear", 2, 0, 0, 16},
+#if AUDIO_SIMD_AES3
+    [AUDIO_SRC_QUALITY_SHORT_SINC] = {"short sinc", 16, 0.85f, 6.0f, 40},
+    [AUDIO_SRC_QUALITY_LONG_SINC] = {"long sinc", 48, 0.94f, 8.6f, 70},
+#else
+    [AUDIO_SRC_QUALITY_SHORT_SINC] = {"short sinc", 16, 0.85f, 6.0f, 70},
+    [AUDIO_SRC_QUALITY_LONG_SINC] = {"long sinc", 48, 0.94f, 8.6f, 190},
+#endif
+};
+
+struct audio_src
+{
+    audio_src_quality_t quality;
+    uint32_t L;                      // 插值因子
+    uint32_t M;                      // 抽取因子
+    uint8_t channels;
+    uint16_t taps;
+    int16_t *coefs;                  // [L][taps]，每相按时间正序存放，Q15
+    uint16_t *lin_frac;              // 线性档位：每相的插值系数，Q15
+    int16_t *hist[SRC_MAX_CHANNELS]; // 每通道历史样本（去交错）
+    uint32_t hist_len;
+    uint32_t pos;                    // 下一个输出样本窗口在 hist 中的起点
+    uint32_t phase;                  // 下一个输出样本的相位 0..L-1
+    uint64_t cycles;
+    uint64_t frames;
+};
+
+static uint32_t src_gcd(uint32_t a, uint32_t b)
+{
+    while (b)
+    {
+        uint32_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+// 第一类零阶修正贝塞尔函数
+static double src_bessel_i0(double x)
+{
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 32; k++)
+    {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+        if (term < sum * 1e-12)
+        {
+            break;
+        }
+    }
+    return sum;
+}
+
+static void *src_alloc(size_t size)
+{
+    // 系数和历史样本在热路径上，优先放内部 RAM
+    void *p = heap_caps_aligned_calloc(AUDIO_SIMD_ALIGN, 1, size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (p == NULL)
+    {
+        p = heap_caps_aligned_calloc(AUDIO_SIMD_ALIGN, 1, size, MALLOC_CAP_SPIRAM);
+    }
+    return p;
+}
+
+// 生成加窗 sinc 原型滤波器并拆成多相系数表，每相直流增益归一化为 1
+static esp_err_t src_build_sinc_table(struct audio_src *s, const src_tier_t *tier)
+{
+    const uint32_t L = s->L, taps = s->taps;
+    const uint32_t len = taps * L;
+    const double center = (len - 1) / 2.0;
+    const double fc = tier->rolloff * 0.5 / (s->L > s->M ? s->L : s->M);
+    const double i0_beta = src_bessel_i0(tier->beta);
+
+    s->coefs = src_alloc(len * sizeof(int16_t));
+    double *proto = malloc(taps * sizeof(double));
+    if (s->coefs == NULL || proto == NULL)
+    {
+        free(proto);
+        return ESP_ERR_NO_MEM;
+    }
+
+    for (uint32_t p = 0; p < L; p++)
+    {
+        double sum = 0;
+        for (uint32_t k = 0; k < taps; k++)
+        {
+            double n = (double)k * L + p;
+            double t = n - center;
+            double sinc = (fabs(t) < 1e-9) ? 1.0 : sin(2.0 * M_PI * fc * t) / (2.0 * M_PI * fc * t);
+            double r = t / (center + 0.5);
+            double win = src_bessel_i0(tier->beta * sqrt(fmax(0.0, 1.0 - r * r))) / i0_beta;
+            proto[k] = sinc * win;
+            sum += proto[k];
+        }
+        // 窗口按时间正序：第 j 个系数对应 x[base - (taps - 1) + j]
+        int16_t *c = &s->coefs[p * taps];
+        for (uint32_t k = 0; k < taps; k++)
+        {
+            long v = lround(proto[k] / sum * 32768.0);
+            c[taps - 1 - k] = (int16_t)(v > 32767 ? 32767 : (v < -32768 ? -32768 : v));
+        }
+    }
+    free(proto);
+    return ESP_OK;
+}
+
+uint32_t audio_src_phase_count(uint32_t in_rate, uint32_t out_rate)
+{
+    if (in_rate == 0 || out_rate == 0)
+    {
+        return 0;
+    }
+    return out_rate / src_gcd(in_rate, out_rate);
+}
+
+bool audio_src_ratio_supported(uint32_t in_rate, uint32_t out_rate)
+{
+    uint32_t L = audio_src_phase_count(in_rate, out_rate);
+    return L > 0 && L <= SRC_MAX_PHASES;
+}
+
+static audio_src_quality_t src_pick_quality(const audio_src_config_t *config)
+{
+    if (config->quality != AUDIO_SRC_QUALITY_AUTO)
+    {
+        return config->quality;
+    }
+    uint64_t budget = (uint64_t)CONFIG_ESP_DEFAULT_CPU_FREQ_MHZ * 1000000 * config->cpu_budget_percent / 100;
+    uint64_t per_sample = budget / ((uint64_t)config->out_rate * config->channels);
+    for (int q = AUDIO_SRC_QUALITY_LONG_SINC; q > AUDIO_SRC_QUALITY_LINEAR; q--)
+    {
+        if (s_src_tiers[q].cost <= per_sample)
+        {
+            return (audio_src_quality_t)q;
+        }
+    }
+    return AUDIO_SRC_QUALITY_LINEAR;
+}
+
+esp_err_t audio_src_create(const audio_src_config_t *config, audio_src_handle_t *src)
+{
+    if (config == NULL || src == NULL || config->in_rate == 0 || config->out_rate == 0 ||
+        config->channels == 0 || config->channels > SRC_MAX_CHANNELS || config->quality > AUDIO_SRC_QUALITY_AUTO)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!audio_src_ratio_supported(config->in_rate, config->out_rate))
+    {
+        ESP_LOGE(TAG, "Unsupported ratio %" PRIu32 " -> %" PRIu32, config->in_rate, config->out_rate);
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+
+    struct audio_src *s = calloc(1, sizeof(struct audio_src));
+    if (s == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    uint32_t g = src_gcd(config->in_rate, config->out_rate);
+    s->L = config->out_rate / g;
+    s->M = config->in_rate / g;
+    s->channels = config->channels;
+    s->quality = src_pick_quality(config);
+    const src_tier_t *tier = &s_src_tiers[s->quality];
+    s->taps = tier->taps;
+
+    esp_err_t ret = ESP_OK;
+    if (s->quality == AUDIO_SRC_QUALITY_LINEAR)
+    {
+        s->lin_frac = src_alloc(s->L * sizeof(uint16_t));
+        if (s->lin_frac == NULL)
+        {
+            ret = ESP_ERR_NO_MEM;
+        }
+        else
+        {
+            for (uint32_t p = 0; p < s->L; p++)
+            {
+                s->lin_frac[p] = (uint16_t)(((uint64_t)p << 15) / s->L);
+            }
+        }
+    }
+    else
+    {
+        ret = src_build_sinc_table(s, tier);
+    }
+
+    // 历史缓冲区末尾留出向量内核越界读取的填充
+    size_t hist_size = (s->taps + SRC_BLOCK_FRAMES + AUDIO_SIMD_ALIGN) * sizeof(int16_t);
+    for (int ch = 0; ch < s->channels && ret == ESP_OK; ch++)
+    {
+        s->hist[ch] = src_alloc(hist_size);
+        if (s->hist[ch] == NULL)
+        {
+            ret = ESP_ERR_NO_MEM;
+        }
+    }
+    if (ret != ESP_OK)
+    {
+        audio_src_delete(s);
+        return ret;
+    }
+
+    audio_src_reset(s);
+    ESP_LOGI(TAG, "%" PRIu32 " -> %" PRIu32 " Hz, L/M %" PRIu32 "/%" PRIu32 ", %s, %u taps",
+             config->in_rate, config->out_rate, s->L, s->M, tier->name, s->taps);
+    *src = s;
+    return ESP_OK;
+}
+
+void audio_src_delete(audio_src_handle_t src)
+{
+    if (src == NULL)
+    {
+        return;
+    }
+    heap_caps_free(src->coefs);
+    heap_caps_free(src->lin_frac);
+    for (int ch = 0; ch < SRC_MAX_CHANNELS; ch++)
+    {
+        heap_caps_free(src->hist[ch]);
+    }
+    free(src);
+}
+
+void audio_src_reset(audio_src_handle_t src)
+{
+    // 预填 taps - 1 个静音样本，使第一个输出样本对齐第一个输入样本
+    for (int ch = 0; ch < src->channels; ch++)
+    {
+        memset(src->hist[ch], 0, (src->taps - 1) * sizeof(int16_t));
+    }
+    src->hist_len = src->taps - 1;
+    src->pos = 0;
+    src->phase = 0;
+}
+
+uint32_t audio_src_max_output_frames(audio_src_handle_t src, uint32_t in_frames)
+{
+    return (uint32_t)(((uint64_t)(in_frames + src->taps) * src->L) / src->M) + 1;
+}
+
+static inline int16_t src_sat16(int32_t v)
+{
+    return (int16_t)(v > 32767 ? 32767 : (v < -32768 ? -32768 : v));
+}
+
+uint32_t audio_src_process(audio_src_handle_t src, const int16_t *in, uint32_t in_frames, int16_t *out)
+{
+    const uint32_t ch_num = src->channels, taps = src->taps, L = src->L, M = src->M;
+    uint32_t start = esp_cpu_get_cycle_count();
+    uint32_t produced = 0;
+
+    while (in_frames > 0)
+    {
+        uint32_t n = in_frames < SRC_BLOCK_FRAMES ? in_frames : SRC_BLOCK_FRAMES;
+        for (uint32_t ch = 0; ch < ch_num; ch++)
+        {
+            int16_t *h = src->hist[ch] + src->hist_len;
+            for (uint32_t i = 0; i < n; i++)
+            {
+                h[i] = in[i * ch_num + ch];
+            }
+        }
+        src->hist_len += n;
+        in += n * ch_num;
+        in_frames -= n;
+
+        uint32_t pos = src->pos, phase = src->phase;
+        if (src->quality == AUDIO_SRC_QUALITY_LINEAR)
+        {
+            while (pos + taps <= src->hist_len)
+            {
+                int32_t frac = src->lin_frac[phase];
+                for (uint32_t ch = 0; ch < ch_num; ch++)
+                {
+                    const int16_t *w = src->hist[ch] + pos;
+                    out[produced * ch_num + ch] = (int16_t)(w[0] + (((w[1] - w[0]) * frac) >> 15));
+                }
+                produced++;
+                phase += M;
+                pos += phase / L;
+                phase %= L;
+            }
+        }
+        else
+        {
+            while (pos + taps <= src->hist_len)
+            {
+                const int16_t *c = &src->coefs[phase * taps];
+                for (uint32_t ch = 0; ch < ch_num; ch++)
+                {
+                    int32_t acc = audio_simd_dot_s16(src->hist[ch] + pos, c, taps);
+                    out[produced * ch_num + ch] = src_sat16((acc + (1 << 14)) >> 15);
+                }
+                produced++;
+                phase += M;
+                pos += phase / L;
+                phase %= L;
+            }
+        }
+
+        // 丢弃不再需要的历史样本
+        uint32_t shift = pos < src->hist_len ? pos : src->hist_len;
+        for (uint32_t ch = 0; ch < ch_num; ch++)
+        {
+            memmove(src->hist[ch], src->hist[ch] + shift, (src->hist_len - shift) * sizeof(int16_t));
+        }
+        src->hist_len -= shift;
+        src->pos = pos - shift;
+        src->phase = phase;
+    }
+
+    src->cycles += esp_cpu_get_cycle_count() - start;
+    src->frames += produced;
+    return produced;
+}
+
+audio_src_quality_t audio_src_get_quality(audio_src_handle_t src)
+{
+    return src->quality;
+}
+
+uint32_t audio_src_get_cycles_per_frame(audio_src_handle_t src)
+{
+    return src->frames ? (uint32_t)(src->cycles / src->frames) : 0;
+}
+
+const char *audio_src_quality_name(audio_src_quality_t quality)
+{
+    if (quality > AUDIO_SRC_QUALITY_LONG_SINC)
+    {
+        return "auto";
+    }
+    return s_src_tiers[quality].name;
+}
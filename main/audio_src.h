@@ -0,0 +1,107 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 流式采样率转换（SRC）
+ *
+ * 有理数比例 L/M 的多相 FIR 实现：创建时按质量档位生成多相系数表（Q15），
+ * 处理时每个输出样本只计算一个相位的点积。输入输出均为 16 位交错 PCM，最多 2 通道。
+ */
+
+/**
+ * @brief 质量档位
+ */
+typedef enum
+{
+    AUDIO_SRC_QUALITY_LINEAR = 0, // 线性插值，开销最小
+    AUDIO_SRC_QUALITY_SHORT_SINC, // 16 抽头加窗 sinc
+    AUDIO_SRC_QUALITY_LONG_SINC,  // 48 抽头加窗 sinc
+    AUDIO_SRC_QUALITY_AUTO,       // 按 CPU 预算自动选择
+} audio_src_quality_t;
+
+/**
+ * @brief SRC 配置
+ */
+typedef struct
+{
+    uint32_t in_rate;             // 输入采样率
+    uint32_t out_rate;            // 输出采样率
+    uint8_t channels;             // 通道数（1 或 2）
+    audio_src_quality_t quality;  // 质量档位
+    uint8_t cpu_budget_percent;   // AUTO 档位可用的单核 CPU 百分比
+} audio_src_config_t;
+
+typedef struct audio_src *audio_src_handle_t;
+
+/**
+ * @brief 创建 SRC 实例并生成系数表
+ *
+ * @return
+ *  - ESP_OK 成功
+ *  - ESP_ERR_INVALID_ARG 参数无效
+ *  - ESP_ERR_NOT_SUPPORTED 比例的相位数超过上限
+ *  - ESP_ERR_NO_MEM 内存不足
+ */
+esp_err_t audio_src_create(const audio_src_config_t *config, audio_src_handle_t *src);
+
+/**
+ * @brief 是否支持 in_rate -> out_rate 的转换（约分后的相位数不超过上限）
+ */
+bool audio_src_ratio_supported(uint32_t in_rate, uint32_t out_rate);
+
+/**
+ * @brief 约分后的插值因子 L，可用来估算转换开销
+ */
+uint32_t audio_src_phase_count(uint32_t in_rate, uint32_t out_rate);
+
+/**
+ * @brief 删除 SRC 实例
+ */
+void audio_src_delete(audio_src_handle_t src);
+
+/**
+ * @brief 清空历史样本（切换曲目或跳转时调用）
+ */
+void audio_src_reset(audio_src_handle_t src);
+
+/**
+ * @brief 输入 in_frames 帧时最多可能输出的帧数
+ */
+uint32_t audio_src_max_output_frames(audio_src_handle_t src, uint32_t in_frames);
+
+/**
+ * @brief 转换一块 PCM，输入总是被全部消耗
+ *
+ * @param[in]  src       SRC 句柄
+ * @param[in]  in        输入 PCM（交错）
+ * @param[in]  in_frames 输入帧数
+ * @param[out] out       输出 PCM（交错），容量至少为 audio_src_max_output_frames(in_frames)
+ * @return 输出帧数
+ */
+uint32_t audio_src_process(audio_src_handle_t src, const int16_t *in, uint32_t in_frames, int16_t *out);
+
+/**
+ * @brief 实际使用的质量档位
+ */
+audio_src_quality_t audio_src_get_quality(audio_src_handle_t src);
+
+/**
+ * @brief 平均每输出帧消耗的 CPU 周期数
+ */
+uint32_t audio_src_get_cycles_per_frame(audio_src_handle_t src);
+
+/**
+ * @brief 档位名称，用于日志
+ */
+const char *audio_src_quality_name(audio_src_quality_t quality);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,297 @@
+#include "audio_tag.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include <sys/stat.h>
+
+// 需要的文本帧最多读取的字节数，超出部分截断
+#define TAG_FRAME_READ_MAX 256
+// ID3v1 标签长度，以及其前面可选的 "TAG+" 扩展标签长度
+#define ID3V1_SIZE 128
+#define ID3V1_EXT_SIZE 227
+// APE 标签页脚（和可选的标签头）长度
+#define APE_FOOTER_SIZE 32
+
+static uint32_t read_syncsafe32(const uint8_t *p)
+{
+    return ((uint32_t)(p[0] & 0x7F) << 21) | ((uint32_t)(p[1] & 0x7F) << 14) | ((uint32_t)(p[2] & 0x7F) << 7) | (p[3] & 0x7F);
+}
+
+static uint32_t read_be32(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static uint32_t read_be24(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | p[2];
+}
+
+static uint32_t read_le32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static bool read_at(FILE *f, uint32_t offset, uint8_t *buf, size_t len)
+{
+    return fseek(f, offset, SEEK_SET) == 0 && fread(buf, 1, len, f) == len;
+}
+
+/*
+ * 按 ID3v2 编码字节把文本转换为 UTF-8：0 为 ISO-8859-1，1 为带 BOM 的 UTF-16，
+ * 2 为 UTF-16BE，3 为 UTF-8。返回消耗的字节数（含结束符），便于继续解析后面的字段。
+ */
+static size_t id3_text_to_utf8(uint8_t enc, const uint8_t *src, size_t len, char *dst, size_t dst_len)
+{
+    bool wide = enc == 1 || enc == 2;
+    bool le = false;
+    size_t i = 0;
+    size_t o = 0;
+    if (enc == 1 && len >= 2 && ((src[0] == 0xFF && src[1] == 0xFE) || (src[0] == 0xFE && src[1] == 0xFF)))
+    {
+        le = src[0] == 0xFF;
+        i = 2;
+    }
+    while (i + (wide ? 1 : 0) < len)
+    {
+        uint32_t c;
+        if (wide)
+        {
+            c = le ? (src[i] | (src[i + 1] << 8)) : ((src[i] << 8) | src[i + 1]);
+            i += 2;
+        }
+        else
+        {
+            c = src[i++];
+        }
+        if (c == 0)
+        {
+            break;
+        }
+        char utf8[3];
+        size_t n;
+        if (enc == 3 || c < 0x80)
+        {
+            utf8[0] = (char)c;
+            n = 1;
+        }
+        else if (c < 0x800)
+        {
+            utf8[0] = (char)(0xC0 | (c >> 6));
+            utf8[1] = (char)(0x80 | (c & 0x3F));
+            n = 2;
+        }
+        else if (c >= 0xD800 && c <= 0xDFFF)
+        {
+            // 不处理代理对
+            utf8[0] = '?';
+            n = 1;
+        }
+        else
+        {
+            utf8[0] = (char)(0xE0 | (c >> 12));
+            utf8[1] = (char)(0x80 | ((c >> 6) & 0x3F));
+            utf8[2] = (char)(0x80 | (c & 0x3F));
+            n = 3;
+        }
+        if (o + n < dst_len)
+        {
+            memcpy(dst + o, utf8, n);
+            o += n;
+        }
+    }
+    if (dst_len > 0)
+    {
+        dst[o] = '\0';
+    }
+    return i;
+}
+
+// 解析需要的帧：标题/艺术家/专辑，以及描述为 iTunSMPB 的 COMM/TXXX
+static void id3v2_handle_frame(const char *id, const uint8_t *data, size_t len, audio_tag_t *tag)
+{
+    if (len < 1)
+    {
+        return;
+    }
+    uint8_t enc = data[0];
+    if (strcmp(id, "TIT2") == 0)
+    {
+        id3_text_to_utf8(enc, data + 1, len - 1, tag->title, sizeof(tag->title));
+    }
+    else if (strcmp(id, "TPE1") == 0)
+    {
+        id3_text_to_utf8(enc, data + 1, len - 1, tag->artist, sizeof(tag->artist));
+    }
+    else if (strcmp(id, "TALB") == 0)
+    {
+        id3_text_to_utf8(enc, data + 1, len - 1, tag->album, sizeof(tag->album));
+    }
+    else if (strcmp(id, "COMM") == 0 || strcmp(id, "TXXX") == 0)
+    {
+        // COMM 在描述前还有 3 字节语言代码
+        size_t pos = strcmp(id, "COMM") == 0 ? 4 : 1;
+        if (len <= pos)
+        {
+            return;
+        }
+        char desc[16];
+        pos += id3_text_to_utf8(enc, data + pos, len - pos, desc, sizeof(desc));
+        if (strcmp(desc, "iTunSMPB") == 0 && pos < len)
+        {
+            id3_text_to_utf8(enc, data + pos, len - pos, tag->itunsmpb, sizeof(tag->itunsmpb));
+        }
+    }
+}
+
+// ID3v2.2 的 3 字符帧 ID 转换为 v2.3 的 4 字符帧 ID
+static void id3v22_frame_id(const uint8_t *p, char *id)
+{
+    static const char *const map[][2] = {{"TT2", "TIT2"}, {"TP1", "TPE1"}, {"TAL", "TALB"}, {"COM", "COMM"}, {"TXX", "TXXX"}};
+    id[0] = '\0';
+    for (size_t i = 0; i < sizeof(map) / sizeof(map[0]); i++)
+    {
+        if (memcmp(p, map[i][0], 3) == 0)
+        {
+            strcpy(id, map[i][1]);
+            return;
+        }
+    }
+}
+
+// 逐帧读取帧头，需要的文本帧读出内容，其余帧（包括 APIC 封面）直接跳过
+static void id3v2_read_frames(FILE *f, uint8_t version, uint8_t flags, uint32_t pos, uint32_t end, audio_tag_t *tag)
+{
+    uint8_t buf[TAG_FRAME_READ_MAX];
+    // 跳过扩展标签头
+    if ((flags & 0x40) && version >= 3)
+    {
+        if (!read_at(f, pos, buf, 4))
+        {
+            return;
+        }
+        pos += version == 4 ? read_syncsafe32(buf) : read_be32(buf) + 4;
+    }
+
+    uint32_t header_len = version == 2 ? 6 : 10;
+    while (pos + header_len <= end)
+    {
+        uint8_t header[10];
+        if (!read_at(f, pos, header, header_len) || header[0] == 0)
+        {
+            // 读到填充区
+            break;
+        }
+        char id[5] = {0};
+        uint32_t size;
+        bool skip = false;
+        uint32_t data_offset = 0;
+        if (version == 2)
+        {
+            id3v22_frame_id(header, id);
+            size = read_be24(header + 3);
+        }
+        else
+        {
+            memcpy(id, header, 4);
+            size = version == 4 ? read_syncsafe32(header + 4) : read_be32(header + 4);
+            // 压缩或加密的帧不解析
+            skip = version == 4 ? (header[9] & 0x0C) : (header[9] & 0xC0);
+            // v2.4 的数据长度指示符在帧内容前占 4 字节
+            data_offset = (version == 4 && (header[9] & 0x01)) ? 4 : 0;
+        }
+        pos += header_len;
+        if (size > end - pos)
+        {
+            break;
+        }
+        bool wanted = id[0] == 'T' ? (strcmp(id, "TIT2") == 0 || strcmp(id, "TPE1") == 0 || strcmp(id, "TALB") == 0 ||
+                                      strcmp(id, "TXXX") == 0)
+                                   : strcmp(id, "COMM") == 0;
+        if (wanted && !skip && size > data_offset)
+        {
+            size_t n = size - data_offset < sizeof(buf) ? size - data_offset : sizeof(buf);
+            if (read_at(f, pos + data_offset, buf, n))
+            {
+                id3v2_handle_frame(id, buf, n, tag);
+            }
+        }
+        pos += size;
+    }
+}
+
+// ID3v1 的定长 ISO-8859-1 字段，只在 ID3v2 没有对应内容时使用
+static void id3v1_copy_field(const uint8_t *src, size_t len, char *dst, size_t dst_len)
+{
+    if (dst[0] != '\0')
+    {
+        return;
+    }
+    size_t n = 0;
+    while (n < len && src[n] != 0)
+    {
+        n++;
+    }
+    while (n > 0 && src[n - 1] == ' ')
+    {
+        n--;
+    }
+    id3_text_to_utf8(0, src, n, dst, dst_len);
+}
+
+bool audio_tag_scan(const char *path, audio_tag_t *tag)
+{
+    memset(tag, 0, sizeof(audio_tag_t));
+    struct stat st;
+    if (stat(path, &st) != 0)
+    {
+        return false;
+    }
+    FILE *f = fopen(path, "rb");
+    if (f == NULL)
+    {
+        return false;
+    }
+    uint32_t file_size = st.st_size;
+    tag->audio_end = file_size;
+
+    // ID3v2：10 字节标签头，带页脚时标签后面还有 10 字节
+    uint8_t header[10];
+    if (read_at(f, 0, header, sizeof(header)) && memcmp(header, "ID3", 3) == 0 && header[3] >= 2 && header[3] <= 4)
+    {
+        uint32_t size = read_syncsafe32(header + 6);
+        uint32_t tag_end = sizeof(header) + size + ((header[5] & 0x10) ? 10 : 0);
+        id3v2_read_frames(f, header[3], header[5], sizeof(header), sizeof(header) + size, tag);
+        tag->audio_start = tag_end < file_size ? tag_end : file_size;
+    }
+
+    // 末尾依次可能是 APE 标签、ID3v1 扩展标签和 ID3v1 标签
+    uint32_t end = file_size;
+    uint8_t buf[ID3V1_SIZE];
+    if (end >= tag->audio_start + ID3V1_SIZE && read_at(f, end - ID3V1_SIZE, buf, ID3V1_SIZE) && memcmp(buf, "TAG", 3) == 0)
+    {
+        id3v1_copy_field(buf + 3, 30, tag->title, sizeof(tag->title));
+        id3v1_copy_field(buf + 33, 30, tag->artist, sizeof(tag->artist));
+        id3v1_copy_field(buf + 63, 30, tag->album, sizeof(tag->album));
+        end -= ID3V1_SIZE;
+        if (end >= tag->audio_start + ID3V1_EXT_SIZE && read_at(f, end - ID3V1_EXT_SIZE, buf, 4) && memcmp(buf, "TAG+", 4) == 0)
+        {
+            end -= ID3V1_EXT_SIZE;
+        }
+    }
+    if (end >= tag->audio_start + APE_FOOTER_SIZE && read_at(f, end - APE_FOOTER_SIZE, buf, APE_FOOTER_SIZE) &&
+        memcmp(buf, "APETAGEX", 8) == 0)
+    {
+        // 页脚中的长度包含页脚本身但不含标签头，标志位 31 表示有标签头
+        uint32_t size = read_le32(buf + 12) + ((read_le32(buf + 20) & 0x80000000) ? APE_FOOTER_SIZE : 0);
+        if (size <= end - tag->audio_start)
+        {
+            end -= size;
+        }
+    }
+    tag->trailer_size = file_size - end;
+    tag->audio_end = end;
+    fclose(f);
+    return true;
+}
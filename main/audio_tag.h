@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 音频文件标签扫描
+ *
+ * 只读取 ID3v2 的 10 字节标签头和各帧的帧头，需要的文本帧读出内容，其余帧（例如
+ * 封面图片 APIC）直接跳过；再检查文件末尾的 ID3v1/APE 标签。结果给出音频数据在
+ * 文件中的起止位置，解码器从第一个音频帧开始读，也不会读到末尾的标签。
+ */
+
+#define AUDIO_TAG_TEXT_LEN 64
+
+/**
+ * @brief 扫描结果
+ */
+typedef struct
+{
+    uint32_t audio_start;                 // 音频数据起始位置（ID3v2 标签之后）
+    uint32_t audio_end;                   // 音频数据结束位置（ID3v1/APE 标签之前）
+    uint32_t trailer_size;                // 末尾 ID3v1/APE 标签的总长度
+    char title[AUDIO_TAG_TEXT_LEN];       // 标题（UTF-8）
+    char artist[AUDIO_TAG_TEXT_LEN];      // 艺术家（UTF-8）
+    char album[AUDIO_TAG_TEXT_LEN];       // 专辑（UTF-8）
+    char itunsmpb[AUDIO_TAG_TEXT_LEN * 2]; // iTunSMPB 注释（无缝播放信息）
+} audio_tag_t;
+
+/**
+ * @brief 扫描文件开头的 ID3v2 标签和末尾的 ID3v1/APE 标签
+ *
+ * @param[in]  path 文件路径
+ * @param[out] tag  扫描结果；没有标签时 audio_start 为 0，audio_end 为文件长度
+ * @return 文件是否可以打开
+ */
+bool audio_tag_scan(const char *path, audio_tag_t *tag);
+
+#ifdef __cplusplus
+}
+#endif
@@ -8,6 +8,8 @@
 #include "conf.h"
 #include <dirent.h>
 #include "audio_task.h"
+#include "uac_audio_player.h"
+#include "audio_probe.h"
 #include "esp_err.h"
 #include "esp_log.h"
 
@@ -21,19 +23,13 @@
 
 
 #define MAX_PATH_LENGTH 256 // 文件路径最大长度
-#define audio_task_stack_size 1024 * 3
 #define TOUCH_THRESHOLD 100000           // 触摸阈值
 #define NVS_NAMESPACE "mp3_player"   // NVS 命名空间
 #define NVS_KEY_LAST_FILE "last_file" // NVS 中保存的键名
 
-extern bool uac_player_playing;
-extern QueueHandle_t audio_file_queue;
-
 static const char *TAG = "MP3_PLAYER";
-static char current_file_path[MAX_PATH_LENGTH]; // 当前播放的文件路径
 static char base_path[MAX_PATH_LENGTH];         // 全局变量，存储音乐文件的基础路径
 static bool loop_playback = false;                     // 是否开启循环播放
-TaskHandle_t audio_task_handle = NULL;
 // 初始化 NVS
 void init_nvs()
 {
@@ -95,8 +91,8 @@ void save_last_file_to_nvs(const char *file_path)
     nvs_close(nvs_handle);
 }
 
-// 查找下一个 MP3 文件
-bool find_next_mp3_file(char *next_file_path)
+// 查找 current 的下一个音频文件（按扩展名过滤，实际格式由解码任务按文件内容识别）
+bool find_next_mp3_file(const char *current, char *next_file_path)
 {
     DIR *dir = opendir(base_path);
     if (dir == NULL)
@@ -106,7 +102,7 @@ bool find_next_mp3_file(char *next_file_path)
     }
 
     struct dirent *entry;
-    bool found_current = false;
+    bool found_current = current[0] == '\0'; // 还没有播放过时从第一个文件开始
     bool result = false; // 用于标记是否找到下一个文件
 
     // 第一次遍历：查找当前文件的下一个文件
@@ -115,21 +111,20 @@ bool find_next_mp3_file(char *next_file_path)
         if (entry->d_type == DT_REG)
         { // 如果是文件
             const char *file_name = entry->d_name;
-            const char *ext = strrchr(file_name, '.');
-            if (ext && strcmp(ext, ".mp3") == 0)
-            { // 判断是否为 MP3 文件
+            if (audio_probe_is_audio_file(file_name))
+            { // 判断是否为支持的音频文件
                 char file_path[MAX_PATH_LENGTH];
                 snprintf(file_path, MAX_PATH_LENGTH, "%s/%s", base_path, file_name);
 
                 if (found_current)
                 {
-                    // 找到当前文件的下一个 MP3 文件
+                    // 找到当前文件的下一个音频文件
                     strncpy(next_file_path, file_path, MAX_PATH_LENGTH);
                     result = true;
                     break;
                 }
 
-                if (strcmp(file_path, current_file_path) == 0)
+                if (strcmp(file_path, current) == 0)
                 {
                     // 找到当前文件，标记为已找到
                     found_current = true;
@@ -147,8 +142,7 @@ bool find_next_mp3_file(char *next_file_path)
             if (entry->d_type == DT_REG)
             {
                 const char *file_name = entry->d_name;
-                const char *ext = strrchr(file_name, '.');
-                if (ext && strcmp(ext, ".mp3") == 0)
+                if (audio_probe_is_audio_file(file_name))
                 {
                     char file_path[MAX_PATH_LENGTH];
                     snprintf(file_path, MAX_PATH_LENGTH, "%s/%s", base_path, file_name);
@@ -163,37 +157,87 @@ bool find_next_mp3_file(char *next_file_path)
     closedir(dir); // 确保目录只关闭一次
     return result;
 }
-void send_next_mp3_file()
+// 查找 current 的上一个音频文件，它是第一个时按循环播放设置回到最后一个
+bool find_prev_mp3_file(const char *current, char *prev_file_path)
 {
-    char next_file_path[MAX_PATH_LENGTH];
-    if (find_next_mp3_file(next_file_path))
+    DIR *dir = opendir(base_path);
+    if (dir == NULL)
+    {
+        ESP_LOGE(TAG, "Failed to open directory: %s", base_path);
+        return false;
+    }
+
+    struct dirent *entry;
+    char last_path[MAX_PATH_LENGTH] = {0}; // 遍历到的最后一个音频文件
+    bool result = false;
+
+    while ((entry = readdir(dir)) != NULL)
     {
-        if (xQueueSend(audio_file_queue, next_file_path, portMAX_DELAY) == pdPASS)
+        if (entry->d_type != DT_REG || !audio_probe_is_audio_file(entry->d_name))
         {
-            ESP_LOGI(TAG, "Sent file to queue: %s", next_file_path);
-            strncpy(current_file_path, next_file_path, MAX_PATH_LENGTH); // 更新当前文件路径
-            save_last_file_to_nvs(next_file_path); // 保存当前播放路径到 NVS
+            continue;
         }
-        else
+        char file_path[MAX_PATH_LENGTH];
+        snprintf(file_path, MAX_PATH_LENGTH, "%s/%s", base_path, entry->d_name);
+        if (strcmp(file_path, current) == 0)
         {
-            ESP_LOGE(TAG, "Failed to send file to queue");
+            // 当前文件前面有文件时就是上一首
+            if (last_path[0] != '\0')
+            {
+                strncpy(prev_file_path, last_path, MAX_PATH_LENGTH);
+                result = true;
+                break;
+            }
+            if (!loop_playback)
+            {
+                break;
+            }
         }
+        strncpy(last_path, file_path, MAX_PATH_LENGTH);
     }
-    else
+
+    // 当前文件是第一个（或已不存在）且开启了循环播放，回到最后一个
+    if (!result && loop_playback && last_path[0] != '\0')
+    {
+        while ((entry = readdir(dir)) != NULL)
+        {
+            if (entry->d_type == DT_REG && audio_probe_is_audio_file(entry->d_name))
+            {
+                snprintf(last_path, MAX_PATH_LENGTH, "%s/%s", base_path, entry->d_name);
+            }
+        }
+        strncpy(prev_file_path, last_path, MAX_PATH_LENGTH);
+        result = true;
+    }
+
+    closedir(dir);
+    return result;
+}
+
+// 由解码任务调用（无缝播放预先打开或下一首命令）：只查询 current 的下一首，不改变播放位置
+static bool next_track_cb(const char *current, char *next_file_path, void *ctx)
+{
+    if (!find_next_mp3_file(current, next_file_path))
     {
-        ESP_LOGW(TAG, "No more MP3 files to play");
+        ESP_LOGW(TAG, "No more audio files to play");
+        return false;
     }
+    return true;
 }
 
-void audio_task(void *param)
+// 由解码任务调用（上一首命令）
+static bool prev_track_cb(const char *current, char *prev_file_path, void *ctx)
 {
-    while (1)
+    return find_prev_mp3_file(current, prev_file_path);
+}
+
+// 曲目真正开始解码时保存到 NVS，下次上电从这一首继续。
+// 在事件任务中执行，当前曲目只通过回调参数传递（上一首/下一首回调的 current 由解码任务给出），不另存全局变量
+static void player_event_cb(const uac_player_event_t *event, void *ctx)
+{
+    if (event->type == UAC_PLAYER_EVENT_TRACK_START)
     {
-        if (!uac_player_playing)
-        {
-            send_next_mp3_file(); // 发送下一个 MP3 文件
-        }
-        vTaskDelay(pdMS_TO_TICKS(1000)); // 每隔 1 秒检查一次
+        save_last_file_to_nvs(event->file_path);
     }
 }
 
@@ -214,30 +258,30 @@ void play_sdcard_mp3_files(const char *path, bool loop)
 
     // 设置全局变量
     strncpy(base_path, path, MAX_PATH_LENGTH); // 存储基础路径
-    memset(current_file_path, 0, MAX_PATH_LENGTH); // 重置当前文件路径
     loop_playback = loop; // 设置是否开启循环播放
+    uac_audio_player_set_next_track_cb(next_track_cb, NULL); // 开启无缝播放
+    uac_audio_player_set_prev_track_cb(prev_track_cb, NULL);
+    uac_player_subscribe(player_event_cb, NULL);
+    uac_player_scan_library(path); // 空闲时在后台测量响度
 
     // 从 NVS 中读取上次播放的文件路径
-    if (read_last_file_from_nvs(current_file_path))
+    char last_file_path[MAX_PATH_LENGTH] = {0};
+    if (read_last_file_from_nvs(last_file_path))
     {
         // 检查文件是否存在
         struct stat file_stat;
-        if (stat(current_file_path, &file_stat) == 0)
+        if (stat(last_file_path, &file_stat) == 0)
         {
-            ESP_LOGI(TAG, "Resuming playback from: %s", current_file_path);
+            ESP_LOGI(TAG, "Resuming playback from: %s", last_file_path);
+            uac_player_play(last_file_path);
+            return;
         }
         else
         {
-            ESP_LOGW(TAG, "Last played file not found: %s", current_file_path);
-            memset(current_file_path, 0, MAX_PATH_LENGTH); // 清空路径
+            ESP_LOGW(TAG, "Last played file not found: %s", last_file_path);
         }
     }
-
-
-    if (audio_task_handle == NULL)
-    {
-        xTaskCreate(audio_task, "send_audio_task", audio_task_stack_size, NULL, 5, NULL);
-    }
+    uac_player_next(); // 从第一个文件开始
 }
 
 void touch_task(void *param)
@@ -264,7 +308,7 @@ void touch_task(void *param)
         if (touch_value > TOUCH_THRESHOLD)
         {
             ESP_LOGI(TAG, "Touch detected on GPIO %d", TOUCH_PAD_NUM);
-            send_next_mp3_file();//播放下一首
+            uac_player_next(); // 播放下一首
             vTaskDelay(pdMS_TO_TICKS(500)); // 防抖延迟
         }
 
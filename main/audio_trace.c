@@ -0,0 +1,233 @@
+#include "audio_trace.h"
+
+#include <string.h>
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include "esp_log.h"
+
+static const char *TAG = "AUDIO_TRACE";
+
+static const char *s_stage_names[AUDIO_TRACE_STAGE_NUM] = {
+    [AUDIO_TRACE_READ_WAIT] = "read wait",
+    [AUDIO_TRACE_DECODE] = "decode",
+    [AUDIO_TRACE_DECODE_TO_RING] = "decode->ring",
+    [AUDIO_TRACE_RING_TO_WRITE] = "ring->write",
+    [AUDIO_TRACE_WRITE] = "write",
+    [AUDIO_TRACE_TX_QUEUE] = "tx queue",
+    [AUDIO_TRACE_TOTAL] = "total",
+};
+
+const char *audio_trace_stage_name(audio_trace_stage_t stage)
+{
+    return stage < AUDIO_TRACE_STAGE_NUM ? s_stage_names[stage] : "?";
+}
+
+uint32_t audio_trace_percentile(const audio_trace_hist_t *hist, uint32_t percent)
+{
+    if (hist->count == 0)
+    {
+        return 0;
+    }
+    // 桶在查询期间仍可能增加，按各桶之和计算
+    uint32_t total = 0;
+    for (int i = 0; i < AUDIO_TRACE_BUCKETS; i++)
+    {
+        total += hist->buckets[i];
+    }
+    uint32_t target = (uint32_t)(((uint64_t)total * percent + 99) / 100);
+    uint32_t sum = 0;
+    for (int i = 0; i < AUDIO_TRACE_BUCKETS - 1; i++)
+    {
+        sum += hist->buckets[i];
+        if (sum >= target)
+        {
+            uint32_t upper = (uint32_t)AUDIO_TRACE_BUCKET0_US << i;
+            return upper < hist->max_us ? upper : hist->max_us;
+        }
+    }
+    return hist->max_us;
+}
+
+#if AUDIO_TRACE_ENABLE
+
+typedef struct
+{
+    atomic_uint count;
+    atomic_uint max_us;
+    atomic_uint buckets[AUDIO_TRACE_BUCKETS];
+} trace_hist_t;
+
+static trace_hist_t s_hist[AUDIO_TRACE_STAGE_NUM];
+
+// 写入驱动缓冲区的记录：写入完成时数据末尾在字节流中的位置。
+// 播放任务写入、USB 回调取出的单生产者/单消费者队列，满了就不再记录（抽样）
+#define TRACE_TX_MARKS 16
+
+typedef struct
+{
+    uint32_t end_pos;
+    uint32_t gen; // 写入时的复位代数
+    int64_t write_us;
+    int64_t origin_us;
+} trace_tx_mark_t;
+
+static trace_tx_mark_t s_tx_marks[TRACE_TX_MARKS];
+static atomic_uint s_tx_head;   // 只由取出方修改
+static atomic_uint s_tx_tail;   // 只由写入方修改
+static uint32_t s_tx_written;   // 只由写入方访问
+static uint32_t s_tx_write_gen; // 只由写入方访问
+static uint32_t s_tx_popped;    // 只由取出方访问
+static uint32_t s_tx_pop_gen;   // 只由取出方访问
+// 复位代数：复位可能来自写入方和取出方以外的任务，只增加代数，两边各自看到新代数时把计数清零
+static atomic_uint s_tx_gen;
+
+static uint32_t trace_bucket(uint32_t us)
+{
+    uint32_t b = 0;
+    uint32_t upper = AUDIO_TRACE_BUCKET0_US;
+    while (b < AUDIO_TRACE_BUCKETS - 1 && us >= upper)
+    {
+        b++;
+        upper <<= 1;
+    }
+    return b;
+}
+
+static void trace_record(audio_trace_stage_t stage, uint32_t us)
+{
+    trace_hist_t *h = &s_hist[stage];
+    atomic_fetch_add_explicit(&h->buckets[trace_bucket(us)], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&h->count, 1, memory_order_relaxed);
+    unsigned int max = atomic_load_explicit(&h->max_us, memory_order_relaxed);
+    while (us > max && !atomic_compare_exchange_weak_explicit(&h->max_us, &max, us, memory_order_relaxed,
+                                                              memory_order_relaxed))
+    {
+    }
+}
+
+void audio_trace_add(audio_trace_stage_t stage, int64_t since_us)
+{
+    if (since_us == 0)
+    {
+        return;
+    }
+    int64_t us = esp_timer_get_time() - since_us;
+    trace_record(stage, us < 0 ? 0 : (us > UINT32_MAX ? UINT32_MAX : (uint32_t)us));
+}
+
+void audio_trace_tx_write(uint32_t len, int64_t write_us, int64_t origin_us)
+{
+    uint32_t gen = atomic_load_explicit(&s_tx_gen, memory_order_acquire);
+    if (gen != s_tx_write_gen)
+    {
+        s_tx_write_gen = gen;
+        s_tx_written = 0;
+    }
+    s_tx_written += len;
+    unsigned int tail = atomic_load_explicit(&s_tx_tail, memory_order_relaxed);
+    if (tail - atomic_load_explicit(&s_tx_head, memory_order_acquire) >= TRACE_TX_MARKS)
+    {
+        return;
+    }
+    s_tx_marks[tail % TRACE_TX_MARKS] = (trace_tx_mark_t){
+        .end_pos = s_tx_written,
+        .gen = gen,
+        .write_us = write_us,
+        .origin_us = origin_us,
+    };
+    atomic_store_explicit(&s_tx_tail, tail + 1, memory_order_release);
+}
+
+void audio_trace_tx_pop(uint32_t len)
+{
+    unsigned int head = atomic_load_explicit(&s_tx_head, memory_order_relaxed);
+    unsigned int tail = atomic_load_explicit(&s_tx_tail, memory_order_acquire);
+    uint32_t gen = atomic_load_explicit(&s_tx_gen, memory_order_acquire);
+    if (gen != s_tx_pop_gen)
+    {
+        s_tx_pop_gen = gen;
+        s_tx_popped = 0;
+    }
+    s_tx_popped += len;
+    int64_t now = esp_timer_get_time();
+    while (head != tail)
+    {
+        const trace_tx_mark_t *m = &s_tx_marks[head % TRACE_TX_MARKS];
+        if (m->gen != gen)
+        {
+            // 复位前的记录对应的数据已被清空，丢弃；复位后（比这里看到的代数更新）的记录留到下一次
+            if ((int32_t)(m->gen - gen) > 0)
+            {
+                break;
+            }
+            head++;
+            continue;
+        }
+        if ((int32_t)(m->end_pos - s_tx_popped) > 0)
+        {
+            break;
+        }
+        trace_record(AUDIO_TRACE_TX_QUEUE, (uint32_t)(now - m->write_us));
+        if (m->origin_us != 0)
+        {
+            trace_record(AUDIO_TRACE_TOTAL, (uint32_t)(now - m->origin_us));
+        }
+        head++;
+    }
+    atomic_store_explicit(&s_tx_head, head, memory_order_release);
+}
+
+void audio_trace_tx_reset(void)
+{
+    atomic_fetch_add_explicit(&s_tx_gen, 1, memory_order_release);
+}
+
+void audio_trace_get(audio_trace_stage_t stage, audio_trace_hist_t *hist)
+{
+    trace_hist_t *h = &s_hist[stage];
+    hist->count = atomic_load_explicit(&h->count, memory_order_relaxed);
+    hist->max_us = atomic_load_explicit(&h->max_us, memory_order_relaxed);
+    for (int i = 0; i < AUDIO_TRACE_BUCKETS; i++)
+    {
+        hist->buckets[i] = atomic_load_explicit(&h->buckets[i], memory_order_relaxed);
+    }
+}
+
+void audio_trace_reset(void)
+{
+    for (int s = 0; s < AUDIO_TRACE_STAGE_NUM; s++)
+    {
+        atomic_store(&s_hist[s].count, 0);
+        atomic_store(&s_hist[s].max_us, 0);
+        for (int i = 0; i < AUDIO_TRACE_BUCKETS; i++)
+        {
+            atomic_store(&s_hist[s].buckets[i], 0);
+        }
+    }
+}
+
+#else
+
+void audio_trace_get(audio_trace_stage_t stage, audio_trace_hist_t *hist)
+{
+    memset(hist, 0, sizeof(audio_trace_hist_t));
+}
+
+void audio_trace_reset(void)
+{
+}
+
+#endif
+
+void audio_trace_log(void)
+{
+    for (int s = 0; s < AUDIO_TRACE_STAGE_NUM; s++)
+    {
+        audio_trace_hist_t hist;
+        audio_trace_get(s, &hist);
+        ESP_LOGI(TAG, "%-12s: %8" PRIu32 " samples, p50 %7" PRIu32 " us, p99 %7" PRIu32 " us, max %7" PRIu32 " us",
+                 audio_trace_stage_name(s), hist.count, audio_trace_percentile(&hist, 50),
+                 audio_trace_percentile(&hist, 99), hist.max_us);
+    }
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 播放链路各阶段的延迟统计
+ *
+ * 数据从 SD 卡读出到等时传输提交要经过：预读块 -> 解码 -> PCM 环形缓冲区 -> 播放任务处理
+ * -> 写入驱动环形缓冲区（uac_host_device_write_acquire/commit） -> stream_tx_xfer_submit 取出。
+ * 在每个阶段的边界打时间戳，相邻时间戳之差记入该阶段的直方图。
+ *
+ * 直方图大小固定，只用原子加和比较交换更新，可以在任意任务和 USB 回调中记录，查询时不停止记录。
+ * AUDIO_TRACE_ENABLE 为 0 时所有记录点编译为空，查询接口返回空的直方图。
+ */
+
+#ifndef AUDIO_TRACE_ENABLE
+#define AUDIO_TRACE_ENABLE 1
+#endif
+
+// 直方图桶数：第 0 个桶为 [0, AUDIO_TRACE_BUCKET0_US)，第 i 个桶为 [BUCKET0 << (i - 1), BUCKET0 << i)，最后一个桶不设上限
+#define AUDIO_TRACE_BUCKETS 16
+#define AUDIO_TRACE_BUCKET0_US 64
+
+typedef enum
+{
+    AUDIO_TRACE_READ_WAIT = 0,  // SD 卡读完一块到解码任务取走
+    AUDIO_TRACE_DECODE,         // 解码一帧
+    AUDIO_TRACE_DECODE_TO_RING, // 解码结束到提交给 PCM 环形缓冲区（增益、淡化、预解码缓存）
+    AUDIO_TRACE_RING_TO_WRITE,  // 提交到开始写入驱动缓冲区（环中排队、均衡、采样率转换、限制器）
+    AUDIO_TRACE_WRITE,          // 写入驱动缓冲区本身（复制或转换，驱动缓冲区满时阻塞）
+    AUDIO_TRACE_TX_QUEUE,       // 写入驱动缓冲区到被 stream_tx_xfer_submit 取出
+    AUDIO_TRACE_TOTAL,          // SD 卡读完到被 stream_tx_xfer_submit 取出
+    AUDIO_TRACE_STAGE_NUM,
+} audio_trace_stage_t;
+
+typedef struct
+{
+    uint32_t count;  // 样本数
+    uint32_t max_us; // 最大值
+    uint32_t buckets[AUDIO_TRACE_BUCKETS];
+} audio_trace_hist_t;
+
+/**
+ * @brief 取得一个阶段的直方图
+ */
+void audio_trace_get(audio_trace_stage_t stage, audio_trace_hist_t *hist);
+
+/**
+ * @brief 清空所有直方图
+ */
+void audio_trace_reset(void);
+
+/**
+ * @brief 阶段名称
+ */
+const char *audio_trace_stage_name(audio_trace_stage_t stage);
+
+/**
+ * @brief 按直方图估计百分位数（所在桶的上界），没有样本时返回 0
+ *
+ * @param[in] percent 1~100
+ */
+uint32_t audio_trace_percentile(const audio_trace_hist_t *hist, uint32_t percent);
+
+/**
+ * @brief 在日志中输出每个阶段的样本数、p50/p99 和最大值
+ */
+void audio_trace_log(void);
+
+#if AUDIO_TRACE_ENABLE
+
+#include "esp_timer.h"
+
+void audio_trace_add(audio_trace_stage_t stage, int64_t since_us);
+void audio_trace_tx_write(uint32_t len, int64_t write_us, int64_t origin_us);
+void audio_trace_tx_pop(uint32_t len);
+void audio_trace_tx_reset(void);
+
+// 当前时间戳
+#define AUDIO_TRACE_NOW() esp_timer_get_time()
+// 记录从 since_us 到现在的时长，since_us 为 0 时不记录
+#define AUDIO_TRACE_SPAN(stage, since_us) audio_trace_add(stage, since_us)
+// 写入驱动缓冲区 len 字节（write_us 为写入完成时间，origin_us 为数据读出 SD 卡的时间，0 表示静音等没有来源的数据）
+#define AUDIO_TRACE_TX_WRITE(len, write_us, origin_us) audio_trace_tx_write(len, write_us, origin_us)
+// 驱动缓冲区中取出 len 字节交给等时传输
+#define AUDIO_TRACE_TX_POP(len) audio_trace_tx_pop(len)
+// 驱动缓冲区被清空（流挂起、换设备），丢弃未取出的写入记录
+#define AUDIO_TRACE_TX_RESET() audio_trace_tx_reset()
+
+#else
+
+#define AUDIO_TRACE_NOW() ((int64_t)0)
+#define AUDIO_TRACE_SPAN(stage, since_us) ((void)(since_us))
+#define AUDIO_TRACE_TX_WRITE(len, write_us, origin_us) ((void)0)
+#define AUDIO_TRACE_TX_POP(len) ((void)0)
+#define AUDIO_TRACE_TX_RESET() ((void)0)
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
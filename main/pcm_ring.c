@@ -0,0 +1,218 @@
+#include "pcm_ring.h"
+
+#include <stdatomic.h>
+#include <string.h>
+#include <assert.h>
+#include <inttypes.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "audio_trace.h"
+
+static const char *TAG = "PCM_RING";
+
+// 槽内存按 16 字节对齐，方便后级 SIMD 处理
+#define PCM_RING_ALIGN 16
+
+struct pcm_ring
+{
+    pcm_slot_t *slots;
+    uint8_t *pool;               // 所有槽共用的一块内存
+    uint32_t slot_num;
+    uint32_t period_ms;
+    // 两端共享，无锁访问
+    atomic_uint write_idx;       // 已发布给消费者的槽（自由递增）
+    atomic_uint read_idx;        // 已被消费者释放的槽（自由递增）
+    atomic_bool producer_waiting;
+    atomic_bool consumer_waiting;
+    SemaphoreHandle_t space_sem; // 有空闲槽时唤醒生产者
+    SemaphoreHandle_t data_sem;  // 有新数据时唤醒消费者
+    // 仅生产者访问
+    uint32_t fill_idx;           // 已提交的槽（含尚未发布的）
+    uint32_t pending_bytes;      // 已提交但未发布的字节数
+    // 仅消费者访问
+    uint32_t recv_idx;           // 已交给消费者的槽
+};
+
+esp_err_t pcm_ring_create(const pcm_ring_config_t *config, pcm_ring_handle_t *ring)
+{
+    // 槽数量必须是 2 的幂，保证自由递增的索引回绕后取模仍然连续
+    if (config == NULL || ring == NULL || config->slot_num < 2 || (config->slot_num & (config->slot_num - 1)) != 0 ||
+        config->slot_size == 0)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    struct pcm_ring *r = calloc(1, sizeof(struct pcm_ring));
+    if (r == NULL)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    uint32_t slot_size = (config->slot_size + PCM_RING_ALIGN - 1) & ~(PCM_RING_ALIGN - 1);
+    r->slots = calloc(config->slot_num, sizeof(pcm_slot_t));
+    r->pool = heap_caps_aligned_alloc(PCM_RING_ALIGN, slot_size * config->slot_num, config->caps);
+    r->space_sem = xSemaphoreCreateBinary();
+    r->data_sem = xSemaphoreCreateBinary();
+    if (r->slots == NULL || r->pool == NULL || r->space_sem == NULL || r->data_sem == NULL)
+    {
+        ESP_LOGE(TAG, "Failed to allocate %" PRIu32 " slots of %" PRIu32 " bytes", config->slot_num, slot_size);
+        pcm_ring_delete(r);
+        return ESP_ERR_NO_MEM;
+    }
+
+    for (uint32_t i = 0; i < config->slot_num; i++)
+    {
+        r->slots[i].data = r->pool + i * slot_size;
+        r->slots[i].size = slot_size;
+    }
+    r->slot_num = config->slot_num;
+    r->period_ms = config->period_ms;
+    atomic_init(&r->write_idx, 0);
+    atomic_init(&r->read_idx, 0);
+    atomic_init(&r->producer_waiting, false);
+    atomic_init(&r->consumer_waiting, false);
+
+    *ring = r;
+    return ESP_OK;
+}
+
+void pcm_ring_delete(pcm_ring_handle_t ring)
+{
+    if (ring == NULL)
+    {
+        return;
+    }
+    if (ring->space_sem)
+    {
+        vSemaphoreDelete(ring->space_sem);
+    }
+    if (ring->data_sem)
+    {
+        vSemaphoreDelete(ring->data_sem);
+    }
+    if (ring->pool)
+    {
+        heap_caps_free(ring->pool);
+    }
+    free(ring->slots);
+    free(ring);
+}
+
+// 等待条件成立：先置等待标志再复查条件，避免丢失唤醒
+static bool pcm_ring_wait(atomic_bool *waiting, SemaphoreHandle_t sem, bool (*ready)(pcm_ring_handle_t),
+                          pcm_ring_handle_t ring, TickType_t timeout)
+{
+    TickType_t start = xTaskGetTickCount();
+    while (!ready(ring))
+    {
+        atomic_store(waiting, true);
+        if (ready(ring))
+        {
+            atomic_store(waiting, false);
+            break;
+        }
+        TickType_t wait = timeout;
+        if (timeout != portMAX_DELAY)
+        {
+            TickType_t elapsed = xTaskGetTickCount() - start;
+            if (elapsed >= timeout)
+            {
+                atomic_store(waiting, false);
+                return false;
+            }
+            wait = timeout - elapsed;
+        }
+        xSemaphoreTake(sem, wait);
+    }
+    return true;
+}
+
+static bool pcm_ring_has_space(pcm_ring_handle_t ring)
+{
+    return ring->fill_idx - atomic_load(&ring->read_idx) < ring->slot_num;
+}
+
+static bool pcm_ring_has_data(pcm_ring_handle_t ring)
+{
+    return atomic_load(&ring->write_idx) != ring->recv_idx;
+}
+
+pcm_slot_t *pcm_ring_acquire(pcm_ring_handle_t ring, TickType_t timeout)
+{
+    if (!pcm_ring_wait(&ring->producer_waiting, ring->space_sem, pcm_ring_has_space, ring, timeout))
+    {
+        return NULL;
+    }
+    pcm_slot_t *slot = &ring->slots[ring->fill_idx & (ring->slot_num - 1)];
+    slot->len = 0;
+    slot->flags = 0;
+    return slot;
+}
+
+void pcm_ring_flush(pcm_ring_handle_t ring)
+{
+    ring->pending_bytes = 0;
+    if (atomic_load(&ring->write_idx) == ring->fill_idx)
+    {
+        return;
+    }
+    atomic_store(&ring->write_idx, ring->fill_idx);
+    if (atomic_exchange(&ring->consumer_waiting, false))
+    {
+        xSemaphoreGive(ring->data_sem);
+    }
+}
+
+void pcm_ring_commit(pcm_ring_handle_t ring, pcm_slot_t *slot)
+{
+    assert(slot == &ring->slots[ring->fill_idx & (ring->slot_num - 1)]);
+    slot->commit_us = AUDIO_TRACE_NOW();
+    ring->fill_idx++;
+    ring->pending_bytes += slot->len;
+
+    uint32_t period_bytes = (uint32_t)((uint64_t)slot->sample_rate * slot->channels * (slot->bits / 8) * ring->period_ms / 1000);
+    bool ring_full = ring->fill_idx - atomic_load(&ring->read_idx) >= ring->slot_num;
+    if (ring->pending_bytes >= period_bytes || (slot->flags & PCM_SLOT_FLAG_TRACK_END) || ring_full)
+    {
+        pcm_ring_flush(ring);
+    }
+}
+
+uint32_t pcm_ring_receive(pcm_ring_handle_t ring, pcm_slot_t **slots, uint32_t max, TickType_t timeout)
+{
+    if (!pcm_ring_wait(&ring->consumer_waiting, ring->data_sem, pcm_ring_has_data, ring, timeout))
+    {
+        return 0;
+    }
+    uint32_t count = atomic_load(&ring->write_idx) - ring->recv_idx;
+    if (count > max)
+    {
+        count = max;
+    }
+    for (uint32_t i = 0; i < count; i++)
+    {
+        slots[i] = &ring->slots[(ring->recv_idx + i) & (ring->slot_num - 1)];
+    }
+    ring->recv_idx += count;
+    return count;
+}
+
+void pcm_ring_release(pcm_ring_handle_t ring, uint32_t count)
+{
+    atomic_fetch_add(&ring->read_idx, count);
+    if (atomic_exchange(&ring->producer_waiting, false))
+    {
+        xSemaphoreGive(ring->space_sem);
+    }
+}
+
+uint32_t pcm_ring_filled(pcm_ring_handle_t ring)
+{
+    return atomic_load(&ring->write_idx) - atomic_load(&ring->read_idx);
+}
+
+uint32_t pcm_ring_slot_num(pcm_ring_handle_t ring)
+{
+    return ring->slot_num;
+}
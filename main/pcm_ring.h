@@ -0,0 +1,125 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief PCM 帧槽环形缓冲区（单生产者/单消费者）
+ *
+ * 解码任务（生产者）从环中取得空闲槽，直接把解码结果写进槽内存，
+ * 写完后提交；播放任务（消费者）取得已提交的槽，写给 USB 后再释放。
+ * 槽内存在整个过程中只有一份，不发生拷贝。
+ *
+ * 读写索引为无锁原子变量，信号量只用于空/满时的阻塞等待。
+ * 提交按周期批量发布：累计的 PCM 时长达到 period_ms 才对消费者可见，
+ * 以减少唤醒次数；pcm_ring_flush 可强制发布（例如曲目结束）。
+ */
+
+/** 槽标志 */
+#define PCM_SLOT_FLAG_TRACK_START (1 << 0) // 曲目的第一个槽
+#define PCM_SLOT_FLAG_TRACK_END   (1 << 1) // 曲目的最后一个槽
+#define PCM_SLOT_FLAG_SPLICE      (1 << 2) // 与 TRACK_START 同时出现：与上一首无缝衔接
+
+/**
+ * @brief PCM 帧槽
+ */
+typedef struct
+{
+    uint8_t *data;        // 槽内存，由环形缓冲区持有
+    uint32_t size;        // 槽容量（字节）
+    uint32_t len;         // 有效 PCM 字节数
+    uint32_t sample_rate; // 采样率
+    uint8_t channels;     // 通道数
+    uint8_t bits;         // 位深度
+    uint16_t flags;       // PCM_SLOT_FLAG_*
+    uint32_t epoch;       // 生产者写入的序号，消费者可据此丢弃过期的数据（例如跳转前解码的槽）
+    int64_t origin_us;    // 数据从 SD 卡读出的时间，由生产者填写（延迟统计用，0 为未知）
+    int64_t commit_us;    // 提交的时间，由 pcm_ring_commit 填写（延迟统计用）
+} pcm_slot_t;
+
+/**
+ * @brief 环形缓冲区配置
+ */
+typedef struct
+{
+    uint32_t slot_num;  // 槽数量，必须是 2 的幂
+    uint32_t slot_size; // 每个槽的字节数，必须能容纳解码器输出的最大一帧
+    uint32_t period_ms; // 批量提交周期（例如 5/10/20 ms）
+    uint32_t caps;      // 槽内存的 heap_caps 属性
+} pcm_ring_config_t;
+
+typedef struct pcm_ring *pcm_ring_handle_t;
+
+/**
+ * @brief 创建 PCM 环形缓冲区
+ *
+ * @param[in]  config 配置
+ * @param[out] ring   环形缓冲区句柄
+ * @return
+ *  - ESP_OK 成功
+ *  - ESP_ERR_INVALID_ARG 参数无效
+ *  - ESP_ERR_NO_MEM 内存不足
+ */
+esp_err_t pcm_ring_create(const pcm_ring_config_t *config, pcm_ring_handle_t *ring);
+
+/**
+ * @brief 删除 PCM 环形缓冲区，调用前两端都必须已停止使用
+ */
+void pcm_ring_delete(pcm_ring_handle_t ring);
+
+/**
+ * @brief 生产者：取得下一个空闲槽
+ *
+ * @param[in] ring    环形缓冲区句柄
+ * @param[in] timeout 等待空闲槽的超时时间
+ * @return 空闲槽，超时返回 NULL
+ */
+pcm_slot_t *pcm_ring_acquire(pcm_ring_handle_t ring, TickType_t timeout);
+
+/**
+ * @brief 生产者：提交已填充的槽（必须是最近一次 acquire 得到的槽）
+ *
+ * 累计未发布的 PCM 达到一个周期，或槽带有 PCM_SLOT_FLAG_TRACK_END 时才发布给消费者。
+ */
+void pcm_ring_commit(pcm_ring_handle_t ring, pcm_slot_t *slot);
+
+/**
+ * @brief 生产者：立即发布所有已提交但尚未发布的槽
+ */
+void pcm_ring_flush(pcm_ring_handle_t ring);
+
+/**
+ * @brief 消费者：批量取得已发布的槽
+ *
+ * @param[in]  ring    环形缓冲区句柄
+ * @param[out] slots   输出槽指针数组
+ * @param[in]  max     最多取得的槽数量
+ * @param[in]  timeout 没有数据时的等待时间
+ * @return 取得的槽数量，超时返回 0
+ */
+uint32_t pcm_ring_receive(pcm_ring_handle_t ring, pcm_slot_t **slots, uint32_t max, TickType_t timeout);
+
+/**
+ * @brief 消费者：按顺序释放 count 个已取得的槽，槽归还给生产者
+ */
+void pcm_ring_release(pcm_ring_handle_t ring, uint32_t count);
+
+/**
+ * @brief 已发布但尚未释放的槽数量
+ */
+uint32_t pcm_ring_filled(pcm_ring_handle_t ring);
+
+/**
+ * @brief 槽数量
+ */
+uint32_t pcm_ring_slot_num(pcm_ring_handle_t ring);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,5 +1,10 @@
 #include "sdcard.h"
+#include <inttypes.h>
+#include "ff.h"
 static const char *TAG = "SD_CARD";
+// 格式化时使用的分配单元大小，也是读取簇大小失败时的默认值
+#define SDCARD_ALLOCATION_UNIT_SIZE 16 * 1024
+static uint32_t s_cluster_size = SDCARD_ALLOCATION_UNIT_SIZE;
 void mount_sd_card()
 {
     esp_err_t ret;
@@ -25,7 +30,7 @@ void mount_sd_card()
     esp_vfs_fat_sdmmc_mount_config_t mount_config = {
         .format_if_mount_failed = false,
         .max_files = 5,
-        .allocation_unit_size = 16 * 1024};
+        .allocation_unit_size = SDCARD_ALLOCATION_UNIT_SIZE};
 
     sdmmc_card_t *card;
     ret = esp_vfs_fat_sdmmc_mount(sdcard_mount_point, &host, &slot_config, &mount_config, &card);
@@ -45,4 +50,18 @@ void mount_sd_card()
 
     // 打印SD/MMC卡信息
     sdmmc_card_print_info(stdout, card);
-}
\ No newline at end of file
+
+    // 读取实际的簇大小（卡可能是在电脑上格式化的），SD 卡是第一个挂载的 FATFS 驱动器 0
+    FATFS *fs;
+    DWORD free_clusters;
+    if (f_getfree("0:", &free_clusters, &fs) == FR_OK)
+    {
+        s_cluster_size = fs->csize * card->csd.sector_size;
+    }
+    ESP_LOGI(TAG, "Cluster size: %" PRIu32 " bytes", s_cluster_size);
+}
+
+uint32_t sdcard_get_cluster_size(void)
+{
+    return s_cluster_size;
+}
@@ -6,4 +6,9 @@
 #include "esp_vfs_fat.h"
 #include "driver/sdmmc_host.h"
 
-void mount_sd_card();
\ No newline at end of file
+void mount_sd_card();
+
+/**
+ * @brief FAT 簇大小（字节），按簇整数倍读取时 SD 卡吞吐最高
+ */
+uint32_t sdcard_get_cluster_size(void);
@@ -2,353 +2,2249 @@
 #include "freertos/event_groups.h"
 #include "freertos/task.h"
 #include "freertos/queue.h"
+#include "freertos/semphr.h"
 
 #include "esp_err.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 
 #include "esp_vfs_fat.h"
-#include "esp_audio_dec.h"
-#include "esp_audio_dec_reg.h"
 #include "esp_audio_dec_default.h"
-#include "esp_mp3_dec.h"
+#include "esp_audio_simple_dec.h"
+#include "esp_audio_simple_dec_default.h"
 
 #include "string.h"
+#include "math.h"
+#include "dirent.h"
+#include "stdatomic.h"
 #include "usb/uac_host.h"
+#include "pcm_ring.h"
+#include "audio_src.h"
+#include "usb_uac.h"
+#include "audio_gapless.h"
+#include "audio_probe.h"
+#include "audio_reader.h"
+#include "audio_seek.h"
+#include "audio_gain.h"
+#include "audio_mixer.h"
+#include "audio_eq.h"
+#include "audio_limiter.h"
+#include "audio_arena.h"
+#include "audio_mem.h"
+#include "audio_trace.h"
+#include "audio_convert.h"
+#include "audio_simd.h"
+#include "audio_loudness.h"
+#include "audio_loudness_cache.h"
+#include "audio_tag.h"
+#include "sdcard.h"
+#include "uac_audio_player.h"
 
 extern uac_host_device_handle_t s_spk_dev_handle;
 extern uint8_t player_volume;
-bool uac_player_playing = false;
-bool uac_decoder_closed = true;
 static const char *TAG = "UAC PLAYER";
-// 音频解码器句柄
-esp_audio_dec_handle_t decoder;
-// 音乐文件 队列句柄
-QueueHandle_t audio_file_queue;
-// 定义用于传递解码后音频数据的队列
-QueueHandle_t audio_data_queue;
-// 控制解码器播放文件的队列
-QueueHandle_t audio_control_file_queue;
-// 定义缓冲区大小
-#define head_buffer_size 1024 * 500 // 缓存音乐文件头部信息，可能包含图片，所以存大一点
-#define input_buffer_size 1024 * 12
-#define out_fram_buffer_size 1024 * 4
+// 解码任务与播放任务之间的 PCM 帧槽环形缓冲区
+static pcm_ring_handle_t pcm_ring;
+// 文件预读：块数量（3 为三缓冲）、每次读取的 FAT 簇数量；块内存的位置见 audio_mem 的放置策略
+#define reader_block_num 3
+#define reader_clusters_per_read 1
+// 块前预留的拼接空间，也是解码器未消耗的剩余数据上限
+#define reader_headroom 1024 * 4
+// 预读任务优先级高于解码任务，大部分时间在等待 SD 卡
+#define reader_TASK_PRIORITY 4
+#define reader_TASK_CORE 0
+// 等待预读数据的超时时间
+#define reader_timeout_ms 2000
+// 文件未读完时缓冲区中至少保留的数据量（大于一帧 MP3），不足时先读文件
+#define decode_min_input 1440
+// PCM 环形缓冲区：槽数量（2 的幂）、槽大小（需容纳解码器输出的最大一帧，FLAC 常见 4096 点 16 位立体声）、批量提交周期
+#define pcm_ring_slot_num 8
+#define pcm_ring_slot_size 1024 * 16
+#define pcm_ring_period_ms 10
+// 播放任务一次最多取出的槽数量
+#define player_batch_num 4
+// 采样率转换质量档位，AUTO 时按 CPU 预算（单核百分比）选择
+#define player_src_quality AUDIO_SRC_QUALITY_AUTO
+#define player_src_cpu_budget 20
+// 音量变化和开始播放时的淡入时长、切歌/停止时的淡出时长
+#define player_gain_ramp_ms 20
+#define player_fade_out_ms 300
+// 预解码缓存：一帧解码输出加上交叉淡入时一个槽的待混音数据
+#define player_prime_size (pcm_ring_slot_size * 2)
+// 交叉淡化：最长时长；两个解码器合计允许占用的单核百分比；第二个解码器的工作内存大小
+#define player_xfade_max_ms 12000
+#define player_xfade_cpu_percent 70
+#define player_xfade_dec_mem_need (1024 * 96)
+// 曲目槽：当前曲目和预先打开的下一首各一个；每个槽的曲目状态、拼接缓存和预解码缓存（含对齐余量）
+#define player_slot_num 2
+#define player_slot_mem_size (sizeof(player_track_t) + reader_headroom + player_prime_size + AUDIO_ARENA_ALIGN * 3)
+// 提示音播放期间音乐压低到的增益（约 -12 dB）
+#define player_duck_gain (AUDIO_GAIN_UNITY / 4)
+// 输出前的峰值限制器：前瞻时长（1~5 ms，也是引入的延迟）、释放时间常数、真峰值上限
+#define player_limiter_lookahead_ms 2
+#define player_limiter_release_ms 80
+#define player_limiter_ceiling_db -1.0f
+// 响度扫描任务：优先级低于播放相关的所有任务
+#define scan_TASK_PRIORITY 1
+#define scan_TASK_CORE 0
+#define scan_TASK_STACK_SIZE 1024 * 4
+#define scan_poll_ms 500
+// 放置策略基准每种放置解码的时长
+#define player_bench_seconds 20
+#define loudness_cache_file sdcard_mount_point "/.loudness"
 // 定义音频任务堆栈大小
-#define codec_TASK_STACK_SIZE 1024 * 3
-#define player_TASK_STACK_SIZE 1024 * 2
-#define countrol_player_TASK_STACK_SIZE 1024 * 3
-// 根据文件扩展名获取音频类型
-esp_audio_type_t get_audio_type_from_file(const char *file_path)
+#define codec_TASK_STACK_SIZE 1024 * 4
+// 播放任务在栈上协商格式（设备信息和 alt 参数表约 0.5 KB）、创建 SRC，并打印浮点日志。
+// 每首曲目开始时以 debug 级别打印栈的最小剩余量，按实测值调整
+#define player_TASK_STACK_SIZE 1024 * 4
+#define event_TASK_STACK_SIZE 1024 * 3
+// 控制命令邮箱和事件队列的深度，发送命令的最长等待时间
+#define player_mailbox_len 8
+#define player_event_queue_len 8
+#define player_cmd_timeout_ms 100
+// 暂停/恢复时的淡出/淡入时长
+#define player_pause_fade_ms 50
+// 无缝播放时取得下一首曲目的回调，切换上一首时取得上一首的回调
+static uac_player_next_track_cb_t next_track_cb = NULL;
+static void *next_track_ctx = NULL;
+static uac_player_next_track_cb_t prev_track_cb = NULL;
+static void *prev_track_ctx = NULL;
+// 最近一首开始解码的曲目，下一首/上一首命令以它为参照；只由解码任务访问
+static char player_current_path[UAC_PLAYER_PATH_MAX];
+// 没有跳转请求
+#define PLAYER_SEEK_NONE UINT32_MAX
+
+// 控制命令，全部经过同一个邮箱交给解码任务，由它按状态机处理
+typedef enum
+{
+    PLAYER_CMD_PLAY = 0,
+    PLAYER_CMD_PAUSE,
+    PLAYER_CMD_RESUME,
+    PLAYER_CMD_STOP,
+    PLAYER_CMD_NEXT,
+    PLAYER_CMD_PREV,
+    PLAYER_CMD_SEEK,
+    PLAYER_CMD_VOLUME,
+    PLAYER_CMD_MEM_TEST,
+    PLAYER_CMD_MEM_BENCH,
+} player_cmd_type_t;
+
+typedef struct
+{
+    player_cmd_type_t type;
+    uint32_t arg; // SEEK 的位置（毫秒）、VOLUME 的音量、MEM_TEST 的切歌次数
+    char *path;   // PLAY、MEM_BENCH 的文件路径，由解码任务释放
+} player_cmd_t;
+
+static QueueHandle_t player_mailbox = NULL;
+// 播放器状态，只由解码任务修改
+static atomic_int player_state = UAC_PLAYER_STATE_IDLE;
+// 事件先进入队列，由事件任务调用订阅者，不阻塞解码
+static QueueHandle_t player_event_queue = NULL;
+static SemaphoreHandle_t player_subscriber_lock = NULL;
+typedef struct
+{
+    uac_player_event_cb_t cb;
+    void *ctx;
+} player_subscriber_t;
+static player_subscriber_t player_subscribers[UAC_PLAYER_SUBSCRIBER_MAX];
+// 暂停时播放任务在增益降到 0 后停止取数据，环中的数据留到恢复后播放
+static atomic_bool player_hold = false;
+// 暂停时是否挂起扬声器流；流是否已被播放任务挂起（只由播放任务访问）
+static atomic_int player_pause_mode = UAC_PLAYER_PAUSE_SUSPEND;
+static bool player_suspended = false;
+// 每次跳转加一，播放任务丢弃跳转前解码的槽
+static atomic_uint player_epoch = 0;
+// 输出路径上的 PCM 增益（音量、静音、淡入淡出）
+static audio_gain_t player_gain;
+static bool player_muted = false;
+// 相邻曲目交叉淡化的时长，0 为关闭（无缝衔接）
+static atomic_uint player_xfade_ms = 0;
+// 提示音等输入流在等时传输提交前混入
+static audio_mixer_handle_t player_mixer = NULL;
+// 解码输出上的参数均衡
+static audio_eq_handle_t player_eq = NULL;
+// 写给 USB 之前的最后一级，防止增益和均衡之后削波
+static audio_limiter_handle_t player_limiter = NULL;
+// 响度扫描任务，扫描完一遍后退出
+static TaskHandle_t scan_task_handle = NULL;
+static char scan_dir[256];
+
+void uac_audio_player_set_next_track_cb(uac_player_next_track_cb_t cb, void *ctx)
+{
+    next_track_ctx = ctx;
+    next_track_cb = cb;
+}
+
+void uac_audio_player_set_prev_track_cb(uac_player_next_track_cb_t cb, void *ctx)
+{
+    prev_track_ctx = ctx;
+    prev_track_cb = cb;
+}
+
+// 曲目槽：曲目用到的内存在初始化时按最坏情况一次分配，关闭曲目时整体复位，不在堆上反复分配释放。
+// 解码器没有复位接口，每首曲目重新打开，不在槽中缓存
+typedef struct
+{
+    audio_arena_handle_t mem;    // 曲目状态、拼接缓存和预解码缓存
+    audio_arena_handle_t reader; // 预读块
+    bool busy;
+    uint32_t dec_open_count; // 打开解码器的次数
+} player_slot_t;
+
+// 正在解码的曲目：文件、解码器、输入缓冲区和无缝拼接的裁剪状态
+typedef struct
+{
+    player_slot_t *slot;
+    char file_path[256];
+    audio_reader_handle_t reader;
+    esp_audio_simple_dec_handle_t decoder;
+    esp_audio_simple_dec_type_t type;
+    bool passthrough;           // WAV 整数 PCM，不经过解码器直接输出
+    uint32_t pcm_offset;        // 直通时 data 块在文件中的位置
+    uint64_t pcm_size;          // 直通时 data 块的长度
+    uint64_t pcm_remain;        // 直通时 data 块剩余的字节数
+    uint8_t *carry;             // 换块时暂存上一块没用完的数据
+    audio_tag_t tag;            // 标签信息和音频数据在文件中的范围
+    uint32_t stream_pos;        // 下一块数据在文件中的位置
+    esp_audio_simple_dec_raw_t raw;
+    bool eof;                   // 文件已读完（raw 中可能还有数据未解码）
+    esp_audio_simple_dec_info_t info;
+    bool info_valid;
+    audio_gapless_info_t gapless;
+    uint64_t skip_frames;       // 开头还需丢弃的帧数（编码器延迟）
+    uint64_t remain_frames;     // 还可以输出的帧数（去掉末尾填充）
+    uint64_t out_frames;        // 已输出的帧数
+    uint8_t *prime;             // 预解码得到的 PCM（无缝衔接的第一帧，或交叉淡入时解码了还没混音的部分）
+    uint32_t prime_pos;
+    uint32_t prime_len;
+    uint64_t decode_us;         // 解码累计耗时，用于估计实时率
+    int64_t origin_us;          // 正在解码的块从 SD 卡读完的时间（延迟统计用）
+    int64_t decode_end_us;      // 上一帧解码结束的时间（延迟统计用）
+    audio_gain_t norm;          // 按缓存的响度归一化的增益
+} player_track_t;
+
+// 解码任务使用的曲目槽；扫描任务另有一个
+static player_slot_t player_slots[player_slot_num];
+static player_slot_t scan_slot;
+
+typedef enum
+{
+    TRACK_DECODE_OK = 0, // 成功（可能没有输出）
+    TRACK_DECODE_END,    // 曲目已全部解码
+    TRACK_DECODE_FAIL,   // 出错
+} track_decode_ret_t;
+
+static void track_close(player_track_t *track)
+{
+    if (track == NULL)
+    {
+        return;
+    }
+    player_slot_t *slot = track->slot;
+    if (track->decoder)
+    {
+        // 解码器收到结束标志后内部状态（比特储备、FLAC/WAV 解析进度等）无法复位，每首曲目关闭后重新打开
+        esp_audio_simple_dec_close(track->decoder);
+    }
+    if (track->reader)
+    {
+        audio_reader_stats_t stats;
+        audio_reader_get_stats(track->reader, &stats);
+        ESP_LOGI(TAG, "Read %llu KB at %llu KB/s (slowest read %" PRIu32 " us), decoder stalls %" PRIu32 " (worst %" PRIu32 " us)",
+                 stats.bytes / 1024, stats.read_us ? stats.bytes * 1000000 / 1024 / stats.read_us : 0, stats.max_read_us,
+                 stats.stall_count, stats.max_stall_us);
+        audio_reader_close(track->reader);
+    }
+    audio_arena_reset(slot->mem);
+    audio_arena_reset(slot->reader);
+    slot->busy = false;
+}
+
+// 取得下一块输入数据：上一块没用完的数据暂存后拷贝到新块前面的 headroom，跨块的帧在内存中连续
+static bool track_next_block(player_track_t *track)
+{
+    uint32_t carry = track->raw.len;
+    if (carry > reader_headroom)
+    {
+        ESP_LOGE(TAG, "Invalid raw.len: %lu", carry);
+        return false;
+    }
+    memmove(track->carry, track->raw.buffer, carry);
+    uint8_t *data;
+    uint32_t len = 0;
+    // 末尾的 ID3v1/APE 标签不交给解码器
+    esp_err_t err = ESP_ERR_NOT_FOUND;
+    if (track->stream_pos < track->tag.audio_end)
+    {
+        err = audio_reader_next(track->reader, &data, &len, pdMS_TO_TICKS(reader_timeout_ms));
+    }
+    if (err == ESP_OK)
+    {
+        track->stream_pos += len;
+        if (track->stream_pos > track->tag.audio_end)
+        {
+            len -= track->stream_pos - track->tag.audio_end;
+        }
+    }
+    if (err == ESP_ERR_NOT_FOUND)
+    {
+        ESP_LOGI(TAG, "Finished reading file: %s", track->file_path);
+        track->eof = true;
+        track->raw.buffer = track->carry;
+        track->raw.len = carry;
+        return true;
+    }
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Error reading file: %s (%s)", track->file_path, esp_err_to_name(err));
+        return false;
+    }
+    memcpy(data - carry, track->carry, carry);
+    track->origin_us = audio_reader_block_time(track->reader);
+    track->raw.buffer = data - carry;
+    track->raw.len = carry + len;
+    return true;
+}
+
+// 丢弃已读入的数据，从文件的 offset 处继续
+static bool track_seek(player_track_t *track, uint32_t offset)
+{
+    if (audio_reader_seek(track->reader, offset) != ESP_OK)
+    {
+        return false;
+    }
+    track->raw.len = 0;
+    track->eof = false;
+    track->stream_pos = offset;
+    return track_next_block(track);
+}
+
+// 打开解码器，简单解码器内部完成容器解析
+static bool track_open_decoder(player_track_t *track)
+{
+    track->slot->dec_open_count++;
+    esp_audio_simple_dec_cfg_t dec_cfg = {
+        .dec_type = track->type,
+        .dec_cfg = NULL, // 如果没有特殊配置，设置为 NULL
+        .cfg_size = 0,   // 如果没有特殊配置，设置为 0
+    };
+    audio_mem_decoder_begin();
+    esp_audio_err_t ret = esp_audio_simple_dec_open(&dec_cfg, &track->decoder);
+    audio_mem_decoder_end();
+    if (ret != ESP_AUDIO_ERR_OK)
+    {
+        ESP_LOGE(TAG, "Failed to open audio decoder, error: %d", ret);
+        track->decoder = NULL;
+        return false;
+    }
+    return true;
+}
+
+// 预读配置：每次读取整数个簇
+static void track_reader_config(audio_reader_config_t *config, uint32_t caps)
+{
+    *config = (audio_reader_config_t){
+        .block_num = reader_block_num,
+        .block_size = sdcard_get_cluster_size() * reader_clusters_per_read,
+        .headroom = reader_headroom,
+        .caps = caps,
+        .task_prio = reader_TASK_PRIORITY,
+        .task_core = reader_TASK_CORE,
+    };
+}
+
+// 按当前的簇大小和放置策略分配槽的内存
+static esp_err_t player_slot_init(player_slot_t *slot)
+{
+    audio_reader_config_t config;
+    track_reader_config(&config, audio_mem_caps(AUDIO_MEM_READ_AHEAD));
+    uint32_t reader_size = audio_reader_mem_size(&config);
+    memset(slot, 0, sizeof(player_slot_t));
+    if (audio_arena_create(player_slot_mem_size, audio_mem_caps(AUDIO_MEM_BULK), &slot->mem) != ESP_OK &&
+        audio_arena_create(player_slot_mem_size, audio_mem_fallback_caps(AUDIO_MEM_BULK), &slot->mem) != ESP_OK)
+    {
+        return ESP_ERR_NO_MEM;
+    }
+    if (audio_arena_create(reader_size, config.caps, &slot->reader) != ESP_OK &&
+        audio_arena_create(reader_size, audio_mem_fallback_caps(AUDIO_MEM_READ_AHEAD), &slot->reader) != ESP_OK)
+    {
+        audio_arena_delete(slot->mem);
+        slot->mem = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+static void player_slot_deinit(player_slot_t *slot)
+{
+    audio_arena_delete(slot->mem);
+    audio_arena_delete(slot->reader);
+    memset(slot, 0, sizeof(player_slot_t));
+}
+
+// 取得一个空闲的曲目槽（只在解码任务中调用）
+static player_slot_t *player_slot_take(void)
+{
+    for (int i = 0; i < player_slot_num; i++)
+    {
+        if (!player_slots[i].busy && player_slots[i].mem != NULL)
+        {
+            return &player_slots[i];
+        }
+    }
+    ESP_LOGE(TAG, "No free track slot");
+    return NULL;
+}
+
+// 打开曲目：打开文件，按文件头部的特征字节识别格式并打开解码器，解析编码器延迟/填充
+static player_track_t *track_open(const char *file_path, player_slot_t *slot)
+{
+    if (slot == NULL)
+    {
+        return NULL;
+    }
+    player_track_t *track = audio_arena_calloc(slot->mem, sizeof(player_track_t));
+    if (track == NULL)
+    {
+        return NULL;
+    }
+    slot->busy = true;
+    track->slot = slot;
+    strncpy(track->file_path, file_path, sizeof(track->file_path) - 1);
+
+    // 只读 ID3v2 标签头和需要的文本帧，封面等其余内容直接跳过
+    if (!audio_tag_scan(file_path, &track->tag))
+    {
+        ESP_LOGE(TAG, "Failed to open file: %s", file_path);
+        track_close(track);
+        return NULL;
+    }
+    if (track->tag.title[0] != '\0')
+    {
+        ESP_LOGI(TAG, "Title: %s, Artist: %s, Album: %s", track->tag.title, track->tag.artist, track->tag.album);
+    }
+    // 扫描过的文件按缓存的响度归一化，没有扫描过的保持原样
+    float lufs, true_peak;
+    uint32_t norm_gain = AUDIO_GAIN_UNITY;
+    if (audio_loudness_cache_lookup(file_path, &lufs, &true_peak))
+    {
+        norm_gain = audio_loudness_gain_q15(lufs, true_peak);
+        ESP_LOGI(TAG, "Loudness %.1f LUFS, true peak %.1f dBTP, gain %.1f dB", lufs, true_peak,
+                 20.0f * log10f(norm_gain / (float)AUDIO_GAIN_UNITY));
+    }
+    audio_gain_init(&track->norm, norm_gain);
+
+    // 从第一个音频字节开始预读；预读块放在槽中，簇大小变大放不下时由预读模块自行分配
+    audio_reader_config_t reader_config;
+    track_reader_config(&reader_config, audio_mem_caps(AUDIO_MEM_READ_AHEAD));
+    uint32_t reader_size = audio_reader_mem_size(&reader_config);
+    if (audio_arena_get_free(slot->reader) >= reader_size)
+    {
+        reader_config.mem = audio_arena_alloc(slot->reader, reader_size, AUDIO_READER_ALIGN);
+    }
+    track->carry = audio_arena_alloc(slot->mem, reader_headroom, 0);
+    track->stream_pos = track->tag.audio_start;
+    if (track->carry == NULL || audio_reader_open(file_path, &reader_config, track->tag.audio_start, &track->reader) != ESP_OK)
+    {
+        track->reader = NULL;
+        track_close(track);
+        return NULL;
+    }
+    if (!track_next_block(track))
+    {
+        track_close(track);
+        return NULL;
+    }
+
+    track->type = audio_probe_type(track->raw.buffer, track->raw.len);
+    if (track->type == ESP_AUDIO_SIMPLE_DEC_TYPE_NONE)
+    {
+        ESP_LOGE(TAG, "Unsupported audio format: %s", file_path);
+        track_close(track);
+        return NULL;
+    }
+    ESP_LOGI(TAG, "Detected %s: %s", audio_probe_type_name(track->type), file_path);
+
+    // WAV 整数 PCM 直接输出，跳到 data 块
+    audio_probe_wav_t wav;
+    if (track->type == ESP_AUDIO_SIMPLE_DEC_TYPE_WAV && audio_probe_wav_pcm(track->raw.buffer, track->raw.len, &wav))
+    {
+        track->passthrough = true;
+        track->info.sample_rate = wav.sample_rate;
+        track->info.channel = wav.channels;
+        track->info.bits_per_sample = wav.bits;
+        track->info_valid = true;
+        track->pcm_offset = track->tag.audio_start + wav.data_offset;
+        track->pcm_size = wav.data_size;
+        track->pcm_remain = wav.data_size;
+        // data 块偏移相对于音频数据起点
+        if (wav.data_offset <= track->raw.len)
+        {
+            track->raw.buffer += wav.data_offset;
+            track->raw.len -= wav.data_offset;
+        }
+        else if (!track_seek(track, track->tag.audio_start + wav.data_offset))
+        {
+            track_close(track);
+            return NULL;
+        }
+        track->remain_frames = UINT64_MAX;
+        return track;
+    }
+
+    if (!track_open_decoder(track))
+    {
+        track_close(track);
+        return NULL;
+    }
+
+    // 第一块从第一个音频帧开始，解析 LAME 信息；iTunSMPB 来自 ID3v2 标签或 MP4 的 ilst
+    bool is_mp3 = track->type == ESP_AUDIO_SIMPLE_DEC_TYPE_MP3;
+    bool gapless_found = audio_gapless_parse(track->raw.buffer, track->raw.len, is_mp3, &track->gapless);
+    if (!gapless_found && track->tag.itunsmpb[0] != '\0')
+    {
+        gapless_found = audio_gapless_parse_itunsmpb(track->tag.itunsmpb, is_mp3, &track->gapless);
+    }
+    if (gapless_found)
+    {
+        ESP_LOGI(TAG, "Gapless info (%s): delay %" PRIu32 ", padding %" PRIu32 ", frames %llu",
+                 track->gapless.source == AUDIO_GAPLESS_SOURCE_LAME ? "LAME" : "iTunSMPB", track->gapless.delay,
+                 track->gapless.padding, track->gapless.total_frames);
+    }
+    if (track->gapless.skip_bytes > 0 && track->gapless.skip_bytes <= track->raw.len)
+    {
+        track->raw.buffer += track->gapless.skip_bytes;
+        track->raw.len -= track->gapless.skip_bytes;
+    }
+    track->skip_frames = track->gapless.delay;
+    track->remain_frames = track->gapless.total_frames ? track->gapless.total_frames : UINT64_MAX;
+    return track;
+}
+
+// WAV 整数 PCM 不经过解码器：预读块中的数据直接拷贝进槽
+static track_decode_ret_t track_copy_pcm(player_track_t *track, uint8_t *out, uint32_t size, uint32_t *len)
+{
+    uint32_t frame_bytes = track->info.channel * (track->info.bits_per_sample / 8);
+    uint32_t want = size - size % frame_bytes;
+    if (want > track->pcm_remain)
+    {
+        want = (uint32_t)track->pcm_remain;
+    }
+    uint32_t n = 0;
+    while (n < want)
+    {
+        if (track->raw.len == 0)
+        {
+            if (track->eof || !track_next_block(track))
+            {
+                break;
+            }
+            continue;
+        }
+        uint32_t copy = track->raw.len < want - n ? track->raw.len : want - n;
+        memcpy(out + n, track->raw.buffer, copy);
+        track->raw.buffer += copy;
+        track->raw.len -= copy;
+        n += copy;
+    }
+    // 文件末尾不完整的一帧丢弃
+    n -= n % frame_bytes;
+    if (n == 0)
+    {
+        return track->eof ? TRACK_DECODE_END : TRACK_DECODE_FAIL;
+    }
+    track->pcm_remain -= n;
+    track->out_frames += n / frame_bytes;
+    *len = n;
+    return TRACK_DECODE_OK;
+}
+
+// 解码一帧到 out，并按编码器延迟/填充裁剪，*len 返回有效 PCM 字节数
+static track_decode_ret_t track_decode_raw(player_track_t *track, uint8_t *out, uint32_t size, uint32_t *len)
+{
+    *len = 0;
+    if (track->passthrough)
+    {
+        return track_copy_pcm(track, out, size, len);
+    }
+    if (track->remain_frames == 0)
+    {
+        // 末尾填充之前的帧都已解码
+        return TRACK_DECODE_END;
+    }
+    // 文件没读完时保留足够的数据，保证解码器拿到完整的一帧
+    while (!track->eof && track->raw.len <= decode_min_input)
+    {
+        if (!track_next_block(track))
+        {
+            return TRACK_DECODE_FAIL;
+        }
+    }
+    if (track->raw.len == 0)
+    {
+        return TRACK_DECODE_END;
+    }
+
+    esp_audio_simple_dec_out_t out_frame = {
+        .buffer = out,
+        .len = size,
+    };
+    // FLAC 等解析器需要结束标志才会输出缓存的最后一帧
+    track->raw.eos = track->eof;
+    // 解码器在解析出第一帧时才分配解码所需的工作内存
+    if (!track->info_valid)
+    {
+        audio_mem_decoder_begin();
+    }
+    int64_t start_us = esp_timer_get_time();
+    esp_audio_err_t ret = esp_audio_simple_dec_process(track->decoder, &track->raw, &out_frame);
+    track->decode_us += esp_timer_get_time() - start_us;
+    AUDIO_TRACE_SPAN(AUDIO_TRACE_DECODE, start_us);
+    track->decode_end_us = AUDIO_TRACE_NOW();
+    if (!track->info_valid)
+    {
+        audio_mem_decoder_end();
+    }
+    if (ret == ESP_AUDIO_ERR_BUFF_NOT_ENOUGH)
+    {
+        // 槽大小固定，帧放不下说明 pcm_ring_slot_size 配置过小
+        ESP_LOGE(TAG, "Decoded frame %lu bytes exceeds pcm slot size %lu", out_frame.needed_size, size);
+        return TRACK_DECODE_FAIL;
+    }
+    if (ret != ESP_AUDIO_ERR_OK)
+    {
+        // 文件末尾不完整的帧
+        if (track->eof)
+        {
+            return TRACK_DECODE_END;
+        }
+        ESP_LOGE(TAG, "Failed to process audio data, error: %d", ret);
+        return TRACK_DECODE_FAIL;
+    }
+    if (track->raw.consumed == 0 && out_frame.decoded_size == 0)
+    {
+        // 解析器需要更多数据才能拼出完整的一帧
+        if (track->eof)
+        {
+            return TRACK_DECODE_END;
+        }
+        return track_next_block(track) ? TRACK_DECODE_OK : TRACK_DECODE_FAIL;
+    }
+    // 更新输入数据指针和长度
+    track->raw.buffer += track->raw.consumed;
+    track->raw.len -= track->raw.consumed;
+    // 没有输出（例如跳过了标签数据）
+    if (out_frame.decoded_size == 0)
+    {
+        return TRACK_DECODE_OK;
+    }
+    if (!track->info_valid)
+    {
+        esp_audio_simple_dec_get_info(track->decoder, &track->info);
+        track->info_valid = true;
+    }
+
+    uint32_t frame_bytes = track->info.channel * (track->info.bits_per_sample / 8);
+    uint32_t frames = out_frame.decoded_size / frame_bytes;
+    uint32_t skip = track->skip_frames < frames ? (uint32_t)track->skip_frames : frames;
+    uint32_t count = frames - skip;
+    if (count > track->remain_frames)
+    {
+        count = (uint32_t)track->remain_frames;
+    }
+    track->skip_frames -= skip;
+    track->remain_frames -= count;
+    track->out_frames += count;
+    if (skip > 0 && count > 0)
+    {
+        memmove(out, out + skip * frame_bytes, count * frame_bytes);
+    }
+    *len = count * frame_bytes;
+    return TRACK_DECODE_OK;
+}
+
+// 解码并施加响度归一化增益
+static track_decode_ret_t track_decode(player_track_t *track, uint8_t *out, uint32_t size, uint32_t *len)
+{
+    track_decode_ret_t ret = track_decode_raw(track, out, size, len);
+    if (ret == TRACK_DECODE_OK && *len > 0)
+    {
+        uint32_t frame_bytes = track->info.channel * (track->info.bits_per_sample / 8);
+        audio_gain_process(&track->norm, out, *len / frame_bytes, track->info.channel, track->info.bits_per_sample,
+                           track->info.sample_rate);
+    }
+    return ret;
+}
+
+// 跳转到曲目的 ms 处：WAV 直接按帧计算位置，MP3/ADTS 经 TOC 或帧索引定位到目标之前的帧，
+// 解码后按采样裁剪到目标位置
+static esp_err_t track_seek_ms(player_track_t *track, uint32_t ms)
+{
+    // 需要知道解码输出的采样率
+    if (!track->info_valid)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    uint64_t target = (uint64_t)ms * track->info.sample_rate / 1000;
+    track->prime_len = 0;
+    track->prime_pos = 0;
+    if (track->passthrough)
+    {
+        uint32_t frame_bytes = track->info.channel * (track->info.bits_per_sample / 8);
+        uint64_t pos = target * frame_bytes;
+        if (pos > track->pcm_size)
+        {
+            pos = track->pcm_size - track->pcm_size % frame_bytes;
+        }
+        if (track->pcm_offset + pos > track->tag.audio_end || !track_seek(track, track->pcm_offset + (uint32_t)pos))
+        {
+            return ESP_FAIL;
+        }
+        track->pcm_remain = track->pcm_size - pos;
+        track->out_frames = pos / frame_bytes;
+        return ESP_OK;
+    }
+
+    // 解码输出比曲目位置多出编码器延迟
+    const audio_seek_file_t file = {
+        .path = track->file_path,
+        .type = track->type,
+        .audio_start = track->tag.audio_start,
+        .audio_end = track->tag.audio_end,
+    };
+    uint64_t stream_target = target + track->gapless.delay;
+    audio_seek_point_t point;
+    esp_err_t err = audio_seek_lookup(&file, stream_target, track->info.sample_rate, &point);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+    // 解码器没有复位接口，重新打开以丢弃内部缓存的数据和比特储备
+    esp_audio_simple_dec_close(track->decoder);
+    if (!track_open_decoder(track) || !track_seek(track, point.offset))
+    {
+        return ESP_FAIL;
+    }
+    track->skip_frames = stream_target > point.sample ? stream_target - point.sample : 0;
+    if (track->gapless.total_frames)
+    {
+        track->remain_frames = track->gapless.total_frames > target ? track->gapless.total_frames - target : 0;
+    }
+    track->out_frames = target;
+    ESP_LOGI(TAG, "Seek to %" PRIu32 " ms: offset %" PRIu32 ", decode and drop %llu frames%s", ms, point.offset,
+             track->skip_frames, point.exact ? "" : " (estimated)");
+    return ESP_OK;
+}
+
+// 预解码第一帧有效 PCM，下一首开始时直接提交，不再等待文件读取和解码器启动
+static bool track_prime(player_track_t *track)
+{
+    // 交叉淡入时这里还要缓存一帧解码输出和一个槽的待混音数据
+    track->prime = audio_arena_alloc(track->slot->mem, player_prime_size, 0);
+    if (track->prime == NULL)
+    {
+        return false;
+    }
+    while (track->prime_len == 0)
+    {
+        if (track_decode(track, track->prime, pcm_ring_slot_size, &track->prime_len) != TRACK_DECODE_OK)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 预解码缓存中至少有 bytes 字节，返回是否已解码到曲目末尾（此时可能不足）
+static track_decode_ret_t track_fill_prime(player_track_t *track, uint32_t bytes)
+{
+    while (track->prime_len < bytes)
+    {
+        // 前移剩余数据，后面留出一个槽的空间给解码器
+        memmove(track->prime, track->prime + track->prime_pos, track->prime_len);
+        track->prime_pos = 0;
+        uint32_t len = 0;
+        track_decode_ret_t ret = track_decode(track, track->prime + track->prime_len, pcm_ring_slot_size, &len);
+        if (ret != TRACK_DECODE_OK)
+        {
+            return ret;
+        }
+        track->prime_len += len;
+    }
+    return TRACK_DECODE_OK;
+}
+
+// 从预解码缓存取出最多 size 字节（整帧）
+static uint32_t track_take_prime(player_track_t *track, uint8_t *out, uint32_t size)
+{
+    uint32_t frame_bytes = track->info.channel * (track->info.bits_per_sample / 8);
+    uint32_t len = track->prime_len < size ? track->prime_len : size - size % frame_bytes;
+    memcpy(out, track->prime + track->prime_pos, len);
+    track->prime_pos += len;
+    track->prime_len -= len;
+    if (track->prime_len == 0)
+    {
+        track->prime_pos = 0;
+    }
+    return len;
+}
+
+// 估计曲目剩余的帧数：有效帧数已知时直接使用，否则按已解码部分的平均码率估计
+static uint64_t track_remaining_frames(const player_track_t *track)
+{
+    uint32_t frame_bytes = track->info.channel * (track->info.bits_per_sample / 8);
+    if (!track->info_valid || frame_bytes == 0)
+    {
+        return UINT64_MAX;
+    }
+    if (track->passthrough)
+    {
+        return track->pcm_remain / frame_bytes;
+    }
+    if (track->remain_frames != UINT64_MAX)
+    {
+        return track->remain_frames;
+    }
+    uint32_t decoded_pos = track->stream_pos - track->raw.len;
+    uint32_t consumed = decoded_pos - track->tag.audio_start;
+    if (consumed == 0 || track->out_frames == 0 || decoded_pos >= track->tag.audio_end)
+    {
+        return decoded_pos >= track->tag.audio_end ? 0 : UINT64_MAX;
+    }
+    return (uint64_t)(track->tag.audio_end - decoded_pos) * track->out_frames / consumed;
+}
+
+// 解码占用单核的百分比（解码耗时 / 输出时长）
+static uint32_t track_cpu_percent(const player_track_t *track)
+{
+    if (!track->info_valid || track->out_frames == 0)
+    {
+        return 0;
+    }
+    uint64_t audio_us = track->out_frames * 1000000 / track->info.sample_rate;
+    return audio_us ? (uint32_t)(track->decode_us * 100 / audio_us) : 0;
+}
+
+// 通过回调取得 track 的下一首，打开并预解码
+static player_track_t *track_prepare_next(const player_track_t *track)
+{
+    char next_file_path[256];
+    uac_player_next_track_cb_t cb = next_track_cb;
+    if (cb == NULL || !cb(track->file_path, next_file_path, next_track_ctx))
+    {
+        return NULL;
+    }
+    player_track_t *next = track_open(next_file_path, player_slot_take());
+    if (next != NULL && !track_prime(next))
+    {
+        ESP_LOGE(TAG, "Failed to prime next track: %s", next_file_path);
+        track_close(next);
+        return NULL;
+    }
+    return next;
+}
+
+// 第二个解码器能否放进剩余内存（预读块和预解码缓存在曲目槽中）
+static bool player_xfade_mem_ok(void)
+{
+    size_t block = heap_caps_get_largest_free_block(audio_mem_caps(AUDIO_MEM_DECODER));
+    size_t fallback = heap_caps_get_largest_free_block(audio_mem_fallback_caps(AUDIO_MEM_DECODER));
+    if (block < player_xfade_dec_mem_need && fallback < player_xfade_dec_mem_need)
+    {
+        ESP_LOGW(TAG, "Crossfade skipped: decoder memory block %u/%u", block > fallback ? block : fallback,
+                 player_xfade_dec_mem_need);
+        return false;
+    }
+    return true;
+}
+
+// 开始交叉淡化：格式一致（目前只混 16 位）且两个解码器的 CPU 占用在预算内时返回淡化帧数，否则返回 0（无缝衔接）
+static uint32_t player_xfade_begin(player_track_t *track, player_track_t *next, uint32_t xfade_frames)
+{
+    if (next->info.sample_rate != track->info.sample_rate || next->info.channel != track->info.channel ||
+        next->info.bits_per_sample != 16 || track->info.bits_per_sample != 16)
+    {
+        ESP_LOGW(TAG, "Crossfade skipped: format %" PRIu32 "/%u/%u -> %" PRIu32 "/%u/%u", track->info.sample_rate,
+                 track->info.channel, track->info.bits_per_sample, next->info.sample_rate, next->info.channel,
+                 next->info.bits_per_sample);
+        return 0;
+    }
+    uint32_t cpu = track_cpu_percent(track) + track_cpu_percent(next);
+    if (cpu > player_xfade_cpu_percent)
+    {
+        ESP_LOGW(TAG, "Crossfade skipped: two decoders need %" PRIu32 "%% CPU", cpu);
+        return 0;
+    }
+    // 不超过本曲目剩余时长，也不超过下一首估计时长的一半
+    uint64_t remain = track_remaining_frames(track);
+    uint64_t next_remain = track_remaining_frames(next);
+    uint64_t len = xfade_frames;
+    if (remain < len)
+    {
+        len = remain;
+    }
+    if (next_remain != UINT64_MAX && next_remain / 2 < len)
+    {
+        len = next_remain / 2;
+    }
+    ESP_LOGI(TAG, "Crossfade %llu frames to: %s (decoders %" PRIu32 "%% CPU)", len, next->file_path, cpu);
+    return (uint32_t)len;
+}
+
+// 一次播放过程中的停止/切歌请求
+typedef struct
+{
+    bool stopping;       // 正在淡出，结束后停止或切歌
+    bool switch_track;   // 淡出后播放新路径
+    int64_t deadline_us; // 淡出最长等待到的时间
+} player_session_t;
+
+// 事件放入队列，队列满时丢弃（订阅者处理太慢）
+static void player_post_event(uac_player_event_type_t type, const char *file_path, bool completed)
+{
+    uac_player_event_t event = {
+        .type = type,
+        .state = atomic_load(&player_state),
+        .completed = completed,
+    };
+    if (file_path)
+    {
+        strncpy(event.file_path, file_path, sizeof(event.file_path) - 1);
+    }
+    if (xQueueSend(player_event_queue, &event, 0) != pdTRUE)
+    {
+        ESP_LOGW(TAG, "Event queue full, event %d dropped", type);
+    }
+}
+
+static void player_set_state(uac_player_state_t state)
+{
+    if (atomic_exchange(&player_state, state) != (int)state)
+    {
+        player_post_event(UAC_PLAYER_EVENT_STATE, NULL, false);
+    }
+}
+
+// 把播放/上一首/下一首命令解析为文件路径，返回是否有可播放的曲目
+// 上一首/下一首以 current 为参照，它可以就是 file_path（连续切歌时以待切换的曲目为参照）
+static bool player_resolve(player_cmd_t *cmd, const char *current, char *file_path)
+{
+    bool ok = false;
+    char path[256];
+    if (cmd->type == PLAYER_CMD_PLAY && cmd->path != NULL)
+    {
+        strncpy(path, cmd->path, 255);
+        path[255] = '\0';
+        ok = true;
+    }
+    else if (cmd->type == PLAYER_CMD_NEXT && next_track_cb != NULL)
+    {
+        ok = next_track_cb(current, path, next_track_ctx);
+    }
+    else if (cmd->type == PLAYER_CMD_PREV && prev_track_cb != NULL)
+    {
+        ok = prev_track_cb(current, path, prev_track_ctx);
+    }
+    if (ok)
+    {
+        strcpy(file_path, path);
+    }
+    free(cmd->path);
+    cmd->path = NULL;
+    if (!ok && cmd->type != PLAYER_CMD_PLAY)
+    {
+        ESP_LOGW(TAG, "No %s track", cmd->type == PLAYER_CMD_NEXT ? "next" : "previous");
+    }
+    return ok;
+}
+
+// 暂停、停止和空闲时只记录音量，开始播放或恢复时再淡入到该音量
+static void player_apply_volume(uint32_t volume)
+{
+    player_volume = volume > 100 ? 100 : volume;
+    if (!player_muted && atomic_load(&player_state) == UAC_PLAYER_STATE_PLAYING)
+    {
+        audio_gain_set(&player_gain, audio_gain_from_percent(player_volume), player_gain_ramp_ms);
+    }
+}
+
+// 切歌或停止：在 PCM 上淡出，淡出完成（或超时）后解码循环退出
+static void player_begin_stop(player_session_t *session)
+{
+    if (session->stopping)
+    {
+        return;
+    }
+    session->stopping = true;
+    session->deadline_us = esp_timer_get_time() + player_fade_out_ms * 2 * 1000;
+    // 暂停中增益已经是 0，不需要再淡出
+    if (!atomic_load(&player_hold))
+    {
+        audio_gain_set(&player_gain, 0, player_fade_out_ms);
+    }
+    atomic_store(&player_hold, false);
+    player_set_state(UAC_PLAYER_STATE_STOPPING);
+}
+
+// 暂停：淡出后播放任务停止取数据，解码任务阻塞在邮箱上，直到恢复、停止或切歌
+static void player_pause(player_session_t *session, char *file_path, uint32_t *seek_ms)
+{
+    audio_gain_set(&player_gain, 0, player_pause_fade_ms);
+    atomic_store(&player_hold, true);
+    player_set_state(UAC_PLAYER_STATE_PAUSED);
+    while (!session->stopping)
+    {
+        player_cmd_t cmd;
+        xQueueReceive(player_mailbox, &cmd, portMAX_DELAY);
+        switch (cmd.type)
+        {
+        case PLAYER_CMD_RESUME:
+            atomic_store(&player_hold, false);
+            audio_gain_set(&player_gain, player_muted ? 0 : audio_gain_from_percent(player_volume), player_pause_fade_ms);
+            player_set_state(UAC_PLAYER_STATE_PLAYING);
+            return;
+        case PLAYER_CMD_PLAY:
+        case PLAYER_CMD_NEXT:
+        case PLAYER_CMD_PREV:
+            if (player_resolve(&cmd, session->switch_track ? file_path : player_current_path, file_path))
+            {
+                session->switch_track = true;
+                player_begin_stop(session);
+            }
+            break;
+        case PLAYER_CMD_STOP:
+            session->switch_track = false;
+            player_begin_stop(session);
+            break;
+        case PLAYER_CMD_SEEK:
+            // 恢复后执行
+            *seek_ms = cmd.arg;
+            break;
+        case PLAYER_CMD_VOLUME:
+            player_apply_volume(cmd.arg);
+            break;
+        default:
+            free(cmd.path);
+            break;
+        }
+    }
+}
+
+// 处理播放过程中收到的命令，返回是否继续解码
+static bool player_poll(player_session_t *session, char *file_path, uint32_t *seek_ms)
+{
+    player_cmd_t cmd;
+    while (xQueueReceive(player_mailbox, &cmd, 0) == pdTRUE)
+    {
+        switch (cmd.type)
+        {
+        case PLAYER_CMD_PLAY:
+        case PLAYER_CMD_NEXT:
+        case PLAYER_CMD_PREV:
+            if (player_resolve(&cmd, session->switch_track ? file_path : player_current_path, file_path))
+            {
+                session->switch_track = true;
+                player_begin_stop(session);
+            }
+            break;
+        case PLAYER_CMD_STOP:
+            session->switch_track = false;
+            player_begin_stop(session);
+            break;
+        case PLAYER_CMD_PAUSE:
+            if (!session->stopping)
+            {
+                player_pause(session, file_path, seek_ms);
+            }
+            break;
+        case PLAYER_CMD_SEEK:
+            if (!session->stopping)
+            {
+                *seek_ms = cmd.arg;
+            }
+            break;
+        case PLAYER_CMD_VOLUME:
+            player_apply_volume(cmd.arg);
+            break;
+        default:
+            free(cmd.path);
+            break;
+        }
+    }
+    if (session->stopping)
+    {
+        // 淡出期间继续解码，让播放任务有数据可以淡出；没有数据输出时按超时结束
+        return !audio_gain_is_settled(&player_gain) && esp_timer_get_time() < session->deadline_us;
+    }
+    return true;
+}
+
+// 播放 file_path 和之后无缝衔接的曲目，直到播完、停止或切歌；切歌时新路径写入 file_path 并返回 true
+static bool player_play(char *file_path)
+{
+    player_session_t session = {0};
+    ESP_LOGI(TAG, "Play: %s", file_path);
+    player_set_state(UAC_PLAYER_STATE_PLAYING);
+    // 环中残留的上一首数据丢弃，从静音淡入
+    atomic_fetch_add(&player_epoch, 1);
+    audio_gain_fade_in(&player_gain, player_muted ? 0 : audio_gain_from_percent(player_volume), player_gain_ramp_ms);
+
+    player_track_t *track = track_open(file_path, player_slot_take());
+    // 当前曲目是否与上一首无缝衔接
+    bool splice = false;
+    while (track != NULL)
+    {
+        player_track_t *next = NULL;
+        bool first_frame = true;
+        bool completed = false;
+        // 交叉淡化的进度：本曲目是否已检查过，淡化总帧数（0 为不淡化）和已混音的帧数
+        bool xfade_checked = false;
+        bool track_done = false;
+        uint32_t xfade_len = 0;
+        uint32_t xfade_pos = 0;
+        // 曲目开始解码时才成为当前曲目，预先打开后被丢弃的下一首不影响切歌的参照
+        strcpy(player_current_path, track->file_path);
+        player_post_event(UAC_PLAYER_EVENT_TRACK_START, track->file_path, false);
+        //  解码数据，直接写入 PCM 环形缓冲区的槽
+        while (1)
+        {
+            uint32_t seek_ms = PLAYER_SEEK_NONE;
+            if (!player_poll(&session, file_path, &seek_ms))
+            {
+                break;
+            }
+            if (seek_ms != PLAYER_SEEK_NONE)
+            {
+                esp_err_t seek_ret = track_seek_ms(track, seek_ms);
+                if (seek_ret == ESP_FAIL)
+                {
+                    ESP_LOGE(TAG, "Seek to %" PRIu32 " ms failed", seek_ms);
+                    break;
+                }
+                if (seek_ret != ESP_OK)
+                {
+                    ESP_LOGW(TAG, "Seek to %" PRIu32 " ms ignored: %s", seek_ms, esp_err_to_name(seek_ret));
+                }
+                else
+                {
+                    // 已提交的槽全部作废，跳转后的第一个槽按新曲目开始处理（重置采样率转换器）
+                    pcm_ring_flush(pcm_ring);
+                    atomic_fetch_add(&player_epoch, 1);
+                    first_frame = true;
+                    splice = false;
+                    // 跳转取消正在进行的交叉淡化，之后按新位置重新判断
+                    if (xfade_len > 0)
+                    {
+                        track_close(next);
+                        next = NULL;
+                        xfade_len = 0;
+                        xfade_pos = 0;
+                    }
+                    xfade_checked = false;
+                }
+            }
+            pcm_slot_t *slot = pcm_ring_acquire(pcm_ring, pdMS_TO_TICKS(1000));
+            if (slot == NULL)
+            {
+                ESP_LOGE(TAG, "Failed to acquire pcm slot");
+                break;
+            }
+            uint32_t len = 0;
+            track_decode_ret_t ret = TRACK_DECODE_OK;
+            if (track_done && xfade_len == 0)
+            {
+                // 淡化中途放弃了下一首
+                ret = TRACK_DECODE_END;
+            }
+            else if (track_done)
+            {
+                // 本曲目比估计的先结束，淡化剩余部分只有下一首
+                uint32_t frame_bytes = track->info.channel * sizeof(int16_t);
+                uint32_t max_len = slot->size - slot->size % frame_bytes;
+                len = (xfade_len - xfade_pos) * frame_bytes;
+                len = len < max_len ? len : max_len;
+                memset(slot->data, 0, len);
+            }
+            else if (track->prime_len > 0)
+            {
+                len = track_take_prime(track, slot->data, slot->size);
+            }
+            else
+            {
+                ret = track_decode(track, slot->data, slot->size, &len);
+            }
+            if (ret == TRACK_DECODE_FAIL)
+            {
+                break;
+            }
+            if (ret == TRACK_DECODE_END && xfade_len > 0)
+            {
+                track_done = true;
+                continue;
+            }
+            slot->sample_rate = track->info.sample_rate;
+            slot->channels = track->info.channel;
+            slot->bits = track->info.bits_per_sample;
+            slot->epoch = atomic_load(&player_epoch);
+            if (ret == TRACK_DECODE_END)
+            {
+                // 用一个空槽标记曲目结束，立即发布
+                slot->len = 0;
+                slot->flags = PCM_SLOT_FLAG_TRACK_END;
+                slot->origin_us = 0;
+                pcm_ring_commit(pcm_ring, slot);
+                ESP_LOGI(TAG, "Finished process, %llu frames", track->out_frames);
+                completed = true;
+                break;
+            }
+            // 剩余时长进入淡化窗口时打开下一首，两个解码器同时运行
+            uint32_t xfade_ms = atomic_load(&player_xfade_ms);
+            uint32_t xfade_frames = (uint32_t)((uint64_t)xfade_ms * track->info.sample_rate / 1000);
+            if (!xfade_checked && xfade_ms > 0 && next_track_cb != NULL && track->info_valid &&
+                track_remaining_frames(track) <= xfade_frames)
+            {
+                xfade_checked = true;
+                if (next == NULL && player_xfade_mem_ok())
+                {
+                    next = track_prepare_next(track);
+                }
+                xfade_len = next != NULL ? player_xfade_begin(track, next, xfade_frames) : 0;
+                xfade_pos = 0;
+            }
+            // 文件全部预读完后，在本曲目剩余数据解码期间提前打开并预解码下一首
+            if (next == NULL && next_track_cb != NULL && audio_reader_all_read(track->reader))
+            {
+                next = track_prepare_next(track);
+            }
+            // 淡化期间下一首解码同样多的帧，按等功率曲线混进槽里
+            if (xfade_len > 0 && len > 0)
+            {
+                track_decode_ret_t next_ret = track_fill_prime(next, len);
+                if (next_ret == TRACK_DECODE_FAIL)
+                {
+                    ESP_LOGE(TAG, "Crossfade aborted: next track failed");
+                    track_close(next);
+                    next = NULL;
+                    xfade_len = 0;
+                }
+                else
+                {
+                    if (next->prime_len < len)
+                    {
+                        // 下一首已解码完（比淡化还短），不足的部分补静音
+                        memset(next->prime + next->prime_pos + next->prime_len, 0, len - next->prime_len);
+                        next->prime_len = len;
+                    }
+                    uint32_t frames = len / (track->info.channel * sizeof(int16_t));
+                    audio_gain_crossfade_s16((int16_t *)slot->data, (const int16_t *)(next->prime + next->prime_pos),
+                                             frames, track->info.channel, xfade_pos, xfade_len);
+                    next->prime_pos += len;
+                    next->prime_len -= len;
+                    xfade_pos += frames;
+                }
+            }
+            // 没有输出时槽不提交，下次 acquire 会拿到同一个槽
+            if (len > 0)
+            {
+                slot->len = len;
+                slot->flags = first_frame ? (PCM_SLOT_FLAG_TRACK_START | (splice ? PCM_SLOT_FLAG_SPLICE : 0)) : 0;
+                slot->origin_us = track->origin_us;
+                AUDIO_TRACE_SPAN(AUDIO_TRACE_DECODE_TO_RING, track->decode_end_us);
+                pcm_ring_commit(pcm_ring, slot);
+                first_frame = false;
+            }
+            if (xfade_len > 0)
+            {
+                // 淡化结束；或者两个解码器跟不上实时（环中已没有待播放的数据），直接切到下一首
+                bool starved = xfade_pos > xfade_frames / 4 && pcm_ring_filled(pcm_ring) == 0;
+                if (starved)
+                {
+                    ESP_LOGW(TAG, "Crossfade falls back to hard cut: decoders can't keep up");
+                }
+                if (xfade_pos >= xfade_len || starved)
+                {
+                    completed = true;
+                    break;
+                }
+            }
+        }
+        if (session.stopping)
+        {
+            ESP_LOGI(TAG, "Player STOP play");
+        }
+        player_post_event(UAC_PLAYER_EVENT_TRACK_END, track->file_path, completed);
+        if (track->info_valid)
+        {
+            ESP_LOGI(TAG, "Sample rate: %" PRIu32 ", Channels: %u, Bits per sample: %u",
+                     track->info.sample_rate, track->info.channel, track->info.bits_per_sample);
+        }
+        // 曲目很短时文件读完前可能还没准备好下一首
+        if (completed && next == NULL && next_track_cb != NULL)
+        {
+            next = track_prepare_next(track);
+        }
+        track_close(track);
+        track = NULL;
+        if (completed && next != NULL && !session.stopping)
+        {
+            ESP_LOGI(TAG, "%s to: %s", xfade_len > 0 ? "Crossfaded" : "Gapless splice", next->file_path);
+            track = next;
+            splice = true;
+        }
+        else
+        {
+            track_close(next);
+        }
+    }
+    if (session.stopping)
+    {
+        // 淡出后环中剩下的数据都是静音，直接作废
+        pcm_ring_flush(pcm_ring);
+        atomic_fetch_add(&player_epoch, 1);
+    }
+    else
+    {
+        // 发布剩余的槽，等播放任务把最后的数据写完（最多 1 秒）
+        pcm_ring_flush(pcm_ring);
+        for (int i = 0; i < 100 && pcm_ring_filled(pcm_ring) > 0; i++)
+        {
+            vTaskDelay(pdMS_TO_TICKS(10));
+        }
+    }
+    atomic_store(&player_hold, false);
+    if (session.switch_track)
+    {
+        return true;
+    }
+    player_set_state(UAC_PLAYER_STATE_IDLE);
+    return false;
+}
+
+static void player_get_mem_stats(uac_player_mem_stats_t *stats)
+{
+    memset(stats, 0, sizeof(uac_player_mem_stats_t));
+    stats->psram_free = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+    stats->psram_largest = heap_caps_get_largest_free_block(MALLOC_CAP_SPIRAM);
+    stats->internal_free = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    stats->internal_largest = heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL);
+    for (int i = 0; i < player_slot_num; i++)
+    {
+        player_slot_t *slot = &player_slots[i];
+        if (slot->mem == NULL)
+        {
+            continue;
+        }
+        audio_arena_stats_t mem, reader;
+        audio_arena_get_stats(slot->mem, &mem);
+        audio_arena_get_stats(slot->reader, &reader);
+        stats->arena_size += mem.size + reader.size;
+        stats->arena_peak += mem.peak + reader.peak;
+        stats->arena_fail_count += mem.fail_count + reader.fail_count;
+        stats->dec_open_count += slot->dec_open_count;
+    }
+}
+
+static void player_log_mem_stats(const char *when, const uac_player_mem_stats_t *stats)
+{
+    ESP_LOGI(TAG, "Memory %s: PSRAM free %" PRIu32 " largest %" PRIu32 ", internal free %" PRIu32 " largest %" PRIu32, when,
+             stats->psram_free, stats->psram_largest, stats->internal_free, stats->internal_largest);
+    ESP_LOGI(TAG, "  Track slots %" PRIu32 "/%" PRIu32 " bytes peak, %" PRIu32 " failed, decoder opened %" PRIu32,
+             stats->arena_peak, stats->arena_size, stats->arena_fail_count, stats->dec_open_count);
+}
+
+// 模拟切歌：按打开曲目的顺序从槽中分配曲目状态、拼接缓存、预读块和预解码缓存，打开解码器后关闭。
+// 不读文件；MP3 和 AAC 交替出现，两种解码器的工作内存交替分配释放。空闲时由解码任务执行
+static void player_mem_test(uint32_t track_changes)
+{
+    uac_player_mem_stats_t before, after;
+    player_get_mem_stats(&before);
+    player_log_mem_stats("before", &before);
+    audio_reader_config_t reader_config;
+    track_reader_config(&reader_config, audio_mem_caps(AUDIO_MEM_READ_AHEAD));
+    uint32_t reader_size = audio_reader_mem_size(&reader_config);
+    uint32_t failed = 0;
+    for (uint32_t i = 0; i < track_changes; i++)
+    {
+        player_slot_t *slot = player_slot_take();
+        player_track_t *track = slot ? audio_arena_calloc(slot->mem, sizeof(player_track_t)) : NULL;
+        if (track == NULL)
+        {
+            failed++;
+            continue;
+        }
+        slot->busy = true;
+        track->slot = slot;
+        track->type = (i % 4 == 3) ? ESP_AUDIO_SIMPLE_DEC_TYPE_AAC : ESP_AUDIO_SIMPLE_DEC_TYPE_MP3;
+        track->carry = audio_arena_alloc(slot->mem, reader_headroom, 0);
+        track->prime = audio_arena_alloc(slot->mem, player_prime_size, 0);
+        uint8_t *blocks = audio_arena_alloc(slot->reader, reader_size, AUDIO_READER_ALIGN);
+        if (track->carry == NULL || track->prime == NULL || blocks == NULL || !track_open_decoder(track))
+        {
+            failed++;
+        }
+        track_close(track);
+    }
+    player_get_mem_stats(&after);
+    ESP_LOGI(TAG, "Simulated %" PRIu32 " track changes, %" PRIu32 " failed", track_changes, failed);
+    player_log_mem_stats("after", &after);
+}
+
+// 放置策略基准：每种放置下解码曲目开头的 player_bench_seconds 秒，比较解码实时率（解码耗时 / 音频时长）
+static void player_mem_bench(const char *file_path)
+{
+    static const struct
+    {
+        const char *name;
+        audio_mem_place_t place[AUDIO_MEM_CLASS_NUM]; // PCM、解码器、预读、其他
+    } configs[] = {
+        {"all PSRAM", {AUDIO_MEM_PSRAM, AUDIO_MEM_PSRAM, AUDIO_MEM_PSRAM, AUDIO_MEM_PSRAM}},
+        {"PCM internal", {AUDIO_MEM_INTERNAL, AUDIO_MEM_PSRAM, AUDIO_MEM_PSRAM, AUDIO_MEM_PSRAM}},
+        {"decoder internal", {AUDIO_MEM_PSRAM, AUDIO_MEM_INTERNAL, AUDIO_MEM_PSRAM, AUDIO_MEM_PSRAM}},
+        {"PCM + decoder internal", {AUDIO_MEM_INTERNAL, AUDIO_MEM_INTERNAL, AUDIO_MEM_PSRAM, AUDIO_MEM_PSRAM}},
+        {"all internal", {AUDIO_MEM_INTERNAL, AUDIO_MEM_INTERNAL, AUDIO_MEM_INTERNAL, AUDIO_MEM_INTERNAL}},
+    };
+    audio_mem_place_t saved[AUDIO_MEM_CLASS_NUM];
+    for (int c = 0; c < AUDIO_MEM_CLASS_NUM; c++)
+    {
+        saved[c] = audio_mem_get_place(c);
+    }
+    for (size_t i = 0; i < sizeof(configs) / sizeof(configs[0]); i++)
+    {
+        for (int c = 0; c < AUDIO_MEM_CLASS_NUM; c++)
+        {
+            audio_mem_set_place(c, configs[i].place[c]);
+        }
+        player_slot_t slot;
+        uint8_t *out = audio_mem_alloc(AUDIO_MEM_PCM, pcm_ring_slot_size);
+        player_track_t *track = NULL;
+        if (out != NULL && player_slot_init(&slot) == ESP_OK)
+        {
+            track = track_open(file_path, &slot);
+        }
+        track_decode_ret_t ret = track ? TRACK_DECODE_OK : TRACK_DECODE_FAIL;
+        while (ret == TRACK_DECODE_OK &&
+               (!track->info_valid || track->out_frames < (uint64_t)track->info.sample_rate * player_bench_seconds))
+        {
+            uint32_t len;
+            ret = track_decode_raw(track, out, pcm_ring_slot_size, &len);
+        }
+        if (ret != TRACK_DECODE_FAIL && track->info_valid && track->out_frames > 0)
+        {
+            float audio_us = (float)track->out_frames * 1000000 / track->info.sample_rate;
+            ESP_LOGI(TAG, "Placement %-22s: RTF %.4f (%.1f s decoded)", configs[i].name, track->decode_us / audio_us,
+                     audio_us / 1000000);
+        }
+        else
+        {
+            ESP_LOGW(TAG, "Placement %-22s: decode failed", configs[i].name);
+        }
+        track_close(track);
+        if (out != NULL)
+        {
+            player_slot_deinit(&slot);
+        }
+        heap_caps_free(out);
+    }
+    for (int c = 0; c < AUDIO_MEM_CLASS_NUM; c++)
+    {
+        audio_mem_set_place(c, saved[c]);
+    }
+}
+
+void audio_decoder_task(void *pvParameters)
+{
+    // 注册解码器
+    esp_audio_dec_register_default();
+    esp_audio_simple_dec_register_default();
+    char file_path[256];
+    bool have_track = false;
+    while (1)
+    {
+        if (have_track)
+        {
+            have_track = player_play(file_path);
+            continue;
+        }
+        // 空闲：只响应开始播放和音量
+        player_cmd_t cmd;
+        xQueueReceive(player_mailbox, &cmd, portMAX_DELAY);
+        if (cmd.type == PLAYER_CMD_PLAY || cmd.type == PLAYER_CMD_NEXT || cmd.type == PLAYER_CMD_PREV)
+        {
+            have_track = player_resolve(&cmd, player_current_path, file_path);
+        }
+        else if (cmd.type == PLAYER_CMD_VOLUME)
+        {
+            player_apply_volume(cmd.arg);
+        }
+        else if (cmd.type == PLAYER_CMD_MEM_TEST)
+        {
+            player_mem_test(cmd.arg);
+        }
+        else if (cmd.type == PLAYER_CMD_MEM_BENCH)
+        {
+            player_mem_bench(cmd.path);
+            free(cmd.path);
+        }
+    }
+}
+// 播放路径上的采样率转换器，解码输出与扬声器采样率不一致时使用
+static audio_src_handle_t player_src = NULL;
+static uint32_t player_src_in_rate = 0;
+static uint32_t player_src_out_rate = 0;
+static uint8_t player_src_channels = 0;
+static int16_t *player_src_buffer = NULL;
+
+// 按需（重新）创建采样率转换器，返回是否可用
+static bool player_src_prepare(const pcm_slot_t *slot, uint32_t out_rate)
+{
+    if (player_src && player_src_in_rate == slot->sample_rate && player_src_out_rate == out_rate &&
+        player_src_channels == slot->channels)
+    {
+        // 无缝衔接时保留历史样本，避免在拼接点引入不连续
+        if ((slot->flags & PCM_SLOT_FLAG_TRACK_START) && !(slot->flags & PCM_SLOT_FLAG_SPLICE))
+        {
+            ESP_LOGI(TAG, "SRC %s: %" PRIu32 " cycles/frame", audio_src_quality_name(audio_src_get_quality(player_src)),
+                     audio_src_get_cycles_per_frame(player_src));
+            audio_src_reset(player_src);
+        }
+        return true;
+    }
+    audio_src_delete(player_src);
+    heap_caps_free(player_src_buffer);
+    player_src = NULL;
+    player_src_buffer = NULL;
+
+    const audio_src_config_t src_config = {
+        .in_rate = slot->sample_rate,
+        .out_rate = out_rate,
+        .channels = slot->channels,
+        .quality = player_src_quality,
+        .cpu_budget_percent = player_src_cpu_budget,
+    };
+    if (audio_src_create(&src_config, &player_src) != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to create SRC %" PRIu32 " -> %" PRIu32, slot->sample_rate, out_rate);
+        return false;
+    }
+    uint32_t max_frames = audio_src_max_output_frames(player_src, slot->size / (slot->channels * sizeof(int16_t)));
+    player_src_buffer = audio_mem_alloc(AUDIO_MEM_PCM, max_frames * slot->channels * sizeof(int16_t));
+    if (player_src_buffer == NULL)
+    {
+        ESP_LOGE(TAG, "Failed to allocate SRC output buffer");
+        audio_src_delete(player_src);
+        player_src = NULL;
+        return false;
+    }
+    player_src_in_rate = slot->sample_rate;
+    player_src_out_rate = out_rate;
+    player_src_channels = slot->channels;
+    return true;
+}
+
+// 上一次协商时的解码输出格式和设备
+static uac_format_t player_src_format = {0};
+// 协商得到的扬声器流格式，位深或通道数与解码输出不同时在写入前转换
+static uac_format_t player_out_format = {0};
+static audio_dither_t player_dither;
+static uac_host_device_handle_t player_dev_handle = NULL;
+// 上一首最后一次写入完成的时间，用于测量无缝衔接处的间隙
+static int64_t player_track_end_us = 0;
+
+// 统计无缝衔接处的间隙：上一首写完后驱动缓冲区基本是满的，
+// 等待时间超过缓冲区时长的部分就是输出中断的采样数
+static void player_report_splice_gap(uint32_t out_rate)
+{
+    if (player_track_end_us == 0)
+    {
+        return;
+    }
+    int64_t wait_us = esp_timer_get_time() - player_track_end_us;
+    int64_t wait_frames = wait_us * out_rate / 1000000;
+    int64_t gap_frames = wait_frames - usb_uac_get_buffer_frames();
+    ESP_LOGI(TAG, "Splice gap: %lld samples (waited %lld us)", gap_frames > 0 ? gap_frames : 0, wait_us);
+    player_track_end_us = 0;
+}
+
+// 把 len 字节的 PCM 写入驱动缓冲区：借用驱动缓冲区中的连续区域，直接复制进去，
+// 需要转换为扬声器流的位深和通道数时转换结果直接写在其中（不支持的组合原样写入）
+static esp_err_t player_write(const pcm_slot_t *slot, const uint8_t *data, uint32_t len, uint32_t *written)
+{
+    const uac_format_t *out = &player_out_format;
+    uint32_t in_frame = slot->channels * (slot->bits / 8);
+    bool convert = out->bits != 0 && (out->bits != slot->bits || out->channels != slot->channels);
+    uint32_t out_frame = convert ? out->channels * (out->bits / 8) : in_frame;
+    // 转换时先减少通道的中间结果是输入位深，区域要按较大的位深计算
+    uint32_t work_frame = convert ? out->channels * ((slot->bits > out->bits ? slot->bits : out->bits) / 8) : in_frame;
+    uint32_t frames = len / in_frame;
+    *written = 0;
+    while (frames > 0)
+    {
+        uint8_t *dst;
+        uint32_t size;
+        esp_err_t ret = uac_host_device_write_acquire(s_spk_dev_handle, &dst, &size, work_frame, portMAX_DELAY);
+        if (ret != ESP_OK)
+        {
+            return ret;
+        }
+        uint32_t n = size / work_frame < frames ? size / work_frame : frames;
+        if (!convert)
+        {
+            memcpy(dst, data, n * in_frame);
+        }
+        else if (audio_convert_pcm(data, slot->bits, slot->channels, dst, out->bits, out->channels, n, &player_dither) != ESP_OK)
+        {
+            convert = false;
+            out_frame = work_frame = in_frame;
+            uac_host_device_write_commit(s_spk_dev_handle, 0);
+            continue;
+        }
+        ret = uac_host_device_write_commit(s_spk_dev_handle, n * out_frame);
+        if (ret != ESP_OK)
+        {
+            return ret;
+        }
+        *written += n * out_frame;
+        data += n * in_frame;
+        frames -= n;
+    }
+    return ESP_OK;
+}
+
+// 输出格式或设备变化后更新混音器，新设备上注册混音回调
+// 驱动缓冲区取出数据、等时传输提交前调用（USB 主机任务中）：统计排队延迟，再混入输入流
+static void player_tx_process(uint8_t *data, size_t size, void *arg)
+{
+#if AUDIO_TRACE_ENABLE
+    // 驱动在 stream_tx_xfer_submit 中从缓冲区取出数据后，同一个任务里紧接着调用这里，此时记录的时间与在
+    // 取出处记录相同。取出的字节数用驱动的 popped_bytes 统计：欠载补静音、漂移补偿重采样时它与 size 不同
+    static uac_host_device_handle_t dev;
+    static uint32_t popped_total;
+    uac_host_stream_stats_t stats;
+    if (player_dev_handle != NULL && uac_host_device_get_stats(player_dev_handle, &stats) == ESP_OK)
+    {
+        if (dev != player_dev_handle)
+        {
+            // 新设备的统计从 0 开始
+            dev = player_dev_handle;
+            popped_total = 0;
+        }
+        AUDIO_TRACE_TX_POP(stats.popped_bytes - popped_total);
+        popped_total = stats.popped_bytes;
+    }
+#endif
+    audio_mixer_process(data, size, arg);
+}
+
+static void player_attach_mixer(const uac_format_t *out_format)
 {
-    const char *ext = strrchr(file_path, '.');
-    if (ext == NULL)
+    audio_mixer_set_format(player_mixer, out_format);
+    if (player_dev_handle != s_spk_dev_handle)
     {
-        return ESP_AUDIO_TYPE_UNSUPPORT;
+        uac_host_device_set_tx_process_cb(s_spk_dev_handle, player_tx_process, player_mixer);
     }
+}
 
-    if (strcmp(ext, ".aac") == 0)
+// 没有音乐时写入静音，让等时传输继续提交，输入流才能混入
+static void player_write_silence(void)
+{
+    if (s_spk_dev_handle == NULL)
     {
-        return ESP_AUDIO_TYPE_AAC;
+        return;
     }
-    else if (strcmp(ext, ".mp3") == 0)
+    uac_format_t format;
+    usb_uac_get_format(&format);
+    if (player_dev_handle != s_spk_dev_handle)
     {
-        return ESP_AUDIO_TYPE_MP3;
+        player_attach_mixer(&format);
+        player_dev_handle = s_spk_dev_handle;
+        // 新设备上播放音乐前重新协商格式
+        memset(&player_src_format, 0, sizeof(player_src_format));
     }
-    else
+    uint32_t frame_bytes = format.channels * (format.bits / 8);
+    uint32_t len = format.sample_rate * pcm_ring_period_ms / 1000 * frame_bytes;
+    while (len > 0)
+    {
+        uint8_t *dst;
+        uint32_t size;
+        if (uac_host_device_write_acquire(s_spk_dev_handle, &dst, &size, frame_bytes, portMAX_DELAY) != ESP_OK)
+        {
+            break;
+        }
+        uint32_t n = len < size ? len : size / frame_bytes * frame_bytes;
+        memset(dst, 0, n);
+        if (uac_host_device_write_commit(s_spk_dev_handle, n) != ESP_OK)
+        {
+            break;
+        }
+        AUDIO_TRACE_TX_WRITE(n, AUDIO_TRACE_NOW(), 0);
+        len -= n;
+    }
+}
+
+// 暂停后恢复被挂起的扬声器流
+static void player_resume_stream(void)
+{
+    if (!player_suspended)
+    {
+        return;
+    }
+    player_suspended = false;
+    esp_err_t err = usb_uac_resume();
+    if (err != ESP_OK)
     {
-        return ESP_AUDIO_TYPE_UNSUPPORT;
+        ESP_LOGW(TAG, "Failed to resume stream: %s", esp_err_to_name(err));
     }
 }
-void audio_decoder_task(void *pvParameters)
+
+// 暂停中的输出：挂起扬声器流；软暂停或有输入流在混音时持续写入静音，不切换 alt 设置
+static void player_hold_output(void)
 {
-    // 注册解码器
-    esp_audio_dec_register_default();
-    char file_path[256];
-    while (1)
+    if (atomic_load(&player_pause_mode) == UAC_PLAYER_PAUSE_SOFT || audio_mixer_is_active(player_mixer))
     {
-        if (xQueueReceive(audio_control_file_queue, &file_path, portMAX_DELAY) == pdTRUE)
+        player_resume_stream();
+        player_write_silence();
+        return;
+    }
+    if (!player_suspended && s_spk_dev_handle != NULL)
+    {
+        esp_err_t err = usb_uac_suspend();
+        if (err == ESP_OK)
+        {
+            player_suspended = true;
+        }
+        else
         {
-            uac_player_playing = true;
-            uac_decoder_closed = false;
-            uac_host_device_set_mute(s_spk_dev_handle, false);
-            uac_host_device_set_volume(s_spk_dev_handle, player_volume);
-            ESP_LOGI(TAG, "Received file path: %s", file_path);
+            ESP_LOGW(TAG, "Failed to suspend stream: %s", esp_err_to_name(err));
+        }
+    }
+    vTaskDelay(pdMS_TO_TICKS(pcm_ring_period_ms));
+}
 
-            // 根据文件扩展名选择解码器类型
-            esp_audio_type_t audio_type = get_audio_type_from_file(file_path);
-            if (audio_type == ESP_AUDIO_TYPE_UNSUPPORT)
+void audio_player_task(void *pvParameters)
+{
+    pcm_slot_t *slots[player_batch_num];
+    uint32_t out_rate = usb_uac_get_sample_freq();
+    while (1)
+    {
+        // 暂停时淡出完成后不再取数据，环形缓冲区中的数据留到恢复播放
+        if (atomic_load(&player_hold) && audio_gain_is_settled(&player_gain))
+        {
+            player_hold_output();
+            continue;
+        }
+        player_resume_stream();
+        uint32_t count = pcm_ring_receive(pcm_ring, slots, player_batch_num, pdMS_TO_TICKS(pcm_ring_period_ms));
+        if (count == 0)
+        {
+            if (audio_mixer_is_active(player_mixer))
             {
-                ESP_LOGE(TAG, "Unsupported audio format: %s", file_path);
-                uac_player_playing = false;
-                uac_decoder_closed = true;
-                uac_host_device_set_mute(s_spk_dev_handle, true);
-                continue;
+                player_write_silence();
             }
-
-            // 配置解码器
-            esp_audio_dec_cfg_t dec_cfg = {
-                .type = audio_type, // 根据文件扩展名设置解码器类型
-                .cfg = NULL,        // 如果没有特殊配置，设置为 NULL
-                .cfg_sz = 0         // 如果没有特殊配置，设置为 0
-            };
-
-            esp_audio_dec_handle_t decoder = NULL;
-            // 1. 打开解码器
-            esp_audio_err_t ret = esp_audio_dec_open(&dec_cfg, &decoder);
-            if (ret != ESP_AUDIO_ERR_OK)
+            continue;
+        }
+        for (uint32_t i = 0; i < count; i++)
+        {
+            uint8_t *data = slots[i]->data;
+            uint32_t len = slots[i]->len;
+            // 跳转前解码的数据直接丢弃
+            if (slots[i]->epoch != atomic_load(&player_epoch))
             {
-                ESP_LOGE(TAG, "Failed to open audio decoder, error: %d", ret);
-                uac_player_playing = false;
-                uac_decoder_closed = true;
-                uac_host_device_set_mute(s_spk_dev_handle, true);
                 continue;
             }
-            // 打开文件
-            FILE *file = fopen(file_path, "rb");
-            if (file == NULL)
+            // 曲目结束标记槽没有数据
+            if (slots[i]->flags & PCM_SLOT_FLAG_TRACK_END)
+            {
+                player_track_end_us = esp_timer_get_time();
+            }
+            if (len == 0)
             {
-                ESP_LOGE(TAG, "Failed to open file: %s", file_path);
-                uac_player_playing = false;
-                uac_decoder_closed = true;
-                uac_host_device_set_mute(s_spk_dev_handle, true);
                 continue;
             }
-            // 2. 准备输入数据和输出缓冲区
-            uint8_t *input_buffer = (uint8_t *)heap_caps_malloc(input_buffer_size, MALLOC_CAP_SPIRAM | MALLOC_CAP_DEFAULT);  // 输入缓冲区
-            uint8_t *frame_data = (uint8_t *)heap_caps_malloc(out_fram_buffer_size, MALLOC_CAP_SPIRAM | MALLOC_CAP_DEFAULT); // 初始输出缓冲区
-            uint8_t *temp_buffer = (uint8_t *)heap_caps_malloc(input_buffer_size * 2, MALLOC_CAP_SPIRAM | MALLOC_CAP_DEFAULT);
-            uint8_t *head_buffer = (uint8_t *)heap_caps_malloc(head_buffer_size, MALLOC_CAP_SPIRAM | MALLOC_CAP_DEFAULT);
-
-            uint32_t temp_buffer_len = 0;
-            size_t bytes_read = 0;
-            esp_audio_dec_in_raw_t raw;
-            while (1)
+            // 解码输出格式或设备变化时重新协商扬声器流格式
+            const uac_format_t src_format = {
+                .sample_rate = slots[i]->sample_rate,
+                .bits = slots[i]->bits,
+                .channels = slots[i]->channels,
+            };
+            if (!uac_format_equal(&src_format, &player_src_format) || player_dev_handle != s_spk_dev_handle)
             {
-                if (bytes_read == 0)
-                {
-                    bytes_read = fread(head_buffer, 1, head_buffer_size, file);
-                    if (ferror(file))
-                    {
-                        ESP_LOGE(TAG, "Error reading file: %s", file_path);
-                        break;
-                    }
-
-                    raw.buffer = head_buffer;
-                    raw.len = bytes_read;
-                }
-                else
-                {
-                    bytes_read = fread(input_buffer, 1, input_buffer_size, file);
-                    if (ferror(file))
-                    {
-                        ESP_LOGE(TAG, "Error reading file: %s", file_path);
-                        break;
-                    }
-                    memcpy(temp_buffer + temp_buffer_len, input_buffer, bytes_read);
-
-                    raw.buffer = temp_buffer;
-                    raw.len = temp_buffer_len + bytes_read;
-                }
-                esp_audio_dec_out_frame_t out_frame = {
-                    .buffer = frame_data,
-                    .len = out_fram_buffer_size,
-                };
-                // ESP_LOGI(TAG, "Read %zu, temp_buffer_len: %lu, raw.len: %lu", bytes_read, temp_buffer_len, raw.len);
-                //  解码数据并放入队列
-                while (raw.len > 1440)
-                {
-                    ret = esp_audio_dec_process(decoder, &raw, &out_frame);
-                    if (ret == ESP_AUDIO_ERR_BUFF_NOT_ENOUGH)
-                    {
-                        // 输出缓冲区不足，重新分配更大的缓冲区
-                        uint8_t *new_frame_data = (uint8_t *)heap_caps_realloc(frame_data, out_frame.needed_size, MALLOC_CAP_SPIRAM | MALLOC_CAP_DEFAULT);
-                        if (new_frame_data == NULL)
-                        {
-                            ESP_LOGE(TAG, "Failed to realloc output buffer");
-                            break;
-                        }
-                        frame_data = new_frame_data;
-                        out_frame.buffer = new_frame_data;
-                        out_frame.len = out_frame.needed_size;
-                        ret = ESP_AUDIO_ERR_CONTINUE;
-                        continue;
-                    }
-
-                    if (ret != ESP_AUDIO_ERR_OK)
-                    {
-                        ESP_LOGE(TAG, "Failed to process audio data, error: %d", ret);
-                        break;
-                    }
-
-                    // 将解码后的数据放入队列
-                    if (xQueueSend(audio_data_queue, &out_frame, pdMS_TO_TICKS(1000)) != pdTRUE)
-                    {
-                        ESP_LOGE(TAG, "Failed to send audio data to queue");
-                        break;
-                    }
-
-                    // 更新输入数据指针和长度
-                    raw.buffer += raw.consumed;
-                    raw.len -= raw.consumed;
-                    // ESP_LOGI(TAG, "consumed: %lu, raw.len: %lu", raw.consumed, raw.len);
-
-                    if (!uac_player_playing)
-                    {
-                        ESP_LOGI(TAG, "Player STOP play");
-                        break;
-                    }
-                }
-                if (!uac_player_playing)
-                {
-                    break;
-                }
-                if (raw.len > 0 && raw.len <= out_fram_buffer_size)
-                {
-                    memcpy(temp_buffer, raw.buffer, raw.len);
-                    temp_buffer_len = raw.len;
-                    // ESP_LOGI(TAG, "reset temp_buffer_len: %lu", temp_buffer_len);
-                }
-                else if (raw.len == 0)
+                uac_format_t out_format;
+                usb_uac_negotiate_format(&src_format, &out_format);
+                player_attach_mixer(&out_format);
+                player_out_format = out_format;
+                out_rate = out_format.sample_rate;
+                player_src_format = src_format;
+                player_dev_handle = s_spk_dev_handle;
+            }
+            if (slots[i]->flags & PCM_SLOT_FLAG_TRACK_START)
+            {
+                if (slots[i]->flags & PCM_SLOT_FLAG_SPLICE)
                 {
-                    ESP_LOGI(TAG, "Finished process");
-                    break;
+                    player_report_splice_gap(out_rate);
                 }
-                else
+                player_track_end_us = 0;
+                if (audio_eq_get_cycles_per_frame(player_eq) > 0)
                 {
-                    ESP_LOGE(TAG, "Invalid raw.len: %lu", raw.len);
-                    break;
+                    ESP_LOGI(TAG, "EQ: %" PRIu32 " cycles/frame", audio_eq_get_cycles_per_frame(player_eq));
                 }
-                if (feof(file))
+                audio_limiter_stats_t limiter_stats;
+                audio_limiter_get_stats(player_limiter, &limiter_stats);
+                if (limiter_stats.limited_seconds > 0)
                 {
-                    ESP_LOGI(TAG, "Finished reading file: %s", file_path);
-                    break; // 文件读取完毕
+                    ESP_LOGI(TAG, "Limiter: active in %" PRIu32 " of %" PRIu32 " s, last second %" PRIu32 " samples, -%.1f dB",
+                             limiter_stats.limited_seconds, limiter_stats.total_seconds, limiter_stats.limited_per_sec,
+                             limiter_stats.max_reduction_db);
                 }
+                // ESP-IDF 中栈以字节为单位，最小剩余量也是字节数
+                ESP_LOGD(TAG, "Player stack high-water mark: %u of %u bytes free", (unsigned)uxTaskGetStackHighWaterMark(NULL),
+                         (unsigned)(player_TASK_STACK_SIZE));
             }
-            uac_host_device_set_mute(s_spk_dev_handle, true);
-            //  关闭文件
-            fclose(file);
-            // 4. 获取解码器信息
-            esp_audio_dec_info_t dec_info;
-            ret = esp_audio_dec_get_info(decoder, &dec_info);
-            if (ret == ESP_AUDIO_ERR_OK)
+            // 在解码采样率上均衡（目前只支持 16 位）
+            if (slots[i]->bits == 16)
             {
-                ESP_LOGI(TAG, "Sample rate: %" PRIu32 ", Channels: %u, Bits per sample: %u",
-                         dec_info.sample_rate, dec_info.channel, dec_info.bits_per_sample);
+                audio_eq_process(player_eq, (int16_t *)data, len / (slots[i]->channels * sizeof(int16_t)), slots[i]->channels,
+                                 slots[i]->sample_rate);
             }
-            else
-            {
-                ESP_LOGE(TAG, "Failed to get decoder info, error: %d", ret);
-            }
-
-            // 5. 关闭解码器
-            esp_audio_dec_close(decoder);
-            vTaskDelay(pdMS_TO_TICKS(1000)); // 延迟一下再清理，以免出现噪音
-
-            // 释放资源（PSRAM 中的内存
-            if (head_buffer)
+            // 解码输出采样率与扬声器不一致时先做采样率转换（目前只支持 16 位）
+            if (slots[i]->sample_rate != out_rate && slots[i]->bits == 16 && player_src_prepare(slots[i], out_rate))
             {
-                heap_caps_free(head_buffer);
+                uint32_t frames = audio_src_process(player_src, (const int16_t *)data, len / (slots[i]->channels * sizeof(int16_t)),
+                                                    player_src_buffer);
+                data = (uint8_t *)player_src_buffer;
+                len = frames * slots[i]->channels * sizeof(int16_t);
             }
-            if (frame_data)
+            uint32_t frame_bytes = slots[i]->channels * (slots[i]->bits / 8);
+            audio_gain_process(&player_gain, data, len / frame_bytes, slots[i]->channels, slots[i]->bits, out_rate);
+            if (slots[i]->bits == 16)
             {
-                heap_caps_free(frame_data);
+                audio_limiter_process(player_limiter, (int16_t *)data, len / frame_bytes, slots[i]->channels, out_rate);
             }
-            if (input_buffer)
+            AUDIO_TRACE_SPAN(AUDIO_TRACE_RING_TO_WRITE, slots[i]->commit_us);
+            int64_t write_us = AUDIO_TRACE_NOW();
+            esp_err_t write_ret = player_write(slots[i], data, len, &len);
+            // ESP_LOGI(TAG, "decoded_size: %lu", len);
+            if (write_ret != ESP_OK)
             {
-                heap_caps_free(input_buffer);
+                ESP_LOGE(TAG, "Failed to write audio data to device, error: %d", write_ret);
             }
-            if (temp_buffer)
+            else
             {
-                heap_caps_free(temp_buffer);
+                AUDIO_TRACE_SPAN(AUDIO_TRACE_WRITE, write_us);
+                AUDIO_TRACE_TX_WRITE(len, AUDIO_TRACE_NOW(), slots[i]->origin_us);
             }
-            uac_player_playing = false;
-            uac_decoder_closed = true;
         }
+        // 数据已写入 USB，批量归还槽
+        pcm_ring_release(pcm_ring, count);
     }
 }
-void audio_player_task(void *pvParameters)
+// 把事件分发给订阅者，订阅者在本任务中执行
+void audio_event_task(void *pvParameters)
 {
+    uac_player_event_t event;
+    player_subscriber_t subscribers[UAC_PLAYER_SUBSCRIBER_MAX];
     while (1)
     {
-        esp_audio_dec_out_frame_t out_frame;
-        if (xQueueReceive(audio_data_queue, &out_frame, portMAX_DELAY) == pdTRUE)
+        if (xQueueReceive(player_event_queue, &event, portMAX_DELAY) != pdTRUE)
+        {
+            continue;
+        }
+        // 在锁内复制订阅表，释放锁后再调用：订阅者可以在回调中订阅/取消订阅，也不会拖住其他任务的订阅调用
+        xSemaphoreTake(player_subscriber_lock, portMAX_DELAY);
+        memcpy(subscribers, player_subscribers, sizeof(subscribers));
+        xSemaphoreGive(player_subscriber_lock);
+        for (int i = 0; i < UAC_PLAYER_SUBSCRIBER_MAX; i++)
         {
-            if (out_frame.buffer)
+            if (subscribers[i].cb)
             {
-                esp_err_t write_ret = uac_host_device_write(s_spk_dev_handle, out_frame.buffer, out_frame.decoded_size, portMAX_DELAY);
-                // ESP_LOGI(TAG, "decoded_size: %lu", out_frame.decoded_size);
-                if (write_ret != ESP_OK)
-                {
-                    ESP_LOGE(TAG, "Failed to write audio data to device, error: %d", write_ret);
-                }
+                subscribers[i].cb(&event, subscribers[i].ctx);
             }
         }
     }
 }
-void audio_control_task(void *pvParameters)
+
+// 播放、暂停和停止过程中扫描任务都让出 SD 卡和 CPU
+static bool scan_should_yield(void)
+{
+    return atomic_load(&player_state) != UAC_PLAYER_STATE_IDLE;
+}
+
+// 解码整首曲目并测量响度，播放开始时放弃，返回 ESP_ERR_TIMEOUT 由调用方稍后重试
+static esp_err_t scan_measure(const char *file_path, uint8_t *buf, float *lufs, float *true_peak)
 {
-    char new_file_path[256];
+    player_track_t *track = track_open(file_path, &scan_slot);
+    if (track == NULL)
+    {
+        return ESP_FAIL;
+    }
+    audio_loudness_handle_t meter = NULL;
+    esp_err_t err = ESP_OK;
     while (1)
     {
-        if (xQueueReceive(audio_file_queue, &new_file_path, portMAX_DELAY) == pdTRUE)
+        if (scan_should_yield())
+        {
+            err = ESP_ERR_TIMEOUT;
+            break;
+        }
+        uint32_t len = 0;
+        track_decode_ret_t ret = track_decode_raw(track, buf, pcm_ring_slot_size, &len);
+        if (ret == TRACK_DECODE_END)
+        {
+            break;
+        }
+        if (ret == TRACK_DECODE_FAIL)
+        {
+            err = ESP_FAIL;
+            break;
+        }
+        if (len == 0)
+        {
+            continue;
+        }
+        if (meter == NULL && audio_loudness_create(track->info.sample_rate, track->info.channel, &meter) != ESP_OK)
         {
-            ESP_LOGI(TAG, "audio_control_task Received new file path: %s,uac_player_playing:%s", new_file_path, (uac_player_playing ? "true" : "false"));
+            err = ESP_ERR_NO_MEM;
+            break;
+        }
+        uint32_t frame_bytes = track->info.channel * (track->info.bits_per_sample / 8);
+        audio_loudness_add(meter, buf, len / frame_bytes, track->info.bits_per_sample);
+    }
+    if (err == ESP_OK && meter == NULL)
+    {
+        err = ESP_FAIL;
+    }
+    if (err == ESP_OK)
+    {
+        audio_loudness_get(meter, lufs, true_peak);
+    }
+    audio_loudness_delete(meter);
+    track_close(track);
+    return err;
+}
 
-            if (uac_player_playing)
-            {
-                
-                uint8_t volume;
-                uac_host_device_get_volume(s_spk_dev_handle, &volume);
-                // 渐出效果，逐渐降低音量
-                for (uint8_t v = volume; v > 0; v -= 1)
-                {
-                    uac_host_device_set_volume(s_spk_dev_handle, v);
-                    vTaskDelay(pdMS_TO_TICKS(10));
-                }
-                uac_host_device_set_mute(s_spk_dev_handle, true);
-                uac_player_playing = false;
-            }
-            ESP_LOGI(TAG, "uac_decoder_closed:%s", (uac_decoder_closed ? "true" : "false"));
-            // Send the new file path to the decoder task
-            if (xQueueSend(audio_control_file_queue, &new_file_path, pdMS_TO_TICKS(1000)) != pdTRUE)
+// 后台扫描目录中没有缓存的曲目，只在空闲时运行
+static void audio_scan_task(void *pvParameters)
+{
+    uint8_t *buf = audio_mem_alloc(AUDIO_MEM_BULK, pcm_ring_slot_size);
+    bool slot_ok = player_slot_init(&scan_slot) == ESP_OK;
+    DIR *dir = buf && slot_ok ? opendir(scan_dir) : NULL;
+    if (dir == NULL)
+    {
+        ESP_LOGE(TAG, "Loudness scan of %s not started", scan_dir);
+    }
+    uint32_t scanned = 0;
+    struct dirent *entry;
+    while (dir != NULL && (entry = readdir(dir)) != NULL)
+    {
+        if (entry->d_type != DT_REG || !audio_probe_is_audio_file(entry->d_name))
+        {
+            continue;
+        }
+        char file_path[256];
+        float lufs, true_peak;
+        snprintf(file_path, sizeof(file_path), "%s/%s", scan_dir, entry->d_name);
+        if (audio_loudness_cache_lookup(file_path, &lufs, &true_peak))
+        {
+            continue;
+        }
+        esp_err_t err;
+        do
+        {
+            while (scan_should_yield())
             {
-                ESP_LOGE(TAG, "Failed to send new file path to audio_control_file_queue");
+                vTaskDelay(pdMS_TO_TICKS(scan_poll_ms));
             }
+            err = scan_measure(file_path, buf, &lufs, &true_peak);
+        } while (err == ESP_ERR_TIMEOUT);
+        if (err != ESP_OK)
+        {
+            ESP_LOGW(TAG, "Loudness scan failed: %s (%s)", file_path, esp_err_to_name(err));
+            continue;
+        }
+        ESP_LOGI(TAG, "Loudness %s: %.1f LUFS, %.1f dBTP", file_path, lufs, true_peak);
+        audio_loudness_cache_store(file_path, lufs, true_peak);
+        scanned++;
+    }
+    if (dir != NULL)
+    {
+        closedir(dir);
+        ESP_LOGI(TAG, "Loudness scan of %s done, %" PRIu32 " new tracks", scan_dir, scanned);
+    }
+    heap_caps_free(buf);
+    player_slot_deinit(&scan_slot);
+    scan_task_handle = NULL;
+    vTaskDelete(NULL);
+}
+
+void uac_player_scan_library(const char *dir)
+{
+    if (scan_task_handle != NULL || audio_loudness_cache_init(loudness_cache_file) != ESP_OK)
+    {
+        return;
+    }
+    strncpy(scan_dir, dir, sizeof(scan_dir) - 1);
+    xTaskCreatePinnedToCore(audio_scan_task, "audio_scan_task", scan_TASK_STACK_SIZE, NULL, scan_TASK_PRIORITY,
+                            &scan_task_handle, scan_TASK_CORE);
+}
+
+// 命令放入邮箱，由解码任务按当前状态处理
+static esp_err_t player_send(player_cmd_type_t type, uint32_t arg, const char *path)
+{
+    if (player_mailbox == NULL)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    player_cmd_t cmd = {
+        .type = type,
+        .arg = arg,
+        .path = NULL,
+    };
+    if (path != NULL)
+    {
+        cmd.path = strdup(path);
+        if (cmd.path == NULL)
+        {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    if (xQueueSend(player_mailbox, &cmd, pdMS_TO_TICKS(player_cmd_timeout_ms)) != pdTRUE)
+    {
+        free(cmd.path);
+        ESP_LOGW(TAG, "Mailbox full, command %d dropped", type);
+        return ESP_ERR_TIMEOUT;
+    }
+    return ESP_OK;
+}
+
+esp_err_t uac_player_play(const char *file_path)
+{
+    if (file_path == NULL || strlen(file_path) >= UAC_PLAYER_PATH_MAX)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return player_send(PLAYER_CMD_PLAY, 0, file_path);
+}
+
+esp_err_t uac_player_pause(void)
+{
+    return player_send(PLAYER_CMD_PAUSE, 0, NULL);
+}
+
+esp_err_t uac_player_resume(void)
+{
+    return player_send(PLAYER_CMD_RESUME, 0, NULL);
+}
+
+esp_err_t uac_player_stop(void)
+{
+    return player_send(PLAYER_CMD_STOP, 0, NULL);
+}
+
+esp_err_t uac_player_next(void)
+{
+    return player_send(PLAYER_CMD_NEXT, 0, NULL);
+}
+
+esp_err_t uac_player_prev(void)
+{
+    return player_send(PLAYER_CMD_PREV, 0, NULL);
+}
+
+uac_player_state_t uac_player_get_state(void)
+{
+    return atomic_load(&player_state);
+}
+
+esp_err_t uac_player_subscribe(uac_player_event_cb_t cb, void *ctx)
+{
+    if (cb == NULL || player_subscriber_lock == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_err_t err = ESP_ERR_NO_MEM;
+    xSemaphoreTake(player_subscriber_lock, portMAX_DELAY);
+    for (int i = 0; i < UAC_PLAYER_SUBSCRIBER_MAX; i++)
+    {
+        if (player_subscribers[i].cb == NULL)
+        {
+            player_subscribers[i].cb = cb;
+            player_subscribers[i].ctx = ctx;
+            err = ESP_OK;
+            break;
+        }
+    }
+    xSemaphoreGive(player_subscriber_lock);
+    return err;
+}
+
+void uac_player_unsubscribe(uac_player_event_cb_t cb, void *ctx)
+{
+    if (player_subscriber_lock == NULL)
+    {
+        return;
+    }
+    xSemaphoreTake(player_subscriber_lock, portMAX_DELAY);
+    for (int i = 0; i < UAC_PLAYER_SUBSCRIBER_MAX; i++)
+    {
+        if (player_subscribers[i].cb == cb && player_subscribers[i].ctx == ctx)
+        {
+            player_subscribers[i].cb = NULL;
+            player_subscribers[i].ctx = NULL;
         }
     }
+    xSemaphoreGive(player_subscriber_lock);
+}
+
+void uac_player_set_pause_mode(uac_player_pause_mode_t mode)
+{
+    atomic_store(&player_pause_mode, mode);
+}
+
+void uac_player_set_volume(uint8_t volume)
+{
+    player_send(PLAYER_CMD_VOLUME, volume, NULL);
+}
+
+void uac_player_set_mute(bool mute)
+{
+    player_muted = mute;
+    // 暂停和空闲时增益保持为 0，恢复播放时按静音状态淡入
+    if (atomic_load(&player_state) == UAC_PLAYER_STATE_PLAYING)
+    {
+        audio_gain_set(&player_gain, mute ? 0 : audio_gain_from_percent(player_volume), player_gain_ramp_ms);
+    }
+}
+
+void uac_player_set_crossfade(uint32_t crossfade_ms)
+{
+    atomic_store(&player_xfade_ms, crossfade_ms > player_xfade_max_ms ? player_xfade_max_ms : crossfade_ms);
+}
+
+esp_err_t uac_player_set_eq_band(uint8_t channel_mask, uint8_t index, const audio_eq_band_t *band)
+{
+    if (player_eq == NULL)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    return audio_eq_set_band(player_eq, channel_mask, index, band);
+}
+
+esp_err_t uac_player_seek_ms(uint32_t position_ms)
+{
+    uac_player_state_t state = atomic_load(&player_state);
+    if ((state != UAC_PLAYER_STATE_PLAYING && state != UAC_PLAYER_STATE_PAUSED) || position_ms == PLAYER_SEEK_NONE)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    return player_send(PLAYER_CMD_SEEK, position_ms, NULL);
+}
+
+void uac_player_get_limiter_stats(audio_limiter_stats_t *stats)
+{
+    audio_limiter_get_stats(player_limiter, stats);
+}
+
+void uac_player_get_mem_stats(uac_player_mem_stats_t *stats)
+{
+    player_get_mem_stats(stats);
+}
+
+esp_err_t uac_player_mem_bench(const char *file_path)
+{
+    if (file_path == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (atomic_load(&player_state) != UAC_PLAYER_STATE_IDLE)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    return player_send(PLAYER_CMD_MEM_BENCH, 0, file_path);
+}
+
+esp_err_t uac_player_mem_test(uint32_t track_changes)
+{
+    if (atomic_load(&player_state) != UAC_PLAYER_STATE_IDLE)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    return player_send(PLAYER_CMD_MEM_TEST, track_changes, NULL);
+}
+
+audio_mixer_handle_t uac_audio_player_get_mixer(void)
+{
+    return player_mixer;
 }
+
 void uac_audio_player_init(void)
 {
+    // 开始播放时再淡入
+    audio_gain_init(&player_gain, 0);
+    audio_dither_init(&player_dither, (uint32_t)esp_timer_get_time());
 
-    // 创建音乐文件队列
-    audio_file_queue = xQueueCreate(5, sizeof(char[256]));
-    if (audio_file_queue == NULL)
+    if (audio_mixer_create(player_duck_gain, &player_mixer) != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to create mixer");
+        return;
+    }
+    if (audio_eq_create(&player_eq) != ESP_OK)
     {
-        ESP_LOGE(TAG, "Failed to create queue");
+        ESP_LOGE(TAG, "Failed to create eq");
         return;
     }
+    const audio_limiter_config_t limiter_config = {
+        .lookahead_ms = player_limiter_lookahead_ms,
+        .release_ms = player_limiter_release_ms,
+        .ceiling_db = player_limiter_ceiling_db,
+    };
+    if (audio_limiter_create(&limiter_config, &player_limiter) != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to create limiter");
+        return;
+    }
+
+    // 曲目槽按当前 SD 卡的簇大小一次分配，之后切歌不再在堆上分配
+    for (int i = 0; i < player_slot_num; i++)
+    {
+        if (player_slot_init(&player_slots[i]) != ESP_OK)
+        {
+            ESP_LOGE(TAG, "Failed to create track slot %d", i);
+            return;
+        }
+    }
 
-    // 创建解码后音频数据队列
-    audio_data_queue = xQueueCreate(5, sizeof(esp_audio_dec_out_frame_t));
-    if (audio_data_queue == NULL)
+    // 创建播放命令邮箱、事件队列和订阅者锁
+    player_mailbox = xQueueCreate(player_mailbox_len, sizeof(player_cmd_t));
+    player_event_queue = xQueueCreate(player_event_queue_len, sizeof(uac_player_event_t));
+    player_subscriber_lock = xSemaphoreCreateMutex();
+    if (player_mailbox == NULL || player_event_queue == NULL || player_subscriber_lock == NULL)
     {
-        ESP_LOGE(TAG, "Failed to create audio data queue");
+        ESP_LOGE(TAG, "Failed to create player mailbox");
         return;
     }
 
-    audio_control_file_queue = xQueueCreate(5, sizeof(char[256]));
-    if (audio_control_file_queue == NULL)
+    // 创建解码后 PCM 环形缓冲区
+    const pcm_ring_config_t ring_config = {
+        .slot_num = pcm_ring_slot_num,
+        .slot_size = pcm_ring_slot_size,
+        .period_ms = pcm_ring_period_ms,
+        .caps = audio_mem_caps(AUDIO_MEM_PCM),
+    };
+    pcm_ring_config_t fallback_config = ring_config;
+    fallback_config.caps = audio_mem_fallback_caps(AUDIO_MEM_PCM);
+    if (pcm_ring_create(&ring_config, &pcm_ring) != ESP_OK && pcm_ring_create(&fallback_config, &pcm_ring) != ESP_OK)
     {
-        ESP_LOGE(TAG, "Failed to create queue");
+        ESP_LOGE(TAG, "Failed to create pcm ring");
         return;
     }
 
     TaskHandle_t decoder_task_handle = NULL;
     TaskHandle_t player_task_handle = NULL;
-    TaskHandle_t control_task_handle = NULL;
+    TaskHandle_t event_task_handle = NULL;
     // 创建解码任务
     xTaskCreatePinnedToCore(audio_decoder_task, "audio_decoder_task", codec_TASK_STACK_SIZE, NULL, 3, &decoder_task_handle, 1);
     // 创建播放任务
     xTaskCreatePinnedToCore(audio_player_task, "audio_player_task", player_TASK_STACK_SIZE, NULL, 3, &player_task_handle, 1);
-    // 创建解码控制任务
-    xTaskCreatePinnedToCore(audio_control_task, "audio_control_task", countrol_player_TASK_STACK_SIZE, NULL, 5, &control_task_handle, 1);
+    // 创建事件分发任务
+    xTaskCreatePinnedToCore(audio_event_task, "audio_event_task", event_TASK_STACK_SIZE, NULL, 5, &event_task_handle, 1);
 }
\ No newline at end of file
@@ -1,3 +1,258 @@
 #pragma once
 
-void uac_audio_player_init(void);
\ No newline at end of file
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "audio_mixer.h"
+#include "audio_eq.h"
+#include "audio_limiter.h"
+
+#define UAC_PLAYER_PATH_MAX 256     // 文件路径最大长度（含结尾的 0）
+#define UAC_PLAYER_SUBSCRIBER_MAX 4 // 事件订阅者最大数量
+
+/**
+ * @brief 播放状态
+ *
+ * 状态只由解码任务修改：IDLE --播放--> PLAYING <--暂停/恢复--> PAUSED，
+ * 停止或切歌时经过 STOPPING（淡出中）回到 IDLE 或开始下一首。
+ */
+typedef enum
+{
+    UAC_PLAYER_STATE_IDLE = 0, // 空闲
+    UAC_PLAYER_STATE_PLAYING,  // 播放中
+    UAC_PLAYER_STATE_PAUSED,   // 暂停，解码器保持打开，环形缓冲区中的数据保留
+    UAC_PLAYER_STATE_STOPPING, // 正在淡出，之后停止或切换曲目
+} uac_player_state_t;
+
+/**
+ * @brief 暂停方式
+ */
+typedef enum
+{
+    UAC_PLAYER_PAUSE_SUSPEND = 0, // 淡出后挂起扬声器流（SET_INTERFACE 到 alt 0），恢复时重新启用
+    UAC_PLAYER_PAUSE_SOFT,        // 软暂停：流保持运行并写入静音，用于切换 alt 设置时有爆音的设备
+} uac_player_pause_mode_t;
+
+typedef enum
+{
+    UAC_PLAYER_EVENT_STATE = 0,   // 状态改变
+    UAC_PLAYER_EVENT_TRACK_START, // 开始解码一首曲目（包括无缝衔接和交叉淡化的下一首）
+    UAC_PLAYER_EVENT_TRACK_END,   // 一首曲目解码结束
+} uac_player_event_type_t;
+
+/**
+ * @brief 播放器事件
+ *
+ * 曲目事件按解码进度发出，比实际听到的声音最多提前一个 PCM 环形缓冲区的时长。
+ */
+typedef struct
+{
+    uac_player_event_type_t type;
+    uac_player_state_t state;            // 发出事件时的状态
+    bool completed;                      // TRACK_END：是否完整播放到结尾（否则为停止或切歌）
+    char file_path[UAC_PLAYER_PATH_MAX]; // 曲目事件的文件路径
+} uac_player_event_t;
+
+/**
+ * @brief 内存统计，用于观察长时间播放后的堆碎片
+ */
+typedef struct
+{
+    uint32_t psram_free;       // PSRAM 剩余字节数
+    uint32_t psram_largest;    // PSRAM 最大空闲块
+    uint32_t internal_free;    // 内部 RAM 剩余字节数
+    uint32_t internal_largest; // 内部 RAM 最大空闲块
+    uint32_t arena_size;       // 曲目槽总大小
+    uint32_t arena_peak;       // 曲目槽用量峰值
+    uint32_t arena_fail_count; // 曲目槽空间不足的次数
+    uint32_t dec_open_count;   // 打开解码器的次数
+} uac_player_mem_stats_t;
+
+/**
+ * @brief 事件回调，在播放器的事件任务中依次调用，不能长时间阻塞；调用时不持有订阅表的锁，回调中可以订阅或取消订阅
+ */
+typedef void (*uac_player_event_cb_t)(const uac_player_event_t *event, void *ctx);
+
+/**
+ * @brief 取得下一首曲目的回调，无缝播放时由解码任务在当前曲目解码结束前调用
+ *
+ * 回调只查询，不能修改播放位置：预先打开的下一首可能被切歌或停止丢弃。
+ * 曲目真正开始解码时播放器发出 UAC_PLAYER_EVENT_TRACK_START，应用在事件中更新自己的播放位置。
+ *
+ * @param[in]  current_file_path 参照的曲目路径，还没有播放过时为空字符串
+ * @param[out] next_file_path    下一首的文件路径（UAC_PLAYER_PATH_MAX 字节）
+ * @param[in]  ctx               注册时传入的参数
+ * @return 是否有下一首
+ */
+typedef bool (*uac_player_next_track_cb_t)(const char *current_file_path, char *next_file_path, void *ctx);
+
+void uac_audio_player_init(void);
+
+/**
+ * @brief 混音器句柄，用于打开提示音等输入流
+ *
+ * 输入流在等时传输提交前叠加到音乐上，标记为 duck 的流打开期间音乐被压低；
+ * 没有音乐时播放任务写入静音，使输入流仍能输出。输入流按 audio_mixer_get_format 的格式写入。
+ */
+audio_mixer_handle_t uac_audio_player_get_mixer(void);
+
+/**
+ * @brief 注册取得下一首的回调，开启无缝播放；传入 NULL 关闭
+ *
+ * 开启后当前曲目的文件读完时就打开并预解码下一首，两首按编码器延迟/填充裁剪后
+ * 连续写入 PCM 环形缓冲区，中间不再静音、淡出或关闭解码器。
+ */
+void uac_audio_player_set_next_track_cb(uac_player_next_track_cb_t cb, void *ctx);
+
+/**
+ * @brief 注册取得上一首的回调，供 uac_player_prev 使用，参数与下一首回调相同
+ */
+void uac_audio_player_set_prev_track_cb(uac_player_next_track_cb_t cb, void *ctx);
+
+/**
+ * @brief 播放控制
+ *
+ * 命令放入播放器的邮箱后立即返回，由解码任务按当前状态依次处理，状态变化通过事件通知。
+ * 播放/切歌时当前曲目先淡出；暂停时淡出后播放任务停止取数据，恢复时从暂停处淡入。
+ * 下一首/上一首由注册的回调取得路径，没有回调或回调返回 false 时忽略。
+ *
+ * @return
+ *  - ESP_OK 命令已提交
+ *  - ESP_ERR_INVALID_ARG 路径为空或过长
+ *  - ESP_ERR_NO_MEM 内存不足
+ *  - ESP_ERR_TIMEOUT 邮箱已满
+ *  - ESP_ERR_INVALID_STATE 播放器未初始化
+ */
+esp_err_t uac_player_play(const char *file_path);
+esp_err_t uac_player_pause(void);
+esp_err_t uac_player_resume(void);
+esp_err_t uac_player_stop(void);
+esp_err_t uac_player_next(void);
+esp_err_t uac_player_prev(void);
+
+/**
+ * @brief 设置暂停方式，默认为 UAC_PLAYER_PAUSE_SUSPEND，暂停中修改时立即生效
+ *
+ * 两种方式下解码器都停在帧边界、保持打开，PCM 环形缓冲区中已解码的数据保留，
+ * 恢复时不重新读取或解码，从暂停处淡入。挂起方式下有提示音等输入流在混音时
+ * 临时按软暂停处理。
+ */
+void uac_player_set_pause_mode(uac_player_pause_mode_t mode);
+
+/**
+ * @brief 当前播放状态
+ */
+uac_player_state_t uac_player_get_state(void);
+
+/**
+ * @brief 订阅播放器事件
+ *
+ * @return
+ *  - ESP_OK 成功
+ *  - ESP_ERR_INVALID_ARG 回调为空或播放器未初始化
+ *  - ESP_ERR_NO_MEM 订阅者已满（UAC_PLAYER_SUBSCRIBER_MAX）
+ */
+esp_err_t uac_player_subscribe(uac_player_event_cb_t cb, void *ctx);
+
+/**
+ * @brief 取消订阅，cb 和 ctx 都与订阅时相同的项被移除
+ *
+ * 可以在回调中调用。事件任务正在分发的那一个事件仍可能再调用一次已取消的回调，
+ * 释放 ctx 前需确认回调不再执行。
+ */
+void uac_player_unsubscribe(uac_player_event_cb_t cb, void *ctx);
+
+/**
+ * @brief 跳转到当前曲目的 position_ms 处
+ *
+ * 请求交给解码任务处理：WAV 按帧直接计算位置；MP3 使用 Xing/Info TOC 或 VBRI 表，
+ * 没有时与 ADTS AAC 一样使用按文件缓存的稀疏帧索引。跳转前已解码的 PCM 全部丢弃。
+ * 超出曲目长度时当前曲目结束。其余格式不支持跳转，请求被忽略。
+ *
+ * @return
+ *  - ESP_OK 请求已提交
+ *  - ESP_ERR_INVALID_STATE 没有在播放或暂停
+ *  - ESP_ERR_TIMEOUT 邮箱已满
+ */
+esp_err_t uac_player_seek_ms(uint32_t position_ms);
+
+/**
+ * @brief 设置播放音量（0~100），在 PCM 上平滑过渡，不发送 USB 控制传输
+ *
+ * 与播放控制一样通过邮箱交给解码任务；暂停和空闲时只记录，恢复或开始播放时生效。
+ */
+void uac_player_set_volume(uint8_t volume);
+
+/**
+ * @brief 静音/取消静音，在 PCM 上平滑过渡
+ */
+void uac_player_set_mute(bool mute);
+
+/**
+ * @brief 设置相邻曲目的交叉淡化时长（0~12000 ms），0 为关闭
+ *
+ * 需要注册下一首回调。当前曲目剩余时长进入淡化窗口时打开下一首，两个解码器同时运行，
+ * 输出按等功率曲线混合。剩余内存不足、两首格式不同（采样率/通道数，目前只混 16 位）
+ * 或两个解码器的 CPU 占用超出预算时不淡化，按无缝衔接处理；淡化过程中解码跟不上实时
+ * 时直接切到下一首。
+ */
+void uac_player_set_crossfade(uint32_t crossfade_ms);
+
+/**
+ * @brief 设置均衡器的一个频段，新参数在约 20 ms 内平滑过渡
+ *
+ * 均衡在解码输出上进行（目前只处理 16 位），每个通道最多 AUDIO_EQ_BAND_MAX 段。
+ *
+ * @param[in] channel_mask 作用的通道（bit0 左，bit1 右）
+ * @param[in] index        频段序号
+ * @param[in] band         频段参数，类型为 AUDIO_EQ_BAND_OFF 时关闭该频段
+ * @return
+ *  - ESP_OK 成功
+ *  - ESP_ERR_INVALID_ARG 参数无效
+ *  - ESP_ERR_INVALID_STATE 播放器未初始化
+ */
+esp_err_t uac_player_set_eq_band(uint8_t channel_mask, uint8_t index, const audio_eq_band_t *band);
+
+/**
+ * @brief 取得输出限制器的统计信息（最近一秒被衰减的样本数、最大衰减等），用于调整增益分配
+ */
+void uac_player_get_limiter_stats(audio_limiter_stats_t *stats);
+
+/**
+ * @brief 取得内存统计
+ */
+void uac_player_get_mem_stats(uac_player_mem_stats_t *stats);
+
+/**
+ * @brief 模拟 track_changes 次切歌（分配曲目缓冲区、打开解码器后关闭，不读文件），
+ *        在日志中输出前后的最大空闲块等内存统计
+ *
+ * @return
+ *  - ESP_OK 已交给解码任务执行
+ *  - ESP_ERR_INVALID_STATE 不是空闲状态
+ */
+esp_err_t uac_player_mem_test(uint32_t track_changes);
+
+/**
+ * @brief 比较缓冲区放在内部 RAM 和 PSRAM 时的解码实时率
+ *
+ * 按几种放置（全部 PSRAM、PCM 或解码器内部 RAM、全部内部 RAM 等）分别解码曲目开头一段，
+ * 在日志中输出解码耗时与音频时长之比。默认的放置见 audio_mem.c 中的策略表。
+ *
+ * @param[in] file_path 用于测试的曲目
+ * @return
+ *  - ESP_OK 已交给解码任务执行
+ *  - ESP_ERR_INVALID_STATE 不是空闲状态
+ */
+esp_err_t uac_player_mem_bench(const char *file_path);
+
+/**
+ * @brief 在后台扫描目录中的曲目并缓存响度（EBU R128 积分响度和真峰值）
+ *
+ * 扫描任务优先级最低，只在没有播放时运行，开始播放后放弃当前文件，停止后重新扫描。
+ * 结果缓存在 SD 卡上，按路径、文件大小和修改时间识别，已扫描的文件不再重复扫描。
+ * 打开曲目时按缓存的响度把音量调整到 AUDIO_LOUDNESS_TARGET_LUFS（只衰减）。
+ *
+ * @param[in] dir 音乐目录
+ */
+void uac_player_scan_library(const char *dir);
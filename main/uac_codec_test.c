@@ -21,7 +21,6 @@
 #include "audio_task.h"
 #include "led_task.h"
 extern uac_host_device_handle_t s_spk_dev_handle;
-extern QueueHandle_t audio_file_queue;
 
 uint8_t player_volume = 100;
 void app_main(void)
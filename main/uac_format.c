@@ -0,0 +1,134 @@
+#include "uac_format.h"
+
+#include <stddef.h>
+#include "audio_src.h"
+
+// 连续采样率范围内额外考虑的常用采样率
+static const uint32_t s_common_rates[] = {44100, 48000, 88200, 96000, 32000, 22050, 24000, 16000};
+
+/*
+ * 代价模型（数值越小越好）：
+ *  - 采样率相同为 0；需要 SRC 时为 100 + L/4（相位数越多系数表越大）+ 输出采样率每 48 kHz 10，
+ *    降采样会损失频带，再加 50
+ *  - 位深相同为 0；提高位深（补零）为 5，降低位深（需要抖动）为 20，只支持 16/24/32 位之间的转换
+ *  - 通道数相同为 0；需要重映射为 10，只支持单声道与立体声互转
+ */
+static bool uac_format_bits_supported(uint8_t bits)
+{
+    return bits == 16 || bits == 24 || bits == 32;
+}
+
+uint32_t uac_format_cost(const uac_format_t *src, const uac_format_t *dst, const uac_format_caps_t *caps)
+{
+    uint32_t cost = 0;
+
+    if (dst->sample_rate != src->sample_rate)
+    {
+        if (!audio_src_ratio_supported(src->sample_rate, dst->sample_rate))
+        {
+            return UAC_FORMAT_COST_INFEASIBLE;
+        }
+        cost += 100 + audio_src_phase_count(src->sample_rate, dst->sample_rate) / 4 + dst->sample_rate / 4800;
+        if (dst->sample_rate < src->sample_rate)
+        {
+            cost += 50;
+        }
+    }
+
+    if (dst->bits != src->bits)
+    {
+        if (!caps->bits_conversion || !uac_format_bits_supported(src->bits) || !uac_format_bits_supported(dst->bits))
+        {
+            return UAC_FORMAT_COST_INFEASIBLE;
+        }
+        cost += dst->bits > src->bits ? 5 : 20;
+    }
+
+    if (dst->channels != src->channels)
+    {
+        if (!caps->channel_remap || src->channels > 2 || dst->channels > 2)
+        {
+            return UAC_FORMAT_COST_INFEASIBLE;
+        }
+        cost += 10;
+    }
+    return cost;
+}
+
+static void uac_format_try(const uac_format_t *src, const uac_format_t *candidate, const uac_format_caps_t *caps,
+                           uac_format_t *best, uint32_t *best_cost)
+{
+    uint32_t cost = uac_format_cost(src, candidate, caps);
+    if (cost < *best_cost)
+    {
+        *best = *candidate;
+        *best_cost = cost;
+    }
+}
+
+esp_err_t uac_format_select(const uac_host_dev_alt_param_t *alts, uint8_t alt_num, const uac_format_t *src,
+                            const uac_format_caps_t *caps, uac_format_t *out, uint32_t *cost)
+{
+    if (alts == NULL || src == NULL || caps == NULL || out == NULL)
+    {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uac_format_t best = {0};
+    uint32_t best_cost = UAC_FORMAT_COST_INFEASIBLE;
+    for (uint8_t i = 0; i < alt_num; i++)
+    {
+        const uac_host_dev_alt_param_t *alt = &alts[i];
+        // 目前只支持 PCM
+        if (alt->format != 1 || alt->channels == 0 || alt->bit_resolution == 0)
+        {
+            continue;
+        }
+        uac_format_t candidate = {
+            .bits = alt->bit_resolution,
+            .channels = alt->channels,
+        };
+        if (alt->sample_freq_type > 0)
+        {
+            // 离散采样率列表，驱动最多只保存 UAC_FREQ_NUM_MAX 个
+            uint8_t freq_num = alt->sample_freq_type < UAC_FREQ_NUM_MAX ? alt->sample_freq_type : UAC_FREQ_NUM_MAX;
+            for (uint8_t j = 0; j < freq_num; j++)
+            {
+                candidate.sample_rate = alt->sample_freq[j];
+                uac_format_try(src, &candidate, caps, &best, &best_cost);
+            }
+        }
+        else
+        {
+            // 连续采样率范围：优先原生采样率，其次范围内的常用采样率和范围边界
+            if (src->sample_rate >= alt->sample_freq_lower && src->sample_rate <= alt->sample_freq_upper)
+            {
+                candidate.sample_rate = src->sample_rate;
+                uac_format_try(src, &candidate, caps, &best, &best_cost);
+            }
+            for (size_t j = 0; j < sizeof(s_common_rates) / sizeof(s_common_rates[0]); j++)
+            {
+                if (s_common_rates[j] >= alt->sample_freq_lower && s_common_rates[j] <= alt->sample_freq_upper)
+                {
+                    candidate.sample_rate = s_common_rates[j];
+                    uac_format_try(src, &candidate, caps, &best, &best_cost);
+                }
+            }
+            candidate.sample_rate = alt->sample_freq_lower;
+            uac_format_try(src, &candidate, caps, &best, &best_cost);
+            candidate.sample_rate = alt->sample_freq_upper;
+            uac_format_try(src, &candidate, caps, &best, &best_cost);
+        }
+    }
+
+    if (best_cost == UAC_FORMAT_COST_INFEASIBLE)
+    {
+        return ESP_ERR_NOT_FOUND;
+    }
+    *out = best;
+    if (cost)
+    {
+        *cost = best_cost;
+    }
+    return ESP_OK;
+}
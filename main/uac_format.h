@@ -0,0 +1,78 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h" // uac_host.h 用到 BaseType_t
+#include "usb/uac_host.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief UAC 输出格式协商
+ *
+ * 根据设备各 alt 设置（uac_host_get_device_alt_param 得到的参数）为每首曲目选择
+ * 转换开销最小的输出格式：设备支持原生采样率/位深/通道数时直接使用，
+ * 否则在可行的候选中选代价最小的一个。本模块只做计算，不访问 USB，可以直接用
+ * 构造的描述符参数测试。
+ */
+
+/**
+ * @brief PCM 流格式
+ */
+typedef struct
+{
+    uint32_t sample_rate; // 采样率
+    uint8_t bits;         // 位深度
+    uint8_t channels;     // 通道数
+} uac_format_t;
+
+/**
+ * @brief 输出路径具备的转换能力
+ */
+typedef struct
+{
+    bool bits_conversion; // 支持位深转换
+    bool channel_remap;   // 支持通道数转换
+} uac_format_caps_t;
+
+// 不可行的转换代价
+#define UAC_FORMAT_COST_INFEASIBLE UINT32_MAX
+
+/**
+ * @brief 把 src 格式转换为 dst 格式的估算代价，0 表示无需转换
+ *
+ * @return 代价，无法转换时返回 UAC_FORMAT_COST_INFEASIBLE
+ */
+uint32_t uac_format_cost(const uac_format_t *src, const uac_format_t *dst, const uac_format_caps_t *caps);
+
+/**
+ * @brief 从设备的 alt 设置中选择代价最小的输出格式
+ *
+ * @param[in]  alts    alt 设置参数数组（对应 alt 1..alt_num）
+ * @param[in]  alt_num alt 设置数量
+ * @param[in]  src     解码输出格式
+ * @param[in]  caps    输出路径具备的转换能力
+ * @param[out] out     选中的输出格式
+ * @param[out] cost    选中格式的代价，可为 NULL
+ * @return
+ *  - ESP_OK 成功
+ *  - ESP_ERR_INVALID_ARG 参数无效
+ *  - ESP_ERR_NOT_FOUND 没有可行的格式
+ */
+esp_err_t uac_format_select(const uac_host_dev_alt_param_t *alts, uint8_t alt_num, const uac_format_t *src,
+                            const uac_format_caps_t *caps, uac_format_t *out, uint32_t *cost);
+
+/**
+ * @brief 两个格式是否相同
+ */
+static inline bool uac_format_equal(const uac_format_t *a, const uac_format_t *b)
+{
+    return a->sample_rate == b->sample_rate && a->bits == b->bits && a->channels == b->channels;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -10,6 +10,7 @@
 #include "usb/uac_host.h"
 #include "esp_vfs_fat.h"
 #include "sdmmc_cmd.h"
+#include "audio_trace.h"
 #include "driver/sdmmc_host.h"
 #include "driver/sdmmc_defs.h"
 #include <inttypes.h>// 包含 PRIu32 宏
@@ -37,6 +38,13 @@ static const char *TAG = "UAC HOST";
 #define UAC_TASK_STACK_SIZE 1024 * 3
 // 定义USB音频类主机任务堆栈大小 "USB UAC Host"
 #define USB_UAC_Host_STACK_SIZE 1024 * 2
+// 定义扬声器数据缓冲区大小和阈值
+#define UAC_BUFFER_SIZE 16000
+#define UAC_BUFFER_THRESHOLD 4000
+// 格式协商时最多读取的 alt 设置数量
+#define UAC_ALT_NUM_MAX 8
+// 设备音量（%）只在连接时设置一次，播放音量、静音和淡入淡出都在 PCM 域完成
+#define UAC_BASE_VOLUME 100
 
 
 static QueueHandle_t s_event_queue = NULL;          // 事件队列
@@ -210,8 +218,8 @@ static void uac_lib_task(void *arg)
                     const uac_host_device_config_t dev_config = {
                         .addr = addr,
                         .iface_num = iface_num,
-                        .buffer_size = 16000,
-                        .buffer_threshold = 4000, 
+                        .buffer_size = UAC_BUFFER_SIZE,
+                        .buffer_threshold = UAC_BUFFER_THRESHOLD,
                         .callback = uac_device_callback,
                         .callback_arg = NULL,
                     };
@@ -224,8 +232,10 @@ static void uac_lib_task(void *arg)
                         .channels = s_spk_curr_ch,
                         .bit_resolution = s_spk_curr_bits,
                         .sample_freq = s_spk_curr_freq,
+                        .flags = FLAG_STREAM_TX_CONTINUOUS, // 缓冲区欠载时驱动补静音，等时传输不断流
                     };
                     esp_err_t err = uac_host_device_start(uac_device_handle, &stm_config); // 启动设备
+                    AUDIO_TRACE_TX_RESET();
                     if (err == ESP_ERR_NOT_SUPPORTED)
                     {
                         ESP_LOGE(TAG, "Unable to claim Interface, error: %s", esp_err_to_name(err)); // 接口不支持
@@ -233,6 +243,11 @@ static void uac_lib_task(void *arg)
                         return;
                     }
                     ESP_ERROR_CHECK(err);
+                    // 设备不支持音量/静音控制时忽略错误
+                    uac_host_device_set_mute(uac_device_handle, false);
+                    uac_host_device_set_volume(uac_device_handle, UAC_BASE_VOLUME);
+                    // 欠载时先把上一个传输淡出，避免直接跳到静音产生爆音
+                    uac_host_device_set_tx_conceal(uac_device_handle, UAC_TX_CONCEAL_FADE);
                     s_spk_dev_handle = uac_device_handle; // 更新设备句柄
                     // xQueueSend(audio_file_queue, MOUNT_POINT MP3_FILE_NAME, portMAX_DELAY);// 发送文件路径
 
@@ -297,4 +312,141 @@ void uac_init(void)
     ret = xTaskCreatePinnedToCore(usb_lib_task, "usb_events", USB_HOST_TASK_STACK_SIZE, (void *)uac_task_handle,
                                   USB_HOST_TASK_PRIORITY, NULL, 1); // 创建USB主机任务
     assert(ret == pdTRUE);
-}
\ No newline at end of file
+}
+
+uint32_t usb_uac_get_sample_freq(void)
+{
+    return s_spk_curr_freq;
+}
+
+void usb_uac_get_format(uac_format_t *format)
+{
+    format->sample_rate = s_spk_curr_freq;
+    format->bits = s_spk_curr_bits;
+    format->channels = s_spk_curr_ch;
+}
+
+uint32_t usb_uac_get_buffer_frames(void)
+{
+    return UAC_BUFFER_SIZE / (s_spk_curr_ch * s_spk_curr_bits / 8);
+}
+
+// 等待驱动缓冲区中的数据播完（按缓冲区满时的时长估计）
+static void usb_uac_wait_drain(void)
+{
+    uint32_t byte_rate = s_spk_curr_freq * s_spk_curr_ch * s_spk_curr_bits / 8;
+    vTaskDelay(pdMS_TO_TICKS(UAC_BUFFER_SIZE * 1000 / byte_rate + 1));
+}
+
+esp_err_t usb_uac_suspend(void)
+{
+    uac_host_device_handle_t handle = s_spk_dev_handle;
+    if (handle == NULL)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    // 挂起时驱动会清空缓冲区，先让淡出的尾部播完
+    usb_uac_wait_drain();
+    AUDIO_TRACE_TX_RESET();
+    return uac_host_device_suspend(handle);
+}
+
+esp_err_t usb_uac_resume(void)
+{
+    uac_host_device_handle_t handle = s_spk_dev_handle;
+    if (handle == NULL)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    return uac_host_device_resume(handle);
+}
+
+esp_err_t usb_uac_get_stats(uac_host_stream_stats_t *stats)
+{
+    uac_host_device_handle_t handle = s_spk_dev_handle;
+    if (handle == NULL)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+    return uac_host_device_get_stats(handle, stats);
+}
+
+esp_err_t usb_uac_negotiate_format(const uac_format_t *src, uac_format_t *out)
+{
+    // 输出路径支持采样率转换、位深转换和单声道/立体声互转
+    static const uac_format_caps_t caps = {
+        .bits_conversion = true,
+        .channel_remap = true,
+    };
+    uac_host_device_handle_t handle = s_spk_dev_handle;
+    const uac_format_t cur = {
+        .sample_rate = s_spk_curr_freq,
+        .bits = s_spk_curr_bits,
+        .channels = s_spk_curr_ch,
+    };
+    *out = cur;
+    if (handle == NULL)
+    {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    uac_host_dev_info_t dev_info;
+    esp_err_t err = uac_host_get_device_info(handle, &dev_info);
+    if (err != ESP_OK)
+    {
+        return err;
+    }
+    uac_host_dev_alt_param_t alts[UAC_ALT_NUM_MAX];
+    uint8_t alt_num = dev_info.iface_alt_num < UAC_ALT_NUM_MAX ? dev_info.iface_alt_num : UAC_ALT_NUM_MAX;
+    for (uint8_t i = 0; i < alt_num; i++)
+    {
+        // alt 设置编号从 1 开始
+        err = uac_host_get_device_alt_param(handle, i + 1, &alts[i]);
+        if (err != ESP_OK)
+        {
+            return err;
+        }
+    }
+
+    uac_format_t best;
+    uint32_t best_cost;
+    if (uac_format_select(alts, alt_num, src, &caps, &best, &best_cost) != ESP_OK)
+    {
+        ESP_LOGW(TAG, "No alt setting fits %" PRIu32 " Hz/%u bit/%u ch, keep current format",
+                 src->sample_rate, src->bits, src->channels);
+        return ESP_ERR_NOT_FOUND;
+    }
+    // 当前格式已经是代价最小的之一，不重新配置流
+    if (uac_format_equal(&best, &cur) || uac_format_cost(src, &cur, &caps) <= best_cost)
+    {
+        return ESP_OK;
+    }
+
+    // 等待驱动缓冲区中上一首的数据播完，再切换格式
+    usb_uac_wait_drain();
+    uac_host_device_stop(handle);
+    AUDIO_TRACE_TX_RESET();
+    uac_host_stream_config_t stm_config = {
+        .channels = best.channels,
+        .bit_resolution = best.bits,
+        .sample_freq = best.sample_rate,
+        .flags = FLAG_STREAM_TX_CONTINUOUS,
+    };
+    err = uac_host_device_start(handle, &stm_config);
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to start stream with new format, error: %s", esp_err_to_name(err));
+        stm_config.channels = cur.channels;
+        stm_config.bit_resolution = cur.bits;
+        stm_config.sample_freq = cur.sample_rate;
+        uac_host_device_start(handle, &stm_config);
+        return err;
+    }
+    s_spk_curr_freq = best.sample_rate;
+    s_spk_curr_bits = best.bits;
+    s_spk_curr_ch = best.channels;
+    *out = best;
+    ESP_LOGI(TAG, "Stream format %" PRIu32 " Hz/%u bit/%u ch -> %" PRIu32 " Hz/%u bit/%u ch (cost %" PRIu32 ")",
+             cur.sample_rate, cur.bits, cur.channels, best.sample_rate, best.bits, best.channels, best_cost);
+    return ESP_OK;
+}
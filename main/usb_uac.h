@@ -1,11 +1,78 @@
 #pragma once
 
+#include <stdint.h>
+#include "esp_err.h"
+#include "uac_format.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 void uac_init(void);
 
+/**
+ * @brief 当前扬声器流的采样率
+ */
+uint32_t usb_uac_get_sample_freq(void);
+
+/**
+ * @brief 当前扬声器流格式
+ */
+void usb_uac_get_format(uac_format_t *format);
+
+/**
+ * @brief 扬声器驱动缓冲区能容纳的帧数（按当前格式）
+ */
+uint32_t usb_uac_get_buffer_frames(void);
+
+/**
+ * @brief 挂起扬声器流（SET_INTERFACE 到 alt 0），等待驱动缓冲区播完后才挂起
+ *
+ * 流格式和驱动的配置保持不变，usb_uac_resume 后可以直接继续写入。
+ *
+ * @return
+ *  - ESP_OK 成功（已经挂起时也返回成功）
+ *  - ESP_ERR_INVALID_STATE 没有连接扬声器
+ */
+esp_err_t usb_uac_suspend(void);
+
+/**
+ * @brief 恢复被挂起的扬声器流
+ *
+ * @return
+ *  - ESP_OK 成功（流本来就在运行时也返回成功）
+ *  - ESP_ERR_INVALID_STATE 没有连接扬声器
+ */
+esp_err_t usb_uac_resume(void);
+
+/**
+ * @brief 扬声器流的欠载/溢出统计
+ *
+ * 流以 FLAG_STREAM_TX_CONTINUOUS 启动，驱动缓冲区欠载时等时传输照常提交，缺的部分淡出后补静音，
+ * 每次欠载都计数并记录时间。
+ *
+ * @return
+ *  - ESP_OK 成功
+ *  - ESP_ERR_INVALID_STATE 没有连接扬声器
+ */
+esp_err_t usb_uac_get_stats(uac_host_stream_stats_t *stats);
+
+/**
+ * @brief 按解码输出格式协商扬声器流格式
+ *
+ * 读取设备所有 alt 设置，选出转换代价最小的输出格式；只有格式确实改变时
+ * 才通过 uac_host_device_stop/uac_host_device_start 重新配置流。
+ *
+ * @param[in]  src 解码输出格式
+ * @param[out] out 协商后实际使用的输出格式（失败时为当前格式）
+ * @return
+ *  - ESP_OK 成功
+ *  - ESP_ERR_INVALID_STATE 没有连接扬声器
+ *  - ESP_ERR_NOT_FOUND 设备没有可行的格式，保持当前格式
+ *  - 其他 重新启动流失败，已恢复为原格式
+ */
+esp_err_t usb_uac_negotiate_format(const uac_format_t *src, uac_format_t *out);
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
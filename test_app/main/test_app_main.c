@@ -0,0 +1,40 @@
+#include <stdio.h>
+#include <string.h>
+#include "unity.h"
+#include "esp_heap_caps.h"
+
+static size_t before_free_8bit;
+static size_t before_free_32bit;
+
+// 测试中创建的任务由空闲任务回收，允许少量差值
+#define TEST_MEMORY_LEAK_THRESHOLD (-530)
+static void check_leak(size_t before_free, size_t after_free, const char *type)
+{
+    ssize_t delta = after_free - before_free;
+    printf("MALLOC_CAP_%s: Before %u bytes free, After %u bytes free (delta %d)\n", type, before_free, after_free, delta);
+    TEST_ASSERT_MESSAGE(delta >= TEST_MEMORY_LEAK_THRESHOLD, "memory leak");
+}
+
+void app_main(void)
+{
+    printf("UAC audio player module tests\n");
+    UNITY_BEGIN();
+    unity_run_menu();
+    UNITY_END();
+}
+
+// 每个测试前记录剩余内存
+void setUp(void)
+{
+    before_free_8bit = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    before_free_32bit = heap_caps_get_free_size(MALLOC_CAP_32BIT);
+}
+
+// 每个测试后检查内存泄漏
+void tearDown(void)
+{
+    size_t after_free_8bit = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    size_t after_free_32bit = heap_caps_get_free_size(MALLOC_CAP_32BIT);
+    check_leak(before_free_8bit, after_free_8bit, "8BIT");
+    check_leak(before_free_32bit, after_free_32bit, "32BIT");
+}
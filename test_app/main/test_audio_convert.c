@@ -0,0 +1,182 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "unity.h"
+#include "esp_heap_caps.h"
+#include "audio_convert.h"
+#include "audio_simd.h"
+
+#define CONVERT_TEST_ALL    65536 // 覆盖全部 16 位取值
+#define CONVERT_TEST_DITHER 65536 // 抖动统计的样本数
+
+static void *convert_test_alloc(size_t size)
+{
+    void *p = heap_caps_aligned_alloc(AUDIO_SIMD_ALIGN, size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    TEST_ASSERT_NOT_NULL(p);
+    return p;
+}
+
+// 全部 16 位取值依次排列
+static void fill_all_s16(int16_t *p)
+{
+    for (uint32_t i = 0; i < CONVERT_TEST_ALL; i++)
+    {
+        p[i] = (int16_t)(i - 32768);
+    }
+}
+
+static void check_s24(const uint8_t *p, const int16_t *src, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+    {
+        uint32_t expect = (uint32_t)(uint16_t)src[i] << 8;
+        uint32_t got = p[3 * i] | (uint32_t)p[3 * i + 1] << 8 | (uint32_t)p[3 * i + 2] << 16;
+        TEST_ASSERT_EQUAL_HEX32(expect, got);
+    }
+}
+
+static void check_s32(const int32_t *p, const int16_t *src, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+    {
+        TEST_ASSERT_EQUAL_INT32((int32_t)((uint32_t)(uint16_t)src[i] << 16), p[i]);
+    }
+}
+
+TEST_CASE("audio convert widens 16-bit samples to 24/32 bits bit-exact", "[audio_convert]")
+{
+    int16_t *src = convert_test_alloc(CONVERT_TEST_ALL * sizeof(int16_t));
+    uint8_t *dst = convert_test_alloc(CONVERT_TEST_ALL * 4 + AUDIO_SIMD_ALIGN);
+    fill_all_s16(src);
+    audio_dither_t dither;
+    audio_dither_init(&dither, 1);
+
+    // 对齐的缓冲区走向量/按字合成的内核；长度不是 8 的倍数时尾部走标量；增大精度时忽略抖动
+    const uint32_t lengths[] = {CONVERT_TEST_ALL, CONVERT_TEST_ALL - 5};
+    for (int i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++)
+    {
+        memset(dst, 0x55, CONVERT_TEST_ALL * 4);
+        audio_convert_samples(src, AUDIO_SAMPLE_S16, dst, AUDIO_SAMPLE_S24, lengths[i], NULL);
+        check_s24(dst, src, lengths[i]);
+        memset(dst, 0x55, CONVERT_TEST_ALL * 4);
+        audio_convert_samples(src, AUDIO_SAMPLE_S16, dst, AUDIO_SAMPLE_S32, lengths[i], &dither);
+        check_s32((const int32_t *)dst, src, lengths[i]);
+    }
+
+    // 不对齐的输出走标量实现，结果相同
+    audio_convert_samples(src, AUDIO_SAMPLE_S16, dst + 1, AUDIO_SAMPLE_S24, CONVERT_TEST_ALL, NULL);
+    check_s24(dst + 1, src, CONVERT_TEST_ALL);
+    audio_convert_samples(src + 1, AUDIO_SAMPLE_S16, dst + 4, AUDIO_SAMPLE_S32, CONVERT_TEST_ALL - 1, NULL);
+    check_s32((const int32_t *)(dst + 4), src + 1, CONVERT_TEST_ALL - 1);
+
+    // 原地转换从后往前写，不覆盖还没读取的样本
+    memcpy(dst, src, CONVERT_TEST_ALL * sizeof(int16_t));
+    audio_convert_samples(dst, AUDIO_SAMPLE_S16, dst, AUDIO_SAMPLE_S24, CONVERT_TEST_ALL, NULL);
+    check_s24(dst, src, CONVERT_TEST_ALL);
+    memcpy(dst, src, CONVERT_TEST_ALL * sizeof(int16_t));
+    audio_convert_samples(dst, AUDIO_SAMPLE_S16, dst, AUDIO_SAMPLE_S32, CONVERT_TEST_ALL, NULL);
+    check_s32((const int32_t *)dst, src, CONVERT_TEST_ALL);
+
+    // 不加抖动时转回 16 位与原样本逐位相同
+    int16_t *back = convert_test_alloc(CONVERT_TEST_ALL * sizeof(int16_t));
+    audio_convert_samples(dst, AUDIO_SAMPLE_S32, back, AUDIO_SAMPLE_S16, CONVERT_TEST_ALL, NULL);
+    TEST_ASSERT_EQUAL_MEMORY(src, back, CONVERT_TEST_ALL * sizeof(int16_t));
+
+    heap_caps_free(back);
+    heap_caps_free(dst);
+    heap_caps_free(src);
+}
+
+/**
+ * @brief 32 位样本加 TPDF 抖动降为 dst_fmt，统计总误差（以目标格式的 LSB 为单位）
+ *
+ * 输入为 base 附近的慢变信号，含各种小数部分。非减性 TPDF 抖动（±1 LSB）加上取整后，
+ * 总误差在 ±1.5 LSB 以内，均值为 0，方差为 1/4 LSB²，且与信号的小数部分无关。
+ */
+static void check_tpdf(audio_sample_format_t dst_fmt, int32_t base)
+{
+    const uint32_t shift = dst_fmt == AUDIO_SAMPLE_S16 ? 16 : 8;
+    const double lsb = (double)(1u << shift);
+    int32_t *src = convert_test_alloc(CONVERT_TEST_DITHER * sizeof(int32_t));
+    uint8_t *dst = convert_test_alloc(CONVERT_TEST_DITHER * sizeof(int32_t));
+    for (uint32_t i = 0; i < CONVERT_TEST_DITHER; i++)
+    {
+        // 每个样本增加 1/64 LSB 再多一点，小数部分均匀覆盖
+        src[i] = base + (int32_t)((int64_t)i * ((1 << shift) + 3) / 64);
+    }
+    audio_dither_t dither;
+    audio_dither_init(&dither, 12345);
+    audio_convert_samples(src, AUDIO_SAMPLE_S32, dst, dst_fmt, CONVERT_TEST_DITHER, &dither);
+
+    double sum = 0, sum2 = 0, max_abs = 0;
+    uint32_t changed = 0;
+    for (uint32_t i = 0; i < CONVERT_TEST_DITHER; i++)
+    {
+        int32_t y;
+        if (dst_fmt == AUDIO_SAMPLE_S16)
+        {
+            y = ((int16_t *)dst)[i];
+        }
+        else
+        {
+            const uint8_t *p = dst + 3 * i;
+            y = (int32_t)((uint32_t)p[0] << 8 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 24) >> 8;
+        }
+        double e = y - src[i] / lsb;
+        sum += e;
+        sum2 += e * e;
+        max_abs = e > max_abs ? e : (-e > max_abs ? -e : max_abs);
+        // 与四舍五入的结果不同，说明抖动确实生效
+        changed += y != (int32_t)(((int64_t)src[i] + (1 << (shift - 1))) >> shift);
+    }
+    double mean = sum / CONVERT_TEST_DITHER;
+    double var = sum2 / CONVERT_TEST_DITHER - mean * mean;
+    printf("%d-bit TPDF: mean %.4f, variance %.4f, max %.3f LSB, %.1f%% differ from rounding\n",
+           dst_fmt == AUDIO_SAMPLE_S16 ? 16 : 24, mean, var, max_abs, 100.0 * changed / CONVERT_TEST_DITHER);
+    TEST_ASSERT_TRUE(max_abs <= 1.5);
+    TEST_ASSERT_DOUBLE_WITHIN(0.02, 0.0, mean);
+    TEST_ASSERT_DOUBLE_WITHIN(0.03, 0.25, var);
+    TEST_ASSERT_GREATER_THAN_UINT32(CONVERT_TEST_DITHER / 4, changed);
+
+    heap_caps_free(dst);
+    heap_caps_free(src);
+}
+
+TEST_CASE("audio convert TPDF dither stays within bounds", "[audio_convert]")
+{
+    check_tpdf(AUDIO_SAMPLE_S16, -(1 << 24));
+    check_tpdf(AUDIO_SAMPLE_S24, 1 << 20);
+
+    // 抖动序列没有短周期：LCG 低 8 位的周期只有 256，只用低位时 24 位输出每 256 个样本重复一次
+    const uint32_t n = 4096;
+    int32_t *flat = convert_test_alloc(n * sizeof(int32_t));
+    uint8_t *packed = convert_test_alloc(n * 3);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        flat[i] = 0x12345680;
+    }
+    audio_dither_t dither;
+    audio_dither_init(&dither, 99);
+    audio_convert_samples(flat, AUDIO_SAMPLE_S32, packed, AUDIO_SAMPLE_S24, n, &dither);
+    uint32_t repeat = 0;
+    for (uint32_t i = 0; i + 256 < n; i++)
+    {
+        repeat += memcmp(&packed[3 * i], &packed[3 * (i + 256)], 3) == 0;
+    }
+    printf("24-bit TPDF: %.1f%% of samples repeat 256 samples later\n", 100.0 * repeat / (n - 256));
+    // 输出只在两个相邻值之间变化，独立的抖动下约一半相同
+    TEST_ASSERT_LESS_THAN_UINT32((n - 256) * 11 / 20, repeat);
+    heap_caps_free(packed);
+    heap_caps_free(flat);
+
+    // 满量程附近加抖动后饱和，不会回绕
+    int32_t full[8] = {INT32_MAX, INT32_MAX, INT32_MAX, INT32_MAX, INT32_MIN, INT32_MIN, INT32_MIN, INT32_MIN};
+    int16_t out[8];
+    audio_dither_init(&dither, 7);
+    audio_convert_samples(full, AUDIO_SAMPLE_S32, out, AUDIO_SAMPLE_S16, 8, &dither);
+    for (int i = 0; i < 4; i++)
+    {
+        TEST_ASSERT_GREATER_OR_EQUAL_INT32(INT16_MAX - 1, out[i]);
+        TEST_ASSERT_LESS_OR_EQUAL_INT32(INT16_MIN + 1, out[i + 4]);
+    }
+}
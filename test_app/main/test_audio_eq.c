@@ -0,0 +1,290 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <inttypes.h>
+#include "unity.h"
+#include "audio_eq.h"
+// 本文件中 audio_simd_biquad_s32 只用标量实现，与汇编内核逐位比较
+#define AUDIO_SIMD_DISABLE
+#include "audio_simd.h"
+
+#if CONFIG_IDF_TARGET_ESP32S3
+void audio_simd_biquad_s32_aes3(int32_t *x, uint32_t n, uint32_t stride, const int32_t *coef, int32_t *state);
+#endif
+
+#define EQ_TEST_FRAMES  (48000 / 2) // 每种组合处理 0.5 秒
+#define EQ_TEST_BLOCK   480         // 播放任务每次处理 10 ms
+
+// 双精度参考：与 audio_eq 相同的 RBJ 公式，直接 I 型
+typedef struct
+{
+    double b0, b1, b2, a1, a2;
+    double x1, x2, y1, y2;
+} ref_biquad_t;
+
+static void ref_design(ref_biquad_t *f, const audio_eq_band_t *band, uint32_t sample_rate)
+{
+    double A = pow(10.0, band->gain_db / 40.0);
+    double w0 = 2.0 * M_PI * band->freq / sample_rate;
+    double cs = cos(w0);
+    double alpha = sin(w0) / (2.0 * band->q);
+    double sa = 2.0 * sqrt(A) * alpha;
+    double b0, b1, b2, a0, a1, a2;
+    switch (band->type)
+    {
+    case AUDIO_EQ_BAND_PEAK:
+        b0 = 1 + alpha * A, b1 = -2 * cs, b2 = 1 - alpha * A;
+        a0 = 1 + alpha / A, a1 = -2 * cs, a2 = 1 - alpha / A;
+        break;
+    case AUDIO_EQ_BAND_LOW_SHELF:
+        b0 = A * ((A + 1) - (A - 1) * cs + sa), b1 = 2 * A * ((A - 1) - (A + 1) * cs), b2 = A * ((A + 1) - (A - 1) * cs - sa);
+        a0 = (A + 1) + (A - 1) * cs + sa, a1 = -2 * ((A - 1) + (A + 1) * cs), a2 = (A + 1) + (A - 1) * cs - sa;
+        break;
+    case AUDIO_EQ_BAND_HIGH_SHELF:
+        b0 = A * ((A + 1) + (A - 1) * cs + sa), b1 = -2 * A * ((A - 1) + (A + 1) * cs), b2 = A * ((A + 1) + (A - 1) * cs - sa);
+        a0 = (A + 1) - (A - 1) * cs + sa, a1 = 2 * ((A - 1) - (A + 1) * cs), a2 = (A + 1) - (A - 1) * cs - sa;
+        break;
+    case AUDIO_EQ_BAND_LOW_PASS:
+        b0 = (1 - cs) / 2, b1 = 1 - cs, b2 = (1 - cs) / 2;
+        a0 = 1 + alpha, a1 = -2 * cs, a2 = 1 - alpha;
+        break;
+    default:
+        b0 = (1 + cs) / 2, b1 = -(1 + cs), b2 = (1 + cs) / 2;
+        a0 = 1 + alpha, a1 = -2 * cs, a2 = 1 - alpha;
+        break;
+    }
+    *f = (ref_biquad_t){b0 / a0, b1 / a0, b2 / a0, a1 / a0, a2 / a0, 0, 0, 0, 0};
+}
+
+static double ref_process(ref_biquad_t *f, double x)
+{
+    double y = f->b0 * x + f->b1 * f->x1 + f->b2 * f->x2 - f->a1 * f->y1 - f->a2 * f->y2;
+    f->x2 = f->x1, f->x1 = x;
+    f->y2 = f->y1, f->y1 = y;
+    return y;
+}
+
+// 测试信号：低、中、高三个频率的正弦加伪随机噪声，level 为 1 时峰值约 -6 dBFS，增益后不削波
+static int16_t test_signal(uint32_t i, uint32_t ch, uint32_t sample_rate, uint32_t *seed, double level)
+{
+    double t = (double)i / sample_rate;
+    double v = 4000 * sin(2 * M_PI * 60 * t + ch) + 3000 * sin(2 * M_PI * 1000 * t) + 2000 * sin(2 * M_PI * 9000 * t + ch);
+    *seed = *seed * 1664525 + 1013904223;
+    v += (int32_t)(*seed >> 21) - 1024;
+    return (int16_t)lround(v * level);
+}
+
+/**
+ * @brief 把测试信号分块送过定点均衡器和双精度参考，返回输出的最大误差（LSB）
+ */
+static int32_t eq_max_error(const audio_eq_band_t *bands, int band_num, uint32_t sample_rate, double level)
+{
+    const uint8_t channels = 2;
+    audio_eq_handle_t eq;
+    TEST_ASSERT_EQUAL(ESP_OK, audio_eq_create(&eq));
+    ref_biquad_t ref[AUDIO_EQ_CHANNEL_MAX][AUDIO_EQ_BAND_MAX];
+    for (int b = 0; b < band_num; b++)
+    {
+        // 左声道按给定参数，右声道增益取反，检查两个通道的系数互相独立
+        audio_eq_band_t right = bands[b];
+        right.gain_db = -right.gain_db;
+        TEST_ASSERT_EQUAL(ESP_OK, audio_eq_set_band(eq, 0x01, b, &bands[b]));
+        TEST_ASSERT_EQUAL(ESP_OK, audio_eq_set_band(eq, 0x02, b, &right));
+        ref_design(&ref[0][b], &bands[b], sample_rate);
+        ref_design(&ref[1][b], &right, sample_rate);
+    }
+
+    int16_t *pcm = malloc(EQ_TEST_BLOCK * channels * sizeof(int16_t));
+    TEST_ASSERT_NOT_NULL(pcm);
+    int32_t max_err = 0;
+    uint32_t seed[2] = {1, 2};
+    uint32_t ref_seed[2] = {1, 2};
+    for (uint32_t done = 0; done < EQ_TEST_FRAMES; done += EQ_TEST_BLOCK)
+    {
+        for (uint32_t i = 0; i < EQ_TEST_BLOCK; i++)
+        {
+            for (uint32_t ch = 0; ch < channels; ch++)
+            {
+                pcm[i * channels + ch] = test_signal(done + i, ch, sample_rate, &seed[ch], level);
+            }
+        }
+        // 第一次处理时采样率从 0 变为 sample_rate，系数直接生效，不做过渡
+        audio_eq_process(eq, pcm, EQ_TEST_BLOCK, channels, sample_rate);
+        for (uint32_t i = 0; i < EQ_TEST_BLOCK; i++)
+        {
+            for (uint32_t ch = 0; ch < channels; ch++)
+            {
+                double y = test_signal(done + i, ch, sample_rate, &ref_seed[ch], level);
+                for (int b = 0; b < band_num; b++)
+                {
+                    y = ref_process(&ref[ch][b], y);
+                }
+                long expect = lround(y);
+                TEST_ASSERT_TRUE_MESSAGE(expect >= INT16_MIN && expect <= INT16_MAX, "reference clipped");
+                int32_t err = abs(pcm[i * channels + ch] - (int32_t)expect);
+                max_err = err > max_err ? err : max_err;
+            }
+        }
+    }
+    free(pcm);
+    audio_eq_delete(eq);
+    return max_err;
+}
+
+TEST_CASE("audio eq Q-format biquads match a double-precision reference", "[audio_eq]")
+{
+    const struct
+    {
+        const char *name;
+        audio_eq_band_t bands[3];
+        int band_num;
+        int32_t max_lsb; // 允许的最大误差（16 位 LSB）
+    } cases[] = {
+        {"peak 1 kHz +6 dB", {{AUDIO_EQ_BAND_PEAK, 1000, 6, 1.0f}}, 1, 2},
+        // 低频高 Q 的极点贴近单位圆，Q29 系数的量化误差被放大，实测 44.1 kHz 下 4 LSB
+        {"narrow peak 60 Hz -12 dB", {{AUDIO_EQ_BAND_PEAK, 60, -12, 8.0f}}, 1, 8},
+        {"low shelf 80 Hz +9 dB", {{AUDIO_EQ_BAND_LOW_SHELF, 80, 9, 0.707f}}, 1, 2},
+        {"high shelf 8 kHz -6 dB", {{AUDIO_EQ_BAND_HIGH_SHELF, 8000, -6, 0.707f}}, 1, 2},
+        {"low pass 5 kHz", {{AUDIO_EQ_BAND_LOW_PASS, 5000, 0, 0.707f}}, 1, 2},
+        {"high pass 30 Hz", {{AUDIO_EQ_BAND_HIGH_PASS, 30, 0, 0.707f}}, 1, 2},
+        {"three bands", {{AUDIO_EQ_BAND_LOW_SHELF, 100, 4, 0.707f}, {AUDIO_EQ_BAND_PEAK, 2500, -5, 1.4f},
+                         {AUDIO_EQ_BAND_HIGH_SHELF, 10000, 3, 0.707f}}, 3, 2},
+    };
+    const uint32_t rates[] = {44100, 48000};
+    for (int r = 0; r < sizeof(rates) / sizeof(rates[0]); r++)
+    {
+        for (int i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+        {
+            int32_t err = eq_max_error(cases[i].bands, cases[i].band_num, rates[r], 1.0);
+            printf("%" PRIu32 " Hz %s: max error %" PRIi32 " LSB\n", rates[r], cases[i].name, err);
+            TEST_ASSERT_LESS_OR_EQUAL_INT32(cases[i].max_lsb, err);
+        }
+    }
+}
+
+// 双精度参考在 freq 处的幅度响应（dB）
+static double ref_response_db(const audio_eq_band_t *band, double freq, uint32_t sample_rate)
+{
+    ref_biquad_t f;
+    ref_design(&f, band, sample_rate);
+    double w = 2 * M_PI * freq / sample_rate;
+    double nr = f.b0 + f.b1 * cos(w) + f.b2 * cos(2 * w), ni = -f.b1 * sin(w) - f.b2 * sin(2 * w);
+    double dr = 1 + f.a1 * cos(w) + f.a2 * cos(2 * w), di = -f.a1 * sin(w) - f.a2 * sin(2 * w);
+    return 10 * log10((nr * nr + ni * ni) / (dr * dr + di * di));
+}
+
+// 单声道正弦通过均衡器，滤波器稳定后按同相/正交分量测量 freq 处的增益（dB）
+static double eq_measure_db(audio_eq_handle_t eq, double freq, uint32_t sample_rate)
+{
+    const double amp = 1000;
+    int16_t *pcm = malloc(EQ_TEST_BLOCK * sizeof(int16_t));
+    TEST_ASSERT_NOT_NULL(pcm);
+    audio_eq_reset(eq);
+    // 在后一半时间里取整数个周期（前一半等待滤波器稳定），避免频谱泄漏
+    uint32_t meas = lround(floor(EQ_TEST_FRAMES / 2 * freq / sample_rate) * sample_rate / freq);
+    double re = 0, im = 0;
+    for (uint32_t done = 0; done < EQ_TEST_FRAMES; done += EQ_TEST_BLOCK)
+    {
+        for (uint32_t i = 0; i < EQ_TEST_BLOCK; i++)
+        {
+            pcm[i] = (int16_t)lround(amp * sin(2 * M_PI * freq * (done + i) / sample_rate));
+        }
+        audio_eq_process(eq, pcm, EQ_TEST_BLOCK, 1, sample_rate);
+        for (uint32_t i = 0; i < EQ_TEST_BLOCK; i++)
+        {
+            if (done + i < EQ_TEST_FRAMES - meas)
+            {
+                continue;
+            }
+            double ph = 2 * M_PI * freq * (done + i) / sample_rate;
+            re += pcm[i] * sin(ph);
+            im += pcm[i] * cos(ph);
+        }
+    }
+    free(pcm);
+    return 20 * log10(2 * sqrt(re * re + im * im) / meas / amp);
+}
+
+TEST_CASE("audio eq high-gain boosts reach the designed response", "[audio_eq]")
+{
+    // 这些频段的前馈系数超出 Q29 的 ±4（搁架滤波器 15 dB 时可达 ±11.3）
+    const audio_eq_band_t bands[] = {
+        {AUDIO_EQ_BAND_LOW_SHELF, 100, 12, 0.707f},
+        {AUDIO_EQ_BAND_LOW_SHELF, 100, 15, 0.707f},
+        {AUDIO_EQ_BAND_HIGH_SHELF, 100, 15, 0.707f},
+        {AUDIO_EQ_BAND_HIGH_SHELF, 1000, 8, 0.707f},
+        {AUDIO_EQ_BAND_HIGH_SHELF, 8000, 15, 2.0f},
+        {AUDIO_EQ_BAND_PEAK, 1000, 12, 1.0f},
+        {AUDIO_EQ_BAND_PEAK, 3000, 15, 0.1f},
+    };
+    const double probes[] = {40, 100, 1000, 8000};
+    const uint32_t rates[] = {44100, 48000};
+    for (int r = 0; r < sizeof(rates) / sizeof(rates[0]); r++)
+    {
+        for (int b = 0; b < sizeof(bands) / sizeof(bands[0]); b++)
+        {
+            audio_eq_handle_t eq;
+            TEST_ASSERT_EQUAL(ESP_OK, audio_eq_create(&eq));
+            TEST_ASSERT_EQUAL(ESP_OK, audio_eq_set_band(eq, 0x01, 0, &bands[b]));
+            for (int p = 0; p < sizeof(probes) / sizeof(probes[0]); p++)
+            {
+                double expect = ref_response_db(&bands[b], probes[p], rates[r]);
+                double got = eq_measure_db(eq, probes[p], rates[r]);
+                printf("%" PRIu32 " Hz band %d %.0f Hz %+.0f dB @ %.0f Hz: %+.3f dB (expect %+.3f)\n", rates[r],
+                       bands[b].type, bands[b].freq, bands[b].gain_db, probes[p], got, expect);
+                TEST_ASSERT_DOUBLE_WITHIN(0.05, expect, got);
+            }
+            audio_eq_delete(eq);
+
+            // 样本级误差：信号降低 12 dB 以免参考削波，右声道为对应的衰减
+            int32_t err = eq_max_error(&bands[b], 1, rates[r], 0.25);
+            printf("%" PRIu32 " Hz band %d: max error %" PRIi32 " LSB\n", rates[r], bands[b].type, err);
+            TEST_ASSERT_LESS_OR_EQUAL_INT32(2, err);
+        }
+    }
+}
+
+#if CONFIG_IDF_TARGET_ESP32S3
+TEST_CASE("audio eq biquad assembly kernel matches the scalar loop bit-exact", "[audio_eq]")
+{
+    enum { N = 1024, STRIDE = 2 };
+    static int32_t x_asm[N * STRIDE], x_ref[N * STRIDE];
+    const audio_eq_band_t bands[] = {
+        {AUDIO_EQ_BAND_PEAK, 60, -12, 8.0f},
+        {AUDIO_EQ_BAND_LOW_SHELF, 80, 9, 0.707f},
+        {AUDIO_EQ_BAND_HIGH_PASS, 30, 0, 0.707f},
+        {AUDIO_EQ_BAND_LOW_PASS, 15000, 0, 0.707f},
+    };
+    uint32_t seed = 3;
+    for (int b = 0; b < sizeof(bands) / sizeof(bands[0]); b++)
+    {
+        ref_biquad_t f;
+        ref_design(&f, &bands[b], 48000);
+        const double c[5] = {f.b0, f.b1, f.b2, -f.a1, -f.a2};
+        int32_t coef[5];
+        for (int i = 0; i < 5; i++)
+        {
+            coef[i] = (int32_t)lround(c[i] * (1 << 29));
+        }
+        // 满幅度的 Q27 样本和任意初始状态（含余数），覆盖乘积和累加的回绕
+        for (int i = 0; i < N * STRIDE; i++)
+        {
+            seed = seed * 1664525 + 1013904223;
+            x_asm[i] = x_ref[i] = (int32_t)seed >> 4;
+        }
+        int32_t state_asm[5], state_ref[5];
+        for (int i = 0; i < 5; i++)
+        {
+            seed = seed * 1664525 + 1013904223;
+            state_asm[i] = state_ref[i] = i < 4 ? (int32_t)seed >> 4 : (int32_t)(seed & 0x3FFFFFF);
+        }
+        // 汇编内核一次处理两个样本，分两段调用检查状态的保存和恢复
+        audio_simd_biquad_s32_aes3(x_asm, N / 2, STRIDE * sizeof(int32_t), coef, state_asm);
+        audio_simd_biquad_s32_aes3(x_asm + N / 2 * STRIDE, N / 2, STRIDE * sizeof(int32_t), coef, state_asm);
+        audio_simd_biquad_s32(x_ref, N, STRIDE, coef, state_ref);
+        TEST_ASSERT_EQUAL_INT32_ARRAY(x_ref, x_asm, N * STRIDE);
+        TEST_ASSERT_EQUAL_INT32_ARRAY(state_ref, state_asm, 5);
+    }
+}
+#endif
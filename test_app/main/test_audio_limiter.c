@@ -0,0 +1,215 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <inttypes.h>
+#include "unity.h"
+#include "audio_limiter.h"
+
+#define LIMITER_TEST_RATE  48000
+#define LIMITER_TEST_BLOCK 480 // 播放任务每次处理 10 ms
+
+// 信号发生器，i 为帧序号
+typedef int16_t (*limiter_test_signal_t)(uint32_t i, uint32_t ch);
+
+static audio_limiter_handle_t limiter_test_create(uint32_t lookahead_ms, uint32_t release_ms, float ceiling_db)
+{
+    const audio_limiter_config_t config = {
+        .lookahead_ms = lookahead_ms,
+        .release_ms = release_ms,
+        .ceiling_db = ceiling_db,
+    };
+    audio_limiter_handle_t limiter;
+    TEST_ASSERT_EQUAL(ESP_OK, audio_limiter_create(&config, &limiter));
+    return limiter;
+}
+
+/**
+ * @brief 分块送入 frames 帧双声道信号，out 不为 NULL 时保存输出
+ *
+ * @return 输出的最大样本绝对值
+ */
+static int32_t limiter_run(audio_limiter_handle_t limiter, limiter_test_signal_t signal, uint32_t start, uint32_t frames,
+                           int16_t *out)
+{
+    int16_t pcm[LIMITER_TEST_BLOCK * 2];
+    int32_t peak = 0;
+    for (uint32_t done = 0; done < frames; done += LIMITER_TEST_BLOCK)
+    {
+        for (uint32_t i = 0; i < LIMITER_TEST_BLOCK; i++)
+        {
+            pcm[2 * i] = signal(start + done + i, 0);
+            pcm[2 * i + 1] = signal(start + done + i, 1);
+        }
+        audio_limiter_process(limiter, pcm, LIMITER_TEST_BLOCK, 2, LIMITER_TEST_RATE);
+        for (uint32_t i = 0; i < LIMITER_TEST_BLOCK * 2; i++)
+        {
+            int32_t v = abs(pcm[i]);
+            peak = v > peak ? v : peak;
+        }
+        if (out)
+        {
+            memcpy(out + done * 2, pcm, sizeof(pcm));
+        }
+    }
+    return peak;
+}
+
+static int32_t limiter_test_ceiling(float ceiling_db)
+{
+    return (int32_t)(32767.0f * powf(10.0f, ceiling_db / 20.0f));
+}
+
+// 满幅度方波和伪随机噪声交替出现，前 0.1 秒为静音，检查前瞻能赶上突发
+static int16_t signal_full_scale(uint32_t i, uint32_t ch)
+{
+    if (i < LIMITER_TEST_RATE / 10)
+    {
+        return 0;
+    }
+    if ((i / 4800) % 2 == 0)
+    {
+        return (i / 24 + ch) % 2 ? INT16_MAX : INT16_MIN;
+    }
+    uint32_t x = (i * 2 + ch) * 2654435761u;
+    x ^= x >> 15;
+    return (int16_t)(x * 2246822519u >> 16);
+}
+
+// fs/4 正弦，相位 45°：样本只有 ±0.707，真峰值 0 dBFS 落在采样点之间
+static int16_t signal_fs4_45deg(uint32_t i, uint32_t ch)
+{
+    return (int16_t)lround(32767.0 * sin(M_PI / 2 * i + M_PI / 4));
+}
+
+TEST_CASE("audio limiter output never exceeds the ceiling", "[audio_limiter]")
+{
+    const float ceilings[] = {-0.1f, -1.0f, -6.0f};
+    for (int c = 0; c < sizeof(ceilings) / sizeof(ceilings[0]); c++)
+    {
+        int32_t ceiling = limiter_test_ceiling(ceilings[c]);
+        audio_limiter_handle_t limiter = limiter_test_create(2, 50, ceilings[c]);
+        int32_t peak = limiter_run(limiter, signal_full_scale, 0, LIMITER_TEST_RATE, NULL);
+        printf("ceiling %.1f dBFS (%" PRIi32 "): full-scale sample peak %" PRIi32 "\n", ceilings[c], ceiling, peak);
+        TEST_ASSERT_LESS_OR_EQUAL_INT32(ceiling, peak);
+        audio_limiter_delete(limiter);
+    }
+}
+
+TEST_CASE("audio limiter catches the inter-sample peak of an fs/4 sine", "[audio_limiter]")
+{
+    const uint32_t frames = LIMITER_TEST_RATE / 2;
+    int16_t *out = malloc(frames * 2 * sizeof(int16_t));
+    TEST_ASSERT_NOT_NULL(out);
+    const float ceilings[] = {-0.1f, -1.0f, -3.0f};
+    for (int c = 0; c < sizeof(ceilings) / sizeof(ceilings[0]); c++)
+    {
+        int32_t ceiling = limiter_test_ceiling(ceilings[c]);
+        audio_limiter_handle_t limiter = limiter_test_create(2, 50, ceilings[c]);
+        limiter_run(limiter, signal_fs4_45deg, 0, frames, out);
+        // fs/4 正弦相邻两个样本相差 90°，真峰值为 sqrt(y[n]² + y[n+1]²)；跳过开头的延迟和起音
+        double true_peak = 0;
+        for (uint32_t i = frames / 4; i + 1 < frames; i++)
+        {
+            for (uint32_t ch = 0; ch < 2; ch++)
+            {
+                double a = out[2 * i + ch], b = out[2 * i + 2 + ch];
+                double v = sqrt(a * a + b * b);
+                true_peak = v > true_peak ? v : true_peak;
+            }
+        }
+        printf("ceiling %.1f dBFS (%" PRIi32 "): fs/4 true peak %.1f\n", ceilings[c], ceiling, true_peak);
+        // 输出样本取整，允许 1 LSB
+        TEST_ASSERT_TRUE(true_peak <= ceiling + 1.0);
+        audio_limiter_delete(limiter);
+    }
+    free(out);
+}
+
+// 第 LIMITER_TEST_RATE / 10 帧处的单个脉冲，低于上限，不会被衰减
+static int16_t signal_impulse(uint32_t i, uint32_t ch)
+{
+    return i == LIMITER_TEST_RATE / 10 ? 10000 : 0;
+}
+
+TEST_CASE("audio limiter reported latency matches the delay and covers the look-ahead", "[audio_limiter]")
+{
+    const uint32_t frames = LIMITER_TEST_RATE / 5;
+    int16_t *out = malloc(frames * 2 * sizeof(int16_t));
+    TEST_ASSERT_NOT_NULL(out);
+    for (uint32_t ms = AUDIO_LIMITER_LOOKAHEAD_MIN_MS; ms <= AUDIO_LIMITER_LOOKAHEAD_MAX_MS; ms++)
+    {
+        audio_limiter_handle_t limiter = limiter_test_create(ms, 50, -1.0f);
+        limiter_run(limiter, signal_impulse, 0, frames, out);
+        uint32_t latency = audio_limiter_get_latency_frames(limiter);
+        uint32_t delay = 0;
+        while (delay < frames && out[2 * delay] == 0)
+        {
+            delay++;
+        }
+        delay -= LIMITER_TEST_RATE / 10;
+        printf("look-ahead %" PRIu32 " ms: reported %" PRIu32 " frames, measured %" PRIu32 " frames\n", ms, latency,
+               delay);
+        TEST_ASSERT_EQUAL_UINT32(latency, delay);
+        TEST_ASSERT_EQUAL_INT16(10000, out[2 * (delay + LIMITER_TEST_RATE / 10)]);
+        // 前瞻按块向上取整，再多一块等待峰值算完
+        uint32_t lookahead = ms * LIMITER_TEST_RATE / 1000;
+        TEST_ASSERT_GREATER_OR_EQUAL_UINT32(lookahead + AUDIO_LIMITER_BLOCK, latency);
+        TEST_ASSERT_LESS_THAN_UINT32(lookahead + 2 * AUDIO_LIMITER_BLOCK, latency);
+        audio_limiter_delete(limiter);
+    }
+    free(out);
+}
+
+// 1 kHz 正弦，-20 dBFS 或 0 dBFS
+static int16_t signal_quiet(uint32_t i, uint32_t ch)
+{
+    return (int16_t)lround(3277.0 * sin(2 * M_PI * 1000 * i / LIMITER_TEST_RATE));
+}
+
+static int16_t signal_loud(uint32_t i, uint32_t ch)
+{
+    return (int16_t)lround(32767.0 * sin(2 * M_PI * 1000 * i / LIMITER_TEST_RATE));
+}
+
+TEST_CASE("audio limiter gain-reduction stats", "[audio_limiter]")
+{
+    audio_limiter_handle_t limiter = limiter_test_create(2, 20, -3.0f);
+    audio_limiter_stats_t stats;
+    audio_limiter_get_stats(limiter, &stats);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.total_seconds);
+
+    // 统计在处理满一秒的那一次调用开始时发布
+    limiter_run(limiter, signal_quiet, 0, 2 * LIMITER_TEST_RATE, NULL);
+    audio_limiter_get_stats(limiter, &stats);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.total_seconds);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.limited_seconds);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.limited_per_sec);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, stats.max_reduction_db);
+
+    limiter_run(limiter, signal_loud, 2 * LIMITER_TEST_RATE, LIMITER_TEST_RATE, NULL);
+    audio_limiter_get_stats(limiter, &stats);
+    printf("loud: %" PRIu32 " limited samples, max reduction %.2f dB\n", stats.limited_per_sec, stats.max_reduction_db);
+    TEST_ASSERT_EQUAL_UINT32(3, stats.total_seconds);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.limited_seconds);
+    // 除了延迟线中还没播出的开头，几乎所有样本都被衰减
+    TEST_ASSERT_GREATER_THAN_UINT32(LIMITER_TEST_RATE * 2 * 9 / 10, stats.limited_per_sec);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 3.0f, stats.max_reduction_db);
+
+    // 安静下来之后增益按 release 时间常数恢复（20 ms 约需 150 ms 回到 1），这一秒只有开头的样本被衰减
+    limiter_run(limiter, signal_quiet, 3 * LIMITER_TEST_RATE, LIMITER_TEST_RATE, NULL);
+    audio_limiter_get_stats(limiter, &stats);
+    printf("release: %" PRIu32 " limited samples, max reduction %.2f dB\n", stats.limited_per_sec,
+           stats.max_reduction_db);
+    TEST_ASSERT_EQUAL_UINT32(4, stats.total_seconds);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.limited_seconds);
+    TEST_ASSERT_LESS_THAN_UINT32(LIMITER_TEST_RATE * 2 / 5, stats.limited_per_sec);
+
+    limiter_run(limiter, signal_quiet, 4 * LIMITER_TEST_RATE, LIMITER_TEST_RATE, NULL);
+    audio_limiter_get_stats(limiter, &stats);
+    TEST_ASSERT_EQUAL_UINT32(5, stats.total_seconds);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.limited_seconds);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.limited_per_sec);
+    audio_limiter_delete(limiter);
+}
@@ -0,0 +1,187 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "unity.h"
+#include "esp_vfs_fat.h"
+#include "audio_loudness.h"
+#include "audio_loudness_cache.h"
+
+#define LOUDNESS_TEST_BASE  "/data"
+#define LOUDNESS_TEST_CACHE LOUDNESS_TEST_BASE "/ldc.bin"
+#define LOUDNESS_TEST_FILE  LOUDNESS_TEST_BASE "/ld.raw"
+#define LOUDNESS_TEST_BLOCK 1024 // 每次输入的帧数
+
+/**
+ * @brief 输入 seconds 秒双声道 1 kHz 正弦（16 位），两个通道同相，幅度为 level_db dBFS
+ */
+static void loudness_add_sine(audio_loudness_handle_t meter, uint32_t sample_rate, double level_db, uint32_t seconds,
+                              uint32_t *phase)
+{
+    int16_t *pcm = malloc(LOUDNESS_TEST_BLOCK * 2 * sizeof(int16_t));
+    TEST_ASSERT_NOT_NULL(pcm);
+    double amp = 32767.0 * pow(10.0, level_db / 20.0);
+    for (uint32_t done = 0; done < seconds * sample_rate; done += LOUDNESS_TEST_BLOCK)
+    {
+        for (uint32_t i = 0; i < LOUDNESS_TEST_BLOCK; i++, (*phase)++)
+        {
+            int16_t v = (int16_t)lround(amp * sin(2 * M_PI * 1000 * *phase / sample_rate));
+            pcm[2 * i] = v;
+            pcm[2 * i + 1] = v;
+        }
+        audio_loudness_add(meter, (const uint8_t *)pcm, LOUDNESS_TEST_BLOCK, 16);
+    }
+    free(pcm);
+}
+
+TEST_CASE("audio loudness reads a -20 dBFS stereo 1 kHz sine as -20 LUFS", "[audio_loudness]")
+{
+    // EBU Tech 3341：两个通道各为 1 kHz、-20 dBFS 的正弦，积分响度为 -20 LUFS
+    const uint32_t rates[] = {44100, 48000};
+    for (int r = 0; r < sizeof(rates) / sizeof(rates[0]); r++)
+    {
+        audio_loudness_handle_t meter;
+        TEST_ASSERT_EQUAL(ESP_OK, audio_loudness_create(rates[r], 2, &meter));
+        uint32_t phase = 0;
+        loudness_add_sine(meter, rates[r], -20.0, 5, &phase);
+        float lufs, peak;
+        audio_loudness_get(meter, &lufs, &peak);
+        printf("%lu Hz: %.3f LUFS, %.3f dBTP\n", (unsigned long)rates[r], lufs, peak);
+        TEST_ASSERT_FLOAT_WITHIN(0.1f, -20.0f, lufs);
+        TEST_ASSERT_FLOAT_WITHIN(0.1f, -20.0f, peak);
+        audio_loudness_delete(meter);
+    }
+}
+
+/**
+ * @brief BS.1770 门限的参考实现：已知每个 100 ms 子块的响度，400 ms 块由相邻 4 个子块组成
+ */
+static double ref_gated_lufs(const double *sub_lufs, int sub_num)
+{
+    double block[64];
+    int block_num = 0;
+    for (int j = 3; j < sub_num; j++)
+    {
+        double e = 0;
+        for (int k = j - 3; k <= j; k++)
+        {
+            e += pow(10.0, (sub_lufs[k] + 0.691) / 10.0) / 4;
+        }
+        block[block_num++] = -0.691 + 10 * log10(e);
+    }
+    double gate = -70.0;
+    double lufs = AUDIO_LOUDNESS_SILENCE;
+    // 第一遍用绝对门限，第二遍用比第一遍结果低 10 LU 的相对门限
+    for (int pass = 0; pass < 2; pass++)
+    {
+        double e = 0;
+        int n = 0;
+        for (int j = 0; j < block_num; j++)
+        {
+            if (block[j] > gate)
+            {
+                e += pow(10.0, (block[j] + 0.691) / 10.0);
+                n++;
+            }
+        }
+        if (n == 0)
+        {
+            return AUDIO_LOUDNESS_SILENCE;
+        }
+        lufs = -0.691 + 10 * log10(e / n);
+        gate = lufs - 10.0;
+    }
+    return lufs;
+}
+
+TEST_CASE("audio loudness gates out quiet sections", "[audio_loudness]")
+{
+    const uint32_t rate = 48000;
+    // 依次输入的各段正弦（dBFS，每段 2 秒），1 kHz 正弦的响度与电平相同
+    const double levels[] = {-80.0, -20.0, -40.0};
+    double sub_lufs[60];
+    int sub_num = 0;
+    audio_loudness_handle_t meter;
+    TEST_ASSERT_EQUAL(ESP_OK, audio_loudness_create(rate, 2, &meter));
+    uint32_t phase = 0;
+    for (int i = 0; i < sizeof(levels) / sizeof(levels[0]); i++)
+    {
+        loudness_add_sine(meter, rate, levels[i], 2, &phase);
+        for (int k = 0; k < 20; k++)
+        {
+            sub_lufs[sub_num++] = levels[i];
+        }
+        float lufs, peak;
+        audio_loudness_get(meter, &lufs, &peak);
+        double expect = ref_gated_lufs(sub_lufs, sub_num);
+        printf("after %.0f dBFS section: %.3f LUFS (reference %.3f)\n", levels[i], lufs, expect);
+        TEST_ASSERT_FLOAT_WITHIN(0.1f, expect, lufs);
+    }
+    // -80 LUFS 的一段低于绝对门限，-40 LUFS 的一段被相对门限去掉，只剩跨越交界的块
+    // 使结果略低于 -20 LUFS（约 -20.6）；不加门限时约为 -24.8 LUFS
+    float lufs, peak;
+    audio_loudness_get(meter, &lufs, &peak);
+    TEST_ASSERT_GREATER_THAN_FLOAT(-21.0f, lufs);
+    audio_loudness_delete(meter);
+
+    // 只有低于绝对门限的信号时没有有效块
+    TEST_ASSERT_EQUAL(ESP_OK, audio_loudness_create(rate, 2, &meter));
+    loudness_add_sine(meter, rate, -80.0, 2, &phase);
+    audio_loudness_get(meter, &lufs, &peak);
+    TEST_ASSERT_EQUAL_FLOAT(AUDIO_LOUDNESS_SILENCE, lufs);
+    audio_loudness_delete(meter);
+}
+
+static wl_handle_t s_wl = WL_INVALID_HANDLE;
+
+static void loudness_test_write(const char *path, size_t len)
+{
+    FILE *f = fopen(path, "wb");
+    TEST_ASSERT_NOT_NULL(f);
+    for (size_t i = 0; i < len; i++)
+    {
+        fputc((int)(i & 0xFF), f);
+    }
+    fclose(f);
+}
+
+TEST_CASE("audio loudness cache round-trip", "[audio_loudness]")
+{
+    const esp_vfs_fat_mount_config_t config = {
+        .format_if_mount_failed = true,
+        .max_files = 2,
+        .allocation_unit_size = 4096,
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, esp_vfs_fat_spiflash_mount_rw_wl(LOUDNESS_TEST_BASE, "storage", &config, &s_wl));
+    remove(LOUDNESS_TEST_CACHE);
+    loudness_test_write(LOUDNESS_TEST_FILE, 1000);
+
+    float lufs = 0, peak = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, audio_loudness_cache_init(LOUDNESS_TEST_CACHE));
+    TEST_ASSERT_FALSE(audio_loudness_cache_lookup(LOUDNESS_TEST_FILE, &lufs, &peak));
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, audio_loudness_cache_store(LOUDNESS_TEST_BASE "/none.raw", -10.0f, -1.0f));
+    TEST_ASSERT_EQUAL(ESP_OK, audio_loudness_cache_store(LOUDNESS_TEST_FILE, -14.25f, -0.5f));
+    TEST_ASSERT_TRUE(audio_loudness_cache_lookup(LOUDNESS_TEST_FILE, &lufs, &peak));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, -14.25f, lufs);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, -0.5f, peak);
+
+    // 重新读入缓存文件，记录仍然有效；同一文件重新扫描时取最新的记录
+    audio_loudness_cache_clear();
+    TEST_ASSERT_EQUAL(ESP_OK, audio_loudness_cache_init(LOUDNESS_TEST_CACHE));
+    TEST_ASSERT_TRUE(audio_loudness_cache_lookup(LOUDNESS_TEST_FILE, &lufs, &peak));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, -14.25f, lufs);
+    TEST_ASSERT_EQUAL(ESP_OK, audio_loudness_cache_store(LOUDNESS_TEST_FILE, -16.5f, -2.0f));
+    TEST_ASSERT_TRUE(audio_loudness_cache_lookup(LOUDNESS_TEST_FILE, &lufs, &peak));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, -16.5f, lufs);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, -2.0f, peak);
+
+    // 文件被替换（大小改变）后记录失效
+    loudness_test_write(LOUDNESS_TEST_FILE, 2000);
+    TEST_ASSERT_FALSE(audio_loudness_cache_lookup(LOUDNESS_TEST_FILE, &lufs, &peak));
+
+    audio_loudness_cache_clear();
+    remove(LOUDNESS_TEST_FILE);
+    remove(LOUDNESS_TEST_CACHE);
+    TEST_ASSERT_EQUAL(ESP_OK, esp_vfs_fat_spiflash_unmount_rw_wl(LOUDNESS_TEST_BASE, s_wl));
+    s_wl = WL_INVALID_HANDLE;
+}
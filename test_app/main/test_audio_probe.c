@@ -0,0 +1,188 @@
+#include <stdint.h>
+#include <string.h>
+#include "unity.h"
+#include "audio_probe.h"
+
+// MPEG1 Layer III 128 kbps 44.1 kHz 联合立体声，无 CRC
+static const uint8_t s_mp3_hdr[4] = {0xFF, 0xFB, 0x90, 0x64};
+
+// 写 ID3v2.4 标签头，size 为标签体长度（同步安全整数）
+static size_t put_id3v2(uint8_t *buf, uint32_t size, bool footer)
+{
+    const uint8_t hdr[10] = {'I', 'D', '3', 4, 0, footer ? 0x10 : 0, (size >> 21) & 0x7F, (size >> 14) & 0x7F,
+                             (size >> 7) & 0x7F, size & 0x7F};
+    memcpy(buf, hdr, sizeof(hdr));
+    return size + 10 + (footer ? 10 : 0);
+}
+
+// 写 ADTS 帧头（AAC LC 立体声），不带 CRC
+static void put_adts(uint8_t *p, uint8_t rate_idx, uint32_t frame_len, uint8_t raw_blocks)
+{
+    p[0] = 0xFF;
+    p[1] = 0xF1;
+    p[2] = (1 << 6) | (rate_idx << 2);
+    p[3] = (2 << 6) | ((frame_len >> 11) & 0x03);
+    p[4] = (frame_len >> 3) & 0xFF;
+    p[5] = ((frame_len & 0x07) << 5) | 0x1F;
+    p[6] = 0xFC | (raw_blocks & 0x03);
+}
+
+// 不含 0xFF 的填充数据，不会被误认为同步字
+static void fill_junk(uint8_t *p, size_t len)
+{
+    for (size_t i = 0; i < len; i++)
+    {
+        p[i] = (uint8_t)(i * 37 % 251);
+    }
+}
+
+TEST_CASE("audio probe parses MP3 frame headers", "[audio_probe]")
+{
+    audio_probe_frame_t f;
+    TEST_ASSERT_TRUE(audio_probe_mp3_frame(s_mp3_hdr, &f));
+    TEST_ASSERT_EQUAL_UINT32(417, f.frame_len);
+    TEST_ASSERT_EQUAL_UINT32(1152, f.samples);
+    TEST_ASSERT_EQUAL_UINT32(44100, f.sample_rate);
+    TEST_ASSERT_EQUAL_UINT32(32, f.side_len);
+
+    // 填充位加一个字节，带 CRC 时边信息多 2 字节
+    const uint8_t padded_crc[4] = {0xFF, 0xFA, 0x92, 0x64};
+    TEST_ASSERT_TRUE(audio_probe_mp3_frame(padded_crc, &f));
+    TEST_ASSERT_EQUAL_UINT32(418, f.frame_len);
+    TEST_ASSERT_EQUAL_UINT32(34, f.side_len);
+
+    // MPEG2 64 kbps 22.05 kHz 单声道
+    const uint8_t mpeg2[4] = {0xFF, 0xF3, 0x80, 0xC0};
+    TEST_ASSERT_TRUE(audio_probe_mp3_frame(mpeg2, &f));
+    TEST_ASSERT_EQUAL_UINT32(208, f.frame_len);
+    TEST_ASSERT_EQUAL_UINT32(576, f.samples);
+    TEST_ASSERT_EQUAL_UINT32(22050, f.sample_rate);
+    TEST_ASSERT_EQUAL_UINT32(9, f.side_len);
+
+    // MPEG2.5 8 kbps 8 kHz
+    const uint8_t mpeg25[4] = {0xFF, 0xE3, 0x18, 0xC0};
+    TEST_ASSERT_TRUE(audio_probe_mp3_frame(mpeg25, &f));
+    TEST_ASSERT_EQUAL_UINT32(72, f.frame_len);
+    TEST_ASSERT_EQUAL_UINT32(8000, f.sample_rate);
+}
+
+TEST_CASE("audio probe rejects invalid MP3 and ADTS headers", "[audio_probe]")
+{
+    audio_probe_frame_t f;
+    const uint8_t bad_mp3[][4] = {
+        {0xFE, 0xFB, 0x90, 0x64}, // 同步字不完整
+        {0xFF, 0xDB, 0x90, 0x64}, // 同步字不完整
+        {0xFF, 0xEB, 0x90, 0x64}, // 保留的版本号
+        {0xFF, 0xFD, 0x90, 0x64}, // Layer II
+        {0xFF, 0xF9, 0x90, 0x64}, // layer 0 即 ADTS
+        {0xFF, 0xFB, 0x00, 0x64}, // 自由格式比特率
+        {0xFF, 0xFB, 0xF0, 0x64}, // 无效比特率
+        {0xFF, 0xFB, 0x9C, 0x64}, // 保留的采样率
+    };
+    for (int i = 0; i < sizeof(bad_mp3) / sizeof(bad_mp3[0]); i++)
+    {
+        TEST_ASSERT_FALSE(audio_probe_mp3_frame(bad_mp3[i], &f));
+    }
+
+    uint8_t adts[7];
+    put_adts(adts, 4, 371, 0);
+    TEST_ASSERT_TRUE(audio_probe_adts_frame(adts, &f));
+    TEST_ASSERT_EQUAL_UINT32(371, f.frame_len);
+    TEST_ASSERT_EQUAL_UINT32(1024, f.samples);
+    TEST_ASSERT_EQUAL_UINT32(44100, f.sample_rate);
+    TEST_ASSERT_EQUAL_UINT32(0, f.side_len);
+    // 一帧多个原始数据块
+    put_adts(adts, 3, 1500, 3);
+    TEST_ASSERT_TRUE(audio_probe_adts_frame(adts, &f));
+    TEST_ASSERT_EQUAL_UINT32(4096, f.samples);
+    TEST_ASSERT_EQUAL_UINT32(48000, f.sample_rate);
+
+    // 帧长度比帧头还短（带 CRC 时帧头 9 字节）、采样率索引无效、MP3 帧头都不是 ADTS
+    put_adts(adts, 4, 6, 0);
+    TEST_ASSERT_FALSE(audio_probe_adts_frame(adts, &f));
+    put_adts(adts, 4, 8, 0);
+    adts[1] &= ~0x01;
+    TEST_ASSERT_FALSE(audio_probe_adts_frame(adts, &f));
+    put_adts(adts, 13, 371, 0);
+    TEST_ASSERT_FALSE(audio_probe_adts_frame(adts, &f));
+    memcpy(adts, s_mp3_hdr, sizeof(s_mp3_hdr));
+    TEST_ASSERT_FALSE(audio_probe_adts_frame(adts, &f));
+}
+
+TEST_CASE("audio probe sniffs ID3-prefixed MP3 and ADTS streams", "[audio_probe]")
+{
+    static uint8_t buf[8192];
+
+    // ID3v2 标签之后紧跟帧头
+    memset(buf, 0, sizeof(buf));
+    size_t pos = put_id3v2(buf, 1000, false);
+    TEST_ASSERT_EQUAL(1010, audio_probe_id3v2_size(buf, sizeof(buf)));
+    memcpy(buf + pos, s_mp3_hdr, sizeof(s_mp3_hdr));
+    TEST_ASSERT_EQUAL(ESP_AUDIO_SIMPLE_DEC_TYPE_MP3, audio_probe_type(buf, sizeof(buf)));
+
+    // 带页脚的标签，后面有一段填充再是帧头
+    memset(buf, 0, sizeof(buf));
+    pos = put_id3v2(buf, 500, true);
+    TEST_ASSERT_EQUAL(520, audio_probe_id3v2_size(buf, sizeof(buf)));
+    fill_junk(buf + pos, 700);
+    memcpy(buf + pos + 700, s_mp3_hdr, sizeof(s_mp3_hdr));
+    TEST_ASSERT_EQUAL(ESP_AUDIO_SIMPLE_DEC_TYPE_MP3, audio_probe_type(buf, sizeof(buf)));
+
+    // 标签体内的字节像同步字也不算，从标签之后开始找
+    memset(buf, 0, sizeof(buf));
+    pos = put_id3v2(buf, 100, false);
+    memcpy(buf + 20, s_mp3_hdr, sizeof(s_mp3_hdr));
+    put_adts(buf + pos, 4, 371, 0);
+    TEST_ASSERT_EQUAL(ESP_AUDIO_SIMPLE_DEC_TYPE_AAC, audio_probe_type(buf, sizeof(buf)));
+
+    // 裸 ADTS 流
+    memset(buf, 0, sizeof(buf));
+    put_adts(buf, 3, 371, 0);
+    TEST_ASSERT_EQUAL(ESP_AUDIO_SIMPLE_DEC_TYPE_AAC, audio_probe_type(buf, 64));
+
+    // ID3v2 标签后的 FLAC
+    memset(buf, 0, sizeof(buf));
+    pos = put_id3v2(buf, 64, false);
+    memcpy(buf + pos, "fLaC", 4);
+    TEST_ASSERT_EQUAL(ESP_AUDIO_SIMPLE_DEC_TYPE_FLAC, audio_probe_type(buf, sizeof(buf)));
+
+    // 没有 ID3 标签时大小为 0
+    TEST_ASSERT_EQUAL(0, audio_probe_id3v2_size(s_mp3_hdr, sizeof(s_mp3_hdr)));
+}
+
+TEST_CASE("audio probe rejects truncated and garbage data", "[audio_probe]")
+{
+    static uint8_t buf[8192];
+
+    // 太短，或为空
+    TEST_ASSERT_EQUAL(ESP_AUDIO_SIMPLE_DEC_TYPE_NONE, audio_probe_type(s_mp3_hdr, sizeof(s_mp3_hdr)));
+    TEST_ASSERT_EQUAL(ESP_AUDIO_SIMPLE_DEC_TYPE_NONE, audio_probe_type(NULL, 0));
+
+    // 没有同步字的数据
+    fill_junk(buf, sizeof(buf));
+    TEST_ASSERT_EQUAL(ESP_AUDIO_SIMPLE_DEC_TYPE_NONE, audio_probe_type(buf, sizeof(buf)));
+
+    // 只有 0xFF 和无效的帧头
+    memset(buf, 0xFF, sizeof(buf));
+    TEST_ASSERT_EQUAL(ESP_AUDIO_SIMPLE_DEC_TYPE_NONE, audio_probe_type(buf, sizeof(buf)));
+
+    // ID3v2 标签声明的长度超过已读数据：标签被截断，不在标签体里找同步字
+    memset(buf, 0, sizeof(buf));
+    put_id3v2(buf, 100000, false);
+    memcpy(buf + 1000, s_mp3_hdr, sizeof(s_mp3_hdr));
+    TEST_ASSERT_EQUAL(ESP_AUDIO_SIMPLE_DEC_TYPE_NONE, audio_probe_type(buf, sizeof(buf)));
+    // 标签头本身被截断
+    TEST_ASSERT_EQUAL(0, audio_probe_id3v2_size(buf, 9));
+
+    // 帧头在标签之后的搜索范围以外
+    memset(buf, 0, sizeof(buf));
+    size_t pos = put_id3v2(buf, 10, false);
+    fill_junk(buf + pos, 4096);
+    memcpy(buf + pos + 4096, s_mp3_hdr, sizeof(s_mp3_hdr));
+    TEST_ASSERT_EQUAL(ESP_AUDIO_SIMPLE_DEC_TYPE_NONE, audio_probe_type(buf, sizeof(buf)));
+
+    // 帧头被截断在数据末尾
+    memset(buf, 0, sizeof(buf));
+    memcpy(buf + 30, s_mp3_hdr, 3);
+    TEST_ASSERT_EQUAL(ESP_AUDIO_SIMPLE_DEC_TYPE_NONE, audio_probe_type(buf, 33));
+}
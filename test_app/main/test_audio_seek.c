@@ -0,0 +1,282 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "unity.h"
+#include "esp_vfs_fat.h"
+#include "audio_seek.h"
+
+#define SEEK_TEST_BASE     "/data"
+#define SEEK_TEST_FRAMES   400       // 每个合成流的音频帧数
+#define SEEK_TEST_SAMPLES  1152      // MPEG1 Layer III 每帧采样数
+#define SEEK_TEST_RATE     44100
+#define SEEK_TEST_JUNK_AT  301       // CBR 流在这一帧之前插入垃圾数据
+#define SEEK_TEST_JUNK_LEN 37
+
+// MPEG1 Layer III 44.1 kHz 联合立体声帧头，比特率索引 9/10/14 分别为 128/160/320 kbps
+#define HDR_128K 0x90
+#define HDR_160K 0xA0
+#define HDR_320K 0xE0
+
+static wl_handle_t s_wl = WL_INVALID_HANDLE;
+
+static void seek_test_mount(void)
+{
+    const esp_vfs_fat_mount_config_t config = {
+        .format_if_mount_failed = true,
+        .max_files = 2,
+        .allocation_unit_size = 4096,
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, esp_vfs_fat_spiflash_mount_rw_wl(SEEK_TEST_BASE, "storage", &config, &s_wl));
+}
+
+static void seek_test_unmount(void)
+{
+    // 定位缓存中的帧索引在测试前后都不应占用内存
+    audio_seek_cache_clear();
+    TEST_ASSERT_EQUAL(ESP_OK, esp_vfs_fat_spiflash_unmount_rw_wl(SEEK_TEST_BASE, s_wl));
+    s_wl = WL_INVALID_HANDLE;
+}
+
+// 帧长度：144 * 比特率 / 采样率，不带填充位
+static uint32_t frame_len(uint8_t hdr2)
+{
+    static const uint16_t kbps[16] = {0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 0};
+    return 144 * kbps[hdr2 >> 4] * 1000 / SEEK_TEST_RATE;
+}
+
+// 写一帧：帧头，其余为不含 0xFF 的数据，不会产生伪同步字
+static void put_frame(FILE *f, uint8_t hdr2, const uint8_t *body, uint32_t body_len)
+{
+    uint32_t len = frame_len(hdr2);
+    uint8_t *frame = calloc(1, len);
+    TEST_ASSERT_NOT_NULL(frame);
+    frame[0] = 0xFF;
+    frame[1] = 0xFB;
+    frame[2] = hdr2;
+    frame[3] = 0x64;
+    for (uint32_t i = 4; i < len; i++)
+    {
+        frame[i] = (uint8_t)(i % 0x7F);
+    }
+    // 边信息之后是 Xing/VBRI 等信息帧的内容
+    if (body != NULL)
+    {
+        memcpy(frame + 4 + 32, body, body_len);
+    }
+    TEST_ASSERT_EQUAL(len, fwrite(frame, 1, len, f));
+    free(frame);
+}
+
+static void put_be(uint8_t *p, uint32_t v, int bytes)
+{
+    for (int i = bytes - 1; i >= 0; i--, v >>= 8)
+    {
+        p[i] = (uint8_t)v;
+    }
+}
+
+static void check_point(const audio_seek_file_t *file, uint64_t sample, uint32_t expect_offset, uint64_t expect_sample)
+{
+    audio_seek_point_t point;
+    TEST_ASSERT_EQUAL(ESP_OK, audio_seek_lookup(file, sample, SEEK_TEST_RATE, &point));
+    TEST_ASSERT_EQUAL_UINT32(expect_offset, point.offset);
+    TEST_ASSERT_EQUAL_UINT64(expect_sample, point.sample);
+    TEST_ASSERT_TRUE(point.exact);
+}
+
+// CBR 流中第 i 帧的位置：前面有 start 字节的标签，SEEK_TEST_JUNK_AT 帧之前有一段垃圾数据
+static uint32_t cbr_offset(uint32_t start, uint32_t i)
+{
+    return start + i * frame_len(HDR_128K) + (i >= SEEK_TEST_JUNK_AT ? SEEK_TEST_JUNK_LEN : 0);
+}
+
+TEST_CASE("audio seek builds a frame index for CBR streams", "[audio_seek]")
+{
+    seek_test_mount();
+    const char *path = SEEK_TEST_BASE "/cbr.mp3";
+    const uint32_t start = 128; // 当作 ID3v2 标签，内容不会被读取
+    FILE *f = fopen(path, "wb");
+    TEST_ASSERT_NOT_NULL(f);
+    for (uint32_t i = 0; i < start; i++)
+    {
+        fputc(0, f);
+    }
+    for (uint32_t i = 0; i < SEEK_TEST_FRAMES; i++)
+    {
+        if (i == SEEK_TEST_JUNK_AT)
+        {
+            for (uint32_t j = 0; j < SEEK_TEST_JUNK_LEN; j++)
+            {
+                fputc(0x55, f);
+            }
+        }
+        put_frame(f, HDR_128K, NULL, 0);
+    }
+    fclose(f);
+
+    const audio_seek_file_t file = {
+        .path = path,
+        .type = ESP_AUDIO_SIMPLE_DEC_TYPE_MP3,
+        .audio_start = start,
+        .audio_end = cbr_offset(start, SEEK_TEST_FRAMES),
+    };
+    // 每 AUDIO_SEEK_INDEX_INTERVAL 帧一个索引项，返回目标之前至少一帧的最近一项
+    const uint32_t step = AUDIO_SEEK_INDEX_INTERVAL * SEEK_TEST_SAMPLES;
+    check_point(&file, 0, start, 0);
+    check_point(&file, step, start, 0);
+    check_point(&file, step + SEEK_TEST_SAMPLES, cbr_offset(start, AUDIO_SEEK_INDEX_INTERVAL), step);
+    // 越过垃圾数据后重新同步，之后的位置都要算上垃圾数据的长度
+    check_point(&file, 5 * step + SEEK_TEST_SAMPLES + 1000, cbr_offset(start, 5 * AUDIO_SEEK_INDEX_INTERVAL), 5 * step);
+    // 已扫描范围内向回跳转直接查索引
+    check_point(&file, 2 * step + 1, cbr_offset(start, AUDIO_SEEK_INDEX_INTERVAL), step);
+    // 超出曲目长度时返回数据末尾和总采样数
+    check_point(&file, (uint64_t)SEEK_TEST_FRAMES * SEEK_TEST_SAMPLES + 10, file.audio_end,
+                (uint64_t)SEEK_TEST_FRAMES * SEEK_TEST_SAMPLES);
+    // 解码输出采样率是帧头的两倍（HE-AAC 那样）时按输出采样率换算
+    audio_seek_point_t point;
+    TEST_ASSERT_EQUAL(ESP_OK, audio_seek_lookup(&file, 2 * (step + SEEK_TEST_SAMPLES), 2 * SEEK_TEST_RATE, &point));
+    TEST_ASSERT_EQUAL_UINT32(cbr_offset(start, AUDIO_SEEK_INDEX_INTERVAL), point.offset);
+    TEST_ASSERT_EQUAL_UINT64(2 * step, point.sample);
+
+    remove(path);
+    seek_test_unmount();
+}
+
+TEST_CASE("audio seek interpolates the Xing TOC", "[audio_seek]")
+{
+    seek_test_mount();
+    const char *path = SEEK_TEST_BASE "/xing.mp3";
+    const uint32_t len = frame_len(HDR_128K);
+    const uint32_t bytes = (SEEK_TEST_FRAMES + 1) * len;
+    // Xing 帧：标志（帧数、字节数、TOC），TOC 第 i 项为 i% 时长处的字节位置 / 总字节数 * 256
+    uint8_t xing[4 + 4 + 4 + 4 + 100];
+    memcpy(xing, "Xing", 4);
+    put_be(xing + 4, 0x07, 4);
+    put_be(xing + 8, SEEK_TEST_FRAMES, 4);
+    put_be(xing + 12, bytes, 4);
+    for (int i = 0; i < 100; i++)
+    {
+        xing[16 + i] = (uint8_t)((uint64_t)(len + i * SEEK_TEST_FRAMES / 100 * len) * 256 / bytes);
+    }
+    FILE *f = fopen(path, "wb");
+    TEST_ASSERT_NOT_NULL(f);
+    put_frame(f, HDR_128K, xing, sizeof(xing));
+    for (uint32_t i = 0; i < SEEK_TEST_FRAMES; i++)
+    {
+        put_frame(f, HDR_128K, NULL, 0);
+    }
+    fclose(f);
+
+    const audio_seek_file_t file = {
+        .path = path,
+        .type = ESP_AUDIO_SIMPLE_DEC_TYPE_MP3,
+        .audio_start = 0,
+        .audio_end = bytes,
+    };
+    // 按 TOC 估计的位置只精确到 1/256，结果必须是帧头，且在目标前一帧附近
+    for (uint32_t frame = 0; frame < SEEK_TEST_FRAMES; frame += 37)
+    {
+        uint64_t target = (uint64_t)frame * SEEK_TEST_SAMPLES + 500;
+        audio_seek_point_t point;
+        TEST_ASSERT_EQUAL(ESP_OK, audio_seek_lookup(&file, target, SEEK_TEST_RATE, &point));
+        TEST_ASSERT_FALSE(point.exact);
+        TEST_ASSERT_EQUAL_UINT64(target, point.sample);
+        // Xing 帧本身不含音频，不能作为跳转位置
+        TEST_ASSERT_GREATER_OR_EQUAL_UINT32(len, point.offset);
+        TEST_ASSERT_EQUAL_UINT32(0, point.offset % len);
+        int32_t found = (int32_t)(point.offset / len) - 1;
+        int32_t expect = frame > 0 ? (int32_t)frame - 1 : 0;
+        TEST_ASSERT_INT32_WITHIN(bytes / 256 / len + 1, expect, found);
+    }
+    // 超出曲目长度
+    check_point(&file, (uint64_t)SEEK_TEST_FRAMES * SEEK_TEST_SAMPLES, file.audio_end,
+                (uint64_t)SEEK_TEST_FRAMES * SEEK_TEST_SAMPLES);
+
+    remove(path);
+    seek_test_unmount();
+}
+
+TEST_CASE("audio seek uses the VBRI table as a frame index", "[audio_seek]")
+{
+    seek_test_mount();
+    const char *path = SEEK_TEST_BASE "/vbri.mp3";
+    const uint32_t frames_per_entry = 10;
+    const uint32_t entries = SEEK_TEST_FRAMES / frames_per_entry;
+    // VBR：每三帧一帧 160 kbps，其余 128 kbps
+    uint32_t offsets[SEEK_TEST_FRAMES + 1];
+    offsets[0] = frame_len(HDR_320K);
+    for (uint32_t i = 0; i < SEEK_TEST_FRAMES; i++)
+    {
+        offsets[i + 1] = offsets[i] + frame_len(i % 3 == 0 ? HDR_160K : HDR_128K);
+    }
+    // VBRI 帧：版本、延迟、质量、字节数、帧数、表项数、缩放系数、表项字节数、每项帧数，然后是表
+    uint8_t vbri[26 + SEEK_TEST_FRAMES / 10 * 2] = {0};
+    memcpy(vbri, "VBRI", 4);
+    put_be(vbri + 4, 1, 2);
+    put_be(vbri + 10, offsets[SEEK_TEST_FRAMES], 4);
+    put_be(vbri + 14, SEEK_TEST_FRAMES, 4);
+    put_be(vbri + 18, entries, 2);
+    put_be(vbri + 20, 1, 2);
+    put_be(vbri + 22, 2, 2);
+    put_be(vbri + 24, frames_per_entry, 2);
+    for (uint32_t i = 0; i < entries; i++)
+    {
+        put_be(vbri + 26 + i * 2, offsets[(i + 1) * frames_per_entry] - offsets[i * frames_per_entry], 2);
+    }
+    FILE *f = fopen(path, "wb");
+    TEST_ASSERT_NOT_NULL(f);
+    put_frame(f, HDR_320K, vbri, sizeof(vbri));
+    for (uint32_t i = 0; i < SEEK_TEST_FRAMES; i++)
+    {
+        put_frame(f, i % 3 == 0 ? HDR_160K : HDR_128K, NULL, 0);
+    }
+    fclose(f);
+
+    const audio_seek_file_t file = {
+        .path = path,
+        .type = ESP_AUDIO_SIMPLE_DEC_TYPE_MP3,
+        .audio_start = 0,
+        .audio_end = offsets[SEEK_TEST_FRAMES],
+    };
+    const uint32_t step = frames_per_entry * SEEK_TEST_SAMPLES;
+    check_point(&file, 0, offsets[0], 0);
+    check_point(&file, step, offsets[0], 0);
+    check_point(&file, step + SEEK_TEST_SAMPLES, offsets[frames_per_entry], step);
+    for (uint32_t i = 1; i < entries; i += 7)
+    {
+        check_point(&file, (uint64_t)i * step + 2 * SEEK_TEST_SAMPLES, offsets[i * frames_per_entry], (uint64_t)i * step);
+    }
+
+    remove(path);
+    seek_test_unmount();
+}
+
+TEST_CASE("audio seek rejects files without frames", "[audio_seek]")
+{
+    seek_test_mount();
+    const char *path = SEEK_TEST_BASE "/junk.mp3";
+    FILE *f = fopen(path, "wb");
+    TEST_ASSERT_NOT_NULL(f);
+    for (int i = 0; i < 20000; i++)
+    {
+        fputc(i % 0x7F, f);
+    }
+    fclose(f);
+    audio_seek_file_t file = {
+        .path = path,
+        .type = ESP_AUDIO_SIMPLE_DEC_TYPE_MP3,
+        .audio_start = 0,
+        .audio_end = 20000,
+    };
+    audio_seek_point_t point;
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, audio_seek_lookup(&file, 1000, SEEK_TEST_RATE, &point));
+    file.type = ESP_AUDIO_SIMPLE_DEC_TYPE_FLAC;
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_SUPPORTED, audio_seek_lookup(&file, 1000, SEEK_TEST_RATE, &point));
+    file.type = ESP_AUDIO_SIMPLE_DEC_TYPE_MP3;
+    file.path = SEEK_TEST_BASE "/none.mp3";
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, audio_seek_lookup(&file, 1000, SEEK_TEST_RATE, &point));
+
+    remove(path);
+    seek_test_unmount();
+}
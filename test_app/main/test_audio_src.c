@@ -0,0 +1,126 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <inttypes.h>
+#include "unity.h"
+#include "audio_src.h"
+
+#define SRC_TEST_FRAMES    (48000 / 4)  // 每种组合转换 0.25 秒
+#define SRC_TEST_BLOCK     300          // 故意不是 256 的整数倍，覆盖跨块的历史样本
+#define SRC_TEST_SKIP      64           // 跳过开头滤波器的暂态
+#define SRC_TEST_TONE_HZ   1000.0
+#define SRC_TEST_AMPLITUDE 16384.0      // -6 dBFS
+
+/**
+ * @brief 对输出做 1 kHz 正弦（含直流）最小二乘拟合，残差即噪声加失真，返回 THD+N 对应的 SNR（dB）
+ *
+ * 拟合不关心滤波器的群延迟，左右声道分别拟合
+ */
+static double src_tone_snr(const int16_t *pcm, uint32_t frames, uint32_t channels, uint32_t rate)
+{
+    double sig2 = 0, err2 = 0;
+    for (uint32_t ch = 0; ch < channels; ch++)
+    {
+        // 正规方程 [s c 1]，对称矩阵按上三角累加
+        double ss = 0, sc = 0, s1 = 0, cc = 0, c1 = 0, n = 0, sy = 0, cy = 0, y1 = 0;
+        for (uint32_t i = SRC_TEST_SKIP; i < frames; i++)
+        {
+            double w = 2 * M_PI * SRC_TEST_TONE_HZ * i / rate;
+            double s = sin(w), c = cos(w), y = pcm[i * channels + ch];
+            ss += s * s, sc += s * c, s1 += s, cc += c * c, c1 += c, n += 1;
+            sy += s * y, cy += c * y, y1 += y;
+        }
+        // 3x3 克拉默法则
+        double det = ss * (cc * n - c1 * c1) - sc * (sc * n - c1 * s1) + s1 * (sc * c1 - cc * s1);
+        double a = (sy * (cc * n - c1 * c1) - sc * (cy * n - c1 * y1) + s1 * (cy * c1 - cc * y1)) / det;
+        double b = (ss * (cy * n - y1 * c1) - sy * (sc * n - c1 * s1) + s1 * (sc * y1 - cy * s1)) / det;
+        double d = (ss * (cc * y1 - c1 * cy) - sc * (sc * y1 - c1 * sy) + sy * (sc * c1 - cc * s1)) / det;
+        for (uint32_t i = SRC_TEST_SKIP; i < frames; i++)
+        {
+            double w = 2 * M_PI * SRC_TEST_TONE_HZ * i / rate;
+            double fit = a * sin(w) + b * cos(w);
+            double e = pcm[i * channels + ch] - fit - d;
+            sig2 += fit * fit;
+            err2 += e * e;
+        }
+    }
+    return 10 * log10(sig2 / err2);
+}
+
+/**
+ * @brief 把 1 kHz 正弦分块送过 SRC，检查输出帧数、幅度和 THD+N
+ */
+static void src_check_tone(uint32_t in_rate, uint32_t out_rate, audio_src_quality_t quality, double min_snr)
+{
+    const uint32_t channels = 2;
+    const audio_src_config_t config = {
+        .in_rate = in_rate,
+        .out_rate = out_rate,
+        .channels = channels,
+        .quality = quality,
+    };
+    audio_src_handle_t src;
+    TEST_ASSERT_EQUAL(ESP_OK, audio_src_create(&config, &src));
+    TEST_ASSERT_EQUAL(quality, audio_src_get_quality(src));
+
+    const uint32_t max_out = (uint32_t)((uint64_t)SRC_TEST_FRAMES * out_rate / in_rate) + SRC_TEST_BLOCK;
+    int16_t *in = malloc(SRC_TEST_BLOCK * channels * sizeof(int16_t));
+    int16_t *out = malloc(max_out * channels * sizeof(int16_t));
+    TEST_ASSERT_NOT_NULL(in);
+    TEST_ASSERT_NOT_NULL(out);
+
+    uint32_t produced = 0;
+    for (uint32_t done = 0; done < SRC_TEST_FRAMES;)
+    {
+        uint32_t n = SRC_TEST_FRAMES - done < SRC_TEST_BLOCK ? SRC_TEST_FRAMES - done : SRC_TEST_BLOCK;
+        for (uint32_t i = 0; i < n; i++)
+        {
+            // 左右声道反相，检查两个通道互不串扰
+            int16_t v = (int16_t)lround(SRC_TEST_AMPLITUDE * sin(2 * M_PI * SRC_TEST_TONE_HZ * (done + i) / in_rate));
+            in[i * channels] = v;
+            in[i * channels + 1] = (int16_t)-v;
+        }
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32(max_out - produced, audio_src_max_output_frames(src, n));
+        produced += audio_src_process(src, in, n, out + produced * channels);
+        done += n;
+    }
+
+    // 输出帧数与比例一致，差值只来自滤波器延迟
+    TEST_ASSERT_UINT32_WITHIN(64, (uint64_t)SRC_TEST_FRAMES * out_rate / in_rate, produced);
+    // 通带增益为 1，左右反相保持
+    int32_t peak = 0;
+    for (uint32_t i = SRC_TEST_SKIP; i < produced; i++)
+    {
+        peak = out[i * channels] > peak ? out[i * channels] : peak;
+        TEST_ASSERT_INT_WITHIN(1, -out[i * channels], out[i * channels + 1]);
+    }
+    TEST_ASSERT_INT_WITHIN(SRC_TEST_AMPLITUDE / 100, SRC_TEST_AMPLITUDE, peak);
+
+    double snr = src_tone_snr(out, produced, channels, out_rate);
+    printf("%" PRIu32 " -> %" PRIu32 " %s: THD+N %.1f dB\n", in_rate, out_rate, audio_src_quality_name(quality), -snr);
+    TEST_ASSERT_GREATER_THAN_DOUBLE(min_snr, snr);
+
+    free(in);
+    free(out);
+    audio_src_delete(src);
+}
+
+TEST_CASE("audio src 44.1k/48k tone THD+N per quality tier", "[audio_src]")
+{
+    // 下限比实测值留出约 3 dB 余量
+    const struct
+    {
+        audio_src_quality_t quality;
+        double min_snr;
+    } tiers[] = {
+        {AUDIO_SRC_QUALITY_LINEAR, 59.0},
+        {AUDIO_SRC_QUALITY_SHORT_SINC, 68.0},
+        {AUDIO_SRC_QUALITY_LONG_SINC, 80.0},
+    };
+    for (int i = 0; i < sizeof(tiers) / sizeof(tiers[0]); i++)
+    {
+        src_check_tone(44100, 48000, tiers[i].quality, tiers[i].min_snr);
+        src_check_tone(48000, 44100, tiers[i].quality, tiers[i].min_snr);
+    }
+}
@@ -0,0 +1,241 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "unity.h"
+#include "pcm_ring.h"
+
+#define RING_SLOT_NUM     8
+#define RING_SLOT_SIZE    64
+#define RING_PERIOD_MS    1   // 48 kHz 立体声 16 位时 192 字节，约 3~4 个槽发布一次
+#define STRESS_SLOTS      200000
+#define STRESS_BATCH      4
+
+typedef struct
+{
+    pcm_ring_handle_t ring;
+    SemaphoreHandle_t done;
+    uint8_t *lap0[RING_SLOT_NUM]; // 第一圈每个槽的内存，之后按序号取模必须回到同一个槽
+    uint32_t produced;
+    uint32_t consumed;
+    uint32_t max_batch;
+    const char *error;            // 消费者发现的第一个错误
+} stress_ctx_t;
+
+// 每个槽的长度和内容都由序号决定，消费者据此检查顺序和数据
+static uint32_t slot_len(uint32_t seq)
+{
+    return 4 + (seq * 7 % (RING_SLOT_SIZE / 4)) * 4;
+}
+
+static uint8_t slot_byte(uint32_t seq, uint32_t i)
+{
+    return (uint8_t)(seq * 31 + i);
+}
+
+// 生产者：取槽、写入、提交，偶尔停顿让消费者等在空环上，偶尔强制发布
+static void stress_producer(void *arg)
+{
+    stress_ctx_t *ctx = arg;
+    for (uint32_t seq = 0; seq < STRESS_SLOTS; seq++)
+    {
+        pcm_slot_t *slot = pcm_ring_acquire(ctx->ring, pdMS_TO_TICKS(1000));
+        if (slot == NULL)
+        {
+            break;
+        }
+        if (seq < RING_SLOT_NUM)
+        {
+            ctx->lap0[seq] = slot->data;
+        }
+        else if (slot->data != ctx->lap0[seq % RING_SLOT_NUM])
+        {
+            break;
+        }
+        uint32_t len = slot_len(seq);
+        for (uint32_t i = 0; i < len; i++)
+        {
+            slot->data[i] = slot_byte(seq, i);
+        }
+        slot->len = len;
+        slot->sample_rate = 48000;
+        slot->channels = 2;
+        slot->bits = 16;
+        slot->epoch = seq;
+        slot->flags = (seq % 97 == 96) ? PCM_SLOT_FLAG_TRACK_END : 0;
+        pcm_ring_commit(ctx->ring, slot);
+        ctx->produced = seq + 1;
+        if (seq % 1013 == 0)
+        {
+            pcm_ring_flush(ctx->ring);
+        }
+        if (seq % 4099 == 0)
+        {
+            vTaskDelay(1);
+        }
+    }
+    pcm_ring_flush(ctx->ring);
+    xSemaphoreGive(ctx->done);
+    vTaskDelete(NULL);
+}
+
+// 消费者：批量取槽，检查序号、长度、内容和槽的位置，偶尔停顿让生产者等在满环上
+static void stress_consumer(void *arg)
+{
+    stress_ctx_t *ctx = arg;
+    uint32_t seq = 0;
+    while (seq < STRESS_SLOTS && ctx->error == NULL)
+    {
+        pcm_slot_t *slots[STRESS_BATCH];
+        uint32_t n = pcm_ring_receive(ctx->ring, slots, STRESS_BATCH, pdMS_TO_TICKS(1000));
+        if (n == 0)
+        {
+            ctx->error = "receive timed out";
+            break;
+        }
+        ctx->max_batch = n > ctx->max_batch ? n : ctx->max_batch;
+        for (uint32_t k = 0; k < n && ctx->error == NULL; k++, seq++)
+        {
+            const pcm_slot_t *slot = slots[k];
+            if (slot->epoch != seq)
+            {
+                ctx->error = "slot out of order";
+            }
+            else if (seq >= RING_SLOT_NUM && slot->data != ctx->lap0[seq % RING_SLOT_NUM])
+            {
+                ctx->error = "slot index did not wrap to the same slot";
+            }
+            else if (slot->len != slot_len(seq))
+            {
+                ctx->error = "slot length mismatch";
+            }
+            else
+            {
+                for (uint32_t i = 0; i < slot->len; i++)
+                {
+                    if (slot->data[i] != slot_byte(seq, i))
+                    {
+                        ctx->error = "slot data corrupted";
+                        break;
+                    }
+                }
+            }
+        }
+        // 生产者不能超前消费者一整圈
+        if (pcm_ring_filled(ctx->ring) > RING_SLOT_NUM)
+        {
+            ctx->error = "more slots filled than the ring holds";
+        }
+        pcm_ring_release(ctx->ring, n);
+        ctx->consumed = seq;
+        if (seq % 5003 < n)
+        {
+            vTaskDelay(1);
+        }
+    }
+    xSemaphoreGive(ctx->done);
+    vTaskDelete(NULL);
+}
+
+TEST_CASE("pcm ring producer/consumer stress on two cores", "[pcm_ring]")
+{
+    static stress_ctx_t ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    const pcm_ring_config_t config = {
+        .slot_num = RING_SLOT_NUM,
+        .slot_size = RING_SLOT_SIZE,
+        .period_ms = RING_PERIOD_MS,
+        .caps = MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT,
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, pcm_ring_create(&config, &ctx.ring));
+    ctx.done = xSemaphoreCreateCounting(2, 0);
+    TEST_ASSERT_NOT_NULL(ctx.done);
+
+    // 与播放器一样：解码任务和播放任务分别固定在两个核上
+    int64_t start = esp_timer_get_time();
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreatePinnedToCore(stress_consumer, "ring_cons", 4096, &ctx, 5, NULL, 1));
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreatePinnedToCore(stress_producer, "ring_prod", 4096, &ctx, 5, NULL, 0));
+    TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(ctx.done, pdMS_TO_TICKS(60000)));
+    TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(ctx.done, pdMS_TO_TICKS(60000)));
+    int64_t elapsed = esp_timer_get_time() - start;
+    printf("%" PRIu32 " slots in %" PRIi64 " ms, largest batch %" PRIu32 "\n", ctx.consumed, elapsed / 1000, ctx.max_batch);
+    // 等空闲任务回收两个任务的内存
+    vTaskDelay(pdMS_TO_TICKS(10));
+
+    vSemaphoreDelete(ctx.done);
+    TEST_ASSERT_EQUAL(0, pcm_ring_filled(ctx.ring));
+    pcm_ring_delete(ctx.ring);
+    if (ctx.error)
+    {
+        TEST_FAIL_MESSAGE(ctx.error);
+    }
+    TEST_ASSERT_EQUAL_UINT32(STRESS_SLOTS, ctx.produced);
+    TEST_ASSERT_EQUAL_UINT32(STRESS_SLOTS, ctx.consumed);
+    TEST_ASSERT_GREATER_THAN_UINT32(1, ctx.max_batch);
+}
+
+TEST_CASE("pcm ring publishes by period, track end and full ring", "[pcm_ring]")
+{
+    pcm_ring_handle_t ring;
+    const pcm_ring_config_t config = {
+        .slot_num = RING_SLOT_NUM,
+        .slot_size = RING_SLOT_SIZE,
+        .period_ms = 1,
+        .caps = MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT,
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, pcm_ring_create(&config, &ring));
+    TEST_ASSERT_EQUAL_UINT32(RING_SLOT_NUM, pcm_ring_slot_num(ring));
+    pcm_slot_t *slots[RING_SLOT_NUM];
+
+    // 8 kHz 单声道 16 位：一个周期 16 字节，两个 8 字节的槽发布一次
+    for (int i = 0; i < 2; i++)
+    {
+        pcm_slot_t *slot = pcm_ring_acquire(ring, 0);
+        TEST_ASSERT_NOT_NULL(slot);
+        slot->len = 8;
+        slot->sample_rate = 8000;
+        slot->channels = 1;
+        slot->bits = 16;
+        pcm_ring_commit(ring, slot);
+        TEST_ASSERT_EQUAL_UINT32(i == 0 ? 0 : 2, pcm_ring_filled(ring));
+    }
+    TEST_ASSERT_EQUAL_UINT32(2, pcm_ring_receive(ring, slots, RING_SLOT_NUM, 0));
+    pcm_ring_release(ring, 2);
+
+    // 曲目结束的空槽立即发布
+    pcm_slot_t *slot = pcm_ring_acquire(ring, 0);
+    slot->len = 0;
+    slot->sample_rate = 8000;
+    slot->channels = 1;
+    slot->bits = 16;
+    slot->flags = PCM_SLOT_FLAG_TRACK_END;
+    pcm_ring_commit(ring, slot);
+    TEST_ASSERT_EQUAL_UINT32(1, pcm_ring_receive(ring, slots, RING_SLOT_NUM, 0));
+    TEST_ASSERT_EQUAL_UINT32(PCM_SLOT_FLAG_TRACK_END, slots[0]->flags);
+    pcm_ring_release(ring, 1);
+
+    // 不足一个周期但环已满时也要发布，否则两端互相等待
+    for (int i = 0; i < RING_SLOT_NUM; i++)
+    {
+        slot = pcm_ring_acquire(ring, 0);
+        TEST_ASSERT_NOT_NULL(slot);
+        slot->len = 2;
+        slot->sample_rate = 48000;
+        slot->channels = 2;
+        slot->bits = 16;
+        pcm_ring_commit(ring, slot);
+    }
+    TEST_ASSERT_EQUAL_UINT32(RING_SLOT_NUM, pcm_ring_filled(ring));
+    TEST_ASSERT_NULL(pcm_ring_acquire(ring, 0));
+    TEST_ASSERT_EQUAL_UINT32(RING_SLOT_NUM, pcm_ring_receive(ring, slots, RING_SLOT_NUM, 0));
+    // 这一批是第 3~10 个槽，第 8 个之后回绕到槽 0
+    TEST_ASSERT_EQUAL_PTR(slots[0]->data - 3 * RING_SLOT_SIZE, slots[5]->data);
+    pcm_ring_release(ring, RING_SLOT_NUM);
+    TEST_ASSERT_EQUAL_UINT32(0, pcm_ring_receive(ring, slots, RING_SLOT_NUM, 0));
+    pcm_ring_delete(ring);
+}
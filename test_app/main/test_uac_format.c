@@ -0,0 +1,131 @@
+#include <stdint.h>
+#include "unity.h"
+#include "uac_format.h"
+
+static const uac_format_caps_t s_caps_all = {
+    .bits_conversion = true,
+    .channel_remap = true,
+};
+
+// 离散采样率 alt 设置
+#define ALT_DISCRETE(ch, bits, n, ...) \
+    { .format = 1, .channels = (ch), .bit_resolution = (bits), .sample_freq_type = (n), .sample_freq = {__VA_ARGS__} }
+// 连续采样率范围 alt 设置
+#define ALT_RANGE(ch, bits, lo, hi) \
+    { .format = 1, .channels = (ch), .bit_resolution = (bits), .sample_freq_type = 0, .sample_freq_lower = (lo), .sample_freq_upper = (hi) }
+
+static void check_select(const uac_host_dev_alt_param_t *alts, uint8_t alt_num, const uac_format_caps_t *caps,
+                         uac_format_t src, uac_format_t expect, uint32_t expect_cost)
+{
+    uac_format_t out;
+    uint32_t cost;
+    TEST_ASSERT_EQUAL(ESP_OK, uac_format_select(alts, alt_num, &src, caps, &out, &cost));
+    TEST_ASSERT_EQUAL_UINT32(expect.sample_rate, out.sample_rate);
+    TEST_ASSERT_EQUAL_UINT8(expect.bits, out.bits);
+    TEST_ASSERT_EQUAL_UINT8(expect.channels, out.channels);
+    TEST_ASSERT_EQUAL_UINT32(expect_cost, cost);
+    TEST_ASSERT_EQUAL_UINT32(cost, uac_format_cost(&src, &out, caps));
+}
+
+TEST_CASE("uac format picks the native format when an alt setting has it", "[uac_format]")
+{
+    // 常见 USB 声卡：alt 1 为 16 位立体声 44.1k/48k，alt 2 为 24 位立体声 48k/96k
+    const uac_host_dev_alt_param_t alts[] = {
+        ALT_DISCRETE(2, 16, 2, 44100, 48000),
+        ALT_DISCRETE(2, 24, 2, 48000, 96000),
+    };
+    check_select(alts, 2, &s_caps_all, (uac_format_t){44100, 16, 2}, (uac_format_t){44100, 16, 2}, 0);
+    check_select(alts, 2, &s_caps_all, (uac_format_t){48000, 16, 2}, (uac_format_t){48000, 16, 2}, 0);
+    check_select(alts, 2, &s_caps_all, (uac_format_t){96000, 24, 2}, (uac_format_t){96000, 24, 2}, 0);
+    // 采样率相同时补零提高位深，比重采样便宜
+    check_select(alts, 2, &s_caps_all, (uac_format_t){96000, 16, 2}, (uac_format_t){96000, 24, 2}, 5);
+    // 单声道曲目只需要通道重映射
+    check_select(alts, 2, &s_caps_all, (uac_format_t){44100, 16, 1}, (uac_format_t){44100, 16, 2}, 10);
+}
+
+TEST_CASE("uac format weighs resampling, bit depth and channel costs", "[uac_format]")
+{
+    // 只有 48k 的设备：44.1k 曲目必须重采样，L = 160
+    const uac_host_dev_alt_param_t only_48k[] = {
+        ALT_DISCRETE(2, 16, 1, 48000),
+    };
+    check_select(only_48k, 1, &s_caps_all, (uac_format_t){44100, 16, 2}, (uac_format_t){48000, 16, 2}, 100 + 40 + 10);
+
+    // 降采样时 2:1 比 96k -> 44.1k 便宜
+    const uac_host_dev_alt_param_t cd_rates[] = {
+        ALT_DISCRETE(2, 16, 2, 44100, 48000),
+    };
+    check_select(cd_rates, 1, &s_caps_all, (uac_format_t){96000, 16, 2}, (uac_format_t){48000, 16, 2}, 100 + 0 + 10 + 50);
+
+    // 24 位 48k 曲目：降位深加抖动（20）比 48k -> 44.1k 重采样便宜
+    const uac_host_dev_alt_param_t mixed[] = {
+        ALT_DISCRETE(2, 24, 1, 44100),
+        ALT_DISCRETE(2, 16, 1, 48000),
+    };
+    check_select(mixed, 2, &s_caps_all, (uac_format_t){48000, 24, 2}, (uac_format_t){48000, 16, 2}, 20);
+}
+
+TEST_CASE("uac format handles continuous ranges and the frequency table limit", "[uac_format]")
+{
+    // 范围内直接使用原生采样率
+    const uac_host_dev_alt_param_t wide[] = {
+        ALT_RANGE(2, 16, 8000, 96000),
+    };
+    check_select(wide, 1, &s_caps_all, (uac_format_t){22050, 16, 2}, (uac_format_t){22050, 16, 2}, 0);
+
+    // 范围外：在常用采样率和边界中选，44.1k -> 88.2k 只需 2 相
+    const uac_host_dev_alt_param_t high[] = {
+        ALT_RANGE(2, 16, 48000, 96000),
+    };
+    check_select(high, 1, &s_caps_all, (uac_format_t){44100, 16, 2}, (uac_format_t){88200, 16, 2}, 100 + 0 + 18);
+
+    // 设备声明的离散采样率多于驱动保存的个数时只看前 UAC_FREQ_NUM_MAX 个
+    uac_host_dev_alt_param_t many = ALT_DISCRETE(2, 16, UAC_FREQ_NUM_MAX + 2, 0);
+    for (int i = 0; i < UAC_FREQ_NUM_MAX; i++)
+    {
+        many.sample_freq[i] = 8000 * (i + 1);
+    }
+    many.sample_freq[UAC_FREQ_NUM_MAX - 1] = 48000;
+    check_select(&many, 1, &s_caps_all, (uac_format_t){48000, 16, 2}, (uac_format_t){48000, 16, 2}, 0);
+}
+
+TEST_CASE("uac format rejects infeasible alt settings", "[uac_format]")
+{
+    uac_format_t out = {0};
+    const uac_format_t src = {44100, 16, 1};
+
+    // 非 PCM 或空的 alt 设置被跳过
+    const uac_host_dev_alt_param_t not_pcm[] = {
+        { .format = 2, .channels = 2, .bit_resolution = 16, .sample_freq_type = 1, .sample_freq = {44100} },
+        ALT_DISCRETE(0, 16, 1, 44100),
+    };
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, uac_format_select(not_pcm, 2, &src, &s_caps_all, &out, NULL));
+
+    // 输出路径不能重映射通道时，立体声设备放不了单声道曲目
+    const uac_format_caps_t no_remap = {
+        .bits_conversion = true,
+        .channel_remap = false,
+    };
+    const uac_host_dev_alt_param_t stereo[] = {
+        ALT_DISCRETE(2, 16, 1, 44100),
+    };
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, uac_format_select(stereo, 1, &src, &no_remap, &out, NULL));
+
+    // 8 位和 8 声道都不在转换能力内
+    const uac_host_dev_alt_param_t odd[] = {
+        ALT_DISCRETE(2, 8, 1, 44100),
+        ALT_DISCRETE(8, 16, 1, 44100),
+    };
+    const uac_format_t stereo_src = {44100, 16, 2};
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, uac_format_select(odd, 2, &stereo_src, &s_caps_all, &out, NULL));
+
+    // 相位数超过 SRC 上限的比例不可行
+    const uac_host_dev_alt_param_t odd_rate[] = {
+        ALT_DISCRETE(2, 16, 1, 47999),
+    };
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, uac_format_select(odd_rate, 1, &stereo_src, &s_caps_all, &out, NULL));
+
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, uac_format_select(stereo, 0, &stereo_src, &s_caps_all, &out, NULL));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, uac_format_select(NULL, 1, &stereo_src, &s_caps_all, &out, NULL));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, uac_format_select(stereo, 1, NULL, &s_caps_all, &out, NULL));
+}